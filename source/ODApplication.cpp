@@ -21,6 +21,9 @@
 
 #include "ODApplication.h"
 
+#include "gamemap/GameMap.h"
+#include "gamemap/LevelSnapshot.h"
+#include "gamemap/MapHandler.h"
 #include "network/ODServer.h"
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
@@ -30,7 +33,9 @@
 #include "render/ODFrameListener.h"
 #include "render/TextRenderer.h"
 #include "utils/ConfigManager.h"
+#include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/LogSinkAsync.h"
 #include "utils/LogSinkConsole.h"
 #include "utils/LogSinkFile.h"
 #include "utils/LogSinkOgre.h"
@@ -55,26 +60,52 @@
 #endif /* OGRE_PLATFORM == OGRE_PLATFORM_WIN32 */
 #endif /* OD_USE_SFML_WINDOW */
 
+#include <SFML/System/Clock.hpp>
+
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <ctime>
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
-void ODApplication::startGame(boost::program_options::variables_map& options)
+void ODApplication::setupLogs(LogManager& logMgr, const ResourceManager& resMgr)
+{
+    logMgr.setLevel(resMgr.getLogLevel());
+
+    // The console and the log file are written from their own thread
+    std::unique_ptr<LogSinkAsync> asyncSink(new LogSinkAsync());
+    asyncSink->addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+    asyncSink->addSink(std::unique_ptr<LogSink>(new LogSinkFile(resMgr.getLogFile())));
+    logMgr.addSink(std::move(asyncSink));
+}
+
+bool ODApplication::startGame(boost::program_options::variables_map& options)
 {
     ResourceManager resMgr(options);
 
     LogManager logMgr;
-    logMgr.setLevel(resMgr.getLogLevel());
+    setupLogs(logMgr, resMgr);
 
-    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
-    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkFile(resMgr.getLogFile())));
+    if(resMgr.getLevelLoadBenchmarkRuns() > 0)
+        return runLevelLoadBenchmark();
 
-    if(resMgr.isServerMode())
-        startServer();
-    else
+    if(!resMgr.getConvertLevelFiles().empty())
+        return runLevelConversion();
+
+    if(!resMgr.isServerMode())
+    {
         startClient();
+        return true;
+    }
+
+    if(resMgr.getDeterminismCheckTurns() > 0)
+        return runDeterminismCheck();
+
+    startServer();
+    return true;
 }
 
 void ODApplication::startServer()
@@ -106,6 +137,108 @@ void ODApplication::startServer()
     server.stopServer();
 }
 
+bool ODApplication::runDeterminismCheck()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath());
+
+    // Both games use the same seed. If none is given, we take one from the time
+    uint64_t seed = resMgr.hasForcedSeed() ? resMgr.getForcedSeed() : static_cast<uint64_t>(std::time(0));
+    uint32_t nbTurns = resMgr.getDeterminismCheckTurns();
+    const std::string& levelFilename = resMgr.getServerModeLevel();
+    OD_LOG_INF("Determinism check on " + levelFilename + ", seed=" + Helper::toString(seed)
+        + ", nbTurns=" + Helper::toString(nbTurns) + ", senseThreads=" + Helper::toString(resMgr.getNbSenseWorkers()));
+
+    // The first game computes what the creatures see on one thread and the second one with the threads
+    // asked for. Both should give the same result
+    std::vector<uint64_t> stateHashes[2];
+    uint32_t nbSenseWorkers[2] = { 0, resMgr.getNbSenseWorkers() };
+    for(uint32_t i = 0; i < 2; ++i)
+    {
+        ODServer server;
+        if(!server.runHeadlessGame(levelFilename, seed, nbSenseWorkers[i], nbTurns, stateHashes[i]))
+            return false;
+    }
+
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        if(stateHashes[0][turn] == stateHashes[1][turn])
+            continue;
+
+        OD_LOG_ERR("Determinism check failed: the game states differ at turn " + Helper::toString(turn + 1));
+        return false;
+    }
+
+    OD_LOG_INF("Determinism check passed: " + Helper::toString(nbTurns) + " identical turns");
+    return true;
+}
+
+bool ODApplication::runLevelLoadBenchmark()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+    Random::initialize();
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath());
+    // The entities are loaded the same way as when the server launches a game
+    ODServer server;
+
+    std::vector<std::string> levels;
+    Helper::fillFilesList(resMgr.getGameLevelPathSkirmish(), levels, MapHandler::LEVEL_EXTENSION);
+    Helper::fillFilesList(resMgr.getGameLevelPathMultiplayer(), levels, MapHandler::LEVEL_EXTENSION);
+    std::sort(levels.begin(), levels.end());
+
+    uint32_t nbRuns = resMgr.getLevelLoadBenchmarkRuns();
+    OD_LOG_INF("Level load benchmark on " + Helper::toString(static_cast<uint32_t>(levels.size()))
+        + " levels, nbRuns=" + Helper::toString(nbRuns));
+
+    double totalMs = 0.0;
+    for(const std::string& level : levels)
+    {
+        double minMs = 0.0;
+        double sumMs = 0.0;
+        for(uint32_t run = 0; run < nbRuns; ++run)
+        {
+            GameMap gameMap(true);
+            sf::Clock clock;
+            if(!gameMap.loadLevel(level))
+            {
+                OD_LOG_ERR("Couldn't load level=" + level);
+                return false;
+            }
+            double ms = static_cast<double>(clock.getElapsedTime().asMicroseconds()) / 1000.0;
+            sumMs += ms;
+            if((run == 0) || (ms < minMs))
+                minMs = ms;
+        }
+
+        totalMs += sumMs;
+        OD_LOG_INF("Loaded level=" + level + ", minMs=" + Helper::toString(minMs)
+            + ", avgMs=" + Helper::toString(sumMs / nbRuns));
+    }
+
+    OD_LOG_INF("Level load benchmark done, totalMs=" + Helper::toString(totalMs));
+    return true;
+}
+
+bool ODApplication::runLevelConversion()
+{
+    const std::vector<std::string>& files = ResourceManager::getSingleton().getConvertLevelFiles();
+    if(files.size() != 2)
+    {
+        OD_LOG_ERR("convertlevel expects an input and an output file, nbFiles="
+            + Helper::toString(static_cast<uint32_t>(files.size())));
+        return false;
+    }
+
+    if(!LevelSnapshot::convertFile(files[0], files[1]))
+    {
+        OD_LOG_ERR("Couldn't convert level=" + files[0]);
+        return false;
+    }
+
+    OD_LOG_INF("Converted level=" + files[0] + " to file=" + files[1]);
+    return true;
+}
+
 void ODApplication::startClient()
 {
     ResourceManager& resMgr = ResourceManager::getSingleton();
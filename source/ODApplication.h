@@ -37,6 +37,7 @@ class Root;
 }
 
 class LogManager;
+class ResourceManager;
 
 //! \brief Base class which manages the startup of OpenDungeons.
 class ODApplication
@@ -48,7 +49,9 @@ public:
     {}
 
     //! \brief Initializes the Application along with the ResourceManager
-    void startGame(boost::program_options::variables_map& options);
+    //! Returns false if the tool asked on the command line (determinism check, level load
+    //! benchmark or level conversion) fails
+    bool startGame(boost::program_options::variables_map& options);
 
     static double turnsPerSecond;
     static const std::string VERSION;
@@ -60,10 +63,21 @@ private:
     ODApplication(const ODApplication&) = delete;
     ODApplication& operator=(const ODApplication&) = delete;
 
+    //! \brief Sets the log level and writes the logs to the console and to the log file
+    static void setupLogs(LogManager& logMgr, const ResourceManager& resMgr);
     //! \brief Normal launch mode. Creates everything to be client and server
     void startClient();
     //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui
     void startServer();
+    //! \brief Plays the server level twice with the same seed without network and checks that the game
+    //! state is the same after each turn. Returns false if it is not
+    bool runDeterminismCheck();
+    //! \brief Loads each bundled level in a server game map the number of times asked on the command
+    //! line and logs the load times. Returns false if a level cannot be loaded
+    bool runLevelLoadBenchmark();
+    //! \brief Converts the level given on the command line between the text format and the savegame
+    //! snapshot format. Returns false if it cannot be converted
+    bool runLevelConversion();
 };
 
 #endif // ODAPPLICATION_H
@@ -24,14 +24,23 @@
 std::function<bool()> CreatureActionWalkToTile::action()
 {
     return std::bind(&CreatureActionWalkToTile::handleWalkToTile,
-        std::ref(mCreature));
+        std::ref(mCreature), mFinalDestination);
 }
 
-bool CreatureActionWalkToTile::handleWalkToTile(Creature& creature)
+bool CreatureActionWalkToTile::handleWalkToTile(Creature& creature, Tile* finalDestination)
 {
     if (creature.isMoving())
         return false;
 
     creature.popAction();
+
+    // If we were walking to a waypoint, we go on to the final destination
+    if((finalDestination != nullptr) &&
+       (creature.getPositionTile() != finalDestination))
+    {
+        creature.setDestination(finalDestination);
+        return false;
+    }
+
     return true;
 }
@@ -20,11 +20,17 @@
 
 #include "creatureaction/CreatureAction.h"
 
+class Tile;
+
 class CreatureActionWalkToTile : public CreatureAction
 {
 public:
-    CreatureActionWalkToTile(Creature& creature) :
-        CreatureAction(creature)
+    //! \brief If finalDestination is not null, the creature is walking to a waypoint on the way
+    //! to finalDestination. When the waypoint is reached, the path to finalDestination will be
+    //! computed again.
+    CreatureActionWalkToTile(Creature& creature, Tile* finalDestination = nullptr) :
+        CreatureAction(creature),
+        mFinalDestination(finalDestination)
     {}
 
     virtual ~CreatureActionWalkToTile()
@@ -35,7 +41,10 @@ public:
 
     std::function<bool()> action() override;
 
-    static bool handleWalkToTile(Creature& creature);
+    static bool handleWalkToTile(Creature& creature, Tile* finalDestination);
+
+private:
+    Tile* mFinalDestination;
 };
 
 #endif // CREATUREACTIONWALKTOTILE_H
@@ -321,6 +321,21 @@ std::string Building::getNameTile(Tile* tile)
         + "_" + Helper::toString(tile->getY());
 }
 
+void Building::seatChanged(Seat* oldSeat)
+{
+    SeatRegionIndex& seatRegionIndex = getGameMap()->getSeatRegionIndex();
+    for(Tile* tile : mCoveredTiles)
+    {
+        if(tile->getCoveringBuilding() != this)
+            continue;
+
+        if(oldSeat != nullptr)
+            seatRegionIndex.remove(tile->getX(), tile->getY(), oldSeat->getId());
+        if(getSeat() != nullptr)
+            seatRegionIndex.add(tile->getX(), tile->getY(), getSeat()->getId());
+    }
+}
+
 bool Building::isAttackable(Tile* tile, Seat* seat) const
 {
     if(getHP(tile) <= 0.0)
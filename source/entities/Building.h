@@ -171,6 +171,9 @@ public:
     virtual bool importFromStream(std::istream& is) override;
 
 protected:
+    //! \brief Moves the tiles covered by this building in the seat index
+    virtual void seatChanged(Seat* oldSeat) override;
+
     //! \brief Allows to export/import specific data for child classes. Note that every tile
     //! should be exported on 1 line (thus, no line ending should be added here). Moreover
     //! the building will only export the tile coords. Exporting other relevant data is
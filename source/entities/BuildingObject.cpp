@@ -125,7 +125,7 @@ void BuildingObject::fireRefresh()
             continue;
 
         const std::string& name = getName();
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::entitiesRefresh, seat->getPlayer());
         uint32_t nb = 1;
         GameEntityType entityType = getObjectType();
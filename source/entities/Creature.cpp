@@ -97,6 +97,21 @@
 
 static const Ogre::Real CANNON_MISSILE_HEIGHT = 0.3;
 
+//! \brief Removes from objects the entities that are not on the map anymore and the dead creatures
+static void removeLeftObjects(std::vector<GameEntity*>& objects)
+{
+    objects.erase(std::remove_if(objects.begin(), objects.end(), [](GameEntity* entity)
+        {
+            if(!entity->getIsOnMap())
+                return true;
+
+            if(entity->getObjectType() != GameEntityType::creature)
+                return false;
+
+            return !static_cast<Creature*>(entity)->isAlive();
+        }), objects.end());
+}
+
 const int32_t Creature::NB_TURNS_BEFORE_CHECKING_TASK = 15;
 const uint32_t Creature::NB_OVERLAY_HEALTH_VALUES = 8;
 
@@ -171,7 +186,14 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mTilesInSightPosition    (nullptr),
+    mTilesInSightRadius      (0),
+    mTilesInSightEpoch       (0),
+    mSenseTurn               (-1),
+    mIsInGameMap             (false),
+    mCountedSeat             (nullptr),
+    mCountedAsWorker         (false)
 
 {
     //TODO: This should be set in initialiser list in parent classes
@@ -249,7 +271,14 @@ Creature::Creature(GameMap* gameMap) :
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mTilesInSightPosition    (nullptr),
+    mTilesInSightRadius      (0),
+    mTilesInSightEpoch       (0),
+    mSenseTurn               (-1),
+    mIsInGameMap             (false),
+    mCountedSeat             (nullptr),
+    mCountedAsWorker         (false)
 {
 }
 
@@ -316,6 +345,8 @@ void Creature::addToGameMap()
     getGameMap()->addCreature(this);
     getGameMap()->addAnimatedObject(this);
     getGameMap()->addClientUpkeepEntity(this);
+    mIsInGameMap = true;
+    updateSeatCount();
 
     if(!getIsOnServerMap())
         return;
@@ -330,6 +361,8 @@ void Creature::removeFromGameMap()
     getGameMap()->removeCreature(this);
     getGameMap()->removeAnimatedObject(this);
     getGameMap()->removeClientUpkeepEntity(this);
+    mIsInGameMap = false;
+    updateSeatCount();
 
     if(!getIsOnServerMap())
         return;
@@ -636,14 +669,14 @@ void Creature::setHP(double nHP)
     else
         mHp = nHP;
 
-    computeCreatureOverlayHealthValue();
+    hpChanged();
 }
 
 void Creature::heal(double hp)
 {
     mHp = std::min(mHp + hp, mMaxHP);
 
-    computeCreatureOverlayHealthValue();
+    hpChanged();
 }
 
 bool Creature::isAlive() const
@@ -675,27 +708,36 @@ void Creature::update(Ogre::Real timeSinceLastFrame)
     }
 }
 
-void Creature::computeVisibleTiles()
+bool Creature::canSeeSurroundings() const
 {
     // dead Creatures do not give vision
     if (getHP() <= 0.0)
-        return;
+        return false;
 
     // KO Creatures do not give vision
     if (isKo())
-        return;
+        return false;
 
     // creatures in jail do not give vision
     if (mSeatPrison != nullptr)
-        return;
+        return false;
+
+    return getIsOnMap();
+}
 
-    if (!getIsOnMap())
+void Creature::computeVisibleTiles()
+{
+    if (!canSeeSurroundings())
         return;
 
     // Look at the surrounding area
     updateTilesInSight();
+    std::vector<uint32_t> tileIndexes;
+    tileIndexes.reserve(mVisibleTiles.size());
     for(Tile* tile : mVisibleTiles)
-        tile->notifyVision(getSeat());
+        tileIndexes.push_back(tile->getTileIndex());
+
+    getGameMap()->getVisionTracker().refreshEntityVision(getName(), getSeat()->getId(), tileIndexes);
 }
 
 void Creature::setLevel(unsigned int level)
@@ -826,7 +868,7 @@ void Creature::doUpkeep()
             return;
 
         mHp = 0;
-        computeCreatureOverlayHealthValue();
+        hpChanged();
         computeCreatureOverlayMoodValue();
     }
 
@@ -886,7 +928,7 @@ void Creature::doUpkeep()
     if (mHp > getMaxHp())
         mHp = getMaxHp();
 
-    computeCreatureOverlayHealthValue();
+    hpChanged();
 
     // Rogue creatures are not affected by wakefulness/hunger
     if(!getSeat()->isRogueSeat())
@@ -896,9 +938,20 @@ void Creature::doUpkeep()
         increaseHunger(mDefinition->getHungerGrowthPerTurn());
     }
 
-    mVisibleEnemyObjects         = getVisibleEnemyObjects();
-    mVisibleAlliedObjects        = getVisibleAlliedObjects();
-    mReachableAlliedObjects      = getReachableAttackableObjects(mVisibleAlliedObjects);
+    // The objects seen are computed for every creature before the upkeep. If this creature was
+    // not looking around at this time (for example, if it has been released from jail since), we
+    // compute them now. Otherwise, we forget the ones removed from the map by the creatures that
+    // did their upkeep before this one
+    if(mSenseTurn != getGameMap()->getTurnNumber())
+    {
+        senseSurroundings();
+    }
+    else
+    {
+        removeLeftObjects(mVisibleEnemyObjects);
+        removeLeftObjects(mVisibleAlliedObjects);
+        removeLeftObjects(mReachableAlliedObjects);
+    }
 
     // Check if we should compute mood
     if(mMoodCooldownTurns > 0)
@@ -1643,11 +1696,34 @@ void Creature::updateTilesInSight()
     if (posTile == nullptr)
         return;
 
+    // If the creature did not move and no tile around changed its opacity, the tiles in sight are the same
+    int sightRadius = mDefinition->getSightRadius();
+    VisionTracker& visionTracker = getGameMap()->getVisionTracker();
+    if((posTile == mTilesInSightPosition) &&
+       (sightRadius == mTilesInSightRadius) &&
+       !visionTracker.hasOpacityChangedSince(posTile->getX() - sightRadius, posTile->getY() - sightRadius,
+            posTile->getX() + sightRadius, posTile->getY() + sightRadius, mTilesInSightEpoch))
+    {
+        return;
+    }
+
+    mTilesInSightPosition = posTile;
+    mTilesInSightRadius = sightRadius;
+    mTilesInSightEpoch = visionTracker.getOpacityEpoch();
+
     // The tiles with sight radius without constraints
-    mTilesWithinSightRadius = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    mTilesWithinSightRadius = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), sightRadius);
 
     // Only the tiles the creature can "see".
-    mVisibleTiles = getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), sightRadius, mVisibleTiles);
+}
+
+void Creature::senseSurroundings()
+{
+    mVisibleEnemyObjects         = getVisibleEnemyObjects();
+    mVisibleAlliedObjects        = getVisibleAlliedObjects();
+    mReachableAlliedObjects      = getReachableAttackableObjects(mVisibleAlliedObjects);
+    mSenseTurn = getGameMap()->getTurnNumber();
 }
 
 std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
@@ -1718,7 +1794,7 @@ void Creature::computeVisualDebugEntities()
 
     updateTilesInSight();
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::refreshCreatureVisDebug, nullptr);
 
     const std::string& name = getName();
@@ -1782,7 +1858,7 @@ void Creature::stopComputeVisualDebugEntities()
 
     mHasVisualDebuggingEntities = false;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::refreshCreatureVisDebug, nullptr);
     const std::string& name = getName();
     serverNotification->mPacket << name;
@@ -1981,7 +2057,7 @@ double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double
         }
     }
 
-    computeCreatureOverlayHealthValue();
+    hpChanged();
     computeCreatureOverlayMoodValue();
 
     if(!isAlive())
@@ -2341,12 +2417,16 @@ bool Creature::setDestination(Tile* tile)
     if(posTile == nullptr)
         return false;
 
-    std::list<Tile*> result = getGameMap()->path(this, tile);
+    // For long distances, we only get the path to some waypoint. The walk action will
+    // ask for the next part when we reach it
+    Tile* waypoint = nullptr;
+    std::list<Tile*> result = getGameMap()->pathToWaypoint(this, tile, waypoint);
 
     std::vector<Ogre::Vector3> path;
     tileToVector3(result, path, true, 0.0);
     setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
-    pushAction(Utils::make_unique<CreatureActionWalkToTile>(*this));
+    Tile* finalDestination = (!result.empty() && (waypoint != tile)) ? tile : nullptr;
+    pushAction(Utils::make_unique<CreatureActionWalkToTile>(*this, finalDestination));
     return true;
 }
 
@@ -2459,7 +2539,7 @@ void Creature::releaseCarriedEntity()
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification* serverNotification = new ServerNotification(
+        ServerNotification* serverNotification = ServerNotification::acquire(
             ServerNotificationType::releaseCarriedEntity, seat->getPlayer());
         serverNotification->mPacket << getName() << carriedEntity->getObjectType();
         serverNotification->mPacket << carriedEntity->getName();
@@ -2516,7 +2596,7 @@ void Creature::slap()
         ConfigManager::getSingleton().getSlapEffectDuration(), "");
     addCreatureEffect(effect);
     mHp -= mMaxHP * ConfigManager::getSingleton().getSlapDamagePercent() / 100.0;
-    computeCreatureOverlayHealthValue();
+    hpChanged();
 }
 
 void Creature::fireAddEntity(Seat* seat, bool async)
@@ -2536,7 +2616,7 @@ void Creature::fireAddEntity(Seat* seat, bool async)
         return;
     }
 
-    ServerNotification* serverNotification = new ServerNotification(
+    ServerNotification* serverNotification = ServerNotification::acquire(
         ServerNotificationType::addEntity, seat->getPlayer());
     exportHeadersToPacket(serverNotification->mPacket);
     exportToPacket(serverNotification->mPacket, seat);
@@ -2546,7 +2626,7 @@ void Creature::fireAddEntity(Seat* seat, bool async)
     {
         mCarriedEntity->addSeatWithVision(seat, false);
 
-        serverNotification = new ServerNotification(
+        serverNotification = ServerNotification::acquire(
             ServerNotificationType::carryEntity, seat->getPlayer());
         serverNotification->mPacket << getName() << mCarriedEntity->getObjectType();
         serverNotification->mPacket << mCarriedEntity->getName();
@@ -2559,7 +2639,7 @@ void Creature::fireRemoveEntity(Seat* seat)
     // If we are carrying an entity, we release it first, then we can remove it and us
     if(mCarriedEntity != nullptr)
     {
-        ServerNotification* serverNotification = new ServerNotification(
+        ServerNotification* serverNotification = ServerNotification::acquire(
             ServerNotificationType::releaseCarriedEntity, seat->getPlayer());
         serverNotification->mPacket << getName() << mCarriedEntity->getObjectType();
         serverNotification->mPacket << mCarriedEntity->getName();
@@ -2570,7 +2650,7 @@ void Creature::fireRemoveEntity(Seat* seat)
     }
 
     const std::string& name = getName();
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::removeEntity, seat->getPlayer());
     GameEntityType type = getObjectType();
     serverNotification->mPacket << type;
@@ -2592,7 +2672,7 @@ void Creature::fireCreatureRefreshIfNeeded()
             continue;
 
         const std::string& name = getName();
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::entitiesRefresh, seat->getPlayer());
         uint32_t nbCreature = 1;
         serverNotification->mPacket << nbCreature;
@@ -2612,7 +2692,7 @@ void Creature::fireChatMsgTookFee(int goldTaken)
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg;
     // We don't display the same message if we have taken all our fee or only a part of it
@@ -2634,7 +2714,7 @@ void Creature::fireChatMsgLeftDungeon()
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg = getName() + " left your dungeon";
     serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -2650,7 +2730,7 @@ void Creature::fireChatMsgLeavingDungeon()
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg = getName() + " is leaving your dungeon";
     serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -2666,7 +2746,7 @@ void Creature::fireChatMsgBecameRogue()
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg = getName() + " is not under your control anymore !";
     serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -2682,7 +2762,7 @@ void Creature::fireChatMsgUnhappy()
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg = getName() + " is unhappy !";
     serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -2698,7 +2778,7 @@ void Creature::fireChatMsgFurious()
     if(getSeat()->getPlayer()->getHasLost())
         return;
 
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, getSeat()->getPlayer());
     std::string msg = getName() + " is furious !";
     serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -2764,7 +2844,7 @@ void Creature::setupDefinition(GameMap& gameMap, const CreatureDefinition& defau
         else
             mHp = Helper::toDouble(mHpString);
 
-        computeCreatureOverlayHealthValue();
+        hpChanged();
     }
 }
 
@@ -2808,7 +2888,7 @@ void Creature::fireCreatureSound(CreatureSound sound)
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playSpatialSound, seat->getPlayer());
         serverNotification->mPacket << soundComplete << posTile->getX() << posTile->getY();
         ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -2863,6 +2943,32 @@ void Creature::computeMood()
     }
 }
 
+void Creature::hpChanged()
+{
+    computeCreatureOverlayHealthValue();
+    updateSeatCount();
+}
+
+void Creature::updateSeatCount()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = (mIsInGameMap && isAlive()) ? getSeat() : nullptr;
+    if(seat == mCountedSeat)
+        return;
+
+    if(mCountedSeat != nullptr)
+        mCountedSeat->addNumCreatures(mCountedAsWorker, -1);
+
+    mCountedSeat = seat;
+    if(seat == nullptr)
+        return;
+
+    mCountedAsWorker = mDefinition->isWorker();
+    seat->addNumCreatures(mCountedAsWorker, 1);
+}
+
 void Creature::computeCreatureOverlayHealthValue()
 {
     if(!getIsOnServerMap())
@@ -3215,6 +3321,25 @@ void Creature::leaveDungeon()
     pushAction(Utils::make_unique<CreatureActionLeaveDungeon>(*this));
 }
 
+void Creature::seatChanged(Seat* oldSeat)
+{
+    updateSeatCount();
+
+    // The creature is in the index of the tile it stands on
+    if(!getIsOnMap())
+        return;
+
+    Tile* myTile = getPositionTile();
+    if(myTile == nullptr)
+        return;
+
+    SeatRegionIndex& seatRegionIndex = getGameMap()->getSeatRegionIndex();
+    if(oldSeat != nullptr)
+        seatRegionIndex.remove(myTile->getX(), myTile->getY(), oldSeat->getId());
+    if(getSeat() != nullptr)
+        seatRegionIndex.add(myTile->getX(), myTile->getY(), getSeat()->getId());
+}
+
 void Creature::changeSeat(Seat* newSeat)
 {
     OD_LOG_INF("creature=" + getName() + " changes side from seatId=" + Helper::toString(getSeat()->getId()) + " to seatId=" + Helper::toString(newSeat->getId()));
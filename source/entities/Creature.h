@@ -252,6 +252,15 @@ public:
     //! \brief Computes the visible tiles and tags them to know which are visible
     void computeVisibleTiles();
 
+    //! \brief Returns true if the creature looks around this turn (alive, on map, not KO and not in jail)
+    bool canSeeSurroundings() const;
+
+    /*! \brief Computes the enemies and allies the creature sees and the allies it can reach from the tiles
+     * computed by computeVisibleTiles. It only reads the game map so that it can be called for several
+     * creatures at the same time (see GameMap::senseCreatures). doUpkeep uses the result.
+     */
+    void senseSurroundings();
+
     virtual bool isAttackable(Tile* tile, Seat* seat) const;
 
     double getPhysicalDefense() const;
@@ -573,6 +582,13 @@ public:
 
     void computeCreatureOverlayHealthValue();
 
+    //! \brief Called when mHp changes. Updates the health overlay and the creature count of the seat
+    void hpChanged();
+
+    //! \brief Counts the creature for its seat if it is in the gamemap and alive, and removes it
+    //! from the count of the seat it was counted for otherwise
+    void updateSeatCount();
+
     //! \brief Search within listObjects the closest attackable one.
     //! If a target is found and can be attacked, returns true and
     //! attackedEntity, attackedTile will be set to the target closest tile and positionTile will
@@ -598,6 +614,7 @@ protected:
     virtual void destroyMeshLocal();
     virtual void fireAddEntity(Seat* seat, bool async);
     virtual void fireRemoveEntity(Seat* seat);
+    virtual void seatChanged(Seat* oldSeat) override;
 private:
     enum ForceAction
     {
@@ -758,6 +775,22 @@ private:
     //! \brief Counts the number of active slaps affecting the creature
     uint32_t                        mActiveSlapsCount;
 
+    //! \brief Position tile, sight radius and vision epoch (see VisionTracker::getOpacityEpoch) when
+    //! mVisibleTiles was computed. Used to avoid computing the line of sight again if nothing changed
+    Tile*                           mTilesInSightPosition;
+    int                             mTilesInSightRadius;
+    uint64_t                        mTilesInSightEpoch;
+
+    //! \brief Turn senseSurroundings was last called on. -1 if never
+    int64_t                         mSenseTurn;
+
+    //! \brief True between addToGameMap and removeFromGameMap
+    bool                            mIsInGameMap;
+
+    //! \brief Seat this creature is counted in as a worker or a fighter (see updateSeatCount). Null if none
+    Seat*                           mCountedSeat;
+    bool                            mCountedAsWorker;
+
     //! \brief Skills the creature can use
     std::vector<CreatureSkillData> mSkillData;
 
@@ -95,6 +95,7 @@ GameEntity::GameEntity(
     mParentSceneNode   (nullptr),
     mEntityNode        (nullptr),
     mGameMap           (gameMap),
+    mIsRandomStreamSeeded(false),
     mIsOnMap           (false),
     mParticleSystemsNumber   (0),
     mCarryLock         (false),
@@ -111,6 +112,16 @@ GameEntity::~GameEntity()
     };
 }
 
+RandomStream& GameEntity::getRandomStream()
+{
+    if(!mIsRandomStreamSeeded)
+    {
+        mRandomStream = getGameMap()->createRandomStream(getName());
+        mIsRandomStreamSeeded = true;
+    }
+    return mRandomStream;
+}
+
 void GameEntity::deleteYourself()
 {
     destroyMesh();
@@ -130,6 +141,16 @@ Tile* GameEntity::getPositionTile() const
                                  Helper::round(tempPosition.y));
 }
 
+void GameEntity::setSeat(Seat* seat)
+{
+    if(mSeat == seat)
+        return;
+
+    Seat* oldSeat = mSeat;
+    mSeat = seat;
+    seatChanged(oldSeat);
+}
+
 void GameEntity::addEntityToPositionTile()
 {
     if(getIsOnMap())
@@ -200,7 +221,7 @@ void GameEntity::firePickupEntity(Player* playerPicking)
         }
         else
         {
-            ServerNotification* serverNotification = new ServerNotification(
+            ServerNotification* serverNotification = ServerNotification::acquire(
                 ServerNotificationType::entityPickedUp, seat->getPlayer());
             serverNotification->mPacket << seatId << entityType << entityName;
             ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -256,7 +277,7 @@ void GameEntity::fireDropEntity(Player* playerPicking, Tile* tile)
         }
         else
         {
-            ServerNotification* serverNotification = new ServerNotification(
+            ServerNotification* serverNotification = ServerNotification::acquire(
                 ServerNotificationType::entityDropped, seat->getPlayer());
             serverNotification->mPacket << seatId;
             getGameMap()->tileToPacket(serverNotification->mPacket, tile);
@@ -277,20 +298,49 @@ void GameEntity::fireDropEntity(Player* playerPicking, Tile* tile)
     }
 }
 
+//! \brief Highest seat id that can be stored in a seats bitmask (see getSeatsMask)
+static const int MAX_SEAT_ID = 63;
+
+//! \brief Sets mask to the bitmask of the given seats (1 << seatId for each seat). Returns false if
+//! a seat id cannot be stored in the mask
+static bool getSeatsMask(const std::vector<Seat*>& seats, uint64_t& mask)
+{
+    mask = 0;
+    for(Seat* seat : seats)
+    {
+        if((seat->getId() < 0) || (seat->getId() > MAX_SEAT_ID))
+            return false;
+
+        mask |= static_cast<uint64_t>(1) << seat->getId();
+    }
+    return true;
+}
+
 void GameEntity::notifySeatsWithVision(const std::vector<Seat*>& seats)
 {
+    // We compare the seats with vision and the notified ones with bitmasks. If a seat id does not fit,
+    // we search the lists
+    uint64_t seatsMask;
+    uint64_t notifiedMask;
+    bool useMasks = getSeatsMask(seats, seatsMask) && getSeatsMask(mSeatsWithVisionNotified, notifiedMask);
+    if(useMasks && (seatsMask == notifiedMask))
+        return;
+
     // We notify seats that lost vision
     for(std::vector<Seat*>::iterator it = mSeatsWithVisionNotified.begin(); it != mSeatsWithVisionNotified.end();)
     {
         Seat* seat = *it;
         // If the seat is still in the list, nothing to do
-        if(std::find(seats.begin(), seats.end(), seat) != seats.end())
+        bool hasVision = useMasks ? ((seatsMask & (static_cast<uint64_t>(1) << seat->getId())) != 0)
+            : (std::find(seats.begin(), seats.end(), seat) != seats.end());
+        if(hasVision)
         {
             ++it;
             continue;
         }
 
         it = mSeatsWithVisionNotified.erase(it);
+        getGameMap()->countEntityVisionEvent();
 
         if(seat->getPlayer() == nullptr)
             continue;
@@ -300,14 +350,18 @@ void GameEntity::notifySeatsWithVision(const std::vector<Seat*>& seats)
         fireRemoveEntity(seat);
     }
 
-    // We notify seats that gain vision
+    // We notify seats that gain vision. Removing the seats that lost vision did not change whether
+    // the other ones are in the notified list
     for(Seat* seat : seats)
     {
         // If the seat was already in the list, nothing to do
-        if(std::find(mSeatsWithVisionNotified.begin(), mSeatsWithVisionNotified.end(), seat) != mSeatsWithVisionNotified.end())
+        bool isNotified = useMasks ? ((notifiedMask & (static_cast<uint64_t>(1) << seat->getId())) != 0)
+            : (std::find(mSeatsWithVisionNotified.begin(), mSeatsWithVisionNotified.end(), seat) != mSeatsWithVisionNotified.end());
+        if(isNotified)
             continue;
 
         mSeatsWithVisionNotified.push_back(seat);
+        getGameMap()->countEntityVisionEvent();
 
         if(seat->getPlayer() == nullptr)
             continue;
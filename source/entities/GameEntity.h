@@ -23,6 +23,8 @@
 #ifndef GAMEENTITY_H
 #define GAMEENTITY_H
 
+#include "utils/Random.h"
+
 #include <OgreVector3.h>
 #include <string>
 #include <vector>
@@ -198,8 +200,7 @@ class GameEntity
     { mMeshName = meshName; }
 
     //! \brief Sets the seat this object belongs to
-    inline void setSeat(Seat* seat)
-    { mSeat = seat; }
+    void setSeat(Seat* seat);
 
     //! \brief Set if the mesh exists
     inline void setMeshExisting(bool isExisting)
@@ -323,8 +324,8 @@ class GameEntity
     void firePickupEntity(Player* playerPicking);
     void fireDropEntity(Player* playerPicking, Tile* tile);
 
-    //! \brief Called each turn with the list of seats that have vision on the tile where the entity is. It should handle
-    //! messages to notify players that gain/lose vision
+    //! \brief Called with the list of seats that have vision on the tile where the entity is when it changes or when the
+    //! entity enters the tile (see Tile::entitiesVisionChanged). It should handle messages to notify players that gain/lose vision
     virtual void notifySeatsWithVision(const std::vector<Seat*>& seats);
     //! \brief Functions to add/remove a seat with vision
     virtual void addSeatWithVision(Seat* seat, bool async);
@@ -393,6 +394,11 @@ class GameEntity
 
     static void exportToStream(GameEntity* entity, std::ostream& os);
 
+    /*! \brief Server side stream used while the entity is upkept. It is seeded from the game seed and the entity
+     * name the first time it is used so that what happens to an entity does not depend on the other entities
+     */
+    RandomStream& getRandomStream();
+
   protected:
     /*! \brief Exports the headers needed to recreate the entity. For example, for missile objects
      * type cannon, it exports GameEntityType::missileObject and MissileType::oneHit. The content of the
@@ -413,6 +419,11 @@ class GameEntity
     virtual void exportToPacket(ODPacket& os, const Seat* seat) const;
     virtual void importFromPacket(ODPacket& is);
 
+    //! \brief Called by setSeat when the seat changes. Allows the entities indexed by seat to
+    //! update the index (see SeatRegionIndex)
+    virtual void seatChanged(Seat* oldSeat)
+    {}
+
     //! \brief Function that implements the mesh creation
     virtual void createMeshLocal()
     {}
@@ -469,6 +480,9 @@ class GameEntity
     //! \brief Pointer to the GameMap object.
     GameMap* mGameMap;
 
+    RandomStream mRandomStream;
+    bool mIsRandomStreamSeeded;
+
     //! \brief Whether the entity is on map or not (for example, when it is
     //! picked up, it is not on map)
     bool mIsOnMap;
@@ -77,6 +77,7 @@ void PersistentObject::notifySeatsWithVision(const std::vector<Seat*>& seats)
         }
 
         it = mSeatsWithVisionNotified.erase(it);
+        getGameMap()->countEntityVisionEvent();
 
         // We don't notify clients so that the objects stays visible
     }
@@ -93,12 +94,16 @@ void PersistentObject::notifySeatsWithVision(const std::vector<Seat*>& seats)
                 continue;
 
             mSeatsWithVisionNotified.push_back(seat);
+            getGameMap()->countEntityVisionEvent();
         }
         else
         {
             // If the seat is not already in the list, nothing to do
             if(it != mSeatsWithVisionNotified.end())
+            {
                 mSeatsWithVisionNotified.erase(it);
+                getGameMap()->countEntityVisionEvent();
+            }
         }
 
 
@@ -163,7 +168,15 @@ void PersistentObject::importFromPacket(ODPacket& is)
 
 bool PersistentObject::notifyRemoveAsked()
 {
-    mIsWorking = false;
+    if(mIsWorking)
+    {
+        mIsWorking = false;
+        // The seats with vision will be notified that the object has been removed
+        Tile* tile = getPositionTile();
+        if(tile != nullptr)
+            tile->entitiesVisionChanged();
+    }
+
     // If at least 1 player has vision on this PersistentObject, we cannot remove it
     // from gamemap.
     // We check if there is at least 1 seat that have been notified previously and
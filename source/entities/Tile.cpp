@@ -26,6 +26,7 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "network/ODPacket.h"
+#include "network/TileDelta.h"
 #include "render/RenderManager.h"
 #include "rooms/Room.h"
 #include "sound/SoundEffectsManager.h"
@@ -33,6 +34,7 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
 
 #include <cstddef>
 #include <bitset>
@@ -44,7 +46,7 @@
 #endif
 
 
-const uint32_t Tile::NO_FLOODFILL = 0;
+const uint32_t Tile::NO_FLOODFILL = TileStore::NO_FLOODFILL;
 const std::string Tile::TILE_PREFIX = "Tile_";
 const std::string Tile::TILE_SCANF = TILE_PREFIX + "%i_%i";
 
@@ -52,14 +54,14 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     GameEntity(gameMap, "", "", nullptr),
     mX                  (x),
     mY                  (y),
-    mType               (type),
+    mTileStore          (&gameMap->getTileStore()),
+    mTileIndex          (mTileStore->getIndex(x, y)),
     mTileVisual         (TileVisual::nullTileVisual),
     mSelected           (false),
-    mFullness           (fullness),
     mRefundPriceRoom    (0),
     mRefundPriceTrap    (0),
+    mEntitiesVisionChanged  (false),
     mCoveringBuilding   (nullptr),
-    mClaimedPercentage  (0.0),
     mIsRoom             (false),
     mIsTrap             (false),
     mDisplayTileMesh    (true),
@@ -69,6 +71,10 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mTileCulling        (CullingType::HIDE),
     mNbWorkersClaiming(0)
 {
+    setType(type);
+    setFullnessValue(fullness);
+    setClaimedPercentage(0.0);
+    mTileStore->setSeatId(mTileIndex, TileStore::NO_SEAT);
     computeTileVisual();
 }
 
@@ -131,7 +137,7 @@ bool Tile::isWallClaimable(Seat* seat)
     if (getFullness() <= 0.0)
         return false;
 
-    if (mType == TileType::lava || mType == TileType::water || mType == TileType::rock || mType == TileType::gold)
+    if (getType() == TileType::lava || getType() == TileType::water || getType() == TileType::rock || getType() == TileType::gold)
         return false;
 
     // Check whether at least one neighbor is a claimed ground tile of the given seat
@@ -190,7 +196,7 @@ bool Tile::isWallClaimedForSeat(Seat* seat)
     if (getFullness() == 0.0)
         return false;
 
-    if (mClaimedPercentage < 1.0)
+    if (getClaimedPercentage() < 1.0)
         return false;
 
     Seat* tileSeat = getSeat();
@@ -203,11 +209,6 @@ bool Tile::isWallClaimedForSeat(Seat* seat)
     return true;
 }
 
-std::string Tile::getFormat()
-{
-    return "posX\tposY\ttype\tfullness\tseatId(optional)";
-}
-
 void Tile::exportToStream(std::ostream& os) const
 {
     os << getX() << "\t" << getY() << "\t";
@@ -218,66 +219,6 @@ void Tile::exportToStream(std::ostream& os) const
     os << "\t" << getSeat()->getId();
 }
 
-ODPacket& operator<<(ODPacket& os, const TileType& type)
-{
-    uint32_t intType = static_cast<uint32_t>(type);
-    os << intType;
-    return os;
-}
-
-ODPacket& operator>>(ODPacket& is, TileType& type)
-{
-    uint32_t intType;
-    is >> intType;
-    type = static_cast<TileType>(intType);
-    return is;
-}
-
-std::ostream& operator<<(std::ostream& os, const TileType& type)
-{
-    uint32_t intType = static_cast<uint32_t>(type);
-    os << intType;
-    return os;
-}
-
-std::istream& operator>>(std::istream& is, TileType& type)
-{
-    uint32_t intType;
-    is >> intType;
-    type = static_cast<TileType>(intType);
-    return is;
-}
-
-ODPacket& operator<<(ODPacket& os, const TileVisual& type)
-{
-    uint32_t intType = static_cast<uint32_t>(type);
-    os << intType;
-    return os;
-}
-
-ODPacket& operator>>(ODPacket& is, TileVisual& type)
-{
-    uint32_t intType;
-    is >> intType;
-    type = static_cast<TileVisual>(intType);
-    return is;
-}
-
-std::ostream& operator<<(std::ostream& os, const TileVisual& type)
-{
-    uint32_t intType = static_cast<uint32_t>(type);
-    os << intType;
-    return os;
-}
-
-std::istream& operator>>(std::istream& is, TileVisual& type)
-{
-    uint32_t intType;
-    is >> intType;
-    type = static_cast<TileVisual>(intType);
-    return is;
-}
-
 std::string Tile::tileTypeToString(TileType t)
 {
     switch (t)
@@ -553,59 +494,18 @@ bool Tile::isSameFloodFill(Seat* seat, FloodFillType type, Tile* tile) const
 
 void Tile::resetFloodFill()
 {
-    for(std::vector<uint32_t>& values : mFloodFillColor)
-    {
-        for(uint32_t& floodFillValue : values)
-        {
-            floodFillValue = NO_FLOODFILL;
-        }
-    }
-}
-
-bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
-{
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size()))
-                + ", fullness=" + Helper::toString(getFullness()));
-        }
-        return false;
-    }
-
-    std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
-    uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
-        }
-        return false;
-    }
-
-    if((values[intType] != NO_FLOODFILL) ||
-       (tile->getFloodFillValue(seat, type) == NO_FLOODFILL))
+    for(uint32_t teamIndex = 0; teamIndex < mTileStore->getNbTeams(); ++teamIndex)
     {
-        return false;
+        uint32_t* values = mTileStore->getFloodFillValues(mTileIndex, teamIndex);
+        for(uint32_t intType = 0; intType < static_cast<uint32_t>(FloodFillType::nbValues); ++intType)
+            values[intType] = NO_FLOODFILL;
     }
-
-    values[intType] = tile->getFloodFillValue(seat, type);
-    return true;
 }
 
 void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
 {
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
+    uint32_t* values = mTileStore->getFloodFillValues(mTileIndex, seat->getTeamIndex());
+    if(values == nullptr)
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -613,14 +513,13 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size())));
+                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(mTileStore->getNbTeams()));
         }
         return;
     }
 
-    std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
     uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
+    if(intType >= static_cast<uint32_t>(FloodFillType::nbValues))
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -628,7 +527,7 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
+                + ", intType=" + Helper::toString(intType));
         }
         return;
     }
@@ -638,7 +537,8 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
 
 void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
 {
-    if(seatToCopy->getTeamIndex() >= mFloodFillColor.size())
+    const uint32_t* valuesToCopy = mTileStore->getFloodFillValues(mTileIndex, seatToCopy->getTeamIndex());
+    if(valuesToCopy == nullptr)
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -646,18 +546,17 @@ void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seatToCopy->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seatToCopy->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size())));
+                + ", seatIndex=" + Helper::toString(seatToCopy->getTeamIndex()) + ", floodfillsize=" + Helper::toString(mTileStore->getNbTeams()));
         }
         return;
     }
 
-    std::vector<uint32_t>& valuesToCopy = mFloodFillColor[seatToCopy->getTeamIndex()];
-    for(uint32_t indexFloodFill = 0; indexFloodFill < mFloodFillColor.size(); ++indexFloodFill)
+    for(uint32_t indexFloodFill = 0; indexFloodFill < mTileStore->getNbTeams(); ++indexFloodFill)
     {
         if(seatToCopy->getTeamIndex() == indexFloodFill)
             continue;
 
-        std::vector<uint32_t>& values = mFloodFillColor[indexFloodFill];
+        uint32_t* values = mTileStore->getFloodFillValues(mTileIndex, indexFloodFill);
         for(uint32_t intType = 0; intType < static_cast<uint32_t>(FloodFillType::nbValues); ++intType)
             values[intType] = valuesToCopy[intType];
 
@@ -670,18 +569,23 @@ void Tile::logFloodFill() const
         + " - type=" + Tile::tileVisualToString(getTileVisual())
         + " - fullness=" + Helper::toString(getFullness())
         + " - seatId=" + std::string(getSeat() == nullptr ? "-1" : Helper::toString(getSeat()->getId()));
-    for(const std::vector<uint32_t>& values : mFloodFillColor)
+    for(uint32_t teamIndex = 0; teamIndex < mTileStore->getNbTeams(); ++teamIndex)
     {
-        int cpt = 0;
-        for(const uint32_t& floodFill : values)
+        const uint32_t* values = mTileStore->getFloodFillValues(mTileIndex, teamIndex);
+        for(uint32_t intType = 0; intType < static_cast<uint32_t>(FloodFillType::nbValues); ++intType)
         {
-            str += ", [" + Helper::toString(cpt) + "]=" + Helper::toString(floodFill);
-            ++cpt;
+            str += ", [" + Helper::toString(intType) + "]=" + Helper::toString(values[intType]);
         }
     }
     OD_LOG_INF(str);
 }
 
+void Tile::seatChanged(Seat* oldSeat)
+{
+    Seat* seat = getSeat();
+    mTileStore->setSeatId(mTileIndex, (seat == nullptr) ? TileStore::NO_SEAT : seat->getId());
+}
+
 bool Tile::isClaimedForSeat(const Seat* seat) const
 {
     if(!isClaimed())
@@ -713,28 +617,39 @@ bool Tile::isClaimed() const
     if(getSeat() == nullptr)
         return false;
 
-    if(mClaimedPercentage < 1.0)
+    if(getClaimedPercentage() < 1.0)
         return false;
 
     return true;
 }
 
-void Tile::clearVision()
+void Tile::seatVisionChanged(Seat* seat, bool hasVision)
 {
-    mSeatsWithVision.clear();
-}
+    auto it = std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), seat);
+    if(hasVision)
+    {
+        if(it != mSeatsWithVision.end())
+        {
+            OD_LOG_ERR("tile=" + displayAsString(this) + ", seat=" + Seat::displayAsString(seat));
+            return;
+        }
 
-void Tile::notifyVision(Seat* seat)
-{
-    if(std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), seat) != mSeatsWithVision.end())
-        return;
+        mSeatsWithVision.push_back(seat);
+        seat->notifyVisionOnTile(this);
+    }
+    else
+    {
+        if(it == mSeatsWithVision.end())
+        {
+            OD_LOG_ERR("tile=" + displayAsString(this) + ", seat=" + Seat::displayAsString(seat));
+            return;
+        }
 
-    seat->notifyVisionOnTile(this);
-    mSeatsWithVision.push_back(seat);
+        mSeatsWithVision.erase(it);
+        seat->notifyVisionLostOnTile(this);
+    }
 
-    // We also notify vision for allied seats
-    for(Seat* alliedSeat : seat->getAlliedSeats())
-        notifyVision(alliedSeat);
+    entitiesVisionChanged();
 }
 
 void Tile::setSeats(const std::vector<Seat*>& seats)
@@ -775,74 +690,15 @@ void Tile::changeNotifiedForSeat(Seat* seat)
 
 void Tile::computeTileVisual()
 {
-    switch(getType())
-    {
-        case TileType::dirt:
-            if(mFullness > 0.0)
-            {
-                if(isClaimed())
-                    mTileVisual = TileVisual::claimedFull;
-                else
-                    mTileVisual = TileVisual::dirtFull;
-            }
-            else
-            {
-                if(isClaimed())
-                    mTileVisual = TileVisual::claimedGround;
-                else
-                    mTileVisual = TileVisual::dirtGround;
-            }
-            return;
-
-        case TileType::rock:
-            if(mFullness > 0.0)
-                mTileVisual = TileVisual::rockFull;
-            else
-                mTileVisual = TileVisual::rockGround;
-            return;
-
-        case TileType::gold:
-            if(mFullness > 0.0)
-            {
-                if(isClaimed())
-                    mTileVisual = TileVisual::claimedFull;
-                else
-                    mTileVisual = TileVisual::goldFull;
-            }
-            else
-            {
-                if(isClaimed())
-                    mTileVisual = TileVisual::claimedGround;
-                else
-                    mTileVisual = TileVisual::goldGround;
-            }
-            return;
-
-        case TileType::water:
-            mTileVisual = TileVisual::waterGround;
-            return;
-
-        case TileType::lava:
-            mTileVisual = TileVisual::lavaGround;
-            return;
-
-        case TileType::gem:
-            if(mFullness > 0.0)
-                mTileVisual = TileVisual::gemFull;
-            else
-                mTileVisual = TileVisual::gemGround;
-            return;
-
-        default:
-            OD_LOG_ERR("Computing tile visual for unknown tile type tile=" + Tile::displayAsString(this) + ", TileType=" + tileTypeToString(getType()));
-            mTileVisual = TileVisual::nullTileVisual;
-            return;
-    }
+    mTileVisual = tileVisualFromState(getType(), getFullness(), isClaimed());
+    if(mTileVisual == TileVisual::nullTileVisual)
+        OD_LOG_ERR("Computing tile visual for unknown tile type tile=" + Tile::displayAsString(this) + ", TileType=" + tileTypeToString(getType()));
 }
 
 uint32_t Tile::getFloodFillValue(Seat* seat, FloodFillType type) const
 {
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
+    const uint32_t* values = mTileStore->getFloodFillValues(mTileIndex, seat->getTeamIndex());
+    if(values == nullptr)
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -850,15 +706,14 @@ uint32_t Tile::getFloodFillValue(Seat* seat, FloodFillType type) const
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size()))
+                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(mTileStore->getNbTeams())
                 + ", fullness=" + Helper::toString(getFullness()));
         }
         return NO_FLOODFILL;
     }
 
-    const std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
     uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
+    if(intType >= static_cast<uint32_t>(FloodFillType::nbValues))
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -866,17 +721,13 @@ uint32_t Tile::getFloodFillValue(Seat* seat, FloodFillType type) const
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
+                + ", intType=" + Helper::toString(intType));
         }
         return NO_FLOODFILL;
     }
 
-    return values.at(intType);
-}
-
-void Tile::setTeamsNumber(uint32_t nbTeams)
-{
-    mFloodFillColor = std::vector<std::vector<uint32_t>>(nbTeams, std::vector<uint32_t>(static_cast<uint32_t>(FloodFillType::nbValues), NO_FLOODFILL));
+    // The areas may have been merged since the value was set
+    return getGameMap()->findFloodFillValue(seat, type, values[intType]);
 }
 
 bool Tile::shouldColorTileMesh() const
@@ -901,15 +752,15 @@ void Tile::setFullness(double f)
 {
     double oldFullness = getFullness();
 
-    mFullness = f;
+    setFullnessValue(f);
 
     // If the tile was marked for digging and has been dug out, unmark it and set its fullness to 0.
-    if (mFullness == 0.0 && isMarkedForDiggingByAnySeat())
+    if (f == 0.0 && isMarkedForDiggingByAnySeat())
     {
         setMarkedForDiggingForAllPlayersExcept(false, nullptr);
     }
 
-    if ((oldFullness > 0.0) && (mFullness == 0.0))
+    if ((oldFullness > 0.0) && (f == 0.0))
     {
         fireTileSound(TileSound::Digged);
 
@@ -920,6 +771,9 @@ void Tile::setFullness(double f)
                 getGameMap()->refreshFloodFill(seat, this);
         }
     }
+
+    if((oldFullness > 0.0) != (f > 0.0))
+        getGameMap()->tilePassabilityChanged(*this);
 }
 
 void Tile::createMeshLocal()
@@ -971,7 +825,16 @@ void Tile::setCoveringBuilding(Building *building)
             seatChanged.second = true;
         }
     }
+    SeatRegionIndex& seatRegionIndex = getGameMap()->getSeatRegionIndex();
+    if((mCoveringBuilding != nullptr) && (mCoveringBuilding->getSeat() != nullptr))
+        seatRegionIndex.remove(getX(), getY(), mCoveringBuilding->getSeat()->getId());
+
     mCoveringBuilding = building;
+    if((mCoveringBuilding != nullptr) && (mCoveringBuilding->getSeat() != nullptr))
+        seatRegionIndex.add(getX(), getY(), mCoveringBuilding->getSeat()->getId());
+
+    // The covering building may change the creatures speed on this tile
+    getGameMap()->tilePassabilityChanged(*this);
     mIsRoom = false;
     if(getCoveringRoom() != nullptr)
     {
@@ -998,7 +861,8 @@ void Tile::setCoveringBuilding(Building *building)
 
         // Set the tile as claimed and of the team color of the building
         setSeat(mCoveringBuilding->getSeat());
-        mClaimedPercentage = 1.0;
+        setClaimedPercentage(1.0);
+        refreshClaimedVision();
     }
 }
 
@@ -1010,7 +874,7 @@ bool Tile::isGroundClaimable(Seat* seat) const
     if(getCoveringBuilding() != nullptr)
         return getCoveringBuilding()->isClaimable(seat);
 
-    if(mType != TileType::dirt && mType != TileType::gold)
+    if(getType() != TileType::dirt && getType() != TileType::gold)
         return false;
 
     if(isClaimedForSeat(seat))
@@ -1021,39 +885,42 @@ bool Tile::isGroundClaimable(Seat* seat) const
 
 void Tile::exportToPacketForUpdate(ODPacket& os, const Seat* seat) const
 {
-    exportToPacketForUpdate(os, seat, false);
+    TileDeltaWriter writer(os);
+    exportToPacketForUpdate(writer, seat, false);
 }
 
-void Tile::exportToPacketForUpdate(ODPacket& os, const Seat* seat, bool hideSeatId) const
+void Tile::exportToPacketForUpdate(TileDeltaWriter& writer, const Seat* seat, bool hideSeatId) const
 {
-    GameEntity::exportToPacketForUpdate(os, seat);
+    GameEntity::exportToPacketForUpdate(writer.getPacket(), seat);
 
-    seat->exportTileToPacket(os, this, hideSeatId);
+    seat->exportTileToPacket(writer, this, hideSeatId);
 }
 
 void Tile::updateFromPacket(ODPacket& is)
 {
-    GameEntity::updateFromPacket(is);
+    TileDeltaReader reader(is);
+    updateFromPacket(reader);
+}
+
+void Tile::updateFromPacket(TileDeltaReader& reader)
+{
+    GameEntity::updateFromPacket(reader.getPacket());
 
     // This function should read parameters as sent by Tile::exportToPacketForUpdate
-    int seatId;
-    std::string meshName;
+    TileDeltaData data;
     std::stringstream ss;
 
-    // We set the seat if there is one
-    OD_ASSERT_TRUE(is >> mIsRoom);
-    OD_ASSERT_TRUE(is >> mIsTrap);
-    OD_ASSERT_TRUE(is >> mRefundPriceRoom);
-    OD_ASSERT_TRUE(is >> mRefundPriceTrap);
-
-    OD_ASSERT_TRUE(is >> mDisplayTileMesh);
-    OD_ASSERT_TRUE(is >> mColorCustomMesh);
-    OD_ASSERT_TRUE(is >> mHasBridge);
+    OD_ASSERT_TRUE(reader.readTile(data));
+    mIsRoom = data.mIsRoom;
+    mIsTrap = data.mIsTrap;
+    mRefundPriceRoom = data.mRefundPriceRoom;
+    mRefundPriceTrap = data.mRefundPriceTrap;
 
-    OD_ASSERT_TRUE(is >> seatId);
+    mDisplayTileMesh = data.mDisplayTileMesh;
+    mColorCustomMesh = data.mColorCustomMesh;
+    mHasBridge = data.mHasBridge;
 
-    OD_ASSERT_TRUE(is >> meshName);
-    setMeshName(meshName);
+    setMeshName(data.mMeshName);
 
     ss.str(std::string());
     ss << TILE_PREFIX;
@@ -1063,15 +930,15 @@ void Tile::updateFromPacket(ODPacket& is)
 
     setName(ss.str());
 
-    OD_ASSERT_TRUE(is >> mTileVisual);
+    mTileVisual = static_cast<TileVisual>(data.mTileVisual);
 
-    if(seatId == -1)
+    if(data.mSeatId == -1)
     {
         setSeat(nullptr);
     }
     else
     {
-        Seat* seat = getGameMap()->getSeatById(seatId);
+        Seat* seat = getGameMap()->getSeatById(data.mSeatId);
         if(seat != nullptr)
             setSeat(seat);
 
@@ -1090,29 +957,37 @@ void Tile::updateFromPacket(ODPacket& is)
     fireTileStateChanged();
 }
 
-void Tile::loadFromLine(const std::string& line, Tile *t)
+bool Tile::loadFromFields(const std::vector<TextRef>& fields, Tile *t)
 {
-    std::vector<std::string> elems = Helper::split(line, '\t');
+    // The name and the position are set when the tile is created at its coordinates
+    int32_t tileTypeInt;
+    if((fields.size() < 4) || !TextTokenizer::toInt(fields[2], tileTypeInt))
+        return false;
 
-    int xLocation = Helper::toInt(elems[0]);
-    int yLocation = Helper::toInt(elems[1]);
+    TileType tileType = static_cast<TileType>(tileTypeInt);
+
+    // The fullness of lava and water is not read
+    double fullness = 0.0;
+    if((tileType != TileType::water) &&
+       (tileType != TileType::lava) &&
+       !TextTokenizer::toDouble(fields[3], fullness))
+    {
+        return false;
+    }
 
-    std::stringstream tileName("");
-    tileName << TILE_PREFIX;
-    tileName << xLocation;
-    tileName << "_";
-    tileName << yLocation;
+    int32_t seatId = -1;
+    if((fields.size() >= 5) && !TextTokenizer::toInt(fields[4], seatId))
+        return false;
 
-    t->setName(tileName.str());
-    t->mX = xLocation;
-    t->mY = yLocation;
-    t->mPosition = Ogre::Vector3(static_cast<Ogre::Real>(t->mX), static_cast<Ogre::Real>(t->mY), 0.0f);
+    loadFromData(t, tileType, fullness, seatId);
+    return true;
+}
 
-    TileType tileType = static_cast<TileType>(Helper::toInt(elems[2]));
+void Tile::loadFromData(Tile* t, TileType tileType, double fullness, int32_t seatId)
+{
     t->setType(tileType);
 
     // If the tile type is lava or water, we ignore fullness
-    double fullness;
     switch(tileType)
     {
         case TileType::water:
@@ -1121,38 +996,21 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
             break;
 
         default:
-            fullness = Helper::toDouble(elems[3]);
             break;
     }
     t->setFullnessValue(fullness);
 
-    bool shouldSetSeat = false;
     // We allow to set seat if the tile is dirt (full or not) or if it is gold (ground only)
-    if(elems.size() >= 5)
-    {
-        if(tileType == TileType::dirt)
-        {
-            shouldSetSeat = true;
-        }
-        else if((tileType == TileType::gold) &&
-            (fullness == 0.0))
-        {
-            shouldSetSeat = true;
-        }
-    }
-
-    if(!shouldSetSeat)
+    Seat* seat = nullptr;
+    if((tileType == TileType::dirt) ||
+       ((tileType == TileType::gold) && (fullness == 0.0)))
     {
-        t->setSeat(nullptr);
-        return;
+        seat = t->getGameMap()->getSeatById(seatId);
     }
 
-    int seatId = Helper::toInt(elems[4]);
-    Seat* seat = t->getGameMap()->getSeatById(seatId);
-    if(seat == nullptr)
-        return;
     t->setSeat(seat);
-    t->mClaimedPercentage = 1.0;
+    if(seat != nullptr)
+        t->setClaimedPercentage(1.0);
 }
 
 void Tile::refreshMesh()
@@ -1195,6 +1053,10 @@ bool Tile::addEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.push_back(entity);
+    // The creatures are indexed by seat to find them faster (see GameMap::getVisibleForce)
+    if((entity->getObjectType() == GameEntityType::creature) && (entity->getSeat() != nullptr))
+        getGameMap()->getSeatRegionIndex().add(getX(), getY(), entity->getSeat()->getId());
+
     if(!getGameMap()->isServerGameMap())
     {
         // On client side, we cull any movable entity that walks over a
@@ -1203,6 +1065,11 @@ bool Tile::addEntity(GameEntity *entity)
         entity->setParentNodeDetachFlags(
             EntityParentNodeAttach::DETACH_CULLING, mTileCulling == CullingType::HIDE);
     }
+    else
+    {
+        // The seats with vision on this tile are notified about the entity
+        entitiesVisionChanged();
+    }
     fireTileStateChanged();
     return true;
 }
@@ -1217,6 +1084,9 @@ void Tile::removeEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.erase(it);
+    if((entity->getObjectType() == GameEntityType::creature) && (entity->getSeat() != nullptr))
+        getGameMap()->getSeatRegionIndex().remove(getX(), getY(), entity->getSeat()->getId());
+
     fireTileStateChanged();
 }
 
@@ -1238,30 +1108,33 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
     // If the seat is allied, we add to it. If it is an enemy seat, we subtract from it.
     if (getSeat() != nullptr && getSeat()->isAlliedSeat(seat))
     {
-        mClaimedPercentage += nDanceRate;
+        setClaimedPercentage(getClaimedPercentage() + nDanceRate);
     }
     else
     {
-        mClaimedPercentage -= nDanceRate;
-        if (mClaimedPercentage <= 0.0)
+        setClaimedPercentage(getClaimedPercentage() - nDanceRate);
+        if (getClaimedPercentage() <= 0.0)
         {
             // We notify the old seat that the tile is lost
             if(getSeat() != nullptr)
                 getSeat()->notifyTileClaimedByEnemy(this);
 
             // The tile is not yet claimed, but it is now an allied seat.
-            mClaimedPercentage *= -1.0;
+            setClaimedPercentage(-getClaimedPercentage());
             setSeat(seat);
             computeTileVisual();
             setDirtyForAllSeats();
         }
     }
 
-    if ((getSeat() != nullptr) && (mClaimedPercentage >= 1.0) &&
+    if ((getSeat() != nullptr) && (getClaimedPercentage() >= 1.0) &&
         (getSeat()->isAlliedSeat(seat)))
     {
         claimTile(seat);
     }
+
+    // The tile may not be claimed anymore
+    refreshClaimedVision();
 }
 
 void Tile::claimTile(Seat* seat)
@@ -1272,7 +1145,7 @@ void Tile::claimTile(Seat* seat)
 
     // We need this because if we are a client, the tile may be from a non allied seat
     setSeat(seat);
-    mClaimedPercentage = 1.0;
+    setClaimedPercentage(1.0);
 
     if(isFullTile())
         fireTileSound(TileSound::ClaimWall);
@@ -1284,6 +1157,7 @@ void Tile::claimTile(Seat* seat)
 
     computeTileVisual();
     setDirtyForAllSeats();
+    refreshClaimedVision();
 
     // Force all the neighbors to recheck their meshes as we have updated this tile.
     for (Tile* tile : mNeighbors)
@@ -1307,10 +1181,11 @@ void Tile::unclaimTile()
         + " unclaimed. Previous seat=" + Seat::displayAsString(getSeat()));
 
     setSeat(nullptr);
-    mClaimedPercentage = 0.0;
+    setClaimedPercentage(0.0);
 
     computeTileVisual();
     setDirtyForAllSeats();
+    refreshClaimedVision();
 
     // Force all the neighbors to recheck their meshes as we have updated this tile.
     for (Tile* tile : mNeighbors)
@@ -1360,15 +1235,15 @@ double Tile::digOut(double digRate)
     if(fullnessLost <= 0.0)
         return digRateScaled;
 
-    if(mFullness <= 0.0)
+    if(getFullness() <= 0.0)
     {
-        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", mFullness=" + Helper::toString(mFullness));
+        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", fullness=" + Helper::toString(getFullness()));
         return 0.0;
     }
 
-    if(fullnessLost >= mFullness)
+    if(fullnessLost >= getFullness())
     {
-        digRateScaled = mFullness;
+        digRateScaled = getFullness();
         setFullness(0.0);
 
         computeTileVisual();
@@ -1388,7 +1263,7 @@ double Tile::digOut(double digRate)
     }
 
     digRateScaled = fullnessLost;
-    setFullness(mFullness - fullnessLost);
+    setFullness(getFullness() - fullnessLost);
     return digRateScaled;
 }
 
@@ -1706,26 +1581,12 @@ bool Tile::checkCoveringTrapType(TrapType type) const
     return (coveringTrap->getType() == type);
 }
 
-void Tile::computeVisibleTiles()
+void Tile::refreshClaimedVision()
 {
-    if(!getGameMap()->getIsFOWActivated())
-    {
-        // If the FOW is deactivated, we allow vision for every seat
-        for(Seat* seat : getGameMap()->getSeats())
-            notifyVision(seat);
-
-        return;
-    }
-
-    if(!isClaimed())
+    if(!getIsOnServerMap())
         return;
 
-    // A claimed tile can see it self and its neighboors
-    notifyVision(getSeat());
-    for(Tile* tile : mNeighbors)
-    {
-        tile->notifyVision(getSeat());
-    }
+    getGameMap()->getVisionTracker().refreshClaimedVision(getX(), getY());
 }
 
 void Tile::setDirtyForAllSeats()
@@ -1739,12 +1600,22 @@ void Tile::setDirtyForAllSeats()
 
 void Tile::notifyEntitiesSeatsWithVision()
 {
+    mEntitiesVisionChanged = false;
     for(GameEntity* entity : mEntitiesInTile)
     {
         entity->notifySeatsWithVision(mSeatsWithVision);
     }
 }
 
+void Tile::entitiesVisionChanged()
+{
+    if(mEntitiesVisionChanged)
+        return;
+
+    mEntitiesVisionChanged = true;
+    getGameMap()->addTileEntitiesVisionChanged(this);
+}
+
 
 bool Tile::isFullTile() const
 {
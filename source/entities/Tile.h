@@ -19,6 +19,8 @@
 #define TILE_H
 
 #include "entities/GameEntity.h"
+#include "entities/TileType.h"
+#include "gamemap/TileStore.h"
 
 #include <OgreVector3.h>
 
@@ -42,24 +44,15 @@ class CraftedTrap;
 class BuildingObject;
 class PersistentObject;
 class ODPacket;
+class TileDeltaReader;
+class TileDeltaWriter;
+
+struct TextRef;
 
 enum class RoomType;
 enum class SelectionEntityWanted;
 enum class TrapType;
 
-//! Tile types a tile can be
-enum class TileType
-{
-    nullTileType = 0,
-    dirt = 1,
-    gold = 2,
-    rock = 3,
-    water = 4,
-    lava = 5,
-    gem = 6,
-    countTileType
-};
-
 enum class TileSound
 {
     ClaimGround,
@@ -69,36 +62,6 @@ enum class TileSound
     BuildTrap
 };
 
-ODPacket& operator<<(ODPacket& os, const TileType& type);
-ODPacket& operator>>(ODPacket& is, TileType& type);
-std::ostream& operator<<(std::ostream& os, const TileType& type);
-std::istream& operator>>(std::istream& is, TileType& type);
-
-
-//! Different representations a tile can have (ground or full)
-enum class TileVisual
-{
-    nullTileVisual = 0,
-    dirtGround,
-    dirtFull,
-    goldGround,
-    goldFull,
-    rockGround,
-    rockFull,
-    waterGround,
-    lavaGround,
-    claimedGround,
-    claimedFull,
-    gemGround,
-    gemFull,
-    countTileVisual
-};
-
-ODPacket& operator<<(ODPacket& os, const TileVisual& type);
-ODPacket& operator>>(ODPacket& is, TileVisual& type);
-std::ostream& operator<<(std::ostream& os, const TileVisual& type);
-std::istream& operator>>(std::istream& is, TileVisual& type);
-
 enum class FloodFillType
 {
     ground = 0,
@@ -167,17 +130,21 @@ public:
     void fireRemoveEntity(Seat* seat) override
     {}
 
+    //! \brief Index of the tile in the TileStore of its game map
+    inline uint32_t getTileIndex() const
+    { return mTileIndex; }
+
     /*! \brief Set the type (rock, claimed, etc.) of the tile.
      *
      * In addition to setting the tile type this function also reloads the new mesh
      * for the tile.
      */
     inline void setType(TileType t)
-    { mType = t; }
+    { mTileStore->setType(mTileIndex, t); }
 
     //! \brief Returns the tile type (rock, claimed, etc.).
     inline TileType getType() const
-    { return mType; }
+    { return mTileStore->getType(mTileIndex); }
 
     //! \brief Returns the tile type (rock, claimed, etc.).
     inline TileVisual getTileVisual() const
@@ -193,7 +160,7 @@ public:
 
     //! \brief An accessor which returns the tile's fullness which should range from 0 to 100.
     inline double getFullness() const
-    { return mFullness; }
+    { return mTileStore->getFullness(mTileIndex); }
 
     //! \brief Tells whether a creature can see through a tile
     bool permitsVision();
@@ -325,10 +292,17 @@ public:
     //! \brief Tells whether a room can be built upon this tile.
     bool isBuildableUpon(Seat* seat) const;
 
-    static std::string getFormat();
+    //! \brief Fields of a tile line in a text level. Inline so that LevelSnapshot does not need the tile code
+    static std::string getFormat()
+    { return "posX\tposY\ttype\tfullness\tseatId(optional)"; }
+
+    //! \brief Loads the tile data from the tab separated fields of a level line. The tile should be the one
+    //! at the coordinates given by the 2 first fields. Returns false if the fields are not valid
+    static bool loadFromFields(const std::vector<TextRef>& fields, Tile *t);
 
-    //! \brief Loads the tile data from a level line.
-    static void loadFromLine(const std::string& line, Tile *t);
+    //! \brief Loads the given tile data in the tile. seatId is -1 if the tile has no seat. Used when the
+    //! tiles are read from a text level or from a savegame snapshot
+    static void loadFromData(Tile* t, TileType tileType, double fullness, int32_t seatId);
 
     /*! \brief This is a helper function which just converts the tile type enum into a string.
      *
@@ -349,7 +323,7 @@ public:
     { return mY; }
 
     inline double getClaimedPercentage() const
-    { return mClaimedPercentage; }
+    { return mTileStore->getClaimedPercentage(mTileIndex); }
 
     static std::string buildName(int x, int y);
     static bool checkTileName(const std::string& tileName, int& x, int& y);
@@ -366,17 +340,27 @@ public:
     //! Fills the given vector with corresponding entities on this tile.
     void fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player);
 
-    //! \brief Computes the visible tiles and tags them to know which are visible
-    void computeVisibleTiles();
-    void clearVision();
-    void notifyVision(Seat* seat);
+    //! \brief A claimed tile gives vision on itself and its neighbors to its seat. Updates this vision if the
+    //! claimed state of the tile changed. Should be called each time it may have changed (see VisionTracker)
+    void refreshClaimedVision();
+
+    //! \brief Called by the game map when the given seat gains or loses its vision sources on this tile
+    //! (see VisionTracker)
+    void seatVisionChanged(Seat* seat, bool hasVision);
 
     void setSeats(const std::vector<Seat*>& seats);
     bool hasChangedForSeat(Seat* seat) const;
     void changeNotifiedForSeat(Seat* seat);
 
+    //! \brief Notifies the entities on this tile about the seats with vision on it. Called on the tiles
+    //! queued with entitiesVisionChanged only (see GameMap::updateVisibleEntities)
     void notifyEntitiesSeatsWithVision();
 
+    //! \brief Queues this tile for the next GameMap::updateVisibleEntities. Called when the seats
+    //! with vision on the tile change, when an entity enters it or when an entity on it changes the
+    //! seats it can be seen by
+    void entitiesVisionChanged();
+
     const std::vector<Seat*>& getSeatsWithVision()
     { return mSeatsWithVision; }
 
@@ -384,17 +368,16 @@ public:
 
     static std::string toString(FloodFillType type);
 
+    //! Returns true if both tiles are in the same area (their floodfill values have the same representative)
     bool isSameFloodFill(Seat* seat, FloodFillType type, Tile* tile) const;
 
-    //! Updates the floodfill from the given tile if floodfill is not already set.
-    //! returns true if the floodfill has been updated and false otherwise
-    bool updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile);
-
     //! Sets the floodfill value corresponding at type to newValue
     void replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue);
 
     void copyFloodFillToOtherSeats(Seat* seatToCopy);
 
+    //! Returns the floodfill of the area containing this tile. That is the representative of the value set on
+    //! this tile in the GameMap floodfill sets
     uint32_t getFloodFillValue(Seat* seat, FloodFillType type) const;
 
     void logFloodFill() const;
@@ -413,8 +396,6 @@ public:
     //! server and client
     bool isFullTile() const;
 
-    //! Sets the number of teams in this gamemap (after seat configuration). This number includes the rogue team.
-    void setTeamsNumber(uint32_t nbTeams);
 
     //! \brief returns true if the mesh from the tileset should be displayed and false otherwise
     inline bool shouldDisplayTileMesh() const
@@ -460,7 +441,10 @@ public:
 
     virtual void exportToPacketForUpdate(ODPacket& os, const Seat* seat) const override;
     virtual void updateFromPacket(ODPacket& is) override;
-    void exportToPacketForUpdate(ODPacket& os, const Seat* seat, bool hideSeatId) const;
+    //! \brief Used when several tiles are sent in the same packet (see Seat::exportTilesToPacket). The
+    //! tiles should be read in the same order with the same reader
+    void exportToPacketForUpdate(TileDeltaWriter& writer, const Seat* seat, bool hideSeatId) const;
+    void updateFromPacket(TileDeltaReader& reader);
 
     bool addTileStateListener(TileStateListener& listener);
     bool removeTileStateListener(TileStateListener& listener);
@@ -478,14 +462,19 @@ protected:
     virtual void importFromPacket(ODPacket& is) override
     {}
 
+    //! \brief Keeps the seat id set by GameEntity::setSeat in the TileStore
+    virtual void seatChanged(Seat* oldSeat) override;
+
     virtual void createMeshLocal();
     virtual void destroyMeshLocal();
 private:
     //! \brief The tile position
     int mX, mY;
 
-    //! \brief The tile type: Dirt, Gold, ...
-    TileType mType;
+    //! \brief The type, fullness, claimed percentage, seat, floodfill and vision of the tile are stored in
+    //! the TileStore of the GameMap at mTileIndex
+    TileStore* mTileStore;
+    uint32_t mTileIndex;
 
     //! \brief The tile visual: Claimed, Dirt, Gold, ...
     //! On client side, we should rely on mTileVisual to know the tile type as claimed percentage
@@ -495,11 +484,6 @@ private:
     //! \brief Whether the tile is selected.
     bool mSelected;
 
-    //! \brief The tile fullness (0.0 - 100.0).
-    //! At 0.0, it is a ground tile. Over it is a wall.
-    //! Used on server side only
-    double mFullness;
-
     //! Used on client side to know how much gold can be retrieved if the room/trap
     //! is sold. Note that it is needed because client are not aware of rooms/traps
     uint32_t mRefundPriceRoom;
@@ -510,15 +494,13 @@ private:
     std::vector<std::pair<Seat*, bool>> mTileChangedForSeats;
     std::vector<Seat*> mSeatsWithVision;
 
+    //! \brief True if the tile is queued for the next GameMap::updateVisibleEntities
+    bool mEntitiesVisionChanged;
+
     //! \brief List of the entities actually on this tile. Most of the creatures actions will rely on this list
     std::vector<GameEntity*> mEntitiesInTile;
 
     Building* mCoveringBuilding;
-    //! Floodfill values per seat and per floodfill type
-    std::vector<std::vector<uint32_t>> mFloodFillColor;
-
-    //! \brief The tile claiming. Used on server side only
-    double mClaimedPercentage;
 
     //! \brief True if a building is on this tile. False otherwise. It is used on client side because the clients do not know about
     //! buildings. However, it needs to know the tiles where a building is to display the room/trap costs.
@@ -541,7 +523,11 @@ private:
      *  before a map object has been set. setFullness is called once a map is assigned.
      */
     inline void setFullnessValue(double f)
-    { mFullness = f; }
+    { mTileStore->setFullness(mTileIndex, f); }
+
+    //! \brief The tile claiming (see TileStore). Used on server side only
+    inline void setClaimedPercentage(double claimedPercentage)
+    { mTileStore->setClaimedPercentage(mTileIndex, claimedPercentage); }
 
     void setDirtyForAllSeats();
 
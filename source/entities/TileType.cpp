@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entities/TileType.h"
+
+#include "network/ODPacket.h"
+
+#include <istream>
+#include <ostream>
+
+ODPacket& operator<<(ODPacket& os, const TileType& type)
+{
+    uint32_t intType = static_cast<uint32_t>(type);
+    os << intType;
+    return os;
+}
+
+ODPacket& operator>>(ODPacket& is, TileType& type)
+{
+    uint32_t intType;
+    is >> intType;
+    type = static_cast<TileType>(intType);
+    return is;
+}
+
+std::ostream& operator<<(std::ostream& os, const TileType& type)
+{
+    uint32_t intType = static_cast<uint32_t>(type);
+    os << intType;
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, TileType& type)
+{
+    uint32_t intType;
+    is >> intType;
+    type = static_cast<TileType>(intType);
+    return is;
+}
+
+ODPacket& operator<<(ODPacket& os, const TileVisual& type)
+{
+    uint32_t intType = static_cast<uint32_t>(type);
+    os << intType;
+    return os;
+}
+
+ODPacket& operator>>(ODPacket& is, TileVisual& type)
+{
+    uint32_t intType;
+    is >> intType;
+    type = static_cast<TileVisual>(intType);
+    return is;
+}
+
+std::ostream& operator<<(std::ostream& os, const TileVisual& type)
+{
+    uint32_t intType = static_cast<uint32_t>(type);
+    os << intType;
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, TileVisual& type)
+{
+    uint32_t intType;
+    is >> intType;
+    type = static_cast<TileVisual>(intType);
+    return is;
+}
+
+TileVisual tileVisualFromState(TileType type, double fullness, bool isClaimed)
+{
+    switch(type)
+    {
+        case TileType::dirt:
+            if(fullness > 0.0)
+                return isClaimed ? TileVisual::claimedFull : TileVisual::dirtFull;
+
+            return isClaimed ? TileVisual::claimedGround : TileVisual::dirtGround;
+
+        case TileType::rock:
+            return (fullness > 0.0) ? TileVisual::rockFull : TileVisual::rockGround;
+
+        case TileType::gold:
+            if(fullness > 0.0)
+                return isClaimed ? TileVisual::claimedFull : TileVisual::goldFull;
+
+            return isClaimed ? TileVisual::claimedGround : TileVisual::goldGround;
+
+        case TileType::water:
+            return TileVisual::waterGround;
+
+        case TileType::lava:
+            return TileVisual::lavaGround;
+
+        case TileType::gem:
+            return (fullness > 0.0) ? TileVisual::gemFull : TileVisual::gemGround;
+
+        default:
+            return TileVisual::nullTileVisual;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILETYPE_H
+#define TILETYPE_H
+
+#include <iosfwd>
+
+class ODPacket;
+
+//! Tile types a tile can be
+enum class TileType
+{
+    nullTileType = 0,
+    dirt = 1,
+    gold = 2,
+    rock = 3,
+    water = 4,
+    lava = 5,
+    gem = 6,
+    countTileType
+};
+
+ODPacket& operator<<(ODPacket& os, const TileType& type);
+ODPacket& operator>>(ODPacket& is, TileType& type);
+std::ostream& operator<<(std::ostream& os, const TileType& type);
+std::istream& operator>>(std::istream& is, TileType& type);
+
+//! Different representations a tile can have (ground or full)
+enum class TileVisual
+{
+    nullTileVisual = 0,
+    dirtGround,
+    dirtFull,
+    goldGround,
+    goldFull,
+    rockGround,
+    rockFull,
+    waterGround,
+    lavaGround,
+    claimedGround,
+    claimedFull,
+    gemGround,
+    gemFull,
+    countTileVisual
+};
+
+ODPacket& operator<<(ODPacket& os, const TileVisual& type);
+ODPacket& operator>>(ODPacket& is, TileVisual& type);
+std::ostream& operator<<(std::ostream& os, const TileVisual& type);
+std::istream& operator>>(std::istream& is, TileVisual& type);
+
+//! \brief Returns the visual of a tile with the given type, fullness and claimed state as the server computes
+//! it (see Tile::computeTileVisual). Returns TileVisual::nullTileVisual for an unknown tile type
+TileVisual tileVisualFromState(TileType type, double fullness, bool isClaimed);
+
+#endif // TILETYPE_H
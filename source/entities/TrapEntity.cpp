@@ -19,6 +19,7 @@
 
 #include "entities/DoorEntity.h"
 #include "entities/GameEntityType.h"
+#include "entities/Tile.h"
 #include "network/ODPacket.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
@@ -97,6 +98,11 @@ void TrapEntity::seatSawTriggering(Seat* seat)
         return;
 
     mSeatsNotHidden.push_back(seat);
+
+    // If the seat has vision on the trap, it will be notified
+    Tile* tile = getPositionTile();
+    if(tile != nullptr)
+        tile->entitiesVisionChanged();
 }
 
 void TrapEntity::notifySeatsWithVision(const std::vector<Seat*>& seats)
@@ -30,6 +30,7 @@
 #include "goals/Goal.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
+#include "network/TileDelta.h"
 #include "render/RenderManager.h"
 #include "rooms/Room.h"
 #include "rooms/RoomManager.h"
@@ -43,6 +44,7 @@
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
+#include <algorithm>
 #include <istream>
 #include <ostream>
 
@@ -55,6 +57,15 @@ const std::string Seat::PLAYER_FACTION_CHOICE = "Choice";
 const int32_t Seat::PLAYER_TYPE_INACTIVE_ID = 0;
 const int32_t Seat::PLAYER_ID_HUMAN_MIN = static_cast<int32_t>(KeeperAIType::nbAI) + Seat::PLAYER_TYPE_INACTIVE_ID + 1;
 
+//! \brief Sorts the tiles by row so that the tiles sent to the clients give the longest runs (see TileDeltaWriter)
+static bool compareTilesByRow(const Tile* t1, const Tile* t2)
+{
+    if(t1->getY() != t2->getY())
+        return t1->getY() < t2->getY();
+
+    return t1->getX() < t2->getX();
+}
+
 
 TileStateNotified::TileStateNotified():
     mTileVisual(TileVisual::nullTileVisual),
@@ -62,6 +73,7 @@ TileStateNotified::TileStateNotified():
     mMarkedForDigging(false),
     mVisionTurnLast(false),
     mVisionTurnCurrent(false),
+    mVisionChangePending(false),
     mBuilding(nullptr)
 {
 }
@@ -225,43 +237,68 @@ void Seat::addAlliedSeat(Seat* seat)
     mAlliedSeats.push_back(seat);
 }
 
-void Seat::clearTilesWithVision()
+TileStateNotified* Seat::getTileStateForVision(Tile* tile)
 {
     if(mPlayer == nullptr)
-        return;
+        return nullptr;
     if(!mPlayer->getIsHuman())
-        return;
+        return nullptr;
 
-    for(std::vector<TileStateNotified>& vec : mTilesStates)
+    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
     {
-        for(TileStateNotified& p : vec)
-        {
-            p.mVisionTurnLast = p.mVisionTurnCurrent;
-            p.mVisionTurnCurrent = false;
-        }
+        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+        return nullptr;
     }
+    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
+    {
+        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+        return nullptr;
+    }
+
+    return &mTilesStates[tile->getX()][tile->getY()];
 }
 
-void Seat::notifyVisionOnTile(Tile* tile)
+void Seat::setVisionOnTile(Tile* tile, TileStateNotified& tileState, bool vision)
 {
-    if(mPlayer == nullptr)
-        return;
-    if(!mPlayer->getIsHuman())
+    tileState.mVisionTurnCurrent = vision;
+    if(tileState.mVisionChangePending)
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
+    tileState.mVisionChangePending = true;
+    mTilesVisionChanged.push_back(tile);
+}
+
+void Seat::refreshForcedTilesVision()
+{
+    for(Tile* tile : mTilesVisionForced)
     {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
+        TileStateNotified* tileState = getTileStateForVision(tile);
+        if(tileState == nullptr)
+            continue;
+
+        const std::vector<Seat*>& seats = tile->getSeatsWithVision();
+        bool vision = (std::find(seats.begin(), seats.end(), this) != seats.end());
+        setVisionOnTile(tile, *tileState, vision);
     }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    mTilesVisionForced.clear();
+}
+
+void Seat::notifyVisionOnTile(Tile* tile)
+{
+    TileStateNotified* tileState = getTileStateForVision(tile);
+    if(tileState == nullptr)
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mVisionTurnCurrent = true;
+    setVisionOnTile(tile, *tileState, true);
+}
+
+void Seat::notifyVisionLostOnTile(Tile* tile)
+{
+    TileStateNotified* tileState = getTileStateForVision(tile);
+    if(tileState == nullptr)
+        return;
+
+    setVisionOnTile(tile, *tileState, false);
 }
 
 void Seat::notifyTileClaimedByEnemy(Tile* tile)
@@ -284,10 +321,12 @@ void Seat::notifyTileClaimedByEnemy(Tile* tile)
 
     TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
 
-    // By default, we set the tile like if it was not claimed anymore
+    // By default, we set the tile like if it was not claimed anymore. We give vision on the tile
+    // until the next turn so that the player gets notified
     tileState.mSeatIdOwner = -1;
     tileState.mTileVisual = TileVisual::dirtGround;
-    tileState.mVisionTurnCurrent = true;
+    setVisionOnTile(tile, tileState, true);
+    mTilesVisionForced.push_back(tile);
 }
 
 const std::string Seat::getFactionFromLine(const std::string& line)
@@ -310,6 +349,14 @@ bool Seat::takeMana(double mana)
     return true;
 }
 
+int Seat::takeStartingGold()
+{
+    // The treasuries are empty when the level is loaded
+    int gold = mGold;
+    mGold = 0;
+    return gold;
+}
+
 bool Seat::sortForMapSave(Seat* s1, Seat* s2)
 {
     return s1->mId < s2->mId;
@@ -439,10 +486,7 @@ void Seat::initSeat()
 
         if(!tilesRefresh.empty())
         {
-            ServerNotification *serverNotification = new ServerNotification(
-                ServerNotificationType::refreshTiles, getPlayer());
-            uint32_t nbTiles = tilesRefresh.size();
-            serverNotification->mPacket << nbTiles;
+            std::vector<Tile*> tilesExport;
             for(Tile* tile : tilesRefresh)
             {
                 std::pair<int, int> tileCoords(tile->getX(), tile->getY());
@@ -461,11 +505,13 @@ void Seat::initSeat()
                     continue;
                 }
                 mTilesStates[tile->getX()][tile->getY()] = tileState;
-
-                // Then, we export tile state to the client
-                mGameMap->tileToPacket(serverNotification->mPacket, tile);
-                tile->exportToPacketForUpdate(serverNotification->mPacket, this);
+                tilesExport.push_back(tile);
             }
+
+            // Then, we export tile state to the client
+            ServerNotification *serverNotification = ServerNotification::acquire(
+                ServerNotificationType::refreshTiles, getPlayer());
+            exportTilesToPacket(serverNotification->mPacket, tilesExport, false);
             ODServer::getSingleton().queueServerNotification(serverNotification);
         }
 
@@ -481,6 +527,8 @@ void Seat::setMapSize(int x, int y)
         return;
 
     mTilesStates = std::vector<std::vector<TileStateNotified>>(x, std::vector<TileStateNotified>(y));
+    mTilesVisionChanged.clear();
+    mTilesVisionForced.clear();
     // By default, we know that rock (ground & full) will be set as rock full tiles,
     // gold (ground & full) will be set as gold full tiles,
     // other tiles will be set as dirt full tiles
@@ -536,7 +584,7 @@ unsigned int Seat::checkAllGoals()
                getPlayer()->getIsHuman() &&
                !getPlayer()->getHasLost())
             {
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::chatServer, getPlayer());
 
                 serverNotification->mPacket << "You have met an objective." << EventShortNoticeType::aboutObjectives;
@@ -567,7 +615,7 @@ unsigned int Seat::checkAllGoals()
                    getPlayer()->getIsHuman() &&
                    !getPlayer()->getHasLost())
                 {
-                    ServerNotification *serverNotification = new ServerNotification(
+                    ServerNotification *serverNotification = ServerNotification::acquire(
                         ServerNotificationType::chatServer, getPlayer());
 
                     serverNotification->mPacket << "You have FAILED an objective!" << EventShortNoticeType::majorGameEvent;
@@ -624,16 +672,12 @@ void Seat::notifyChangedVisibleTiles()
     if(tilesToNotify.empty())
         return;
 
-    uint32_t nbTiles = tilesToNotify.size();
-    ServerNotification *serverNotification = new ServerNotification(
-        ServerNotificationType::refreshTiles, getPlayer());
-    serverNotification->mPacket << nbTiles;
     for(Tile* tile : tilesToNotify)
-    {
-        mGameMap->tileToPacket(serverNotification->mPacket, tile);
         updateTileStateForSeat(tile, false);
-        tile->exportToPacketForUpdate(serverNotification->mPacket, this);
-    }
+
+    ServerNotification *serverNotification = ServerNotification::acquire(
+        ServerNotificationType::refreshTiles, getPlayer());
+    exportTilesToPacket(serverNotification->mPacket, tilesToNotify, false);
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
@@ -723,7 +767,7 @@ void Seat::refreshSeatVisualDebug()
             }
         }
         uint32_t nbTiles = tiles.size();
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::refreshSeatVisDebug, nullptr);
         serverNotification->mPacket << seatId;
         serverNotification->mPacket << true;
@@ -736,7 +780,7 @@ void Seat::refreshSeatVisualDebug()
     }
     else
     {
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::refreshSeatVisDebug, nullptr);
         serverNotification->mPacket << seatId;
         serverNotification->mPacket << false;
@@ -755,50 +799,40 @@ void Seat::sendVisibleTiles()
     if(!getPlayer()->getIsHuman())
         return;
 
-    uint32_t nbTiles;
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::refreshVisibleTiles, getPlayer());
     std::vector<Tile*> tilesVisionGained;
     std::vector<Tile*> tilesVisionLost;
-    // Tiles we gained vision
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
+    // We only check the tiles where vision changed since the last time
+    for(Tile* tile : mTilesVisionChanged)
     {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
-        {
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent == mTilesStates[xxx][yyy].mVisionTurnLast)
-                continue;
+        TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+        tileState.mVisionChangePending = false;
+        if(tileState.mVisionTurnCurrent == tileState.mVisionTurnLast)
+            continue;
 
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent)
-            {
-                // Vision gained
-                tilesVisionGained.push_back(tile);
-            }
-            else
-            {
-                // Vision lost
-                tilesVisionLost.push_back(tile);
-            }
+        tileState.mVisionTurnLast = tileState.mVisionTurnCurrent;
+        if(tileState.mVisionTurnCurrent)
+        {
+            // Vision gained
+            tilesVisionGained.push_back(tile);
+        }
+        else
+        {
+            // Vision lost
+            tilesVisionLost.push_back(tile);
         }
     }
+    mTilesVisionChanged.clear();
 
-    // Notify tiles we gained vision
-    nbTiles = tilesVisionGained.size();
-    serverNotification->mPacket << nbTiles;
-    for(Tile* tile : tilesVisionGained)
-    {
-        mGameMap->tileToPacket(serverNotification->mPacket, tile);
-    }
+    // Notify tiles we gained vision then tiles we lost vision. They are sorted by row to
+    // get the longest runs
+    std::sort(tilesVisionGained.begin(), tilesVisionGained.end(), compareTilesByRow);
+    std::sort(tilesVisionLost.begin(), tilesVisionLost.end(), compareTilesByRow);
 
-    // Notify tiles we lost vision
-    nbTiles = tilesVisionLost.size();
-    serverNotification->mPacket << nbTiles;
-    for(Tile* tile : tilesVisionLost)
-    {
-        mGameMap->tileToPacket(serverNotification->mPacket, tile);
-    }
+    TileDeltaWriter writer(serverNotification->mPacket);
+    mGameMap->tilesToPacket(writer, tilesVisionGained);
+    mGameMap->tilesToPacket(writer, tilesVisionLost);
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
@@ -1295,7 +1329,7 @@ bool Seat::addSkill(SkillType type)
        getPlayer()->getIsHuman() &&
        !getPlayer()->getHasLost())
     {
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::chatServer, getPlayer());
 
         std::string msg = Skills::skillTypeToPlayerVisibleString(type) + " is now available.";
@@ -1452,7 +1486,7 @@ void Seat::setSkillsDone(const std::vector<SkillType>& skills)
         if((getPlayer() != nullptr) && getPlayer()->getIsHuman())
         {
             // We notify the client
-            ServerNotification *serverNotification = new ServerNotification(
+            ServerNotification *serverNotification = ServerNotification::acquire(
                 ServerNotificationType::skillsDone, getPlayer());
 
             uint32_t nbItems = mSkillDone.size();
@@ -1511,7 +1545,7 @@ void Seat::setSkillTree(const std::vector<SkillType>& skills)
         if((getPlayer() != nullptr) && getPlayer()->getIsHuman())
         {
             // We notify the client
-            ServerNotification *serverNotification = new ServerNotification(
+            ServerNotification *serverNotification = ServerNotification::acquire(
                 ServerNotificationType::skillTree, getPlayer());
 
             uint32_t nbItems = mSkillPending.size();
@@ -1630,7 +1664,7 @@ void Seat::setVisibleBuildingOnTile(Building* building, Tile* tile)
     tileState.mSeatIdOwner = building->getSeat()->getId();
 }
 
-void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
+void Seat::exportTileToPacket(TileDeltaWriter& writer, const Tile* tile,
         bool hideSeatId) const
 {
     if(getPlayer() == nullptr)
@@ -1657,7 +1691,7 @@ void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
 
     const TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
 
-    int tileSeatId = -1;
+    TileDeltaData data;
     // We only pass the tile seat to the client if the tile is fully claimed
     if(!hideSeatId)
     {
@@ -1665,70 +1699,61 @@ void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
         {
             case TileVisual::claimedGround:
             case TileVisual::claimedFull:
-                tileSeatId = tileState.mSeatIdOwner;
+                data.mSeatId = tileState.mSeatIdOwner;
                 break;
             case TileVisual::waterGround:
             case TileVisual::lavaGround:
                 if(tileState.mBuilding != nullptr)
-                    tileSeatId = tileState.mSeatIdOwner;
+                    data.mSeatId = tileState.mSeatIdOwner;
                 break;
             default:
                 break;
         }
     }
 
-    std::string meshName;
-
+    // If there is no building mesh, we set an empty mesh so that the client can compute the tile itself
     if((tileState.mBuilding != nullptr) &&
        !tileState.mBuilding->getMeshName().empty())
     {
-        meshName = tileState.mBuilding->getMeshName() + ".mesh";
-    }
-    else
-    {
-        // We set an empty mesh so that the client can compute the tile itself
-        meshName.clear();
+        data.mMeshName = tileState.mBuilding->getMeshName() + ".mesh";
     }
-    bool isRoom = false;
-    bool isTrap = false;
-    bool displayTileMesh = true;
-    bool colorCustomMesh = false;
-    bool hasBridge = false;
 
-    uint32_t refundPriceRoom = 0;
-    uint32_t refundPriceTrap = 0;
     if(tileState.mBuilding != nullptr)
     {
-        displayTileMesh = tileState.mBuilding->displayTileMesh();
-        colorCustomMesh = tileState.mBuilding->colorCustomMesh();
+        data.mDisplayTileMesh = tileState.mBuilding->displayTileMesh();
+        data.mColorCustomMesh = tileState.mBuilding->colorCustomMesh();
 
         if(tileState.mBuilding->getObjectType() == GameEntityType::room)
         {
-            isRoom = true;
+            data.mIsRoom = true;
             Room* room = static_cast<Room*>(tileState.mBuilding);
             if(room->getSeat() == this)
-                refundPriceRoom = (RoomManager::costPerTile(room->getType()) / 2);
+                data.mRefundPriceRoom = (RoomManager::costPerTile(room->getType()) / 2);
 
-            hasBridge = room->isBridge();
+            data.mHasBridge = room->isBridge();
         }
         else if(tileState.mBuilding->getObjectType() == GameEntityType::trap)
         {
-            isTrap = true;
+            data.mIsTrap = true;
             Trap* trap = static_cast<Trap*>(tileState.mBuilding);
             if(trap->getSeat() == this)
-                refundPriceTrap = (TrapManager::costPerTile(trap->getType()) / 2);
+                data.mRefundPriceTrap = (TrapManager::costPerTile(trap->getType()) / 2);
         }
     }
-    os << isRoom;
-    os << isTrap;
-    os << refundPriceRoom;
-    os << refundPriceTrap;
-    os << displayTileMesh;
-    os << colorCustomMesh;
-    os << hasBridge;
-    os << tileSeatId;
-    os << meshName;
-    os << tileState.mTileVisual;
+    data.mTileVisual = static_cast<uint8_t>(tileState.mTileVisual);
+    writer.writeTile(data);
+}
+
+void Seat::exportTilesToPacket(ODPacket& os, const std::vector<Tile*>& tiles,
+        bool hideSeatId) const
+{
+    std::vector<Tile*> sortedTiles = tiles;
+    std::sort(sortedTiles.begin(), sortedTiles.end(), compareTilesByRow);
+
+    TileDeltaWriter writer(os);
+    mGameMap->tilesToPacket(writer, sortedTiles);
+    for(Tile* tile : sortedTiles)
+        tile->exportToPacketForUpdate(writer, this, hideSeatId);
 }
 
 void Seat::notifyBuildingRemovedFromGameMap(Building* building, Tile* tile)
@@ -1935,7 +1960,7 @@ void Seat::setPlayerSettings(bool koCreatures)
         return;
 
     // We send a message to the client to update his settings
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::setPlayerSettings, getPlayer());
 
     serverNotification->mPacket << mKoCreatures;
@@ -37,6 +37,7 @@ class Player;
 class Skill;
 class Seat;
 class Tile;
+class TileDeltaWriter;
 
 enum class KeeperAIType;
 enum class RoomType;
@@ -54,8 +55,12 @@ public:
     TileVisual mTileVisual;
     int mSeatIdOwner;
     bool mMarkedForDigging;
+    //! \brief Vision state last sent to the player
     bool mVisionTurnLast;
+    //! \brief Current vision state
     bool mVisionTurnCurrent;
+    //! \brief True if the tile is in Seat::mTilesVisionChanged
+    bool mVisionChangePending;
     Building* mBuilding;
 };
 
@@ -167,6 +172,28 @@ public:
     inline void addGoldMined(int quantity)
     { mGoldMined += quantity; }
 
+    //! \brief Called when a creature of this seat starts (delta = 1) or stops (delta = -1) being counted
+    inline void addNumCreatures(bool isWorker, int delta)
+    {
+        if(isWorker)
+            mNumCreaturesWorkers += delta;
+        else
+            mNumCreaturesFighters += delta;
+    }
+
+    //! \brief Called when the gold stored in the treasuries of this seat or their storage changes
+    inline void addTreasuryGold(int goldDelta, int goldMaxDelta)
+    {
+        mGold += goldDelta;
+        mGoldMax += goldMaxDelta;
+    }
+
+    /*! \brief Returns the gold read from the level file and sets the seat gold back to 0. The gold
+     * of a seat is the one stored in its treasuries so the starting gold is only counted once
+     * deposited in them.
+     */
+    int takeStartingGold();
+
     inline bool getIsDebuggingVision()
     { return mIsDebuggingVision; }
 
@@ -200,8 +227,14 @@ public:
     bool canOwnedCreatureUseRoomFrom(const Seat* seat) const;
     bool canBuildingBeDestroyedBy(const Seat* seat) const;
 
-    void clearTilesWithVision();
+    //! \brief Tiles claimed by an enemy are visible during the turn they are lost. Sets back their vision to
+    //! what the vision sources give. Should be called once per turn before computing vision
+    void refreshForcedTilesVision();
+
+    //! \brief Called by the tile when this seat gains or loses vision on it (see VisionTracker)
     void notifyVisionOnTile(Tile* tile);
+    void notifyVisionLostOnTile(Tile* tile);
+
     void notifyTileClaimedByEnemy(Tile* tile);
 
     //! \brief Returns true if this seat can see the given tile and false otherwise
@@ -297,7 +330,14 @@ public:
      * associated to the seat have the needed information to display the
      * tile correctly
      */
-    void exportTileToPacket(ODPacket& os, const Tile* tile,
+    void exportTileToPacket(TileDeltaWriter& writer, const Tile* tile,
+        bool hideSeatId) const;
+
+    /*! \brief Exports the given tiles as expected by the refreshTiles notification: the tiles
+     * coordinates then the tiles data as seen by this seat (see Tile::exportToPacketForUpdate).
+     * The tiles are sorted by row so that the coordinates take as little space as possible
+     */
+    void exportTilesToPacket(ODPacket& os, const std::vector<Tile*>& tiles,
         bool hideSeatId) const;
 
     static bool sortForMapSave(Seat* s1, Seat* s2);
@@ -363,8 +403,20 @@ private:
 
     std::map<std::pair<int, int>, TileStateNotified> mTilesStateLoaded;
 
+    //! \brief Tiles where the vision may have changed since the last call to sendVisibleTiles
+    std::vector<Tile*> mTilesVisionChanged;
+
+    //! \brief Tiles with vision forced by notifyTileClaimedByEnemy
+    std::vector<Tile*> mTilesVisionForced;
+
     std::vector<Tile*> mVisualDebugEntityTiles;
 
+    //! \brief Returns the state of the given tile or nullptr if it is not handled by this seat
+    TileStateNotified* getTileStateForVision(Tile* tile);
+
+    //! \brief Sets the current vision on the given tile and remembers it should be sent
+    void setVisionOnTile(Tile* tile, TileStateNotified& tileState, bool vision);
+
     //! \brief Index of the team in the gamemap (from 0 to N). Must be set when the seat is added to the gamemap
     //! and never changed after
     uint32_t mTeamIndex;
@@ -0,0 +1,148 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/AstarSearch.h"
+
+const uint32_t AstarSearch::NO_NODE = static_cast<uint32_t>(-1);
+
+AstarSearch::AstarSearch() :
+    mMapSizeX(0),
+    mGeneration(0),
+    mOrder(0)
+{
+}
+
+void AstarSearch::startSearch(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mHeap.clear();
+    mOrder = 0;
+
+    uint32_t nbNodes = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    if(mNodes.size() != nbNodes)
+    {
+        // The map size changed. We can reset everything
+        mNodes.assign(nbNodes, Node());
+        mGeneration = 0;
+    }
+
+    ++mGeneration;
+    if(mGeneration != 0)
+        return;
+
+    // The generation counter wrapped. We have to reset the stamps once
+    for(Node& node : mNodes)
+        node.mGeneration = 0;
+    mGeneration = 1;
+}
+
+void AstarSearch::open(uint32_t index, uint32_t parent, double g, double h)
+{
+    Node& node = mNodes[index];
+    node.mGeneration = mGeneration;
+    node.mParent = parent;
+    node.mG = g;
+    node.mH = h;
+    node.mOrder = mOrder++;
+
+    mHeap.push_back(index);
+    siftUp(static_cast<uint32_t>(mHeap.size() - 1));
+}
+
+bool AstarSearch::decreaseCost(uint32_t index, uint32_t parent, double g)
+{
+    Node& node = mNodes[index];
+    if(g >= node.mG)
+        return false;
+
+    node.mParent = parent;
+    node.mG = g;
+    node.mOrder = mOrder++;
+
+    // The cost can only decrease so the node can only go up in the heap
+    siftUp(node.mHeapPos);
+    return true;
+}
+
+bool AstarSearch::popBest(uint32_t& index)
+{
+    if(mHeap.empty())
+        return false;
+
+    index = mHeap.front();
+    mNodes[index].mHeapPos = NO_NODE;
+
+    uint32_t last = mHeap.back();
+    mHeap.pop_back();
+    if(mHeap.empty())
+        return true;
+
+    placeInHeap(0, last);
+    siftDown(0);
+    return true;
+}
+
+void AstarSearch::siftUp(uint32_t heapPos)
+{
+    uint32_t index = mHeap[heapPos];
+    const Node& node = mNodes[index];
+    while(heapPos > 0)
+    {
+        uint32_t parentPos = (heapPos - 1) / 2;
+        uint32_t parentIndex = mHeap[parentPos];
+        if(!isBefore(node, mNodes[parentIndex]))
+            break;
+
+        placeInHeap(heapPos, parentIndex);
+        heapPos = parentPos;
+    }
+    placeInHeap(heapPos, index);
+}
+
+void AstarSearch::siftDown(uint32_t heapPos)
+{
+    uint32_t index = mHeap[heapPos];
+    const Node& node = mNodes[index];
+    uint32_t heapSize = static_cast<uint32_t>(mHeap.size());
+    while(true)
+    {
+        uint32_t childPos = 2 * heapPos + 1;
+        if(childPos >= heapSize)
+            break;
+
+        // We take the best of the 2 children
+        if((childPos + 1 < heapSize) &&
+           isBefore(mNodes[mHeap[childPos + 1]], mNodes[mHeap[childPos]]))
+        {
+            ++childPos;
+        }
+
+        uint32_t childIndex = mHeap[childPos];
+        if(!isBefore(mNodes[childIndex], node))
+            break;
+
+        placeInHeap(heapPos, childIndex);
+        heapPos = childPos;
+    }
+    placeInHeap(heapPos, index);
+}
+
+void AstarSearch::placeInHeap(uint32_t heapPos, uint32_t index)
+{
+    mHeap[heapPos] = index;
+    mNodes[index].mHeapPos = heapPos;
+}
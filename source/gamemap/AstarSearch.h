@@ -0,0 +1,117 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASTARSEARCH_H
+#define ASTARSEARCH_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Reusable storage for the A* search done in GameMap::path.
+ *
+ * Nodes are stored in a flat array indexed by (y * mapSizeX + x). Instead of clearing
+ * the array before each search, every node is stamped with the generation of the search
+ * that last touched it: a node with an old generation is considered as never visited.
+ * The open list is a binary heap over node indexes with decrease-key support.
+ *
+ * Entries with the same fCost are popped in the order they were inserted (or last had their
+ * cost decreased) so that the computed paths are the same as with the previous sorted list.
+ */
+class AstarSearch
+{
+public:
+    static const uint32_t NO_NODE;
+
+    AstarSearch();
+
+    //! \brief Prepares a new search on a map with the given size. The nodes from the previous
+    //! search are invalidated without being cleared.
+    void startSearch(int mapSizeX, int mapSizeY);
+
+    inline uint32_t nodeIndex(int x, int y) const
+    { return static_cast<uint32_t>(y * mMapSizeX + x); }
+
+    inline int nodeX(uint32_t index) const
+    { return static_cast<int>(index) % mMapSizeX; }
+
+    inline int nodeY(uint32_t index) const
+    { return static_cast<int>(index) / mMapSizeX; }
+
+    //! \brief Returns true if the node has been added to the open list during the current search
+    inline bool isVisited(uint32_t index) const
+    { return mNodes[index].mGeneration == mGeneration; }
+
+    //! \brief Returns true if the node has already been popped from the open list during the current search
+    inline bool isClosed(uint32_t index) const
+    { return isVisited(index) && (mNodes[index].mHeapPos == NO_NODE); }
+
+    inline double getG(uint32_t index) const
+    { return mNodes[index].mG; }
+
+    inline uint32_t getParent(uint32_t index) const
+    { return mNodes[index].mParent; }
+
+    //! \brief Adds a node that has not been visited yet to the open list
+    void open(uint32_t index, uint32_t parent, double g, double h);
+
+    //! \brief Updates the cost of a node in the open list if g is lower than its
+    //! current cost. Returns true if the node has been updated
+    bool decreaseCost(uint32_t index, uint32_t parent, double g);
+
+    //! \brief Removes the node with the lowest fCost from the open list and closes it.
+    //! Returns false if the open list is empty
+    bool popBest(uint32_t& index);
+
+private:
+    struct Node
+    {
+        uint32_t mGeneration;
+        uint32_t mParent;
+        uint32_t mHeapPos;
+        uint64_t mOrder;
+        double mG;
+        double mH;
+    };
+
+    int mMapSizeX;
+    uint32_t mGeneration;
+
+    //! \brief Incremented each time a node is pushed or reordered in the heap. Used to
+    //! break ties between nodes with the same fCost
+    uint64_t mOrder;
+
+    std::vector<Node> mNodes;
+
+    //! \brief Binary heap of node indexes. The first element is the node with the lowest fCost
+    std::vector<uint32_t> mHeap;
+
+    inline bool isBefore(const Node& n1, const Node& n2) const
+    {
+        double f1 = n1.mG + n1.mH;
+        double f2 = n2.mG + n2.mH;
+        if(f1 != f2)
+            return f1 < f2;
+
+        return n1.mOrder < n2.mOrder;
+    }
+
+    void siftUp(uint32_t heapPos);
+    void siftDown(uint32_t heapPos);
+    void placeInHeap(uint32_t heapPos, uint32_t index);
+};
+
+#endif // ASTARSEARCH_H
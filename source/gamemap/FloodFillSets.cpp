@@ -0,0 +1,63 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/FloodFillSets.h"
+
+uint32_t FloodFillSets::find(uint32_t value) const
+{
+    while((value < mParents.size()) && (mParents[value] != value))
+        value = mParents[value];
+
+    return value;
+}
+
+uint32_t FloodFillSets::unite(uint32_t value1, uint32_t value2)
+{
+    uint32_t root1 = find(value1);
+    uint32_t root2 = find(value2);
+    if(root1 == root2)
+        return root1;
+
+    uint32_t maxRoot = (root1 > root2) ? root1 : root2;
+    if(maxRoot >= mParents.size())
+    {
+        uint32_t oldSize = static_cast<uint32_t>(mParents.size());
+        mParents.resize(maxRoot + 1);
+        mRanks.resize(maxRoot + 1, 0);
+        for(uint32_t i = oldSize; i <= maxRoot; ++i)
+            mParents[i] = i;
+    }
+
+    // The tree with the lower rank is attached to the other one
+    if(mRanks[root1] < mRanks[root2])
+    {
+        mParents[root1] = root2;
+        return root2;
+    }
+
+    mParents[root2] = root1;
+    if(mRanks[root1] == mRanks[root2])
+        ++mRanks[root1];
+
+    return root1;
+}
+
+void FloodFillSets::clear()
+{
+    mParents.clear();
+    mRanks.clear();
+}
@@ -0,0 +1,52 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLOODFILLSETS_H
+#define FLOODFILLSETS_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Disjoint sets (union-find) over floodfill values.
+ *
+ * When 2 areas get connected (a tile is dug, a door is unlocked, a bridge is built, ...), their floodfill
+ * values are merged in the same set instead of relabeling every tile of one area. The floodfill of a
+ * tile is then the representative of the set containing its value.
+ * Values that were never merged are their own representative so there is no need to register them.
+ * Note that find does not compress paths so that it can be used on a const object. Union by rank keeps
+ * the trees shallow anyway.
+ */
+class FloodFillSets
+{
+public:
+    //! \brief Returns the representative of the set containing value
+    uint32_t find(uint32_t value) const;
+
+    //! \brief Merges the sets containing value1 and value2. Returns the representative of the merged set
+    uint32_t unite(uint32_t value1, uint32_t value2);
+
+    //! \brief Every value becomes its own representative again
+    void clear();
+
+private:
+    //! \brief Parent of each value. A value is a representative if it is its own parent. Values
+    //! out of the vector are representatives
+    std::vector<uint32_t> mParents;
+    std::vector<uint8_t> mRanks;
+};
+
+#endif // FLOODFILLSETS_H
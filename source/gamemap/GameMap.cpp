@@ -29,6 +29,7 @@
 #include "creaturemood/CreatureMood.h"
 #include "entities/Creature.h"
 #include "entities/CreatureDefinition.h"
+#include "entities/DoorEntity.h"
 #include "entities/GameEntityType.h"
 #include "entities/MapLight.h"
 #include "entities/RenderedMovableEntity.h"
@@ -38,7 +39,10 @@
 #include "game/Skill.h"
 #include "game/SkillType.h"
 #include "game/Seat.h"
+#include "gamemap/AstarSearch.h"
+#include "gamemap/HierarchicalPathfinding.h"
 #include "gamemap/MapHandler.h"
+#include "gamemap/PathCache.h"
 #include "gamemap/Pathfinding.h"
 #include "gamemap/TileSet.h"
 #include "goals/Goal.h"
@@ -55,100 +59,42 @@
 #include "spells/Spell.h"
 #include "sound/SoundEffectsManager.h"
 #include "traps/Trap.h"
+#include "traps/TrapDoor.h"
 #include "traps/TrapManager.h"
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/ResourceManager.h"
+#include "utils/WorkerPool.h"
 
-#include <OgreTimer.h>
+#include <SFML/System/Clock.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <ctime>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 
 const std::string DEFAULT_NICK = "You";
 
-using namespace std;
-
-/*! \brief A helper class for the A* search in the GameMap::path function.
-*
-* This class stores the requisite information about a tile which is placed in
-* the search queue for the A-star, or A*, algorithm which is used to
-* calculate paths in the path function.
-*
-* The A* description can be found here:
-* http://en.wikipedia.org/wiki/A*_search_algorithm
-*/
-class AstarEntry
-{
-public:
-    AstarEntry() :
-        tile    (nullptr),
-        parent  (nullptr),
-        g       (0.0),
-        h       (0.0)
-    {}
-
-    AstarEntry(Tile* tile, int x1, int y1, int x2, int y2) :
-        mHasBeenProcessed (false),
-        tile    (tile),
-        parent  (nullptr),
-        g       (0.0),
-        h       (0.0)
-    {
-        h = computeHeuristic(x1, y1, x2, y2);
-    }
-
-    static double computeHeuristic(const int& x1, const int& y1, const int& x2, const int& y2)
-    {
-        return fabs(static_cast<double>(x2 - x1)) + fabs(static_cast<double>(y2 - y1));
-    }
-
-    void setHeuristic(const int& x1, const int& y1, const int& x2, const int& y2)
-    {
-        h = fabs(static_cast<double>(x2 - x1)) + fabs(static_cast<double>(y2 - y1));
-    }
-
-    inline double fCost() const
-    { return g + h; }
-
-    inline Tile* getTile() const
-    { return tile; }
-
-    inline bool getHasBeenProcessed() const
-    { return mHasBeenProcessed; }
-
-    inline void setHasBeenProcessed()
-    { mHasBeenProcessed = true; }
+//! \brief Number of clusters refined into a tile path by GameMap::pathToWaypoint. Paths shorter than
+//! that are computed entirely
+const int NB_CLUSTERS_REFINED = 3;
 
-    inline void setTile(Tile* newTile)
-    { tile = newTile; }
+//! \brief Maximum number of paths kept by the path cache
+const uint32_t PATH_CACHE_CAPACITY = 512;
 
-    inline AstarEntry* getParent() const
-    { return parent; }
-
-    inline void setParent(AstarEntry* newParent)
-    { parent = newParent; }
-
-    inline const double& getG() const
-    { return g; }
-
-    inline void setG(const double& newG)
-    { g = newG; }
-
-private:
-    bool        mHasBeenProcessed;
-    Tile*       tile;
-    AstarEntry* parent;
-    double      g;
-    double      h;
-};
+using namespace std;
 
+//! \brief Manhattan distance used as heuristic and as weight between 2 tiles in the A* search
+static double computeAstarHeuristic(int x1, int y1, int x2, int y2)
+{
+    return fabs(static_cast<double>(x2 - x1)) + fabs(static_cast<double>(y2 - y1));
+}
 
 GameMap::GameMap(bool isServerGameMap) :
         TileContainer(isServerGameMap ? 15 : 0),
@@ -156,15 +102,22 @@ GameMap::GameMap(bool isServerGameMap) :
         mLocalPlayer(nullptr),
         mLocalPlayerNick(DEFAULT_NICK),
         mTurnNumber(-1),
+        mSeed(0),
+        mHasLevelSeed(false),
         mIsPaused(false),
         mTimePayDay(0),
         mFloodFillEnabled(false),
         mIsFOWActivated(true),
         mNumCallsTo_path(0),
+        mHierarchicalPathfinding(getTileStore(), mFloodFillSets),
+        mPathCache(PATH_CACHE_CAPACITY),
+        mVisionTracker(getTileStore(), *this),
+        mNbEntityVisionEvents(0),
         mAiManager(*this),
         mTileSet(nullptr)
 {
     resetUniqueNumbers();
+    setSeed(static_cast<uint64_t>(std::time(0)));
 }
 
 GameMap::~GameMap()
@@ -271,7 +224,14 @@ void GameMap::clearAll()
     processDeletionQueues();
 
     clearTiles();
+    mTilesEntitiesVisionChanged.clear();
     processDeletionQueues();
+    // The cached paths reference the deleted tiles
+    mPathCache.clear();
+    mHierarchicalPathfinding.invalidateAll();
+    mVisionTracker.clear();
+    mSavedFloodFillTeamIds.clear();
+    mSavedFloodFillValues.clear();
 
     clearGoalsForAllSeats();
     clearSeats();
@@ -285,6 +245,7 @@ void GameMap::clearAll()
     resetUniqueNumbers();
     mIsFOWActivated = true;
     mTimePayDay = 0;
+    mHasLevelSeed = false;
 
     // We check if the different vectors are empty
     if(!mActiveObjects.empty())
@@ -401,6 +362,8 @@ void GameMap::resetUniqueNumbers()
     mUniqueNumberTrap = 0;
     mUniqueNumberMapLight = 0;
     mUniqueFloodFillValue = 0;
+    // The floodfill values will be reused
+    mFloodFillSets.clear();
 }
 
 void GameMap::addClassDescription(const CreatureDefinition *c)
@@ -1076,6 +1039,8 @@ void GameMap::doTurn(double timeSinceLastTurn)
 {
     OD_LOG_INF("Computing turn " + Helper::toString(mTurnNumber) + ", timeSinceLastTurn=" + Helper::toString(timeSinceLastTurn));
     unsigned int numCallsTo_path_atStart = mNumCallsTo_path;
+    uint32_t numPathCacheHits_atStart = mPathCache.getNbHits();
+    uint32_t numPathCacheMisses_atStart = mPathCache.getNbMisses();
 
     uint32_t miscUpkeepTime = doMiscUpkeep(timeSinceLastTurn);
 
@@ -1088,7 +1053,9 @@ void GameMap::doTurn(double timeSinceLastTurn)
     }
 
     OD_LOG_INF("During this turn there were " + Helper::toString(mNumCallsTo_path - numCallsTo_path_atStart)
-        + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
+        + " calls to GameMap::path() (cache hits=" + Helper::toString(mPathCache.getNbHits() - numPathCacheHits_atStart)
+        + ", misses=" + Helper::toString(mPathCache.getNbMisses() - numPathCacheMisses_atStart)
+        + "), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
 }
 
 void GameMap::doPlayerAITurn(double timeSinceLastTurn)
@@ -1098,8 +1065,7 @@ void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 
 unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
 {
-    Tile *tempTile;
-    Ogre::Timer stopwatch;
+    sf::Clock stopwatch;
     unsigned long int timeTaken;
 
     // We check if it is pay day
@@ -1116,23 +1082,10 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
                 continue;
 
             // We notify the player if he owns a fighter only
-            bool isCreatureSeat = false;
-            for(Creature* creature : mCreatures)
-            {
-                if(creature->getSeat() != player->getSeat())
-                    continue;
-
-                if(creature->getDefinition()->isWorker())
-                    continue;
-
-                isCreatureSeat = true;
-                break;
-            }
-
-            if(!isCreatureSeat)
+            if(player->getSeat()->getNumCreaturesFighters() <= 0)
                 continue;
 
-            ServerNotification *serverNotification = new ServerNotification(
+            ServerNotification *serverNotification = ServerNotification::acquire(
                 ServerNotificationType::chatServer, player);
             serverNotification->mPacket << "It's pay day !" << EventShortNoticeType::majorGameEvent;
             ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -1159,52 +1112,22 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
         if (seat->checkAllGoals() == 0 && seat->numFailedGoals() == 0)
             addWinningSeat(seat);
 
+        // The number of workers and fighters is kept up to date by the creatures (see Creature::updateSeatCount)
         seat->mNumCreaturesFightersMax = getMaxNumberCreatures(seat);
-
-        // Set the creatures count to 0. It will be reset by the next count in doTurn()
-        seat->mNumCreaturesFighters = 0;
-        seat->mNumCreaturesWorkers = 0;
     }
 
-    // Count how many creatures the player controls
-    for(Creature* creature : mCreatures)
-    {
-        // Check to see if the creature has died.
-        if (!creature->isAlive())
-            continue;
-
-        Seat *tempSeat = creature->getSeat();
-        if(tempSeat == nullptr)
-            continue;
-
-        // We only count fighters
-        if (creature->getDefinition()->isWorker())
-            ++(tempSeat->mNumCreaturesWorkers);
-        else
-            ++(tempSeat->mNumCreaturesFighters);
-    }
-
-    // At each upkeep, we re-compute tiles with vision
+    // Vision is updated incrementally: tiles only notify the seats when they gain or lose a vision
+    // source. We need to compute every seats including AI because a human can be allied with an AI
+    // and they would share vision
     for (Seat* seat : mSeats)
-        seat->clearTilesWithVision();
+        seat->refreshForcedTilesVision();
 
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            getTile(ii,jj)->clearVision();
-        }
-    }
+    // If the FOW is deactivated, we allow vision for every seat
+    std::vector<int32_t> seatIds;
+    for (Seat* seat : mSeats)
+        seatIds.push_back(seat->getId());
 
-    // Compute vision. We need to compute every seats including AI because
-    // a human can be allied with an AI and they would share vision
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            getTile(ii,jj)->computeVisibleTiles();
-        }
-    }
+    mVisionTracker.beginTurn(!getIsFOWActivated(), seatIds);
 
     for (Creature* creature : mCreatures)
     {
@@ -1216,6 +1139,8 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
         spell->computeVisibleTiles();
     }
 
+    mVisionTracker.endTurn();
+
     for (Seat* seat : mSeats)
     {
         if(!seat->getIsDebuggingVision())
@@ -1228,15 +1153,24 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
     for (Seat* seat : mSeats)
         seat->sendVisibleTiles();
 
+    // The creatures look around before acting. Every creature sees the game map as it is at the
+    // beginning of the upkeep whatever the order the creatures act in
+    senseCreatures();
+
     // Carry out the upkeep round of all the active objects in the game.
     // Here, we work on a copy of the active objects list because they might
     // try to remove themselves which would break the iterator
+    // Each entity uses its own random stream so that the result does not depend on the upkeep order
     std::vector<GameEntity*> activeObjects = mActiveObjects;
     for(GameEntity* ge : activeObjects)
+    {
+        Random::ScopedStream randomScope(ge->getRandomStream());
         ge->doUpkeep();
+    }
 
-    // Carry out the upkeep round for each seat. This means recomputing how much gold is
-    // available in their treasuries, how much mana they gain/lose during this turn, etc.
+    // Carry out the upkeep round for each seat. This means computing how much mana they gain/lose
+    // during this turn, etc. The gold available in their treasuries is kept up to date by the
+    // treasuries themselves (see RoomTreasury::updateSeatGold)
     for (Seat* seat : mSeats)
     {
         if(seat->getPlayer() == nullptr)
@@ -1258,42 +1192,13 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             if (seat->mMana > maxMana)
                 seat->mMana = maxMana;
         }
-
-        // Update the count on how much gold is available in all of the treasuries claimed by the given seat.
-        seat->mGold = 0;
-        seat->mGoldMax = 0;
-        for (Room* room : getRooms())
-        {
-            if(room->getSeat() != seat)
-                continue;
-
-            seat->mGold += room->getTotalGoldStored();
-            seat->mGoldMax += room->getTotalGoldStorage();
-        }
     }
 
-    // Determine the number of tiles claimed by each seat.
-    // Begin by setting the number of claimed tiles for each seat to 0.
+    // The number of tiles claimed by each seat is counted by the TileStore when the tiles change
     for (Seat* seat : mSeats)
-        seat->setNumClaimedTiles(0);
+        seat->setNumClaimedTiles(getTileStore().getNbClaimedTiles(seat->getId()));
 
-    // Now loop over all of the tiles, if the tile is claimed increment the given seats count.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            tempTile = getTile(ii,jj);
-
-            // Check to see if the current tile is claimed by anyone.
-            if (tempTile->isClaimed())
-            {
-                // Increment the count of the seat who owns the tile.
-                tempTile->getSeat()->incrementNumClaimedTiles();
-            }
-        }
-    }
-
-    timeTaken = stopwatch.getMicroseconds();
+    timeTaken = stopwatch.getElapsedTime().asMicroseconds();
     return timeTaken;
 }
 
@@ -1310,6 +1215,208 @@ void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
         mge->update(timeSinceLastFrame);
 }
 
+void GameMap::setSeed(uint64_t seed)
+{
+    mSeed = seed;
+    mRandomStream.setSeed(RandomStream::deriveSeed(seed, "GameMap"));
+}
+
+RandomStream GameMap::createRandomStream(const std::string& key) const
+{
+    return RandomStream(RandomStream::deriveSeed(mSeed, key));
+}
+
+namespace
+{
+    //! \brief FNV-1a hash used to build the state hash
+    class StateHasher
+    {
+    public:
+        StateHasher() :
+            mHash(0xCBF29CE484222325ULL)
+        {}
+
+        void add(const void* data, std::size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                mHash ^= bytes[i];
+                mHash *= 0x100000001B3ULL;
+            }
+        }
+
+        template<typename T>
+        void add(const T& value)
+        { add(&value, sizeof(T)); }
+
+        void add(const std::string& value)
+        { add(value.data(), value.size()); }
+
+        inline uint64_t getHash() const
+        { return mHash; }
+
+    private:
+        uint64_t mHash;
+    };
+}
+
+void GameMap::senseCreatures()
+{
+    mSensingCreatures.clear();
+    for(Creature* creature : mCreatures)
+    {
+        if(!creature->canSeeSurroundings())
+            continue;
+
+        mSensingCreatures.push_back(creature);
+    }
+
+    if(mSenseWorkers == nullptr)
+    {
+        for(Creature* creature : mSensingCreatures)
+            creature->senseSurroundings();
+
+        return;
+    }
+
+    mSenseWorkers->parallelFor(static_cast<uint32_t>(mSensingCreatures.size()), [this](uint32_t index)
+    {
+        mSensingCreatures[index]->senseSurroundings();
+    });
+}
+
+void GameMap::setNbSenseWorkers(uint32_t nbWorkers)
+{
+    if(nbWorkers == 0)
+    {
+        mSenseWorkers.reset();
+        return;
+    }
+
+    if((mSenseWorkers != nullptr) && (mSenseWorkers->getNbWorkers() == nbWorkers))
+        return;
+
+    mSenseWorkers.reset(new WorkerPool(nbWorkers));
+}
+
+uint64_t GameMap::computeStateHash() const
+{
+    StateHasher hasher;
+    hasher.add(mTurnNumber);
+
+    const TileStore& tileStore = getTileStore();
+    for (uint32_t index = 0; index < tileStore.getNbTiles(); ++index)
+    {
+        hasher.add(static_cast<uint32_t>(tileStore.getType(index)));
+        hasher.add(tileStore.getFullness(index));
+        hasher.add(tileStore.getClaimedPercentage(index));
+        hasher.add(tileStore.getSeatId(index));
+    }
+
+    for (const Seat* seat : mSeats)
+    {
+        hasher.add(seat->getId());
+        hasher.add(seat->getGold());
+        hasher.add(seat->getMana());
+        hasher.add(seat->getNumClaimedTiles());
+    }
+
+    for (const Creature* creature : mCreatures)
+    {
+        hasher.add(creature->getName());
+        const Ogre::Vector3& position = creature->getPosition();
+        hasher.add(static_cast<double>(position.x));
+        hasher.add(static_cast<double>(position.y));
+        hasher.add(static_cast<double>(position.z));
+        hasher.add(creature->getHP());
+        hasher.add(creature->getLevel());
+        hasher.add(creature->getSeat() == nullptr ? -1 : creature->getSeat()->getId());
+    }
+
+    for (const Room* room : mRooms)
+    {
+        hasher.add(room->getName());
+        hasher.add(room->numCoveredTiles());
+    }
+
+    for (const Trap* trap : mTraps)
+        hasher.add(trap->getName());
+
+    for (const GameEntity* entity : mRenderedMovableEntities)
+        hasher.add(entity->getName());
+
+    for (const Spell* spell : mSpells)
+        hasher.add(spell->getName());
+
+    return hasher.getHash();
+}
+
+bool GameMap::checkSeatStatistics() const
+{
+    bool isConsistent = true;
+    const TileStore& tileStore = getTileStore();
+    for (const Seat* seat : mSeats)
+    {
+        uint32_t nbClaimedTiles = 0;
+        for (uint32_t index = 0; index < tileStore.getNbTiles(); ++index)
+        {
+            if (tileStore.isClaimed(index) && (tileStore.getSeatId(index) == seat->getId()))
+                ++nbClaimedTiles;
+        }
+
+        int nbWorkers = 0;
+        int nbFighters = 0;
+        for (const Creature* creature : mCreatures)
+        {
+            if ((creature->getSeat() != seat) || !creature->isAlive())
+                continue;
+
+            if (creature->getDefinition()->isWorker())
+                ++nbWorkers;
+            else
+                ++nbFighters;
+        }
+
+        int gold = 0;
+        int goldMax = 0;
+        for (const Room* room : mRooms)
+        {
+            if (room->getSeat() != seat)
+                continue;
+
+            gold += room->getTotalGoldStored();
+            goldMax += room->getTotalGoldStorage();
+        }
+
+        if (nbClaimedTiles != tileStore.getNbClaimedTiles(seat->getId()))
+        {
+            OD_LOG_ERR("seatId=" + Helper::toString(seat->getId()) + ", claimed tiles="
+                + Helper::toString(tileStore.getNbClaimedTiles(seat->getId())) + ", counted=" + Helper::toString(nbClaimedTiles));
+            isConsistent = false;
+        }
+
+        if ((nbWorkers != seat->mNumCreaturesWorkers) || (nbFighters != seat->mNumCreaturesFighters))
+        {
+            OD_LOG_ERR("seatId=" + Helper::toString(seat->getId())
+                + ", workers=" + Helper::toString(seat->mNumCreaturesWorkers) + ", counted=" + Helper::toString(nbWorkers)
+                + ", fighters=" + Helper::toString(seat->mNumCreaturesFighters) + ", counted=" + Helper::toString(nbFighters));
+            isConsistent = false;
+        }
+
+        // In editor mode, the seat gold is the starting gold
+        if (!isInEditorMode() && ((gold != seat->mGold) || (goldMax != seat->mGoldMax)))
+        {
+            OD_LOG_ERR("seatId=" + Helper::toString(seat->getId())
+                + ", gold=" + Helper::toString(seat->mGold) + ", counted=" + Helper::toString(gold)
+                + ", goldMax=" + Helper::toString(seat->mGoldMax) + ", counted=" + Helper::toString(goldMax));
+            isConsistent = false;
+        }
+    }
+
+    return isConsistent;
+}
+
 void GameMap::playerIsFighting(Player* player, Tile* tile)
 {
     if (player == nullptr)
@@ -1336,6 +1443,18 @@ void GameMap::playerIsFighting(Player* player, Tile* tile)
 
 std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
     Tile*& chosenTile)
+{
+    chosenTile = nullptr;
+    std::vector<Tile*> reachedTiles;
+    std::list<Tile*> returnList = pathToClosestTiles(creature, tileStart, possibleDests, 1, reachedTiles);
+    if(!reachedTiles.empty())
+        chosenTile = reachedTiles.front();
+
+    return returnList;
+}
+
+std::list<Tile*> GameMap::findBestPathSeparateSearches(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
+    Tile*& chosenTile)
 {
     chosenTile = nullptr;
     std::list<Tile*> returnList;
@@ -1381,17 +1500,8 @@ std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart
     return returnList;
 }
 
-bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd)
+FloodFillType GameMap::getFloodFillTypeForCreature(const Creature* creature) const
 {
-    // If floodfill is not enabled, we cannot check if the path exists so we return true
-    if(!mFloodFillEnabled)
-        return true;
-
-    // We check if the tile we are heading to is walkable. We don't do the same for the start tile because it might
-    //not be the case if a creature is on a door tile while it is closed
-    if(creature == nullptr)
-        return false;
-
     FloodFillType floodFill = FloodFillType::ground;
     if((creature->getMoveSpeedGround() > 0.0) &&
         (creature->getMoveSpeedWater() > 0.0) &&
@@ -1410,6 +1520,21 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
         floodFill = FloodFillType::groundLava;
     }
 
+    return floodFill;
+}
+
+bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd)
+{
+    // If floodfill is not enabled, we cannot check if the path exists so we return true
+    if(!mFloodFillEnabled)
+        return true;
+
+    // We check if the tile we are heading to is walkable. We don't do the same for the start tile because it might
+    //not be the case if a creature is on a door tile while it is closed
+    if(creature == nullptr)
+        return false;
+
+    FloodFillType floodFill = getFloodFillTypeForCreature(creature);
     if(creature->getDefinition()->isWorker())
     {
         // Workers can go on a tile if and only if the path is open for any creature. If it is closed, that
@@ -1454,202 +1579,249 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
     if (!throughDiggableTiles && !pathExists(creature, start, destination))
         return returnList;
 
-    AstarEntry *currentEntry = new AstarEntry(start, x1, y1, x2, y2);
-    AstarEntry neighbor;
-
-    std::vector<AstarEntry*> openList;
-    openList.push_back(currentEntry);
-
-    // This list will contain the processed and the to process entries
-    // allowing to quickly know if a tile has been processed or not
-    std::vector<std::vector<AstarEntry*>> processList(getMapSizeX(), std::vector<AstarEntry*>(getMapSizeY(), nullptr));
-    processList[currentEntry->getTile()->getX()][currentEntry->getTile()->getY()] = currentEntry;
-    AstarEntry* destinationEntry = nullptr;
-    while (true)
+    if(mPathQueriesRecord != nullptr)
     {
-        // if the openList is empty we failed to find a path
-        if (openList.empty())
-            break;
+        *mPathQueriesRecord << x1 << "\t" << y1 << "\t" << x2 << "\t" << y2 << "\t"
+            << creature->getDefinition()->getClassName() << "\t"
+            << (seat == nullptr ? 0 : seat->getId()) << "\t" << throughDiggableTiles << "\n";
+    }
 
-        // openList being sorted, the last element is the smallest
-        auto smallestAstar = openList.rbegin();
-        openList.pop_back();
+    // Paths through diggable tiles are not cached
+    PathCacheKey cacheKey;
+    bool useCache = !throughDiggableTiles && getPathCacheKey(creature, start, destination, cacheKey);
+    if(useCache && mPathCache.getPath(cacheKey, returnList))
+        return returnList;
 
-        currentEntry = *smallestAstar;
-        currentEntry->setHasBeenProcessed();
+    // The search uses a flat array and a binary heap that are kept between calls. See AstarSearch
+    // for more details.
+    mAstarSearch.startSearch(getMapSizeX(), getMapSizeY());
+    uint32_t startIndex = mAstarSearch.nodeIndex(x1, y1);
+    uint32_t destinationIndex = mAstarSearch.nodeIndex(x2, y2);
+    mAstarSearch.open(startIndex, AstarSearch::NO_NODE, 0.0, computeAstarHeuristic(x1, y1, x2, y2));
 
+    uint32_t currentIndex;
+    while (mAstarSearch.popBest(currentIndex))
+    {
         // We found the path, break out of the search loop
-        if (currentEntry->getTile() == destination)
-        {
-            destinationEntry = currentEntry;
-            break;
-        }
-
-        // Check the tiles surrounding the current square
-        bool areTilesPassable[4] = {false, false, false, false};
-        // Note : to disable diagonals, process tiles from 0 to 3. To allow them, process tiles from 0 to 7
-        for (unsigned int i = 0; i < 8; ++i)
-        {
-            Tile* neighborTile = nullptr;
-            switch(i)
-            {
-                // We process the 4 adjacent tiles
-                case 0:
-                    neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY());
-                    break;
-                case 1:
-                    neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY());
-                    break;
-                case 2:
-                    neighborTile = getTile(currentEntry->getTile()->getX(), currentEntry->getTile()->getY() - 1);
-                    break;
-                case 3:
-                    neighborTile = getTile(currentEntry->getTile()->getX(), currentEntry->getTile()->getY() + 1);
-                    break;
-                // We process the 4 diagonal tiles. We only process a diagonal tile if the 2 tiles adjacent to the original one are
-                // passable.
-                case 4:
-                    if(areTilesPassable[0] && areTilesPassable[2])
-                        neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY() - 1);
-                    break;
-                case 5:
-                    if(areTilesPassable[0] && areTilesPassable[3])
-                        neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY() + 1);
-                    break;
-                case 6:
-                    if(areTilesPassable[1] && areTilesPassable[2])
-                        neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY() - 1);
-                    break;
-                case 7:
-                    if(areTilesPassable[1] && areTilesPassable[3])
-                        neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY() + 1);
-                    break;
-                default:
-                    break;
-            }
-            if(neighborTile == nullptr)
-                continue;
+        if (currentIndex == destinationIndex)
+            return buildSearchPath(destinationIndex, useCache, cacheKey);
 
-            neighbor.setTile(neighborTile);
+        expandPathNode(creature, seat, start, throughDiggableTiles, currentIndex, destination);
+    }
 
-            bool processNeighbor = false;
-            // We process the tile if the creature can go through. But if it is the first tile that is
-            // not passable, we also process it. That happens if a door is closed
-            if((creature->canGoThroughTile(neighbor.getTile())) ||
-               (neighbor.getTile() == start))
-            {
-                processNeighbor = true;
-                // We set passability for the 4 adjacent tiles only
-                if(i < 4)
-                    areTilesPassable[i] = true;
-             }
-            else if(throughDiggableTiles && neighbor.getTile()->isDiggable(seat))
-                processNeighbor = true;
-
-            if (!processNeighbor)
-                continue;
+    return returnList;
+}
 
-            // See if the neighbor has already been processed
-            AstarEntry* neighborEntry = processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()];
-            if ((neighborEntry != nullptr) && (neighborEntry->getHasBeenProcessed()))
-                continue;
+std::list<Tile*> GameMap::pathToClosestTiles(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
+    uint32_t nbTargets, std::vector<Tile*>& reachedTiles)
+{
+    ++mNumCallsTo_path;
+    reachedTiles.clear();
+    std::list<Tile*> returnList;
+    if((creature == nullptr) || (tileStart == nullptr) || (nbTargets == 0))
+        return returnList;
 
-            // If the neighbor is not in the open list
-            if (neighborEntry == nullptr)
-            {
-                double weightToParent = AstarEntry::computeHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(),
-                    currentEntry->getTile()->getX(), currentEntry->getTile()->getY());
-
-                if(currentEntry->getTile()->getFullness() == 0)
-                    weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
-                else
-                    weightToParent /= creature->getMoveSpeedGround();
-                neighbor.setG(currentEntry->getG() + weightToParent);
-
-                // Use the manhattan distance for the heuristic
-                neighbor.setHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(), x2, y2);
-                neighbor.setParent(currentEntry);
-
-                AstarEntry* entry = new AstarEntry(neighbor);
-                auto itr = openList.begin();
-                while((itr != openList.end()) &&
-                      ((*itr)->fCost() > entry->fCost()))
-                {
-                    ++itr;
-                }
+    // We only keep the destinations that may be reachable according to the floodfill
+    std::vector<uint32_t> targets;
+    for(Tile* tile : possibleDests)
+    {
+        if(!pathExists(creature, tileStart, tile))
+            continue;
 
-                openList.insert(itr, entry);
-                processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()] = entry;
-            }
-            else
-            {
-                // If this path to the given neighbor tile is a shorter path than the
-                // one already given, make this the new parent.
-                double weightToParent = AstarEntry::computeHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(),
-                    currentEntry->getTile()->getX(), currentEntry->getTile()->getY());
+        targets.push_back(static_cast<uint32_t>(tile->getY() * getMapSizeX() + tile->getX()));
+    }
 
-                if(currentEntry->getTile()->getFullness() == 0)
-                    weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
-                else
-                    weightToParent /= creature->getMoveSpeedGround();
+    if(targets.empty())
+        return returnList;
 
-                if (currentEntry->getG() + weightToParent < neighborEntry->getG())
-                {
-                    neighborEntry->setG(currentEntry->getG() + weightToParent);
-                    neighborEntry->setParent(currentEntry);
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
 
-                    // The cost changed. We need to re-order openList
-                    auto itr = std::find(openList.begin(), openList.end(), neighborEntry);
-                    if(itr == openList.end())
-                    {
-                        OD_LOG_ERR("Unexpected entry not found tileStart=" + Tile::displayAsString(start)
-                            + ", tileDest=" + Tile::displayAsString(destination)
-                            + ", tile=" + Tile::displayAsString(neighborEntry->getTile()));
-                    }
-                    else
-                    {
-                        itr = openList.erase(itr);
-                        // We look for the new location
-                        while((itr != openList.end()) &&
-                              ((*itr)->fCost() > neighborEntry->fCost()))
-                        {
-                            ++itr;
-                        }
-
-                        openList.insert(itr, neighborEntry);
-                    }
-                }
-            }
-        }
-    }
+    // Without heuristic, the A* search behaves like Dijkstra's algorithm: tiles are closed by increasing
+    // walking cost so the first target popped is the closest one
+    mAstarSearch.startSearch(getMapSizeX(), getMapSizeY());
+    uint32_t startIndex = mAstarSearch.nodeIndex(tileStart->getX(), tileStart->getY());
+    mAstarSearch.open(startIndex, AstarSearch::NO_NODE, 0.0, 0.0);
 
-    if (destinationEntry != nullptr)
+    uint32_t currentIndex;
+    while (mAstarSearch.popBest(currentIndex))
     {
-        // Follow the parent chain back the the starting tile
-        AstarEntry* curEntry = destinationEntry;
-        do
+        if(std::binary_search(targets.begin(), targets.end(), currentIndex))
         {
-            if (curEntry->getTile() != nullptr)
-            {
-                returnList.push_front(curEntry->getTile());
-                curEntry = curEntry->getParent();
-            }
+            Tile* tile = getTile(mAstarSearch.nodeX(currentIndex), mAstarSearch.nodeY(currentIndex));
+            // The path is not cached: it may differ from the one path() finds for the same tiles when
+            // several paths have the same cost so path() would not always return the same path
+            if(reachedTiles.empty())
+                returnList = buildSearchPath(currentIndex, false, PathCacheKey());
 
-        } while (curEntry != nullptr);
-    }
+            reachedTiles.push_back(tile);
+            if((reachedTiles.size() >= nbTargets) || (reachedTiles.size() >= targets.size()))
+                break;
+        }
 
-    // Clean up the memory we allocated by deleting the astarEntries.  Note that
-    // processList contains all the created entries so it is enough to clean it.
-    for (std::vector<AstarEntry*>& column : processList)
-    {
-        for (AstarEntry* entry : column)
-            delete entry;
+        expandPathNode(creature, creature->getSeat(), tileStart, false, currentIndex, nullptr);
     }
 
     return returnList;
 }
 
-bool GameMap::addPlayer(Player* player)
+bool GameMap::getPathCacheKey(const Creature* creature, Tile* start, Tile* destination, PathCacheKey& cacheKey)
+{
+    // Paths that only depend on the creature movement class and seat are shared between creatures.
+    // Paths for fighting or fleeing creatures are not cached because their passability differs on
+    // locked doors: enemy creatures go through them unless they are fighting or fleeing (see
+    // TrapDoor::getCreatureSpeed). The key does not hold the creature actions
+    if((creature->getSeat() == nullptr) ||
+       creature->isActionInList(CreatureActionType::fight) ||
+       creature->isActionInList(CreatureActionType::flee))
+    {
+        return false;
+    }
+
+    cacheKey.mStartX = start->getX();
+    cacheKey.mStartY = start->getY();
+    cacheKey.mDestX = destination->getX();
+    cacheKey.mDestY = destination->getY();
+    cacheKey.mSeatId = creature->getSeat()->getId();
+    cacheKey.mFloodFillType = static_cast<uint32_t>(getFloodFillTypeForCreature(creature));
+    cacheKey.mMoveSpeedGround = creature->getMoveSpeedGround();
+    cacheKey.mMoveSpeedWater = creature->getMoveSpeedWater();
+    cacheKey.mMoveSpeedLava = creature->getMoveSpeedLava();
+    mPathCache.setMapSize(getMapSizeX(), getMapSizeY());
+    return true;
+}
+
+void GameMap::expandPathNode(const Creature* creature, Seat* seat, Tile* start, bool throughDiggableTiles,
+    uint32_t currentIndex, const Tile* destination)
+{
+    int currentX = mAstarSearch.nodeX(currentIndex);
+    int currentY = mAstarSearch.nodeY(currentIndex);
+    Tile* currentTile = getTile(currentX, currentY);
+
+    // The weight to go from the current tile to a neighbor only depends on the current tile
+    double moveSpeed;
+    if(currentTile->getFullness() == 0)
+        moveSpeed = creature->getMoveSpeed(currentTile);
+    else
+        moveSpeed = creature->getMoveSpeedGround();
+
+    // Check the tiles surrounding the current square
+    bool areTilesPassable[4] = {false, false, false, false};
+    // Note : to disable diagonals, process tiles from 0 to 3. To allow them, process tiles from 0 to 7
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        Tile* neighborTile = nullptr;
+        switch(i)
+        {
+            // We process the 4 adjacent tiles
+            case 0:
+                neighborTile = getTile(currentX - 1, currentY);
+                break;
+            case 1:
+                neighborTile = getTile(currentX + 1, currentY);
+                break;
+            case 2:
+                neighborTile = getTile(currentX, currentY - 1);
+                break;
+            case 3:
+                neighborTile = getTile(currentX, currentY + 1);
+                break;
+            // We process the 4 diagonal tiles. We only process a diagonal tile if the 2 tiles adjacent to the original one are
+            // passable.
+            case 4:
+                if(areTilesPassable[0] && areTilesPassable[2])
+                    neighborTile = getTile(currentX - 1, currentY - 1);
+                break;
+            case 5:
+                if(areTilesPassable[0] && areTilesPassable[3])
+                    neighborTile = getTile(currentX - 1, currentY + 1);
+                break;
+            case 6:
+                if(areTilesPassable[1] && areTilesPassable[2])
+                    neighborTile = getTile(currentX + 1, currentY - 1);
+                break;
+            case 7:
+                if(areTilesPassable[1] && areTilesPassable[3])
+                    neighborTile = getTile(currentX + 1, currentY + 1);
+                break;
+            default:
+                break;
+        }
+        if(neighborTile == nullptr)
+            continue;
+
+        bool processNeighbor = false;
+        // We process the tile if the creature can go through. But if it is the first tile that is
+        // not passable, we also process it. That happens if a door is closed
+        if((creature->canGoThroughTile(neighborTile)) ||
+           (neighborTile == start))
+        {
+            processNeighbor = true;
+            // We set passability for the 4 adjacent tiles only
+            if(i < 4)
+                areTilesPassable[i] = true;
+         }
+        else if(throughDiggableTiles && neighborTile->isDiggable(seat))
+            processNeighbor = true;
+
+        if (!processNeighbor)
+            continue;
+
+        // See if the neighbor has already been processed
+        uint32_t neighborIndex = mAstarSearch.nodeIndex(neighborTile->getX(), neighborTile->getY());
+        if (mAstarSearch.isClosed(neighborIndex))
+            continue;
+
+        double weightToParent = computeAstarHeuristic(neighborTile->getX(), neighborTile->getY(),
+            currentX, currentY);
+        weightToParent /= moveSpeed;
+        double g = mAstarSearch.getG(currentIndex) + weightToParent;
+
+        // If the neighbor is not in the open list, we add it. Otherwise, if this path to the given
+        // neighbor tile is a shorter path than the one already given, we make this the new parent.
+        if (!mAstarSearch.isVisited(neighborIndex))
+        {
+            // Use the manhattan distance for the heuristic
+            double h = 0.0;
+            if(destination != nullptr)
+                h = computeAstarHeuristic(neighborTile->getX(), neighborTile->getY(), destination->getX(), destination->getY());
+
+            mAstarSearch.open(neighborIndex, currentIndex, g, h);
+        }
+        else
+        {
+            mAstarSearch.decreaseCost(neighborIndex, currentIndex, g);
+        }
+    }
+}
+
+std::list<Tile*> GameMap::buildSearchPath(uint32_t destinationIndex, bool useCache, const PathCacheKey& cacheKey)
+{
+    std::list<Tile*> returnList;
+
+    // Follow the parent chain back the the starting tile
+    int minX = mAstarSearch.nodeX(destinationIndex);
+    int minY = mAstarSearch.nodeY(destinationIndex);
+    int maxX = minX;
+    int maxY = minY;
+    for(uint32_t index = destinationIndex; index != AstarSearch::NO_NODE; index = mAstarSearch.getParent(index))
+    {
+        int x = mAstarSearch.nodeX(index);
+        int y = mAstarSearch.nodeY(index);
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+        returnList.push_front(getTile(x, y));
+    }
+
+    if(useCache)
+        mPathCache.addPath(cacheKey, returnList, minX, minY, maxX, maxY);
+
+    return returnList;
+}
+
+bool GameMap::addPlayer(Player* player)
 {
     mPlayers.push_back(player);
     OD_LOG_INF(serverStr() + "Added player: " + player->getNick());
@@ -1702,9 +1874,58 @@ Player* GameMap::getPlayerBySeat(Seat* seat) const
     return nullptr;
 }
 
+namespace
+{
+    //! \brief Returns the mask (see SeatRegionIndex) of the seats allied with seat or, if enemy is true, of the others
+    uint64_t getSeatsMask(const std::vector<Seat*>& seats, const Seat* seat, bool enemy)
+    {
+        uint64_t mask = 0;
+        for(const Seat* otherSeat : seats)
+        {
+            if(otherSeat->isAlliedSeat(seat) == enemy)
+                continue;
+
+            mask |= SeatRegionIndex::seatBit(otherSeat->getId());
+        }
+        return mask;
+    }
+
+    //! \brief Adds to entities the alive creatures on tile allied with seat or, if enemy is true, the enemy
+    //! ones that can be attacked. Same as Tile::fillWithEntities with creatureAliveAllied or creatureAliveEnemyAttackable
+    void addCreaturesOnTile(Tile* tile, Seat* seat, bool enemy, std::vector<GameEntity*>& entities)
+    {
+        for(GameEntity* entity : tile->getEntitiesInTile())
+        {
+            if(entity->getObjectType() != GameEntityType::creature)
+                continue;
+
+            if(entity->getSeat() == nullptr)
+                continue;
+
+            if(seat->isAlliedSeat(entity->getSeat()) == enemy)
+                continue;
+
+            Creature* creature = static_cast<Creature*>(entity);
+            if(!creature->isAlive())
+                continue;
+
+            if(enemy && !creature->isAttackable(tile, seat))
+                continue;
+
+            entities.push_back(entity);
+        }
+    }
+}
+
 std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce)
 {
     std::vector<GameEntity*> returnList;
+    // Buildings already added, sorted to find them quickly. Most of the time, a building covers
+    // several visible tiles
+    std::vector<Building*> buildings;
+
+    const SeatRegionIndex& seatRegionIndex = getSeatRegionIndex();
+    uint64_t seatsWanted = getSeatsMask(mSeats, seat, enemyForce);
 
     // Loop over the visible tiles
     for (Tile* tile : visibleTiles)
@@ -1715,29 +1936,28 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
             continue;
         }
 
-        if(enemyForce)
-        {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer());
-            Building* building = tile->getCoveringBuilding();
-            if((building != nullptr) &&
-               (!building->getSeat()->isAlliedSeat(seat)) &&
-               (building->isAttackable(tile, seat)) &&
-               (std::find(returnList.begin(), returnList.end(), building) == returnList.end()))
-            {
-                returnList.push_back(building);
-            }
-        }
-        else
-        {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer());
-            Building* building = tile->getCoveringBuilding();
-            if((building != nullptr) &&
-               (building->getSeat()->isAlliedSeat(seat)) &&
-               (std::find(returnList.begin(), returnList.end(), building) == returnList.end()))
-            {
-                returnList.push_back(building);
-            }
-        }
+        // We skip the tiles of the regions without creature or building of the seats we look for
+        if((seatRegionIndex.getSeatsAt(tile->getX(), tile->getY()) & seatsWanted) == 0)
+            continue;
+
+        addCreaturesOnTile(tile, seat, enemyForce, returnList);
+
+        Building* building = tile->getCoveringBuilding();
+        if(building == nullptr)
+            continue;
+
+        if(building->getSeat()->isAlliedSeat(seat) == enemyForce)
+            continue;
+
+        if(enemyForce && !building->isAttackable(tile, seat))
+            continue;
+
+        std::vector<Building*>::iterator it = std::lower_bound(buildings.begin(), buildings.end(), building);
+        if((it != buildings.end()) && (*it == building))
+            continue;
+
+        buildings.insert(it, building);
+        returnList.push_back(building);
     }
 
     return returnList;
@@ -1747,6 +1967,9 @@ std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>&
 {
     std::vector<GameEntity*> returnList;
 
+    const SeatRegionIndex& seatRegionIndex = getSeatRegionIndex();
+    uint64_t seatsWanted = getSeatsMask(mSeats, seat, enemyCreatures);
+
     // Loop over the visible tiles
     for (Tile* tile : visibleTiles)
     {
@@ -1756,14 +1979,10 @@ std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>&
             continue;
         }
 
-        if(enemyCreatures)
-        {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveEnemyAttackable, seat->getPlayer());
-        }
-        else
-        {
-            tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer());
-        }
+        if((seatRegionIndex.getSeatsAt(tile->getX(), tile->getY()) & seatsWanted) == 0)
+            continue;
+
+        addCreaturesOnTile(tile, seat, enemyCreatures, returnList);
     }
 
     return returnList;
@@ -2111,7 +2330,7 @@ void GameMap::addWinningSeat(Seat *s)
     Player* player = getPlayerBySeat(s);
     if (player && player->getIsHuman())
     {
-        ServerNotification* serverNotification = new ServerNotification(
+        ServerNotification* serverNotification = ServerNotification::acquire(
             ServerNotificationType::chatServer, player);
         serverNotification->mPacket << "You Won" << EventShortNoticeType::majorGameEvent;
         ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -2152,68 +2371,29 @@ void GameMap::clearGoalsForAllSeats()
     mGoalsForAllSeats.clear();
 }
 
-bool GameMap::doFloodFill(Seat* seat, Tile* tile)
+void GameMap::replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew)
 {
-    if (!mFloodFillEnabled)
-        return false;
-
-    if(tile->isFloodFillFilled(seat))
-        return false;
+    if((colorOld == Tile::NO_FLOODFILL) || (colorNew == Tile::NO_FLOODFILL))
+        return;
 
-    bool hasChanged = false;
-    // If a neigboor is colored with the same colors, we color the tile
-    for(Tile* neigh : tile->getAllNeighbors())
+    uint32_t index = seat->getTeamIndex() * static_cast<uint32_t>(FloodFillType::nbValues) + static_cast<uint32_t>(floodFillType);
+    if(index >= mFloodFillSets.size())
     {
-        // TODO: check if this can be optimized with Tile::isFloodFillPossible
-        switch(tile->getType())
-        {
-            case TileType::dirt:
-            case TileType::gold:
-            case TileType::rock:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::ground, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWater, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundLava, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            case TileType::water:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWater, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            case TileType::lava:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundLava, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            default:
-                continue;
-        }
-
-        // If the tile is fully filled, no need to continue
-        if(tile->isFloodFillFilled(seat))
-            return true;
+        OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
+            + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", type=" + Tile::toString(floodFillType));
+        return;
     }
 
-    return hasChanged;
+    mFloodFillSets[index].unite(colorOld, colorNew);
 }
 
-void GameMap::replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew)
+uint32_t GameMap::findFloodFillValue(Seat* seat, FloodFillType floodFillType, uint32_t value) const
 {
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            Tile* tile = getTile(ii,jj);
-            if(tile->getFloodFillValue(seat, floodFillType) != colorOld)
-                continue;
+    uint32_t index = seat->getTeamIndex() * static_cast<uint32_t>(FloodFillType::nbValues) + static_cast<uint32_t>(floodFillType);
+    if(index >= mFloodFillSets.size())
+        return value;
 
-            tile->replaceFloodFill(seat, floodFillType, colorNew);
-        }
-    }
+    return mFloodFillSets[index].find(value);
 }
 
 void GameMap::refreshFloodFill(Seat* seat, Tile* tile)
@@ -2276,15 +2456,8 @@ void GameMap::refreshFloodFill(Seat* seat, Tile* tile)
 
 void GameMap::enableFloodFill()
 {
-    // Carry out a flood fill of the whole level to make sure everything is good.
-    // Start by setting the flood fill color for every tile on the map to -1.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            getTile(ii,jj)->resetFloodFill();
-        }
-    }
+    // Floodfill will be computed again for every tile
+    mHierarchicalPathfinding.invalidateAll();
 
     // The algorithm used to find a path is efficient when the path exists but not if it doesn't.
     // To improve path finding, we tag the contiguous tiles to know if a path exists between 2 tiles or not.
@@ -2292,153 +2465,176 @@ void GameMap::enableFloodFill()
     // Note : when a tile is digged, floodfill will have to be refreshed.
     mFloodFillEnabled = true;
 
-    // To optimize floodfilling, we start by tagging the dirt tiles with fullness = 0
-    // because they are walkable for most creatures. When we will have tagged all
-    // thoses, we will deal with water/lava remaining (there can be some left if
-    // surrounded by not passable tiles).
-    FloodFillType currentType = FloodFillType::ground;
-    // We do the floodfill for the rogue seat. Then, once it is done, we copy for the other seats.
-    // If there are locked doors, floodfill will be refreshed when they are added
-    Seat* rogueSeat = getSeatRogue();
-    while(true)
+    sf::Clock stopwatch;
+
+    // Every tile gets a new value so no value is merged anymore
+    uint32_t nbFloodFillTypes = static_cast<uint32_t>(FloodFillType::nbValues);
+    mFloodFillSets.clear();
+    mFloodFillSets.resize(mTeamIds.size() * nbFloodFillTypes);
+
+    // In a savegame, the teams cannot change so the saved floodfill is still valid
+    if(restoreSavedFloodFill())
     {
-        int yy = 0;
+        OD_LOG_INF("Floodfill restored in " + Helper::toString(static_cast<uint32_t>(stopwatch.getElapsedTime().asMicroseconds())) + " us");
+        return;
+    }
 
-        bool isTileFound;
-        isTileFound = false;
-        while(!isTileFound && (yy < getMapSizeY()))
-        {
-            for(int xx = 0; xx < getMapSizeX(); ++xx)
+    // We do the floodfill for the rogue seat. Then, once it is done, we copy for the other seats.
+    // If there are locked doors, floodfill will be refreshed when they are added.
+    // For each type, we merge in a single pass each tile with its left and top neighboors (the tiles are
+    // identified by their index). Then, we give a new floodfill value to each set
+    Seat* rogueSeat = getSeatRogue();
+    int mapSizeX = getMapSizeX();
+    int mapSizeY = getMapSizeY();
+    uint32_t nbTiles = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    FloodFillSets tileSets;
+    std::vector<uint32_t> setValues;
+    for(uint32_t intType = 0; intType < nbFloodFillTypes; ++intType)
+    {
+        FloodFillType type = static_cast<FloodFillType>(intType);
+        tileSets.clear();
+        for(int yy = 0; yy < mapSizeY; ++yy)
+        {
+            for(int xx = 0; xx < mapSizeX; ++xx)
             {
                 Tile* tile = getTile(xx, yy);
-                if(tile->getFullness() > 0.0)
+                if(!tile->isFloodFillPossible(rogueSeat, type))
                     continue;
 
-                if(currentType == FloodFillType::ground)
-                {
-                    if(((tile->getType() == TileType::dirt) ||
-                        (tile->getType() == TileType::gold) ||
-                        (tile->getType() == TileType::rock)) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::ground) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::ground) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::ground, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWater, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundLava, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
-                }
-                else if(currentType == FloodFillType::groundWater)
-                {
-                    if((tile->getType() == TileType::water) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWater, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
-                }
-                else if(currentType == FloodFillType::groundLava)
-                {
-                    if((tile->getType() == TileType::lava) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundLava, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
-                }
+                uint32_t index = static_cast<uint32_t>(yy * mapSizeX + xx);
+                if((xx > 0) && getTile(xx - 1, yy)->isFloodFillPossible(rogueSeat, type))
+                    tileSets.unite(index, index - 1);
+                if((yy > 0) && getTile(xx, yy - 1)->isFloodFillPossible(rogueSeat, type))
+                    tileSets.unite(index, index - static_cast<uint32_t>(mapSizeX));
             }
-
-            if(!isTileFound)
-                ++yy;
         }
 
-        // If there are no more walkable tiles, we go for water. Then, for lava. After that, floodfill should be complete
-        if(!isTileFound)
+        setValues.assign(nbTiles, Tile::NO_FLOODFILL);
+        for(int yy = 0; yy < mapSizeY; ++yy)
         {
-            switch(currentType)
+            for(int xx = 0; xx < mapSizeX; ++xx)
             {
-                case FloodFillType::ground:
-                {
-                    // There are no more ground tiles. We go for water tiles
-                    currentType = FloodFillType::groundWater;
-                    isTileFound = true;
-                    break;
-                }
-                case FloodFillType::groundWater:
-                {
-                    // There are no more ground tiles. We go for water tiles
-                    currentType = FloodFillType::groundLava;
-                    isTileFound = true;
-                    break;
-                }
-                case FloodFillType::groundLava:
+                Tile* tile = getTile(xx, yy);
+                if(!tile->isFloodFillPossible(rogueSeat, type))
                 {
-                    // There are no more tiles. We can stop
-                    break;
+                    tile->replaceFloodFill(rogueSeat, type, Tile::NO_FLOODFILL);
+                    continue;
                 }
-                default:
-                    OD_LOG_ERR("Unexpected enum value=" + Tile::toString(currentType));
-                    break;
+
+                uint32_t& value = setValues[tileSets.find(static_cast<uint32_t>(yy * mapSizeX + xx))];
+                if(value == Tile::NO_FLOODFILL)
+                    value = nextUniqueFloodFillValue();
+
+                tile->replaceFloodFill(rogueSeat, type, value);
             }
         }
+    }
 
-        if(!isTileFound)
-            break;
+    // We copy floodfill for all seats
+    for(int xx = 0; xx < mapSizeX; ++xx)
+    {
+        for(int yy = 0; yy < mapSizeY; ++yy)
+        {
+            Tile* tile = getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->copyFloodFillToOtherSeats(rogueSeat);
+        }
+    }
+
+    OD_LOG_INF("Floodfill computed in " + Helper::toString(static_cast<uint32_t>(stopwatch.getElapsedTime().asMicroseconds())) + " us");
+}
 
-        while(yy < getMapSizeY())
+bool GameMap::exportFloodFill(std::vector<uint32_t>& values) const
+{
+    if(!mFloodFillEnabled)
+        return false;
+
+    const TileStore& tileStore = getTileStore();
+    uint32_t nbFloodFillTypes = static_cast<uint32_t>(FloodFillType::nbValues);
+    int mapSizeX = getMapSizeX();
+    int mapSizeY = getMapSizeY();
+    uint32_t nbTiles = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    uint32_t nbTeams = static_cast<uint32_t>(mTeamIds.size());
+    values.assign(nbTeams * nbFloodFillTypes * nbTiles, Tile::NO_FLOODFILL);
+    for(uint32_t teamIndex = 0; teamIndex < nbTeams; ++teamIndex)
+    {
+        for(int xx = 0; xx < mapSizeX; ++xx)
         {
-            int nbTiles = 0;
-            for(int xx = 0; xx < getMapSizeX(); ++xx)
+            for(int yy = 0; yy < mapSizeY; ++yy)
             {
-                Tile* tile = getTile(xx, yy);
-                if(doFloodFill(rogueSeat, tile))
-                    ++nbTiles;
-            }
+                const uint32_t* tileValues = tileStore.getFloodFillValues(tileStore.getIndex(xx, yy), teamIndex);
+                if(tileValues == nullptr)
+                    return false;
 
-            // For optimization purposes, if a tile has changed, we go on the other side
-            if(nbTiles > 0)
-            {
-                for(int xx = getMapSizeX() - 1; xx >= 0; --xx)
+                // Same layout as in LevelSnapshot
+                uint32_t snapshotIndex = static_cast<uint32_t>(xx * mapSizeY + yy);
+                for(uint32_t intType = 0; intType < nbFloodFillTypes; ++intType)
                 {
-                    Tile* tile = getTile(xx, yy);
-                    if(doFloodFill(rogueSeat, tile))
-                        ++nbTiles;
+                    uint32_t setsIndex = teamIndex * nbFloodFillTypes + intType;
+                    uint32_t value = tileValues[intType];
+                    if((value != Tile::NO_FLOODFILL) && (setsIndex < mFloodFillSets.size()))
+                        value = mFloodFillSets[setsIndex].find(value);
+
+                    values[setsIndex * nbTiles + snapshotIndex] = value;
                 }
             }
-
-            // If at least one tile as been changed, we go back to the previous line
-            if((nbTiles > 0) && (yy > 0))
-                --yy;
-            else
-                ++yy;
         }
     }
 
-    // We copy floodfill for all seats
-    for(int xx = 0; xx < getMapSizeX(); ++xx)
+    return true;
+}
+
+void GameMap::setSavedFloodFill(std::vector<int> teamIds, std::vector<uint32_t> values)
+{
+    mSavedFloodFillTeamIds.swap(teamIds);
+    mSavedFloodFillValues.swap(values);
+}
+
+bool GameMap::restoreSavedFloodFill()
+{
+    std::vector<int> teamIds;
+    std::vector<uint32_t> values;
+    teamIds.swap(mSavedFloodFillTeamIds);
+    values.swap(mSavedFloodFillValues);
+    if(values.empty())
+        return false;
+
+    uint32_t nbFloodFillTypes = static_cast<uint32_t>(FloodFillType::nbValues);
+    int mapSizeX = getMapSizeX();
+    int mapSizeY = getMapSizeY();
+    uint32_t nbTiles = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    if((teamIds != mTeamIds) || (values.size() != teamIds.size() * nbFloodFillTypes * nbTiles))
     {
-        for(int yy = 0; yy < getMapSizeY(); ++yy)
-        {
-            Tile* tile = getTile(xx, yy);
-            if(tile == nullptr)
-                continue;
+        OD_LOG_WRN("The saved floodfill does not match the teams, it will be computed");
+        return false;
+    }
 
-            tile->copyFloodFillToOtherSeats(rogueSeat);
+    TileStore& tileStore = getTileStore();
+    uint32_t nbTeams = static_cast<uint32_t>(mTeamIds.size());
+    uint32_t maxValue = 0;
+    for(uint32_t teamIndex = 0; teamIndex < nbTeams; ++teamIndex)
+    {
+        for(int xx = 0; xx < mapSizeX; ++xx)
+        {
+            for(int yy = 0; yy < mapSizeY; ++yy)
+            {
+                uint32_t* tileValues = tileStore.getFloodFillValues(tileStore.getIndex(xx, yy), teamIndex);
+                uint32_t snapshotIndex = static_cast<uint32_t>(xx * mapSizeY + yy);
+                for(uint32_t intType = 0; intType < nbFloodFillTypes; ++intType)
+                {
+                    uint32_t value = values[(teamIndex * nbFloodFillTypes + intType) * nbTiles + snapshotIndex];
+                    tileValues[intType] = value;
+                    maxValue = std::max(maxValue, value);
+                }
+            }
         }
     }
+
+    // The new areas should not get a value already used
+    mUniqueFloodFillValue = std::max(mUniqueFloodFillValue, maxValue);
+    return true;
 }
 
 std::list<Tile*> GameMap::path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
@@ -2466,6 +2662,77 @@ std::list<Tile*> GameMap::path(const Creature* creature, Tile* destination, bool
                 creature, creature->getSeat(), throughDiggableTiles);
 }
 
+std::list<Tile*> GameMap::pathToWaypoint(const Creature* creature, Tile* destination, Tile*& waypoint)
+{
+    waypoint = destination;
+    if (destination == nullptr)
+        return std::list<Tile*>();
+
+    Tile* positionTile = creature->getPositionTile();
+    if (positionTile == nullptr)
+        return std::list<Tile*>();
+
+    // For short paths or if we cannot rely on floodfill, we compute the full path
+    int distClusters = std::max(
+        std::abs(HierarchicalPathfinding::clusterCoord(destination->getX()) - HierarchicalPathfinding::clusterCoord(positionTile->getX())),
+        std::abs(HierarchicalPathfinding::clusterCoord(destination->getY()) - HierarchicalPathfinding::clusterCoord(positionTile->getY())));
+    if(!mFloodFillEnabled || (distClusters <= NB_CLUSTERS_REFINED))
+        return path(creature, destination);
+
+    if(!pathExists(creature, positionTile, destination))
+        return std::list<Tile*>();
+
+    std::vector<uint32_t> waypoints;
+    if(!mHierarchicalPathfinding.findAbstractPath(creature->getSeat()->getTeamIndex(), getFloodFillTypeForCreature(creature),
+        positionTile->getX(), positionTile->getY(), destination->getX(), destination->getY(), waypoints))
+    {
+        return path(creature, destination);
+    }
+
+    // We only refine the path to the first waypoint far enough. The creature will ask for
+    // the next part when it reaches it
+    for(uint32_t index : waypoints)
+    {
+        waypoint = getTile(static_cast<int>(index) % getMapSizeX(), static_cast<int>(index) / getMapSizeX());
+        int dist = std::max(
+            std::abs(HierarchicalPathfinding::clusterCoord(waypoint->getX()) - HierarchicalPathfinding::clusterCoord(positionTile->getX())),
+            std::abs(HierarchicalPathfinding::clusterCoord(waypoint->getY()) - HierarchicalPathfinding::clusterCoord(positionTile->getY())));
+        if(dist >= NB_CLUSTERS_REFINED)
+            break;
+    }
+
+    std::list<Tile*> result = path(creature, waypoint);
+    if(!result.empty())
+        return result;
+
+    // The abstract graph only relies on floodfill. If the creature cannot go to the waypoint (a locked
+    // door for example), we try the full path
+    waypoint = destination;
+    return path(creature, destination);
+}
+
+void GameMap::tilePassabilityChanged(Tile& tile)
+{
+    mHierarchicalPathfinding.tileChanged(tile.getX(), tile.getY());
+    mPathCache.tileChanged(tile.getX(), tile.getY());
+    // Passability and opacity change together (full tiles, doors)
+    refreshTileOpacity(tile);
+    mVisionTracker.tileOpacityChanged(tile.getX(), tile.getY());
+}
+
+void GameMap::seatVisionChanged(int x, int y, int32_t seatId, bool hasVision)
+{
+    Tile* tile = getTile(x, y);
+    Seat* seat = getSeatById(seatId);
+    if((tile == nullptr) || (seat == nullptr))
+    {
+        OD_LOG_ERR("x=" + Helper::toString(x) + ", y=" + Helper::toString(y) + ", seatId=" + Helper::toString(seatId));
+        return;
+    }
+
+    tile->seatVisionChanged(seat, hasVision);
+}
+
 void GameMap::processDeletionQueues()
 {
     for(GameEntity* entity : mEntitiesToDelete)
@@ -2733,6 +3000,24 @@ void GameMap::consoleSetCreatureDestination(const std::string& creatureName, int
     creature->setDestination(tile);
 }
 
+bool GameMap::consoleToggleDoor(int x, int y)
+{
+    Tile* tile = getTile(x, y);
+    if(tile == nullptr)
+        return false;
+
+    Trap* trap = tile->getCoveringTrap();
+    if((trap == nullptr) || !trap->isDoor())
+        return false;
+
+    DoorEntity* doorEntity = static_cast<TrapDoor*>(trap)->getDoorEntity(tile);
+    if(doorEntity == nullptr)
+        return false;
+
+    doorEntity->slap();
+    return true;
+}
+
 void GameMap::consoleToggleCreatureVisualDebug(const std::string& creatureName)
 {
     Creature* creature = getCreature(creatureName);
@@ -2788,6 +3073,239 @@ void GameMap::consoleAskUnlockSkills()
     }
 }
 
+void GameMap::consoleRecordPathQueries(const std::string& fileName)
+{
+    if(mPathQueriesRecord != nullptr)
+    {
+        OD_LOG_INF("Stopped recording path queries");
+        mPathQueriesRecord.reset();
+    }
+
+    if(fileName.empty())
+        return;
+
+    mPathQueriesRecord.reset(new std::ofstream(fileName.c_str()));
+    if(!mPathQueriesRecord->is_open())
+    {
+        OD_LOG_ERR("Cannot open file to record path queries=" + fileName);
+        mPathQueriesRecord.reset();
+        return;
+    }
+
+    OD_LOG_INF("Recording path queries in file=" + fileName);
+}
+
+void GameMap::consoleBenchmarkPathQueries(const std::string& fileName, uint32_t nbIterations)
+{
+    std::ifstream file(fileName.c_str());
+    if(!file.is_open())
+    {
+        OD_LOG_ERR("Cannot open path queries file=" + fileName);
+        return;
+    }
+
+    // We replay every query with a creature of the recorded class (and seat if possible)
+    // because the path depends on the creature speeds and passability
+    struct PathQuery
+    {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+        const Creature* creature;
+        Seat* seat;
+        bool throughDiggableTiles;
+    };
+    std::vector<PathQuery> queries;
+    uint32_t nbSkipped = 0;
+    PathQuery query;
+    std::string className;
+    int seatId;
+    while(file >> query.x1 >> query.y1 >> query.x2 >> query.y2 >> className >> seatId >> query.throughDiggableTiles)
+    {
+        query.creature = nullptr;
+        for(Creature* creature : mCreatures)
+        {
+            if(creature->getDefinition()->getClassName() != className)
+                continue;
+
+            query.creature = creature;
+            if(creature->getSeat()->getId() == seatId)
+                break;
+        }
+        query.seat = getSeatById(seatId);
+        if((query.creature == nullptr) || (query.seat == nullptr))
+        {
+            ++nbSkipped;
+            continue;
+        }
+        queries.push_back(query);
+    }
+
+    if(nbIterations == 0)
+        nbIterations = 1;
+
+    uint64_t nbTiles = 0;
+    uint32_t nbEmptyPaths = 0;
+    sf::Clock stopwatch;
+    for(uint32_t i = 0; i < nbIterations; ++i)
+    {
+        // Each iteration starts with an empty cache to measure the same thing
+        mPathCache.clear();
+        for(const PathQuery& q : queries)
+        {
+            std::list<Tile*> result = path(q.x1, q.y1, q.x2, q.y2, q.creature, q.seat, q.throughDiggableTiles);
+            nbTiles += result.size();
+            if(result.empty())
+                ++nbEmptyPaths;
+        }
+    }
+    uint64_t timeTaken = stopwatch.getElapsedTime().asMicroseconds();
+
+    OD_LOG_INF("Path benchmark file=" + fileName + ", queries=" + Helper::toString(static_cast<uint32_t>(queries.size()))
+        + ", skipped=" + Helper::toString(nbSkipped) + ", iterations=" + Helper::toString(nbIterations)
+        + ", emptyPaths=" + Helper::toString(nbEmptyPaths) + ", tiles=" + Helper::toString(nbTiles)
+        + ", totalTimeUs=" + Helper::toString(timeTaken));
+}
+
+void GameMap::consoleBenchmarkFindBestPath(uint32_t nbIterations)
+{
+    // For each creature, we look for the best path to the tiles of the rooms of its seat like
+    // the creatures do when they look for a job, a bed or food
+    std::vector<std::pair<Creature*, std::vector<Tile*>>> queries;
+    uint64_t nbDests = 0;
+    for(Creature* creature : mCreatures)
+    {
+        if((creature->getPositionTile() == nullptr) || (creature->getSeat() == nullptr))
+            continue;
+
+        std::vector<Tile*> tiles;
+        for(Room* room : mRooms)
+        {
+            if(room->getSeat() != creature->getSeat())
+                continue;
+
+            for(Tile* tile : room->getCoveredTiles())
+                tiles.push_back(tile);
+        }
+
+        if(tiles.empty())
+            continue;
+
+        nbDests += tiles.size();
+        queries.push_back(std::make_pair(creature, tiles));
+    }
+
+    if(nbIterations == 0)
+        nbIterations = 1;
+
+    // The paths are compared without cache
+    uint64_t nbTilesSeparate = 0;
+    uint64_t nbTilesSingle = 0;
+    uint32_t nbDifferentChoices = 0;
+    uint64_t timeSeparate = 0;
+    uint64_t timeSingle = 0;
+    sf::Clock stopwatch;
+    for(uint32_t i = 0; i < nbIterations; ++i)
+    {
+        for(const std::pair<Creature*, std::vector<Tile*>>& query : queries)
+        {
+            Tile* chosenSeparate;
+            Tile* chosenSingle;
+
+            mPathCache.clear();
+            stopwatch.restart();
+            std::list<Tile*> pathSeparate = findBestPathSeparateSearches(query.first, query.first->getPositionTile(),
+                query.second, chosenSeparate);
+            timeSeparate += stopwatch.getElapsedTime().asMicroseconds();
+
+            mPathCache.clear();
+            stopwatch.restart();
+            std::list<Tile*> pathSingle = findBestPath(query.first, query.first->getPositionTile(),
+                query.second, chosenSingle);
+            timeSingle += stopwatch.getElapsedTime().asMicroseconds();
+
+            nbTilesSeparate += pathSeparate.size();
+            nbTilesSingle += pathSingle.size();
+            if(chosenSeparate != chosenSingle)
+                ++nbDifferentChoices;
+        }
+    }
+
+    OD_LOG_INF("Best path benchmark queries=" + Helper::toString(static_cast<uint32_t>(queries.size()))
+        + ", destinations=" + Helper::toString(nbDests) + ", iterations=" + Helper::toString(nbIterations)
+        + ", separateSearchesTimeUs=" + Helper::toString(timeSeparate) + ", separateSearchesTiles=" + Helper::toString(nbTilesSeparate)
+        + ", singleSearchTimeUs=" + Helper::toString(timeSingle) + ", singleSearchTiles=" + Helper::toString(nbTilesSingle)
+        + ", differentChoices=" + Helper::toString(nbDifferentChoices));
+}
+
+void GameMap::consoleBenchmarkVisibleTiles(uint32_t nbIterations)
+{
+    if(nbIterations == 0)
+        nbIterations = 1;
+
+    const OpacityBitmap& opacity = getOpacityBitmap();
+    std::vector<Tile*> tiles;
+    std::vector<std::pair<int, int>> tilesReference;
+    sf::Clock stopwatch;
+    for(int radius = 5; radius <= 20; ++radius)
+    {
+        // We build the tables before measuring
+        mVisibilityKernel.buildTileDistance(radius);
+
+        uint32_t nbOrigins = 0;
+        uint32_t nbDifferences = 0;
+        uint64_t nbTiles = 0;
+        uint64_t nbTilesReference = 0;
+        uint64_t timeKernel = 0;
+        uint64_t timeReference = 0;
+        for(int yy = 0; yy < getMapSizeY(); ++yy)
+        {
+            for(int xx = 0; xx < getMapSizeX(); ++xx)
+            {
+                if(opacity.isOpaque(xx, yy))
+                    continue;
+
+                ++nbOrigins;
+                for(uint32_t i = 0; i < nbIterations; ++i)
+                {
+                    stopwatch.restart();
+                    visibleTiles(xx, yy, radius, tiles);
+                    timeKernel += stopwatch.getElapsedTime().asMicroseconds();
+
+                    stopwatch.restart();
+                    mVisibilityKernel.computeVisibleTilesReference(opacity, xx, yy, radius, tilesReference);
+                    timeReference += stopwatch.getElapsedTime().asMicroseconds();
+                }
+
+                nbTiles += tiles.size();
+                nbTilesReference += tilesReference.size();
+                if(tiles.size() != tilesReference.size())
+                {
+                    ++nbDifferences;
+                    continue;
+                }
+
+                for(uint32_t k = 0; k < tiles.size(); ++k)
+                {
+                    if((tiles[k]->getX() != tilesReference[k].first) ||
+                       (tiles[k]->getY() != tilesReference[k].second))
+                    {
+                        ++nbDifferences;
+                        break;
+                    }
+                }
+            }
+        }
+
+        OD_LOG_INF("Visible tiles benchmark radius=" + Helper::toString(radius) + ", origins=" + Helper::toString(nbOrigins)
+            + ", iterations=" + Helper::toString(nbIterations)
+            + ", kernelTimeUs=" + Helper::toString(timeKernel) + ", kernelTiles=" + Helper::toString(nbTiles)
+            + ", referenceTimeUs=" + Helper::toString(timeReference) + ", referenceTiles=" + Helper::toString(nbTilesReference)
+            + ", differences=" + Helper::toString(nbDifferences));
+    }
+}
+
 Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 {
     for (Creature* creature : mCreatures)
@@ -2803,15 +3321,16 @@ Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 
 void GameMap::updateVisibleEntities()
 {
-    // Notify what happened to entities on visible tiles
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            Tile* tile = getTile(ii,jj);
-            tile->notifyEntitiesSeatsWithVision();
-        }
-    }
+    // Notify what happened to entities on the tiles where the vision or the entities changed. The
+    // list is swapped because the notifications may queue tiles for the next update
+    mNbEntityVisionEvents = 0;
+    std::vector<Tile*> tiles;
+    tiles.swap(mTilesEntitiesVisionChanged);
+    for (Tile* tile : tiles)
+        tile->notifyEntitiesSeatsWithVision();
+
+    OD_LOG_DBG(serverStr() + "Entities vision updated on " + Helper::toString(static_cast<uint32_t>(tiles.size()))
+        + " tiles, events=" + Helper::toString(mNbEntityVisionEvents));
 }
 
 void GameMap::fireRefreshEntities()
@@ -3058,6 +3577,8 @@ void GameMap::clientUpKeep(int64_t turnNumber)
 
 void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
 {
+    tilePassabilityChanged(*tileDoor);
+
     if(!locked)
     {
         // When a door is unlocked, we check all its neighboors to find a floodfill value for each possible
@@ -3234,17 +3755,9 @@ void GameMap::notifySeatsConfigured()
     }
 
     uint32_t nbTeams = mTeamIds.size();
-    for(int xxx = 0; xxx < getMapSizeX(); ++xxx)
-    {
-        for(int yyy = 0; yyy < getMapSizeY(); ++yyy)
-        {
-            Tile* tile = getTile(xxx, yyy);
-            if(tile == nullptr)
-                continue;
-
-            tile->setTeamsNumber(nbTeams);
-        }
-    }
+    getTileStore().setTeamsNumber(nbTeams);
+    OD_LOG_INF("Tiles fields memory=" + Helper::toString(getTileStore().getMemorySize()) + " bytes for "
+        + Helper::toString(getTileStore().getNbTiles()) + " tiles and " + Helper::toString(nbTeams) + " teams");
     // Now that team ids are set and tiles are configured, we can compute floodfill
     enableFloodFill();
 }
@@ -3259,7 +3772,7 @@ void GameMap::fireGameSound(Tile& tile, const std::string& soundFamily)
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playSpatialSound, seat->getPlayer());
         serverNotification->mPacket << sound << tile.getX() << tile.getY();
         ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -3275,7 +3788,7 @@ void GameMap::fireRelativeSound(const std::vector<Seat*>& seats, const std::stri
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playRelativeSound, seat->getPlayer());
         serverNotification->mPacket << soundFamily;
         ODServer::getSingleton().queueServerNotification(serverNotification);
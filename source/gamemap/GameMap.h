@@ -18,9 +18,15 @@
 #ifndef GAMEMAP_H
 #define GAMEMAP_H
 
+#include "gamemap/AstarSearch.h"
+#include "gamemap/FloodFillSets.h"
+#include "gamemap/HierarchicalPathfinding.h"
+#include "gamemap/PathCache.h"
 #include "gamemap/TileContainer.h"
+#include "gamemap/VisionTracker.h"
 
 #include "ai/AIManager.h"
+#include "utils/Random.h"
 
 #ifdef __MINGW32__
 #ifndef mode_t
@@ -29,6 +35,7 @@
 #endif //mingw32
 
 #include <cstdint>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
@@ -53,6 +60,7 @@ class Room;
 class Spell;
 class TileSet;
 class TileSetValue;
+class WorkerPool;
 
 enum class GameEntityType;
 enum class FloodFillType;
@@ -94,7 +102,7 @@ enum class SelectionEntityWanted
  * sortest path between two tiles" or "what creatures are in some particular
  * tile".
  */
-class GameMap : public TileContainer
+class GameMap : public TileContainer, public VisionListener
 {
 
 friend class RenderManager;
@@ -350,12 +358,21 @@ public:
      * will choose the closest tile in possibleDests and return the path between tileStart and it.
      * If a path is found, it is returned and chosenTile is set to the chosen tile. If no path is found,
      * an empty list will be returned and chosenTile will be set to nullptr
-     * Note that this function will use some magic numbers to avoid computing paths that are likely to be
-     * further
+     * The closest tile and its path are computed with a single search (see pathToClosestTiles)
      */
     std::list<Tile*> findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
         Tile*& chosenTile);
 
+    /*! \brief Searches from tileStart until nbTargets tiles from possibleDests are reached (or until
+     * every reachable tile has been explored). reachedTiles is filled with the reached tiles sorted by
+     * increasing walking cost for the given creature. The path to the closest one is returned (or an
+     * empty list if none can be reached).
+     * Unlike calling path() for each destination, only one search is done whatever the number of destinations.
+     * Counted like the path() calls but the returned path is not put in the path cache.
+     */
+    std::list<Tile*> pathToClosestTiles(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
+        uint32_t nbTargets, std::vector<Tile*>& reachedTiles);
+
     /*! \brief Calculates the walkable path between tiles (x1, y1) and (x2, y2).
      *
      * The search is carried out using the A-star search algorithm.
@@ -374,8 +391,33 @@ public:
     //! \note Returns a path for the given creature to the given destination.
     std::list<Tile*> path(const Creature* creature, Tile* destination, bool throughDiggableTiles = false);
 
+    /*! \brief Returns a path for the given creature to the given destination for long distance routing.
+     * The route is computed on the clusters graph (see HierarchicalPathfinding) and only the part going through the
+     * next few clusters is refined into a tile path. waypoint is set to the last tile of the returned path. If it is
+     * not the destination, the creature is expected to ask for the next part when it reaches it.
+     */
+    std::list<Tile*> pathToWaypoint(const Creature* creature, Tile* destination, Tile*& waypoint);
+
+    //! \brief Returns the floodfill type that should be used for the given creature depending on where it can go
+    FloodFillType getFloodFillTypeForCreature(const Creature* creature) const;
+
+    //! \brief Should be called when the passability of the given tile changes (digging, doors, bridges,
+    //! buildings). Updates the pathfinding structures depending on it
+    void tilePassabilityChanged(Tile& tile);
+
+    //! \brief Vision sources (claimed tiles, creatures, spells) on the server map. See VisionTracker
+    inline VisionTracker& getVisionTracker()
+    { return mVisionTracker; }
+
+    //! \brief Forwards the vision changes computed by the VisionTracker to the tile and the seat
+    void seatVisionChanged(int x, int y, int32_t seatId, bool hasVision) override;
+
+    //! \brief Sets the number of threads computing what the creatures see in addition to the server
+    //! thread (see senseCreatures). With 0, the server thread computes it alone
+    void setNbSenseWorkers(uint32_t nbWorkers);
+
     //! \brief Loops over the visibleTiles and returns any creature/room/trap in those tiles allied with the given seat
-    //! (or if enemyForce is true, is not allied)
+    //! (or if enemyForce is true, is not allied). The tiles in regions without entity of these seats are skipped (see SeatRegionIndex)
     std::vector<GameEntity*> getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce);
 
     //! \brief Loops over the visibleTiles and returns any creature in those tiles allied with the given seat.
@@ -385,13 +427,18 @@ public:
     //! \brief Loops over the given tiles and returns any carryable entity in those tiles
     std::vector<GameEntity*> getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles);
 
-    //! \brief Checks the neighboor tiles to see if the floodfill can be used. Floodfill consists on tagging all contiguous tiles
-    //! to be able to know before computing it if a path exists between 2 tiles. We do that to avoid computing paths when we
-    //! already know that no path exists.
-    bool doFloodFill(Seat* seat, Tile* tile);
+    //! \brief Floodfill consists on tagging all contiguous tiles to be able to know before computing it if a path exists
+    //! between 2 tiles. We do that to avoid computing paths when we already know that no path exists.
+    //! refreshFloodFill sets the floodfill of the given tile from its neighboors and merges the areas it connects
     void refreshFloodFill(Seat* seat, Tile* tile);
+
+    //! \brief Merges the area with floodfill colorOld into the one with colorNew. The tiles are not changed: both values
+    //! are put in the same set (see FloodFillSets) so this does not depend on the map size
     void replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew);
 
+    //! \brief Returns the floodfill of the area containing a tile with the given raw floodfill value
+    uint32_t findFloodFillValue(Seat* seat, FloodFillType floodFillType, uint32_t value) const;
+
     //! \brief Temporarily disables the flood fill computations on this game map.
     void disableFloodFill()
     { mFloodFillEnabled = false; }
@@ -401,6 +448,15 @@ public:
      */
     void enableFloodFill();
 
+    //! \brief Returns in values the floodfill of every tile for every team in the layout of LevelSnapshot::setFloodFill.
+    //! The merged areas are resolved so that the floodfill sets are not needed to restore them. Returns false if the
+    //! floodfill is not enabled
+    bool exportFloodFill(std::vector<uint32_t>& values) const;
+
+    //! \brief Floodfill read from a savegame. The next enableFloodFill restores it instead of computing the floodfill
+    //! if the teams are the ones it was saved with
+    void setSavedFloodFill(std::vector<int> teamIds, std::vector<uint32_t> values);
+
     inline void setLocalPlayer(Player* player)
     { mLocalPlayer = player; }
 
@@ -428,6 +484,39 @@ public:
     inline bool isServerGameMap() const
     { return mIsServerGameMap; }
 
+    /*! \brief Seeds the random streams of the game. Two games started with the same seed, level and
+     * orders give the same result. The seed can be set by the level, the command line or is taken from the time
+     */
+    void setSeed(uint64_t seed);
+
+    inline uint64_t getSeed() const
+    { return mSeed; }
+
+    //! \brief True if the seed was read from the level file. In this case, it is saved with the level
+    inline bool hasLevelSeed() const
+    { return mHasLevelSeed; }
+
+    inline void setHasLevelSeed(bool hasLevelSeed)
+    { mHasLevelSeed = hasLevelSeed; }
+
+    //! \brief Stream used by the server for what is not computed by a given entity (see GameEntity::getRandomStream)
+    inline RandomStream& getRandomStream()
+    { return mRandomStream; }
+
+    //! \brief Returns a stream that only depends on the game seed and the given key (for example, an entity name)
+    RandomStream createRandomStream(const std::string& key) const;
+
+    /*! \brief Computes a hash of the game state (tiles, seats and entities) to check that 2 games
+     * seeded with the same value stay identical
+     */
+    uint64_t computeStateHash() const;
+
+    /*! \brief Recounts on the whole map the claimed tiles, creatures and treasury gold of each seat
+     * and compares them with the counts kept up to date during the game. The differences are logged.
+     * Returns true if there is none. Meant for debugging and tests as it is slow on big maps
+     */
+    bool checkSeatStatistics() const;
+
     inline bool getGamePaused() const
     { return mIsPaused; }
 
@@ -450,12 +539,32 @@ public:
 
     void logFloodFileTiles();
     void consoleSetCreatureDestination(const std::string& creatureName, int x, int y);
+
+    //! \brief Slaps the door on the given tile as its owner would. Returns false if there is none
+    bool consoleToggleDoor(int x, int y);
+
     void consoleToggleCreatureVisualDebug(const std::string& creatureName);
     void consoleToggleSeatVisualDebug(int seatId);
     void consoleSetLevelCreature(const std::string& creatureName, uint32_t level);
     void consoleAskToggleFOW();
     void consoleAskUnlockSkills();
 
+    //! \brief Starts recording every query made to GameMap::path in the given file. If the given
+    //! file name is empty, stops recording.
+    void consoleRecordPathQueries(const std::string& fileName);
+
+    //! \brief Replays the path queries recorded in the given file nbIterations times and logs
+    //! the time taken.
+    void consoleBenchmarkPathQueries(const std::string& fileName, uint32_t nbIterations);
+
+    //! \brief For each creature, looks for the best path to the rooms of its seat with findBestPath and with
+    //! one path() call per destination nbIterations times. Logs the time taken by both.
+    void consoleBenchmarkFindBestPath(uint32_t nbIterations);
+
+    //! \brief Computes the visible tiles from every tile not blocking vision for sight radius from 5 to 20 nbIterations
+    //! times with visibleTiles and with the former algorithm. Logs the time taken by both.
+    void consoleBenchmarkVisibleTiles(uint32_t nbIterations);
+
     //! \brief This functions create unique names. They check that there
     //! is no entity with the same name before returning
     std::string nextUniqueNameCreature(const std::string& className);
@@ -492,8 +601,24 @@ public:
     //! RenderManager has finished to render every object inside.
     void processDeletionQueues();
 
+    /*! \brief Notifies the entities about the seats that gained or lost vision on them. Only the
+     * entities on the tiles queued with addTileEntitiesVisionChanged are checked
+     */
     void updateVisibleEntities();
 
+    //! \brief Queues a tile for the next updateVisibleEntities (see Tile::entitiesVisionChanged)
+    inline void addTileEntitiesVisionChanged(Tile* tile)
+    { mTilesEntitiesVisionChanged.push_back(tile); }
+
+    //! \brief Called by the entities each time a seat is added to or removed from the seats they are
+    //! visible to while updating the visible entities
+    inline void countEntityVisionEvent()
+    { ++mNbEntityVisionEvents; }
+
+    //! \brief Number of seats added to or removed from the entities during the last updateVisibleEntities
+    inline uint32_t getNbEntityVisionEvents() const
+    { return mNbEntityVisionEvents; }
+
     void fireRefreshEntities();
 
     inline const std::vector<RenderedMovableEntity*>& getRenderedMovableEntities() const
@@ -540,6 +665,10 @@ public:
     void fireRelativeSound(const std::vector<Seat*>& seats, const std::string& soundFamily);
 
 private:
+    //! \brief Sets the floodfill given by setSavedFloodFill to the tiles. Returns false if it was not saved with the
+    //! current teams
+    bool restoreSavedFloodFill();
+
     //! \brief Tells whether this game map instance is used as a reference by the server-side,
     //! or as a standard client game map.
     bool mIsServerGameMap;
@@ -553,6 +682,10 @@ private:
     //! \brief The current server turn number.
     int64_t mTurnNumber;
 
+    uint64_t mSeed;
+    bool mHasLevelSeed;
+    RandomStream mRandomStream;
+
     //! \brief Unique numbers to ensure names are unique
     int mUniqueNumberCreature;
     int mUniqueNumberMissileObj;
@@ -618,12 +751,46 @@ private:
     //! \brief Debug member used to know how many call to pathfinding has been made within the same turn.
     unsigned int mNumCallsTo_path;
 
+    //! \brief Nodes and open list used by path(). Kept between calls to avoid allocating them on each search.
+    AstarSearch mAstarSearch;
+
+    //! \brief Merged floodfill values for each team and floodfill type. The sets for the team index i
+    //! and the type t are at index i * FloodFillType::nbValues + t
+    std::vector<FloodFillSets> mFloodFillSets;
+
+    //! \brief Clusters graph used for long distance paths
+    HierarchicalPathfinding mHierarchicalPathfinding;
+
+    //! \brief Paths recently computed by path(). The hits and misses are logged with mNumCallsTo_path
+    PathCache mPathCache;
+
+    //! \brief Vision given by the claimed tiles and the entities to each seat. Updated incrementally
+    VisionTracker mVisionTracker;
+
+    //! \brief Tiles whose entities have to be notified about the seats with vision at the next
+    //! updateVisibleEntities
+    std::vector<Tile*> mTilesEntitiesVisionChanged;
+    uint32_t mNbEntityVisionEvents;
+
+    //! \brief Threads used by senseCreatures. Null if the server thread computes it alone
+    std::unique_ptr<WorkerPool> mSenseWorkers;
+
+    //! \brief Creatures looking around during the current turn. Kept to avoid allocating it at each turn
+    std::vector<Creature*> mSensingCreatures;
+
+    //! \brief If not null, every query to path() will be written in this file.
+    std::unique_ptr<std::ofstream> mPathQueriesRecord;
+
     std::vector<RenderedMovableEntity*> mRenderedMovableEntities;
 
     std::vector<Spell*> mSpells;
 
     std::vector<int> mTeamIds;
 
+    //! \brief Floodfill given by setSavedFloodFill. Cleared by enableFloodFill
+    std::vector<int> mSavedFloodFillTeamIds;
+    std::vector<uint32_t> mSavedFloodFillValues;
+
     //! AI Handling manager
     AIManager mAiManager;
 
@@ -635,8 +802,31 @@ private:
     //! Updates active objects (creatures, rooms, ...), goals, count each team Workers, gold, mana and claimed tiles.
     unsigned long int doMiscUpkeep(double timeSinceLastTurn);
 
+    /*! \brief Calls Creature::senseSurroundings for each creature looking around. As it only reads the
+     * game map, it is done in parallel with mSenseWorkers. The result does not depend on the number of threads
+     */
+    void senseCreatures();
+
     //! \brief Resets the unique numbers
     void resetUniqueNumbers();
+
+    //! \brief Fills cacheKey for a path from start to destination for the given creature. Returns false if the
+    //! path depends on the creature state and should not be cached
+    bool getPathCacheKey(const Creature* creature, Tile* start, Tile* destination, PathCacheKey& cacheKey);
+
+    //! \brief Adds to the open list of mAstarSearch the neighbors of the given node the creature can go to.
+    //! If destination is nullptr, no heuristic is used and the search behaves like Dijkstra's algorithm
+    void expandPathNode(const Creature* creature, Seat* seat, Tile* start, bool throughDiggableTiles,
+        uint32_t currentIndex, const Tile* destination);
+
+    //! \brief Builds the path to the given node of mAstarSearch by following its parents. If useCache is true,
+    //! the path is added to mPathCache
+    std::list<Tile*> buildSearchPath(uint32_t destinationIndex, bool useCache, const PathCacheKey& cacheKey);
+
+    //! \brief Former implementation of findBestPath computing one path per destination. Only used to
+    //! compare both in consoleBenchmarkFindBestPath
+    std::list<Tile*> findBestPathSeparateSearches(const Creature* creature, Tile* tileStart,
+        const std::vector<Tile*>& possibleDests, Tile*& chosenTile);
 };
 
 #endif // GAMEMAP_H
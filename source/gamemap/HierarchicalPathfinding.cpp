@@ -0,0 +1,478 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/HierarchicalPathfinding.h"
+
+#include "gamemap/FloodFillSets.h"
+#include "gamemap/TileStore.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+const int HierarchicalPathfinding::CLUSTER_SIZE = 16;
+
+//! \brief Entrances at least this long give 2 transitions (one at each end) instead of 1 in the middle
+static const int MIN_ENTRANCE_SIZE_DOUBLE_TRANSITION = 6;
+
+static const uint32_t NO_COST = static_cast<uint32_t>(-1);
+
+static double abstractHeuristic(int x1, int y1, int x2, int y2)
+{
+    return static_cast<double>(std::abs(x2 - x1) + std::abs(y2 - y1));
+}
+
+HierarchicalPathfinding::HierarchicalPathfinding(const TileStore& tileStore, const std::vector<FloodFillSets>& floodFillSets) :
+    mTileStore(tileStore),
+    mFloodFillSets(floodFillSets),
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbClustersX(0),
+    mNbClustersY(0),
+    mNbClustersComputed(0)
+{
+}
+
+void HierarchicalPathfinding::invalidateAll()
+{
+    mLayers.clear();
+    mNbClustersComputed = 0;
+}
+
+void HierarchicalPathfinding::tileChanged(int x, int y)
+{
+    checkMapSize();
+
+    int clusterX = clusterCoord(x);
+    int clusterY = clusterCoord(y);
+    uint32_t cluster = clusterIndex(x, y);
+    for(Layer& layer : mLayers)
+    {
+        if(!layer.mInitialized)
+            continue;
+
+        layer.mClusters[cluster].mDirty = true;
+
+        // If the tile is on the cluster edge, the border transitions may change too
+        if((x % CLUSTER_SIZE == 0) && (clusterX > 0))
+            layer.mBorderDirty[verticalBorderIndex(clusterX - 1, clusterY)] = true;
+        if((x % CLUSTER_SIZE == CLUSTER_SIZE - 1) && (clusterX < mNbClustersX - 1))
+            layer.mBorderDirty[verticalBorderIndex(clusterX, clusterY)] = true;
+        if((y % CLUSTER_SIZE == 0) && (clusterY > 0))
+            layer.mBorderDirty[horizontalBorderIndex(clusterX, clusterY - 1)] = true;
+        if((y % CLUSTER_SIZE == CLUSTER_SIZE - 1) && (clusterY < mNbClustersY - 1))
+            layer.mBorderDirty[horizontalBorderIndex(clusterX, clusterY)] = true;
+    }
+}
+
+void HierarchicalPathfinding::checkMapSize()
+{
+    if((mMapSizeX == mTileStore.getMapSizeX()) &&
+       (mMapSizeY == mTileStore.getMapSizeY()))
+    {
+        return;
+    }
+
+    mMapSizeX = mTileStore.getMapSizeX();
+    mMapSizeY = mTileStore.getMapSizeY();
+    mNbClustersX = (mMapSizeX + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    mNbClustersY = (mMapSizeY + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    invalidateAll();
+}
+
+uint32_t HierarchicalPathfinding::getFloodFillValue(int x, int y, uint32_t teamIndex, uint32_t floodFillType) const
+{
+    uint32_t value = mTileStore.getFloodFillValues(mTileStore.getIndex(x, y), teamIndex)[floodFillType];
+    // The areas may have been merged since the value was set
+    uint32_t setsIndex = teamIndex * TileStore::NB_FLOODFILL_TYPES + floodFillType;
+    if((value == TileStore::NO_FLOODFILL) || (setsIndex >= mFloodFillSets.size()))
+        return value;
+
+    return mFloodFillSets[setsIndex].find(value);
+}
+
+HierarchicalPathfinding::Layer& HierarchicalPathfinding::getLayer(uint32_t teamIndex, uint32_t floodFillType)
+{
+    uint32_t layerIndex = teamIndex * TileStore::NB_FLOODFILL_TYPES + floodFillType;
+    if(layerIndex >= mLayers.size())
+        mLayers.resize(layerIndex + 1);
+
+    Layer& layer = mLayers[layerIndex];
+    if(layer.mInitialized)
+        return layer;
+
+    // Everything will be computed on first use
+    uint32_t nbClusters = static_cast<uint32_t>(mNbClustersX * mNbClustersY);
+    layer.mInitialized = true;
+    layer.mClusters.assign(nbClusters, Cluster());
+    for(Cluster& cluster : layer.mClusters)
+        cluster.mDirty = true;
+    layer.mBorders.assign(2 * nbClusters, std::vector<uint32_t>());
+    layer.mBorderDirty.assign(2 * nbClusters, true);
+    return layer;
+}
+
+void HierarchicalPathfinding::refreshLayer(Layer& layer, uint32_t teamIndex, uint32_t floodFillType)
+{
+    for(int clusterY = 0; clusterY < mNbClustersY; ++clusterY)
+    {
+        for(int clusterX = 0; clusterX < mNbClustersX; ++clusterX)
+        {
+            uint32_t cluster = static_cast<uint32_t>(clusterY * mNbClustersX + clusterX);
+            uint32_t border = verticalBorderIndex(clusterX, clusterY);
+            if((clusterX < mNbClustersX - 1) && layer.mBorderDirty[border])
+            {
+                computeBorder(layer, border, teamIndex, floodFillType);
+                layer.mClusters[cluster].mDirty = true;
+                layer.mClusters[cluster + 1].mDirty = true;
+            }
+            layer.mBorderDirty[border] = false;
+
+            border = horizontalBorderIndex(clusterX, clusterY);
+            if((clusterY < mNbClustersY - 1) && layer.mBorderDirty[border])
+            {
+                computeBorder(layer, border, teamIndex, floodFillType);
+                layer.mClusters[cluster].mDirty = true;
+                layer.mClusters[cluster + mNbClustersX].mDirty = true;
+            }
+            layer.mBorderDirty[border] = false;
+        }
+    }
+
+    for(uint32_t cluster = 0; cluster < layer.mClusters.size(); ++cluster)
+    {
+        if(!layer.mClusters[cluster].mDirty)
+            continue;
+
+        computeCluster(layer, cluster, teamIndex, floodFillType);
+        layer.mClusters[cluster].mDirty = false;
+        ++mNbClustersComputed;
+    }
+}
+
+void HierarchicalPathfinding::computeBorder(Layer& layer, uint32_t borderIndex, uint32_t teamIndex, uint32_t floodFillType)
+{
+    uint32_t nbClusters = static_cast<uint32_t>(mNbClustersX * mNbClustersY);
+    bool isVertical = (borderIndex < nbClusters);
+    uint32_t cluster = isVertical ? borderIndex : borderIndex - nbClusters;
+    int clusterX = static_cast<int>(cluster) % mNbClustersX;
+    int clusterY = static_cast<int>(cluster) / mNbClustersX;
+
+    // For vertical borders, we walk along y on the last column of the cluster. For horizontal
+    // borders, along x on the last row
+    int start = isVertical ? clusterY * CLUSTER_SIZE : clusterX * CLUSTER_SIZE;
+    int end = std::min(start + CLUSTER_SIZE, isVertical ? mMapSizeY : mMapSizeX);
+    int fixedCoord = isVertical ? (clusterX + 1) * CLUSTER_SIZE - 1 : (clusterY + 1) * CLUSTER_SIZE - 1;
+
+    std::vector<uint32_t>& transitions = layer.mBorders[borderIndex];
+    transitions.clear();
+
+    int entranceStart = -1;
+    for(int i = start; i <= end; ++i)
+    {
+        bool isConnected = false;
+        if(i < end)
+        {
+            uint32_t color1 = isVertical ? getFloodFillValue(fixedCoord, i, teamIndex, floodFillType)
+                : getFloodFillValue(i, fixedCoord, teamIndex, floodFillType);
+            uint32_t color2 = isVertical ? getFloodFillValue(fixedCoord + 1, i, teamIndex, floodFillType)
+                : getFloodFillValue(i, fixedCoord + 1, teamIndex, floodFillType);
+            isConnected = (color1 != TileStore::NO_FLOODFILL) && (color1 == color2);
+        }
+
+        if(isConnected)
+        {
+            if(entranceStart < 0)
+                entranceStart = i;
+            continue;
+        }
+
+        if(entranceStart < 0)
+            continue;
+
+        // The entrance is over. We add its transitions
+        int entranceEnd = i - 1;
+        std::vector<int> positions;
+        if(entranceEnd - entranceStart + 1 >= MIN_ENTRANCE_SIZE_DOUBLE_TRANSITION)
+        {
+            positions.push_back(entranceStart);
+            positions.push_back(entranceEnd);
+        }
+        else
+            positions.push_back((entranceStart + entranceEnd) / 2);
+
+        for(int pos : positions)
+        {
+            if(isVertical)
+            {
+                transitions.push_back(static_cast<uint32_t>(pos * mMapSizeX + fixedCoord));
+                transitions.push_back(static_cast<uint32_t>(pos * mMapSizeX + fixedCoord + 1));
+            }
+            else
+            {
+                transitions.push_back(static_cast<uint32_t>(fixedCoord * mMapSizeX + pos));
+                transitions.push_back(static_cast<uint32_t>((fixedCoord + 1) * mMapSizeX + pos));
+            }
+        }
+        entranceStart = -1;
+    }
+}
+
+void HierarchicalPathfinding::getClusterBorders(int clusterX, int clusterY, std::vector<uint32_t>& borders) const
+{
+    borders.clear();
+    if(clusterX > 0)
+        borders.push_back(verticalBorderIndex(clusterX - 1, clusterY));
+    if(clusterX < mNbClustersX - 1)
+        borders.push_back(verticalBorderIndex(clusterX, clusterY));
+    if(clusterY > 0)
+        borders.push_back(horizontalBorderIndex(clusterX, clusterY - 1));
+    if(clusterY < mNbClustersY - 1)
+        borders.push_back(horizontalBorderIndex(clusterX, clusterY));
+}
+
+void HierarchicalPathfinding::computeCluster(Layer& layer, uint32_t clusterIndex, uint32_t teamIndex, uint32_t floodFillType)
+{
+    Cluster& cluster = layer.mClusters[clusterIndex];
+    int clusterX = static_cast<int>(clusterIndex) % mNbClustersX;
+    int clusterY = static_cast<int>(clusterIndex) / mNbClustersX;
+
+    // The nodes are the transition tiles on this side of the cluster borders
+    cluster.mNodes.clear();
+    std::vector<uint32_t> borders;
+    getClusterBorders(clusterX, clusterY, borders);
+    for(uint32_t border : borders)
+    {
+        for(uint32_t node : layer.mBorders[border])
+        {
+            int x = static_cast<int>(node) % mMapSizeX;
+            int y = static_cast<int>(node) / mMapSizeX;
+            if((clusterCoord(x) != clusterX) || (clusterCoord(y) != clusterY))
+                continue;
+
+            // A tile in a cluster corner can be a transition for 2 borders
+            if(std::find(cluster.mNodes.begin(), cluster.mNodes.end(), node) != cluster.mNodes.end())
+                continue;
+
+            cluster.mNodes.push_back(node);
+        }
+    }
+
+    cluster.mEdges.assign(cluster.mNodes.size(), std::vector<Edge>());
+    for(uint32_t i = 0; i < cluster.mNodes.size(); ++i)
+    {
+        int x = static_cast<int>(cluster.mNodes[i]) % mMapSizeX;
+        int y = static_cast<int>(cluster.mNodes[i]) / mMapSizeX;
+        computeCostsInCluster(x, y, teamIndex, floodFillType);
+        for(uint32_t j = 0; j < cluster.mNodes.size(); ++j)
+        {
+            if(i == j)
+                continue;
+
+            int x2 = static_cast<int>(cluster.mNodes[j]) % mMapSizeX;
+            int y2 = static_cast<int>(cluster.mNodes[j]) / mMapSizeX;
+            uint32_t cost = mBfsCost[clusterLocalIndex(x2, y2)];
+            if(cost == NO_COST)
+                continue;
+
+            cluster.mEdges[i].push_back(Edge{cluster.mNodes[j], cost});
+        }
+    }
+}
+
+void HierarchicalPathfinding::computeCostsInCluster(int x, int y, uint32_t teamIndex, uint32_t floodFillType)
+{
+    mBfsCost.assign(CLUSTER_SIZE * CLUSTER_SIZE, NO_COST);
+    mBfsQueue.clear();
+
+    uint32_t color = getFloodFillValue(x, y, teamIndex, floodFillType);
+    if(color == TileStore::NO_FLOODFILL)
+        return;
+
+    int minX = clusterCoord(x) * CLUSTER_SIZE;
+    int minY = clusterCoord(y) * CLUSTER_SIZE;
+    int maxX = std::min(minX + CLUSTER_SIZE, mMapSizeX) - 1;
+    int maxY = std::min(minY + CLUSTER_SIZE, mMapSizeY) - 1;
+
+    // Since floodfill values are set on contiguous tiles, tiles reachable are the ones with the same
+    // value. We use the manhattan distance as cost like GameMap::path does for every step
+    mBfsCost[clusterLocalIndex(x, y)] = 0;
+    mBfsQueue.push_back(static_cast<uint32_t>(y * mMapSizeX + x));
+    for(uint32_t queueIndex = 0; queueIndex < mBfsQueue.size(); ++queueIndex)
+    {
+        int curX = static_cast<int>(mBfsQueue[queueIndex]) % mMapSizeX;
+        int curY = static_cast<int>(mBfsQueue[queueIndex]) / mMapSizeX;
+        uint32_t curCost = mBfsCost[clusterLocalIndex(curX, curY)];
+        static const int DIRS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for(const int* dir : DIRS)
+        {
+            int neighX = curX + dir[0];
+            int neighY = curY + dir[1];
+            if((neighX < minX) || (neighX > maxX) || (neighY < minY) || (neighY > maxY))
+                continue;
+
+            uint32_t& neighCost = mBfsCost[clusterLocalIndex(neighX, neighY)];
+            if(neighCost != NO_COST)
+                continue;
+
+            if(getFloodFillValue(neighX, neighY, teamIndex, floodFillType) != color)
+                continue;
+
+            neighCost = curCost + 1;
+            mBfsQueue.push_back(static_cast<uint32_t>(neighY * mMapSizeX + neighX));
+        }
+    }
+}
+
+bool HierarchicalPathfinding::findAbstractPath(uint32_t teamIndex, FloodFillType floodFillType, int startX, int startY,
+    int destX, int destY, std::vector<uint32_t>& waypoints)
+{
+    waypoints.clear();
+    checkMapSize();
+
+    uint32_t intFloodFillType = static_cast<uint32_t>(floodFillType);
+    if((teamIndex >= mTileStore.getNbTeams()) ||
+       (intFloodFillType >= TileStore::NB_FLOODFILL_TYPES))
+    {
+        return false;
+    }
+
+    uint32_t color = getFloodFillValue(startX, startY, teamIndex, intFloodFillType);
+    if((color == TileStore::NO_FLOODFILL) ||
+       (color != getFloodFillValue(destX, destY, teamIndex, intFloodFillType)))
+    {
+        return false;
+    }
+
+    uint32_t startIndex = mTileStore.getIndex(startX, startY);
+    uint32_t destIndex = mTileStore.getIndex(destX, destY);
+    uint32_t startCluster = clusterIndex(startX, startY);
+    uint32_t destCluster = clusterIndex(destX, destY);
+
+    Layer& layer = getLayer(teamIndex, intFloodFillType);
+    refreshLayer(layer, teamIndex, intFloodFillType);
+
+    // We link the start tile to the nodes of its cluster. If the destination can be reached without
+    // leaving the cluster, no need to go further
+    std::vector<Edge> startEdges;
+    computeCostsInCluster(startX, startY, teamIndex, intFloodFillType);
+    if((startCluster == destCluster) &&
+       (mBfsCost[clusterLocalIndex(destX, destY)] != NO_COST))
+    {
+        waypoints.push_back(destIndex);
+        return true;
+    }
+    for(uint32_t node : layer.mClusters[startCluster].mNodes)
+    {
+        uint32_t cost = mBfsCost[clusterLocalIndex(static_cast<int>(node) % mMapSizeX, static_cast<int>(node) / mMapSizeX)];
+        if(cost != NO_COST)
+            startEdges.push_back(Edge{node, cost});
+    }
+
+    // And the nodes of the destination cluster to the destination
+    std::vector<Edge> destEdges;
+    computeCostsInCluster(destX, destY, teamIndex, intFloodFillType);
+    for(uint32_t node : layer.mClusters[destCluster].mNodes)
+    {
+        uint32_t cost = mBfsCost[clusterLocalIndex(static_cast<int>(node) % mMapSizeX, static_cast<int>(node) / mMapSizeX)];
+        if(cost != NO_COST)
+            destEdges.push_back(Edge{node, cost});
+    }
+
+    if(startEdges.empty() || destEdges.empty())
+        return false;
+
+    mAbstractSearch.startSearch(mMapSizeX, mMapSizeY);
+    mAbstractSearch.open(startIndex, AstarSearch::NO_NODE, 0.0,
+        abstractHeuristic(startX, startY, destX, destY));
+
+    std::vector<Edge> edges;
+    std::vector<uint32_t> borders;
+    bool isFound = false;
+    uint32_t currentIndex;
+    while(mAbstractSearch.popBest(currentIndex))
+    {
+        if(currentIndex == destIndex)
+        {
+            isFound = true;
+            break;
+        }
+
+        int currentX = mAbstractSearch.nodeX(currentIndex);
+        int currentY = mAbstractSearch.nodeY(currentIndex);
+        const Cluster& cluster = layer.mClusters[clusterIndex(currentX, currentY)];
+
+        // Edges within the cluster
+        edges.clear();
+        if(currentIndex == startIndex)
+            edges = startEdges;
+        else
+        {
+            auto it = std::find(cluster.mNodes.begin(), cluster.mNodes.end(), currentIndex);
+            if(it != cluster.mNodes.end())
+                edges = cluster.mEdges[it - cluster.mNodes.begin()];
+        }
+
+        // Edges to the neighbor clusters
+        getClusterBorders(clusterCoord(currentX), clusterCoord(currentY), borders);
+        for(uint32_t border : borders)
+        {
+            const std::vector<uint32_t>& transitions = layer.mBorders[border];
+            for(uint32_t i = 0; i < transitions.size(); i += 2)
+            {
+                if(transitions[i] == currentIndex)
+                    edges.push_back(Edge{transitions[i + 1], 1});
+                else if(transitions[i + 1] == currentIndex)
+                    edges.push_back(Edge{transitions[i], 1});
+            }
+        }
+
+        // Edge to the destination
+        for(const Edge& edge : destEdges)
+        {
+            if(edge.mNode != currentIndex)
+                continue;
+
+            edges.push_back(Edge{destIndex, edge.mCost});
+            break;
+        }
+
+        for(const Edge& edge : edges)
+        {
+            if(mAbstractSearch.isClosed(edge.mNode))
+                continue;
+
+            double g = mAbstractSearch.getG(currentIndex) + static_cast<double>(edge.mCost);
+            if(!mAbstractSearch.isVisited(edge.mNode))
+            {
+                mAbstractSearch.open(edge.mNode, currentIndex, g,
+                    abstractHeuristic(mAbstractSearch.nodeX(edge.mNode), mAbstractSearch.nodeY(edge.mNode),
+                        destX, destY));
+            }
+            else
+                mAbstractSearch.decreaseCost(edge.mNode, currentIndex, g);
+        }
+    }
+
+    if(!isFound)
+        return false;
+
+    for(uint32_t index = destIndex; index != startIndex; index = mAbstractSearch.getParent(index))
+        waypoints.push_back(index);
+
+    std::reverse(waypoints.begin(), waypoints.end());
+    return true;
+}
@@ -0,0 +1,163 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HIERARCHICALPATHFINDING_H
+#define HIERARCHICALPATHFINDING_H
+
+#include "gamemap/AstarSearch.h"
+
+#include <cstdint>
+#include <vector>
+
+class FloodFillSets;
+class TileStore;
+
+enum class FloodFillType;
+
+/*! \brief Cluster/portal abstraction (HPA*) built over the game map tiles to speed up long distance paths.
+ *
+ * The map is cut in square clusters of CLUSTER_SIZE tiles. On each border between 2 clusters, the
+ * contiguous passable tiles are grouped in entrances and each entrance gives one or two transitions
+ * (a pair of tiles, one on each side). The transitions tiles are the nodes of an abstract graph
+ * where each node is linked to the nodes of its cluster it can reach without leaving the cluster.
+ *
+ * Passability is taken from the floodfill stored in the TileStore: 2 neighbor tiles are connected for a
+ * team and a floodfill type if their floodfill values are in the same FloodFillSets set. Since doors split
+ * the floodfill per team, there is one graph per team and per floodfill type.
+ *
+ * The graphs are computed lazily. When a tile passability changes (digging, door locked/unlocked, bridge
+ * built/destroyed), only the clusters (and borders) containing the tile are marked dirty and they will
+ * be computed again the next time the graph is used.
+ */
+class HierarchicalPathfinding
+{
+public:
+    static const int CLUSTER_SIZE;
+
+    //! \brief floodFillSets is indexed like the graphs (team index * FloodFillType::nbValues + floodfill type)
+    HierarchicalPathfinding(const TileStore& tileStore, const std::vector<FloodFillSets>& floodFillSets);
+
+    //! \brief Drops every computed graph. Should be called when the floodfill is computed again for the whole map.
+    void invalidateAll();
+
+    //! \brief Marks the clusters containing the tile (x, y) as needing to be computed again. Should be called
+    //! each time a tile passability or floodfill changes.
+    void tileChanged(int x, int y);
+
+    //! \brief Computes an abstract path between the tiles (startX, startY) and (destX, destY) for the given
+    //! team index (see Seat::getTeamIndex) and floodfill type. If a path exists, waypoints is filled with the
+    //! indexes (see TileStore::getIndex) of the transition tiles to go through followed by the destination and
+    //! true is returned. Note that the tiles between 2 waypoints are not computed.
+    bool findAbstractPath(uint32_t teamIndex, FloodFillType floodFillType, int startX, int startY,
+        int destX, int destY, std::vector<uint32_t>& waypoints);
+
+    //! \brief Number of clusters computed since the graphs were dropped
+    inline uint32_t getNbClustersComputed() const
+    { return mNbClustersComputed; }
+
+    //! \brief Returns the index of the cluster containing the given tile along x or y
+    static inline int clusterCoord(int tileCoord)
+    { return tileCoord / CLUSTER_SIZE; }
+
+private:
+    struct Edge
+    {
+        uint32_t mNode;
+        uint32_t mCost;
+    };
+
+    struct Cluster
+    {
+        bool mDirty;
+        //! \brief Tile indexes of the transition tiles in this cluster. mEdges[i] contains the
+        //! nodes reachable from mNodes[i] within the cluster.
+        std::vector<uint32_t> mNodes;
+        std::vector<std::vector<Edge>> mEdges;
+    };
+
+    struct Layer
+    {
+        Layer() :
+            mInitialized(false)
+        {}
+
+        bool mInitialized;
+        std::vector<Cluster> mClusters;
+        //! \brief Transitions for each border. Each transition is stored as 2 consecutive tile indexes
+        std::vector<std::vector<uint32_t>> mBorders;
+        std::vector<bool> mBorderDirty;
+    };
+
+    const TileStore& mTileStore;
+    const std::vector<FloodFillSets>& mFloodFillSets;
+
+    int mMapSizeX;
+    int mMapSizeY;
+    int mNbClustersX;
+    int mNbClustersY;
+
+    //! \brief Graphs indexed by (team index * FloodFillType::nbValues + floodfill type)
+    std::vector<Layer> mLayers;
+
+    //! \brief Search used on the abstract graph. Nodes are indexed like tiles
+    AstarSearch mAbstractSearch;
+
+    uint32_t mNbClustersComputed;
+
+    //! \brief Temporary buffers used by the breadth first searches within a cluster
+    std::vector<uint32_t> mBfsCost;
+    std::vector<uint32_t> mBfsQueue;
+
+    //! \brief Sets the map size and drops the computed graphs if it changed
+    void checkMapSize();
+
+    Layer& getLayer(uint32_t teamIndex, uint32_t floodFillType);
+
+    //! \brief Computes again the dirty borders and clusters of the given layer
+    void refreshLayer(Layer& layer, uint32_t teamIndex, uint32_t floodFillType);
+
+    void computeBorder(Layer& layer, uint32_t borderIndex, uint32_t teamIndex, uint32_t floodFillType);
+
+    void computeCluster(Layer& layer, uint32_t clusterIndex, uint32_t teamIndex, uint32_t floodFillType);
+
+    //! \brief Computes the cost from tile (x, y) to every tile it can reach without leaving its cluster.
+    //! The result is stored in mBfsCost (indexed by clusterLocalIndex)
+    void computeCostsInCluster(int x, int y, uint32_t teamIndex, uint32_t floodFillType);
+
+    //! \brief Returns the floodfill value of tile (x, y). The team index is expected to be valid
+    uint32_t getFloodFillValue(int x, int y, uint32_t teamIndex, uint32_t floodFillType) const;
+
+    //! \brief Returns the index in mBfsCost corresponding to tile (x, y)
+    inline uint32_t clusterLocalIndex(int x, int y) const
+    { return static_cast<uint32_t>((y % CLUSTER_SIZE) * CLUSTER_SIZE + (x % CLUSTER_SIZE)); }
+
+    inline uint32_t clusterIndex(int x, int y) const
+    { return static_cast<uint32_t>(clusterCoord(y) * mNbClustersX + clusterCoord(x)); }
+
+    //! \brief Borders are indexed by the cluster on their left (for vertical borders) or top (for horizontal
+    //! borders). Vertical borders are stored first.
+    inline uint32_t verticalBorderIndex(int clusterX, int clusterY) const
+    { return static_cast<uint32_t>(clusterY * mNbClustersX + clusterX); }
+
+    inline uint32_t horizontalBorderIndex(int clusterX, int clusterY) const
+    { return static_cast<uint32_t>(mNbClustersX * mNbClustersY + clusterY * mNbClustersX + clusterX); }
+
+    //! \brief Fills borders with the indexes of the (up to 4) borders of the given cluster
+    void getClusterBorders(int clusterX, int clusterY, std::vector<uint32_t>& borders) const;
+};
+
+#endif // HIERARCHICALPATHFINDING_H
@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/LevelInfoIndex.h"
+
+#include "utils/LogManager.h"
+
+#include "ODApplication.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static const std::string INDEX_HEADER = "[LevelInfoIndex]";
+
+//! \brief Each entry is written on one line with tab separated fields. The tabs and the new lines
+//! in the level info are escaped
+static std::string escapeField(const std::string& field)
+{
+    std::string str;
+    str.reserve(field.size());
+    for(char c : field)
+    {
+        switch(c)
+        {
+            case '\\':
+                str += "\\\\";
+                break;
+            case '\t':
+                str += "\\t";
+                break;
+            case '\n':
+                str += "\\n";
+                break;
+            case '\r':
+                str += "\\r";
+                break;
+            default:
+                str += c;
+                break;
+        }
+    }
+    return str;
+}
+
+static std::string unescapeField(const std::string& field)
+{
+    std::string str;
+    str.reserve(field.size());
+    for(std::size_t i = 0; i < field.size(); ++i)
+    {
+        char c = field[i];
+        if((c != '\\') || (i + 1 >= field.size()))
+        {
+            str += c;
+            continue;
+        }
+
+        c = field[++i];
+        switch(c)
+        {
+            case 't':
+                str += '\t';
+                break;
+            case 'n':
+                str += '\n';
+                break;
+            case 'r':
+                str += '\r';
+                break;
+            default:
+                str += c;
+                break;
+        }
+    }
+    return str;
+}
+
+static bool getFileStamp(const std::string& fileName, std::time_t& lastWriteTime, uintmax_t& fileSize)
+{
+    boost::system::error_code ec;
+    lastWriteTime = boost::filesystem::last_write_time(fileName, ec);
+    if(ec)
+        return false;
+
+    fileSize = boost::filesystem::file_size(fileName, ec);
+    return !ec;
+}
+
+LevelInfoIndex::LevelInfoIndex(const std::string& indexFileName) :
+    mIndexFileName(indexFileName),
+    mIsModified(false)
+{
+    load();
+}
+
+void LevelInfoIndex::load()
+{
+    std::ifstream indexFile(mIndexFileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!indexFile.good())
+        return;
+
+    // If the index was written by another version, we drop it
+    std::string line;
+    if(!std::getline(indexFile, line) || (line != INDEX_HEADER + "\t" + ODApplication::VERSIONSTRING))
+    {
+        mIsModified = true;
+        return;
+    }
+
+    std::vector<std::string> fields;
+    while(std::getline(indexFile, line))
+    {
+        // The name and the description can be empty so we cannot skip empty fields
+        fields.clear();
+        std::size_t begin = 0;
+        while(true)
+        {
+            std::size_t end = line.find('\t', begin);
+            fields.push_back(line.substr(begin, end - begin));
+            if(end == std::string::npos)
+                break;
+
+            begin = end + 1;
+        }
+
+        if(fields.size() != 6)
+        {
+            OD_LOG_WRN("Invalid entry in level index=" + mIndexFileName);
+            mIsModified = true;
+            continue;
+        }
+
+        Entry entry;
+        std::stringstream stamp(fields[1] + " " + fields[2] + " " + fields[3]);
+        if(!(stamp >> entry.mLastWriteTime >> entry.mFileSize >> entry.mIsValid))
+        {
+            OD_LOG_WRN("Invalid entry in level index=" + mIndexFileName);
+            mIsModified = true;
+            continue;
+        }
+
+        entry.mLevelInfo.mLevelName = unescapeField(fields[4]);
+        entry.mLevelInfo.mLevelDescription = unescapeField(fields[5]);
+        mEntries[unescapeField(fields[0])] = entry;
+    }
+}
+
+bool LevelInfoIndex::getMapInfo(const std::string& fileName, LevelInfo& levelInfo)
+{
+    std::time_t lastWriteTime;
+    uintmax_t fileSize;
+    if(!getFileStamp(fileName, lastWriteTime, fileSize))
+        return MapHandler::getMapInfo(fileName, levelInfo);
+
+    auto it = mEntries.find(fileName);
+    if((it != mEntries.end()) &&
+       (it->second.mLastWriteTime == lastWriteTime) &&
+       (it->second.mFileSize == fileSize))
+    {
+        if(!it->second.mIsValid)
+            return false;
+
+        levelInfo = it->second.mLevelInfo;
+        return true;
+    }
+
+    Entry& entry = mEntries[fileName];
+    entry.mLastWriteTime = lastWriteTime;
+    entry.mFileSize = fileSize;
+    entry.mLevelInfo = LevelInfo();
+    entry.mIsValid = MapHandler::getMapInfo(fileName, entry.mLevelInfo);
+    mIsModified = true;
+
+    if(!entry.mIsValid)
+        return false;
+
+    levelInfo = entry.mLevelInfo;
+    return true;
+}
+
+bool LevelInfoIndex::save()
+{
+    for(auto it = mEntries.begin(); it != mEntries.end();)
+    {
+        boost::system::error_code ec;
+        if(boost::filesystem::exists(it->first, ec))
+        {
+            ++it;
+            continue;
+        }
+
+        it = mEntries.erase(it);
+        mIsModified = true;
+    }
+
+    if(!mIsModified)
+        return true;
+
+    std::ofstream indexFile(mIndexFileName.c_str(), std::ofstream::out | std::ofstream::binary);
+    if(!indexFile.good())
+    {
+        OD_LOG_WRN("Couldn't write level index=" + mIndexFileName);
+        return false;
+    }
+
+    indexFile << INDEX_HEADER << "\t" << ODApplication::VERSIONSTRING << "\n";
+    for(const std::pair<const std::string, Entry>& p : mEntries)
+    {
+        const Entry& entry = p.second;
+        indexFile << escapeField(p.first)
+            << "\t" << entry.mLastWriteTime
+            << "\t" << entry.mFileSize
+            << "\t" << entry.mIsValid
+            << "\t" << escapeField(entry.mLevelInfo.mLevelName)
+            << "\t" << escapeField(entry.mLevelInfo.mLevelDescription)
+            << "\n";
+    }
+
+    indexFile.close();
+    if(indexFile.fail())
+    {
+        OD_LOG_WRN("Couldn't write level index=" + mIndexFileName);
+        return false;
+    }
+
+    mIsModified = false;
+    return true;
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVELINFOINDEX_H
+#define LEVELINFOINDEX_H
+
+#include "gamemap/MapHandler.h"
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+
+/*! \brief Caches the info of the levels listed in the menus so that they are not read each time a menu
+ * is opened.
+ *
+ * The entries are stored in a file and are keyed by the level path. A level is read again only if its
+ * modification time or its size changed since it was indexed. The whole index is dropped when the game
+ * version changes because getMapInfo rejects the levels from other versions.
+ */
+class LevelInfoIndex
+{
+public:
+    //! \brief Loads the index from the given file. If it cannot be read, the index starts empty
+    LevelInfoIndex(const std::string& indexFileName);
+
+    //! \brief Same as MapHandler::getMapInfo. The level file is read only if it is not indexed yet or if it changed
+    bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo);
+
+    //! \brief Writes the index file if it changed. The levels that do not exist anymore are removed.
+    //! Returns false if the file could not be written
+    bool save();
+
+private:
+    struct Entry
+    {
+        std::time_t mLastWriteTime;
+        uintmax_t mFileSize;
+        //! \brief false if getMapInfo failed. Invalid levels are indexed too so that they are not read each time
+        bool mIsValid;
+        LevelInfo mLevelInfo;
+    };
+
+    std::string mIndexFileName;
+    std::map<std::string, Entry> mEntries;
+    bool mIsModified;
+
+    void load();
+};
+
+#endif // LEVELINFOINDEX_H
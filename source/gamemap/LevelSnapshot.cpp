@@ -0,0 +1,579 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/LevelSnapshot.h"
+
+#include "entities/Tile.h"
+#include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+static const char SNAPSHOT_MAGIC[8] = { 'O', 'D', 'S', 'N', 'A', 'P', '\r', '\n' };
+//! \brief Should be incremented when the format of a section changes
+static const uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+enum class SnapshotSection : uint32_t
+{
+    header = 1,
+    tiles = 2,
+    entities = 3,
+    floodFill = 4
+};
+
+//! \brief Size of a tile in the tiles section: type, fullness and seat id
+static const std::size_t TILE_DATA_SIZE = 1 + 8 + 4;
+
+//! \brief The numbers are written in little endian whatever the platform is
+static void writeUInt32(std::string& buffer, uint32_t value)
+{
+    for(uint32_t i = 0; i < 4; ++i)
+        buffer += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static void writeUInt64(std::string& buffer, uint64_t value)
+{
+    for(uint32_t i = 0; i < 8; ++i)
+        buffer += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static uint32_t readUInt32(const unsigned char* data)
+{
+    uint32_t value = 0;
+    for(uint32_t i = 0; i < 4; ++i)
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    return value;
+}
+
+static uint64_t readUInt64(const unsigned char* data)
+{
+    uint64_t value = 0;
+    for(uint32_t i = 0; i < 8; ++i)
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+static void writeSection(std::ostream& os, SnapshotSection section, const std::string& data)
+{
+    std::string sectionHeader;
+    writeUInt32(sectionHeader, static_cast<uint32_t>(section));
+    writeUInt64(sectionHeader, static_cast<uint64_t>(data.size()));
+    os.write(sectionHeader.data(), static_cast<std::streamsize>(sectionHeader.size()));
+    os.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+static bool readBytes(std::istream& is, std::size_t size, std::string& data)
+{
+    data.resize(size);
+    if(size == 0)
+        return true;
+
+    is.read(&data[0], static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(is.gcount()) == size;
+}
+
+//! \brief Appends the compressed data to the given buffer
+static bool compressData(const std::string& data, std::string& buffer)
+{
+    uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
+    std::size_t offset = buffer.size();
+    buffer.resize(offset + compressedSize);
+    // The savegames are written while the game is running so we use the fastest compression
+    if(compress2(reinterpret_cast<Bytef*>(&buffer[offset]), &compressedSize,
+        reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), Z_BEST_SPEED) != Z_OK)
+    {
+        return false;
+    }
+    buffer.resize(offset + compressedSize);
+    return true;
+}
+
+//! \brief Uncompresses the given data. Returns false if it is not valid or if its size is not the one of data
+static bool uncompressData(const unsigned char* compressed, std::size_t compressedSize, std::vector<unsigned char>& data)
+{
+    uLongf destSize = static_cast<uLongf>(data.size());
+    return (uncompress(data.data(), &destSize, compressed, static_cast<uLong>(compressedSize)) == Z_OK) &&
+        (destSize == data.size());
+}
+
+LevelSnapshot::LevelSnapshot() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbFloodFillTypes(0)
+{
+}
+
+bool LevelSnapshot::isSnapshotFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    if(!file.read(magic, sizeof(magic)))
+        return false;
+
+    return std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+bool LevelSnapshot::convertFile(const std::string& fileNameIn, const std::string& fileNameOut)
+{
+    LevelSnapshot snapshot;
+    bool isSnapshot = isSnapshotFile(fileNameIn);
+    if(isSnapshot)
+    {
+        if(!snapshot.readFromFile(fileNameIn, false))
+            return false;
+    }
+    else
+    {
+        TextTokenizer tokenizer;
+        if(!tokenizer.loadFile(fileNameIn))
+        {
+            OD_LOG_WRN("File not found=" + fileNameIn);
+            return false;
+        }
+
+        if(!snapshot.readFromLevelText(tokenizer))
+        {
+            OD_LOG_WRN("Invalid level file=" + fileNameIn);
+            return false;
+        }
+    }
+
+    std::ofstream file(fileNameOut.c_str(), std::ofstream::out | std::ofstream::binary);
+    if(!file.good())
+    {
+        OD_LOG_WRN("Couldn't open file for writing: " + fileNameOut);
+        return false;
+    }
+
+    bool isWritten = isSnapshot ? snapshot.writeToLevelText(file) : snapshot.writeToStream(file);
+    file.close();
+    if(!isWritten || file.fail())
+    {
+        OD_LOG_WRN("Unexpected failure on file: " + fileNameOut);
+        return false;
+    }
+
+    return true;
+}
+
+void LevelSnapshot::setMapSize(int32_t mapSizeX, int32_t mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    TileData defaultTile;
+    defaultTile.mType = static_cast<uint8_t>(TileType::dirt);
+    defaultTile.mFullness = 100.0;
+    defaultTile.mSeatId = NO_SEAT_ID;
+    mTiles.assign(static_cast<std::size_t>(mapSizeX) * static_cast<std::size_t>(mapSizeY), defaultTile);
+    // The floodfill depends on the tiles
+    mFloodFillTeamIds.clear();
+    mNbFloodFillTypes = 0;
+    mFloodFillValues.clear();
+}
+
+void LevelSnapshot::setFloodFill(std::vector<int32_t> teamIds, uint32_t nbFloodFillTypes, std::vector<uint32_t> values)
+{
+    if(values.size() != teamIds.size() * nbFloodFillTypes * mTiles.size())
+    {
+        OD_LOG_ERR("Unexpected floodfill size=" + Helper::toString(values.size()) + ", nbTeams=" + Helper::toString(teamIds.size())
+            + ", nbFloodFillTypes=" + Helper::toString(nbFloodFillTypes) + ", nbTiles=" + Helper::toString(mTiles.size()));
+        return;
+    }
+
+    mFloodFillTeamIds.swap(teamIds);
+    mNbFloodFillTypes = nbFloodFillTypes;
+    mFloodFillValues.swap(values);
+}
+
+bool LevelSnapshot::readFloodFill(const std::string& data)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    if(mTiles.empty() || (data.size() < 8))
+        return false;
+
+    uint32_t nbTeams = readUInt32(bytes);
+    uint32_t nbFloodFillTypes = readUInt32(bytes + 4);
+    if((nbTeams == 0) || (nbFloodFillTypes == 0) || ((data.size() - 8) / 4 < nbTeams))
+        return false;
+
+    std::vector<int32_t> teamIds(nbTeams);
+    for(uint32_t i = 0; i < nbTeams; ++i)
+        teamIds[i] = static_cast<int32_t>(readUInt32(bytes + 8 + i * 4));
+
+    std::size_t offset = 8 + static_cast<std::size_t>(nbTeams) * 4;
+    std::size_t nbValues = static_cast<std::size_t>(nbTeams) * nbFloodFillTypes * mTiles.size();
+    std::vector<unsigned char> valuesData(nbValues * 4);
+    if(!uncompressData(bytes + offset, data.size() - offset, valuesData))
+        return false;
+
+    std::vector<uint32_t> values(nbValues);
+    for(std::size_t i = 0; i < nbValues; ++i)
+        values[i] = readUInt32(valuesData.data() + i * 4);
+
+    mFloodFillTeamIds.swap(teamIds);
+    mNbFloodFillTypes = nbFloodFillTypes;
+    mFloodFillValues.swap(values);
+    return true;
+}
+
+bool LevelSnapshot::writeFloodFill(std::string& data) const
+{
+    writeUInt32(data, static_cast<uint32_t>(mFloodFillTeamIds.size()));
+    writeUInt32(data, mNbFloodFillTypes);
+    for(int32_t teamId : mFloodFillTeamIds)
+        writeUInt32(data, static_cast<uint32_t>(teamId));
+
+    std::string valuesData;
+    valuesData.reserve(mFloodFillValues.size() * 4);
+    for(uint32_t value : mFloodFillValues)
+        writeUInt32(valuesData, value);
+
+    return compressData(valuesData, data);
+}
+
+bool LevelSnapshot::readFromFile(const std::string& fileName, bool headerOnly)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!file.good())
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    std::string data;
+    if(!readBytes(file, sizeof(SNAPSHOT_MAGIC) + 4, data) ||
+       (std::memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0))
+    {
+        OD_LOG_WRN("Not a snapshot file=" + fileName);
+        return false;
+    }
+
+    uint32_t formatVersion = readUInt32(reinterpret_cast<const unsigned char*>(data.data()) + sizeof(SNAPSHOT_MAGIC));
+    if(formatVersion != SNAPSHOT_FORMAT_VERSION)
+    {
+        OD_LOG_WRN("Unsupported snapshot format version=" + Helper::toString(formatVersion) + ", file=" + fileName);
+        return false;
+    }
+
+    bool hasHeader = false;
+    bool hasTiles = false;
+    bool hasEntities = false;
+    while(true)
+    {
+        // The end of the file should be reached between 2 sections
+        if(file.peek() == std::ifstream::traits_type::eof())
+            break;
+
+        if(!readBytes(file, 4 + 8, data))
+        {
+            OD_LOG_WRN("Truncated snapshot file=" + fileName);
+            return false;
+        }
+
+        const unsigned char* sectionHeader = reinterpret_cast<const unsigned char*>(data.data());
+        uint32_t sectionId = readUInt32(sectionHeader);
+        uint64_t sectionSize = readUInt64(sectionHeader + 4);
+        if(sectionSize > static_cast<uint64_t>(fileSize - file.tellg()))
+        {
+            OD_LOG_WRN("Truncated snapshot file=" + fileName);
+            return false;
+        }
+
+        switch(static_cast<SnapshotSection>(sectionId))
+        {
+            case SnapshotSection::header:
+            {
+                if(!readBytes(file, static_cast<std::size_t>(sectionSize), mHeader))
+                {
+                    OD_LOG_WRN("Truncated snapshot file=" + fileName);
+                    return false;
+                }
+                hasHeader = true;
+                break;
+            }
+            case SnapshotSection::tiles:
+            {
+                if((sectionSize < 8) || !readBytes(file, 8, data))
+                {
+                    OD_LOG_WRN("Invalid tiles section in file=" + fileName);
+                    return false;
+                }
+
+                int32_t mapSizeX = static_cast<int32_t>(readUInt32(reinterpret_cast<const unsigned char*>(data.data())));
+                int32_t mapSizeY = static_cast<int32_t>(readUInt32(reinterpret_cast<const unsigned char*>(data.data()) + 4));
+                if((mapSizeX <= 0) || (mapSizeY <= 0))
+                {
+                    OD_LOG_WRN("Invalid map size in file=" + fileName);
+                    return false;
+                }
+
+                // The map size is shown in the menus so it is read with the header
+                if(headerOnly)
+                {
+                    mMapSizeX = mapSizeX;
+                    mMapSizeY = mapSizeY;
+                    return hasHeader;
+                }
+
+                std::string compressed;
+                if(!readBytes(file, static_cast<std::size_t>(sectionSize - 8), compressed))
+                {
+                    OD_LOG_WRN("Truncated snapshot file=" + fileName);
+                    return false;
+                }
+
+                setMapSize(mapSizeX, mapSizeY);
+                std::size_t nbTiles = mTiles.size();
+                std::vector<unsigned char> tilesData(nbTiles * TILE_DATA_SIZE);
+                if(!uncompressData(reinterpret_cast<const unsigned char*>(compressed.data()), compressed.size(), tilesData))
+                {
+                    OD_LOG_WRN("Invalid tiles data in file=" + fileName);
+                    return false;
+                }
+
+                // The types, then the fullness, then the seats are stored together because they compress better
+                const unsigned char* types = tilesData.data();
+                const unsigned char* fullness = types + nbTiles;
+                const unsigned char* seatIds = fullness + nbTiles * 8;
+                for(std::size_t i = 0; i < nbTiles; ++i)
+                {
+                    TileData& tile = mTiles[i];
+                    tile.mType = types[i];
+                    uint64_t fullnessBits = readUInt64(fullness + i * 8);
+                    std::memcpy(&tile.mFullness, &fullnessBits, sizeof(tile.mFullness));
+                    tile.mSeatId = static_cast<int32_t>(readUInt32(seatIds + i * 4));
+                }
+                hasTiles = true;
+                break;
+            }
+            case SnapshotSection::entities:
+            {
+                if(!readBytes(file, static_cast<std::size_t>(sectionSize), mEntities))
+                {
+                    OD_LOG_WRN("Truncated snapshot file=" + fileName);
+                    return false;
+                }
+                hasEntities = true;
+                break;
+            }
+            case SnapshotSection::floodFill:
+            {
+                if(!readBytes(file, static_cast<std::size_t>(sectionSize), data))
+                {
+                    OD_LOG_WRN("Truncated snapshot file=" + fileName);
+                    return false;
+                }
+                if(!hasTiles || !readFloodFill(data))
+                {
+                    OD_LOG_WRN("Invalid floodfill section in file=" + fileName);
+                    return false;
+                }
+                break;
+            }
+            default:
+            {
+                // Sections added by later versions are skipped
+                file.seekg(static_cast<std::streamoff>(sectionSize), std::ios::cur);
+                if(!file.good())
+                {
+                    OD_LOG_WRN("Truncated snapshot file=" + fileName);
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+
+    if(!hasHeader || !hasTiles || !hasEntities)
+    {
+        OD_LOG_WRN("Missing section in snapshot file=" + fileName);
+        return false;
+    }
+
+    return true;
+}
+
+bool LevelSnapshot::writeToStream(std::ostream& os) const
+{
+    os.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    std::string version;
+    writeUInt32(version, SNAPSHOT_FORMAT_VERSION);
+    os.write(version.data(), static_cast<std::streamsize>(version.size()));
+
+    writeSection(os, SnapshotSection::header, mHeader);
+
+    std::size_t nbTiles = mTiles.size();
+    std::string tilesData;
+    tilesData.reserve(nbTiles * TILE_DATA_SIZE);
+    for(const TileData& tile : mTiles)
+        tilesData += static_cast<char>(tile.mType);
+
+    for(const TileData& tile : mTiles)
+    {
+        uint64_t fullnessBits;
+        std::memcpy(&fullnessBits, &tile.mFullness, sizeof(fullnessBits));
+        writeUInt64(tilesData, fullnessBits);
+    }
+
+    for(const TileData& tile : mTiles)
+        writeUInt32(tilesData, static_cast<uint32_t>(tile.mSeatId));
+
+    std::string tilesSection;
+    writeUInt32(tilesSection, static_cast<uint32_t>(mMapSizeX));
+    writeUInt32(tilesSection, static_cast<uint32_t>(mMapSizeY));
+    if(!compressData(tilesData, tilesSection))
+    {
+        OD_LOG_ERR("Couldn't compress tiles");
+        return false;
+    }
+    writeSection(os, SnapshotSection::tiles, tilesSection);
+
+    writeSection(os, SnapshotSection::entities, mEntities);
+
+    if(hasFloodFill())
+    {
+        std::string floodFillSection;
+        if(!writeFloodFill(floodFillSection))
+        {
+            OD_LOG_ERR("Couldn't compress floodfill");
+            return false;
+        }
+        writeSection(os, SnapshotSection::floodFill, floodFillSection);
+    }
+
+    return os.good();
+}
+
+bool LevelSnapshot::readFromLevelText(TextTokenizer& tokenizer)
+{
+    std::ostringstream header;
+    if(!tokenizer.copyLinesUntil("[/Goals]", header))
+    {
+        OD_LOG_WRN("No Goals section");
+        return false;
+    }
+    mHeader = header.str();
+
+    TextRef token;
+    int32_t mapSizeX;
+    int32_t mapSizeY;
+    if(!tokenizer.nextToken(token) || (token != "[Tiles]") ||
+       !tokenizer.nextToken(token) || !TextTokenizer::toInt(token, mapSizeX) ||
+       !tokenizer.nextToken(token) || !TextTokenizer::toInt(token, mapSizeY) ||
+       (mapSizeX <= 0) || (mapSizeY <= 0))
+    {
+        OD_LOG_WRN("Invalid tiles start format:" + token.toString());
+        return false;
+    }
+
+    setMapSize(mapSizeX, mapSizeY);
+    TextRef line;
+    std::vector<TextRef> fields;
+    while(true)
+    {
+        if(!tokenizer.nextLine(line))
+        {
+            OD_LOG_WRN("unexpected EOF reached");
+            return false;
+        }
+
+        line = TextTokenizer::trim(line);
+        if(line.empty())
+            continue;
+
+        if(line == "[/Tiles]")
+            break;
+
+        // Same fields as the ones read by Tile::loadFromFields
+        TextTokenizer::split(line, '\t', fields);
+        int32_t x;
+        int32_t y;
+        int32_t type;
+        if((fields.size() < 4) ||
+           !TextTokenizer::toInt(fields[0], x) || !TextTokenizer::toInt(fields[1], y) ||
+           (x < 0) || (x >= mapSizeX) || (y < 0) || (y >= mapSizeY) ||
+           !TextTokenizer::toInt(fields[2], type) || (type < 0) || (type > 255))
+        {
+            OD_LOG_WRN("Invalid tile line:" + line.toString());
+            return false;
+        }
+
+        TileData& tile = getTileData(x, y);
+        tile.mType = static_cast<uint8_t>(type);
+        tile.mFullness = 0.0;
+        tile.mSeatId = NO_SEAT_ID;
+        TileType tileType = static_cast<TileType>(type);
+        if((tileType != TileType::water) && (tileType != TileType::lava) &&
+           !TextTokenizer::toDouble(fields[3], tile.mFullness))
+        {
+            OD_LOG_WRN("Invalid tile line:" + line.toString());
+            return false;
+        }
+
+        if((fields.size() >= 5) && !TextTokenizer::toInt(fields[4], tile.mSeatId))
+        {
+            OD_LOG_WRN("Invalid tile line:" + line.toString());
+            return false;
+        }
+    }
+
+    std::ostringstream entities;
+    tokenizer.copyRemainingLines(entities);
+    mEntities = entities.str();
+    return true;
+}
+
+bool LevelSnapshot::writeToLevelText(std::ostream& os) const
+{
+    os << mHeader;
+
+    os << "\n[Tiles]\n";
+    os << "# Map Size" << std::endl;
+    os << mMapSizeX << " # MapSizeX" << std::endl;
+    os << mMapSizeY << " # MapSizeY" << std::endl;
+    os << "# " << Tile::getFormat() << "\n";
+    for(int32_t xx = 0; xx < mMapSizeX; ++xx)
+    {
+        for(int32_t yy = 0; yy < mMapSizeY; ++yy)
+        {
+            // Like MapHandler::writeGameMapToStream, the full dirt tiles are not written
+            const TileData& tile = getTileData(xx, yy);
+            if((static_cast<TileType>(tile.mType) == TileType::dirt) && (tile.mFullness >= 100.0) &&
+               (tile.mSeatId == NO_SEAT_ID))
+            {
+                continue;
+            }
+
+            os << xx << "\t" << yy << "\t" << static_cast<uint32_t>(tile.mType) << "\t" << tile.mFullness;
+            if(tile.mSeatId != NO_SEAT_ID)
+                os << "\t" << tile.mSeatId;
+            os << std::endl;
+        }
+    }
+    os << "[/Tiles]" << std::endl;
+
+    os << mEntities;
+    return os.good();
+}
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVELSNAPSHOT_H
+#define LEVELSNAPSHOT_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TextTokenizer;
+
+/*! \brief Binary format used for the savegames. The text level format stays the one used to edit and exchange levels.
+ *
+ * The file starts with a magic string and the format version followed by sections. Each section starts with its id
+ * and its size so that a reader can skip the sections it does not know:
+ * - the header: version, info, seats and goals in the text format.
+ * - the tiles: the map size then the type, fullness and seat of every tile (compressed). They are stored for all the
+ *   tiles in index order so that they are restored with a single pass and without parsing text.
+ * - the entities: rooms, traps, lights, definitions, creatures and the other entities in the text format as they are
+ *   read by their importFromStream functions.
+ * - the floodfill (optional): the teams then the floodfill values of every tile (compressed). The teams cannot
+ *   change in a savegame so the values are restored instead of being computed again. A text level has no floodfill.
+ * The savegames keep the ".level" extension. The files are recognized by their magic string (see isSnapshotFile).
+ */
+class LevelSnapshot
+{
+public:
+    struct TileData
+    {
+        uint8_t mType;
+        double mFullness;
+        //! \brief -1 if the tile has no seat
+        int32_t mSeatId;
+    };
+
+    LevelSnapshot();
+
+    //! \brief Returns true if the given file starts with the snapshot magic string
+    static bool isSnapshotFile(const std::string& fileName);
+
+    /*! \brief Converts the given level file in the other format: a text level is written as a snapshot and a
+     * snapshot as a text level. The comments of a text level are not kept. Returns false if the level could not
+     * be read or written
+     */
+    static bool convertFile(const std::string& fileNameIn, const std::string& fileNameOut);
+
+    //! \brief Reads the snapshot from the given file. If headerOnly is true, the tiles (except the map size) and the
+    //! entities are not read. Returns false if the file is not a valid snapshot
+    bool readFromFile(const std::string& fileName, bool headerOnly);
+
+    //! \brief Writes the snapshot in binary. Returns false if an error occurred
+    bool writeToStream(std::ostream& os) const;
+
+    //! \brief Reads a level in the text format. Returns false if it is not valid
+    bool readFromLevelText(TextTokenizer& tokenizer);
+
+    //! \brief Writes the snapshot in the text level format
+    bool writeToLevelText(std::ostream& os) const;
+
+    //! \brief Sets the map size. Every tile is set to full dirt without seat like the tiles not listed in a text level
+    void setMapSize(int32_t mapSizeX, int32_t mapSizeY);
+
+    inline int32_t getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int32_t getMapSizeY() const
+    { return mMapSizeY; }
+
+    //! \brief Tile at the given coordinates. They should be in the map
+    inline TileData& getTileData(int32_t x, int32_t y)
+    { return mTiles[static_cast<std::size_t>(x) * static_cast<std::size_t>(mMapSizeY) + static_cast<std::size_t>(y)]; }
+
+    inline const TileData& getTileData(int32_t x, int32_t y) const
+    { return mTiles[static_cast<std::size_t>(x) * static_cast<std::size_t>(mMapSizeY) + static_cast<std::size_t>(y)]; }
+
+    //! \brief Version, info, seats and goals in the text level format
+    inline const std::string& getHeader() const
+    { return mHeader; }
+
+    inline void setHeader(std::string header)
+    { mHeader.swap(header); }
+
+    //! \brief Sections following the tiles in the text level format
+    inline const std::string& getEntities() const
+    { return mEntities; }
+
+    inline void setEntities(std::string entities)
+    { mEntities.swap(entities); }
+
+    /*! \brief Sets the floodfill of the tiles. teamIds are the teams in the order they are indexed by the game map.
+     * The value of the tile (x, y) for the team index t and the floodfill type f is at
+     * (t * nbFloodFillTypes + f) * nbTiles + x * mapSizeY + y. The map size should be set before
+     */
+    void setFloodFill(std::vector<int32_t> teamIds, uint32_t nbFloodFillTypes, std::vector<uint32_t> values);
+
+    inline bool hasFloodFill() const
+    { return !mFloodFillTeamIds.empty(); }
+
+    inline const std::vector<int32_t>& getFloodFillTeamIds() const
+    { return mFloodFillTeamIds; }
+
+    inline uint32_t getNbFloodFillTypes() const
+    { return mNbFloodFillTypes; }
+
+    inline const std::vector<uint32_t>& getFloodFillValues() const
+    { return mFloodFillValues; }
+
+    static const int32_t NO_SEAT_ID = -1;
+
+private:
+    //! \brief Reads the floodfill section. The tiles should have been read before
+    bool readFloodFill(const std::string& data);
+
+    //! \brief Appends the floodfill section data to the given buffer
+    bool writeFloodFill(std::string& data) const;
+
+    int32_t mMapSizeX;
+    int32_t mMapSizeY;
+    //! \brief Ordered by x then y, the way the tiles are written in a text level
+    std::vector<TileData> mTiles;
+    std::string mHeader;
+    std::string mEntities;
+    //! \brief Empty if the snapshot has no floodfill
+    std::vector<int32_t> mFloodFillTeamIds;
+    uint32_t mNbFloodFillTypes;
+    std::vector<uint32_t> mFloodFillValues;
+};
+
+#endif // LEVELSNAPSHOT_H
@@ -19,6 +19,7 @@
 
 #include "creaturemood/CreatureMoodManager.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/LevelSnapshot.h"
 #include "game/Seat.h"
 #include "goals/Goal.h"
 #include "goals/GoalLoading.h"
@@ -45,20 +46,53 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/ResourceManager.h"
+#include "utils/TextTokenizer.h"
 
 #include "ODApplication.h"
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
-namespace MapHandler {
+//! \brief Number of uncommented lines needed after [Tiles] to read the map size
+static const int NB_LINES_MAP_SIZE = 2;
 
-bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
+//! \brief Reads the uncommented lines of the level file until the map size. The info read by getMapInfo
+//! is at the beginning of the file so that the tiles and the entities do not have to be read
+static bool readLevelHeaderWithoutComments(const std::string& fileName, std::stringstream& stream)
 {
-    std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    std::ifstream levelFile(fileName.c_str(), std::ifstream::in);
+    if (!levelFile.good())
+    {
+        OD_LOG_WRN("File not found=" + fileName);
         return false;
+    }
+
+    int nbLinesLeft = -1;
+    std::string line;
+    while ((nbLinesLeft != 0) && std::getline(levelFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        stream << line << "\n";
+
+        Helper::trim(line);
+        if(line.empty())
+            continue;
+
+        if(nbLinesLeft > 0)
+            --nbLinesLeft;
+        else if(line == "[Tiles]")
+            nbLinesLeft = NB_LINES_MAP_SIZE;
+    }
+
+    return true;
+}
+
+namespace MapHandler {
 
+//! \brief Reads the version, the info, the seats and the goals from the given stream
+static bool readLevelHeader(const std::string& fileName, std::stringstream& levelFile, GameMap& gameMap)
+{
     std::string nextParam;
     // Read in the version number from the level file
     levelFile >> nextParam;
@@ -132,6 +166,21 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             OD_LOG_INF("TileSet: " + tileSet);
             continue;
         }
+
+        param = "Seed\t";
+        if (nextParam.compare(0, param.size(), param) == 0)
+        {
+            std::stringstream seedStream(nextParam.substr(param.size()));
+            uint64_t seed;
+            if(!(seedStream >> seed))
+            {
+                OD_LOG_WRN("Invalid seed: " + nextParam);
+                return false;
+            }
+            gameMap.setSeed(seed);
+            gameMap.setHasLevelSeed(true);
+            continue;
+        }
     }
 
     levelFile >> nextParam;
@@ -195,51 +244,13 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             gameMap.addGoalForAllSeats(std::move(tempGoal));
     }
 
-    levelFile >> nextParam;
-    if (nextParam != "[Tiles]")
-    {
-        OD_LOG_WRN("Invalid tile start format:" + nextParam);
-        return false;
-    }
-
-    // Load the map size on next two lines
-    int mapSizeX;
-    int mapSizeY;
-    levelFile >> mapSizeX;
-    levelFile >> mapSizeY;
-
-    if (!gameMap.createNewMap(mapSizeX, mapSizeY))
-        return false;
-
-    // Read in the map tiles from disk
-    gameMap.disableFloodFill();
-
-    while (true)
-    {
-        if(!levelFile.good())
-        {
-            OD_LOG_WRN("unexpected EOF reached");
-            return false;
-        }
-
-        levelFile >> nextParam;
-        if (nextParam == "[/Tiles]")
-            break;
-
-        // Get all the params together in order to prepare for the new parsing function
-        std::string entire_line = nextParam;
-        std::getline(levelFile, nextParam);
-        entire_line += nextParam;
-
-        Tile* tile = new Tile(&gameMap, true);
-
-        Tile::loadFromLine(entire_line, tile);
-        tile->computeTileVisual();
-
-        gameMap.addTile(tile);
-    }
+    return true;
+}
 
-    gameMap.setAllFullnessAndNeighbors();
+//! \brief Reads the sections following the tiles from the given stream
+static bool readLevelEntities(std::stringstream& levelFile, GameMap& gameMap)
+{
+    std::string nextParam;
 
     // Read in the rooms
     levelFile >> nextParam;
@@ -513,6 +524,141 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     return true;
 }
 
+//! \brief Reads a savegame written by writeGameMapToSnapshot. The header and the entities are read as in a
+//! text level. The tiles are restored from the snapshot data in a single pass
+static bool readGameMapFromSnapshot(const std::string& fileName, GameMap& gameMap)
+{
+    LevelSnapshot snapshot;
+    if(!snapshot.readFromFile(fileName, false))
+        return false;
+
+    std::stringstream levelFile(snapshot.getHeader());
+    if(!readLevelHeader(fileName, levelFile, gameMap))
+        return false;
+
+    int32_t mapSizeX = snapshot.getMapSizeX();
+    int32_t mapSizeY = snapshot.getMapSizeY();
+    if (!gameMap.createNewMap(mapSizeX, mapSizeY))
+        return false;
+
+    gameMap.disableFloodFill();
+    // The floodfill is restored when it is enabled once the seats are configured
+    if(snapshot.hasFloodFill() && (snapshot.getNbFloodFillTypes() == static_cast<uint32_t>(FloodFillType::nbValues)))
+    {
+        const std::vector<int32_t>& teamIds = snapshot.getFloodFillTeamIds();
+        gameMap.setSavedFloodFill(std::vector<int>(teamIds.begin(), teamIds.end()), snapshot.getFloodFillValues());
+    }
+
+    for(int32_t xx = 0; xx < mapSizeX; ++xx)
+    {
+        for(int32_t yy = 0; yy < mapSizeY; ++yy)
+        {
+            Tile* tile = gameMap.getTile(xx, yy);
+            const LevelSnapshot::TileData& tileData = snapshot.getTileData(xx, yy);
+            Tile::loadFromData(tile, static_cast<TileType>(tileData.mType), tileData.mFullness, tileData.mSeatId);
+            tile->computeTileVisual();
+        }
+    }
+
+    gameMap.setAllFullnessAndNeighbors();
+
+    levelFile.str(snapshot.getEntities());
+    levelFile.clear();
+    return readLevelEntities(levelFile, gameMap);
+}
+
+bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
+{
+    if(LevelSnapshot::isSnapshotFile(fileName))
+        return readGameMapFromSnapshot(fileName, gameMap);
+
+    // The file is read in memory at once. The tiles, which are most of the level, are read directly
+    // from there. The other sections are read from a stream by the seats, goals and entities so they
+    // are copied in levelFile
+    TextTokenizer tokenizer;
+    if(!tokenizer.loadFile(fileName))
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return false;
+    }
+
+    std::stringstream levelFile;
+    if(!tokenizer.copyLinesUntil("[/Goals]", levelFile))
+    {
+        OD_LOG_WRN("No Goals section in file=" + fileName);
+        return false;
+    }
+
+    if(!readLevelHeader(fileName, levelFile, gameMap))
+        return false;
+
+    TextRef token;
+    if (!tokenizer.nextToken(token) || (token != "[Tiles]"))
+    {
+        OD_LOG_WRN("Invalid tile start format:" + token.toString());
+        return false;
+    }
+
+    // Load the map size on next two lines
+    int32_t mapSizeX;
+    int32_t mapSizeY;
+    if (!tokenizer.nextToken(token) || !TextTokenizer::toInt(token, mapSizeX) ||
+        !tokenizer.nextToken(token) || !TextTokenizer::toInt(token, mapSizeY))
+    {
+        OD_LOG_WRN("Invalid map size:" + token.toString());
+        return false;
+    }
+
+    if (!gameMap.createNewMap(mapSizeX, mapSizeY))
+        return false;
+
+    // Read in the map tiles from disk
+    gameMap.disableFloodFill();
+
+    TextRef line;
+    std::vector<TextRef> fields;
+    while (true)
+    {
+        if(!tokenizer.nextLine(line))
+        {
+            OD_LOG_WRN("unexpected EOF reached");
+            return false;
+        }
+
+        line = TextTokenizer::trim(line);
+        if(line.empty())
+            continue;
+
+        if (line == "[/Tiles]")
+            break;
+
+        // The tiles have been created by createNewMap. We load the line in the tile at its coordinates
+        TextTokenizer::split(line, '\t', fields);
+        Tile* tile = nullptr;
+        int32_t x;
+        int32_t y;
+        if((fields.size() >= 2) && TextTokenizer::toInt(fields[0], x) && TextTokenizer::toInt(fields[1], y))
+            tile = gameMap.getTile(x, y);
+
+        if((tile == nullptr) || !Tile::loadFromFields(fields, tile))
+        {
+            OD_LOG_WRN("Invalid tile line:" + line.toString());
+            return false;
+        }
+
+        tile->computeTileVisual();
+    }
+
+    gameMap.setAllFullnessAndNeighbors();
+
+    // The rest of the level is read from a stream
+    levelFile.str(std::string());
+    levelFile.clear();
+    tokenizer.copyRemainingLines(levelFile);
+
+    return readLevelEntities(levelFile, gameMap);
+}
+
 bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile)
 {
     std::string nextParam;
@@ -560,6 +706,23 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         return false;
     }
 
+    // The level is formatted in memory and written to the file at once
+    std::ostringstream levelStream;
+    writeGameMapToStream(levelStream, gameMap);
+    levelFile << levelStream.str();
+
+    if (!levelFile.good()) {
+        OD_LOG_WRN("Unexpected failure on file: " + fileName);
+        return false;
+    }
+
+    levelFile.close();
+    return true;
+}
+
+//! \brief Writes the version, the info, the seats and the goals
+static void writeLevelHeader(std::ostream& levelFile, GameMap& gameMap)
+{
     // Write the identifier string and the version number
     levelFile << ODApplication::VERSIONSTRING
             << "  # The version of OpenDungeons which created this file (for compatibility reasons).\n";
@@ -575,6 +738,8 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         levelFile << "FightMusic\t" << gameMap.getLevelFightMusicFile() << std::endl;
     if(!gameMap.getTileSetName().empty())
         levelFile << "TileSet\t" << gameMap.getTileSetName() << std::endl;
+    if(gameMap.hasLevelSeed())
+        levelFile << "Seed\t" << gameMap.getSeed() << std::endl;
 
     levelFile << "[/Info]" << std::endl;
 
@@ -601,7 +766,10 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         levelFile << *goal.get();
     }
     levelFile << "[/Goals]" << std::endl;
+}
 
+static void writeLevelTiles(std::ostream& levelFile, GameMap& gameMap)
+{
     levelFile << "\n[Tiles]\n";
     int mapSizeX = gameMap.getMapSizeX();
     int mapSizeY = gameMap.getMapSizeY();
@@ -629,7 +797,11 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         }
     }
     levelFile << "[/Tiles]" << std::endl;
+}
 
+//! \brief Writes the sections following the tiles
+static void writeLevelEntities(std::ostream& levelFile, GameMap& gameMap)
+{
     std::vector<Room*> rooms = gameMap.getRooms();
     std::sort(rooms.begin(), rooms.end(), Room::sortForMapSave);
 
@@ -778,13 +950,66 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         levelFile << std::endl;
     }
     levelFile << "[/Chickens]" << std::endl;
+}
 
-    if (!levelFile.good()) {
-        OD_LOG_WRN("Unexpected failure on file: " + fileName);
-        return false;
+bool writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap)
+{
+    writeLevelHeader(levelFile, gameMap);
+    writeLevelTiles(levelFile, gameMap);
+    writeLevelEntities(levelFile, gameMap);
+    return levelFile.good();
+}
+
+bool writeGameMapToSnapshot(LevelSnapshot& snapshot, GameMap& gameMap)
+{
+    // The header and the entities are kept in the text format without the comments so that they are
+    // read by the same functions as a text level
+    TextTokenizer tokenizer;
+    std::ostringstream textStream;
+    std::ostringstream strippedStream;
+    writeLevelHeader(textStream, gameMap);
+    tokenizer.setText(textStream.str());
+    tokenizer.copyRemainingLines(strippedStream);
+    snapshot.setHeader(strippedStream.str());
+
+    int mapSizeX = gameMap.getMapSizeX();
+    int mapSizeY = gameMap.getMapSizeY();
+    snapshot.setMapSize(mapSizeX, mapSizeY);
+    for(int ii = 0; ii < mapSizeX; ++ii)
+    {
+        for(int jj = 0; jj < mapSizeY; ++jj)
+        {
+            Tile* tile = gameMap.getTile(ii, jj);
+            if (tile == nullptr)
+                continue;
+
+            // Standard tiles are left as set by setMapSize like in writeLevelTiles
+            if (!tile->isClaimed() && tile->getType() == TileType::dirt && tile->getFullness() >= 100.0)
+                continue;
+
+            LevelSnapshot::TileData& tileData = snapshot.getTileData(ii, jj);
+            tileData.mType = static_cast<uint8_t>(tile->getType());
+            tileData.mFullness = tile->getFullness();
+            tileData.mSeatId = (tile->getSeat() == nullptr) ? LevelSnapshot::NO_SEAT_ID : tile->getSeat()->getId();
+        }
+    }
+
+    textStream.str(std::string());
+    strippedStream.str(std::string());
+    writeLevelEntities(textStream, gameMap);
+    tokenizer.setText(textStream.str());
+    tokenizer.copyRemainingLines(strippedStream);
+    snapshot.setEntities(strippedStream.str());
+
+    // The teams cannot change in a savegame so the floodfill does not have to be computed again when it is loaded
+    std::vector<uint32_t> floodFillValues;
+    if(gameMap.exportFloodFill(floodFillValues))
+    {
+        const std::vector<int>& teamIds = gameMap.getTeamIds();
+        snapshot.setFloodFill(std::vector<int32_t>(teamIds.begin(), teamIds.end()),
+            static_cast<uint32_t>(FloodFillType::nbValues), std::move(floodFillValues));
     }
 
-    levelFile.close();
     return true;
 }
 
@@ -792,7 +1017,17 @@ bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo)
 {
     // Prepare an invalid level reference
     std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    if(LevelSnapshot::isSnapshotFile(fileName))
+    {
+        // The map size is read from the tiles section and given like in a text level
+        LevelSnapshot snapshot;
+        if(!snapshot.readFromFile(fileName, true))
+            return false;
+
+        levelFile << snapshot.getHeader() << "[Tiles]\n"
+            << snapshot.getMapSizeX() << "\n" << snapshot.getMapSizeY() << "\n";
+    }
+    else if(!readLevelHeaderWithoutComments(fileName, levelFile))
         return false;
 
     std::string nextParam;
@@ -19,9 +19,11 @@
 #ifndef MAPHANDLER_H
 #define MAPHANDLER_H
 
+#include <iosfwd>
 #include <string>
 
 class GameMap;
+class LevelSnapshot;
 
 enum class GameEntityType;
 
@@ -44,6 +46,15 @@ namespace MapHandler
 
     bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap);
 
+    //! \brief Writes the level in the format read by readGameMapFromFile. Used to save the game in
+    //! memory before writing it to a file from another thread (see AsyncFileWriter)
+    bool writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap);
+
+    //! \brief Copies the level in the given savegame snapshot (see LevelSnapshot). The header and the entities are
+    //! formatted as text here but the snapshot is compressed and written by LevelSnapshot::writeToStream so that it
+    //! can be done from another thread. readGameMapFromFile reads both the text levels and the snapshots
+    bool writeGameMapToSnapshot(LevelSnapshot& snapshot, GameMap& gameMap);
+
     bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile);
 
     bool loadEquipments(const std::string& fileName, GameMap& gameMap);
@@ -0,0 +1,133 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/PathCache.h"
+
+#include <functional>
+
+bool PathCacheKey::operator==(const PathCacheKey& other) const
+{
+    return (mStartX == other.mStartX) &&
+        (mStartY == other.mStartY) &&
+        (mDestX == other.mDestX) &&
+        (mDestY == other.mDestY) &&
+        (mSeatId == other.mSeatId) &&
+        (mFloodFillType == other.mFloodFillType) &&
+        (mMoveSpeedGround == other.mMoveSpeedGround) &&
+        (mMoveSpeedWater == other.mMoveSpeedWater) &&
+        (mMoveSpeedLava == other.mMoveSpeedLava);
+}
+
+std::size_t PathCacheKeyHash::operator()(const PathCacheKey& key) const
+{
+    std::size_t hash = std::hash<int>()(key.mStartX);
+    auto combine = [&hash](std::size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(std::hash<int>()(key.mStartY));
+    combine(std::hash<int>()(key.mDestX));
+    combine(std::hash<int>()(key.mDestY));
+    combine(std::hash<int>()(key.mSeatId));
+    combine(std::hash<uint32_t>()(key.mFloodFillType));
+    combine(std::hash<double>()(key.mMoveSpeedGround));
+    combine(std::hash<double>()(key.mMoveSpeedWater));
+    combine(std::hash<double>()(key.mMoveSpeedLava));
+    return hash;
+}
+
+PathCache::PathCache(uint32_t capacity) :
+    mCapacity(capacity),
+    mNbHits(0),
+    mNbMisses(0)
+{
+}
+
+void PathCache::setMapSize(int mapSizeX, int mapSizeY)
+{
+    if(mRegionEpochs.setMapSize(mapSizeX, mapSizeY))
+        clear();
+}
+
+void PathCache::clear()
+{
+    mEntries.clear();
+    mEntriesByKey.clear();
+    mRegionEpochs.clear();
+}
+
+void PathCache::tileChanged(int x, int y)
+{
+    mRegionEpochs.tileChanged(x, y);
+}
+
+bool PathCache::getPath(const PathCacheKey& key, std::list<Tile*>& path)
+{
+    auto it = mEntriesByKey.find(key);
+    if(it == mEntriesByKey.end())
+    {
+        ++mNbMisses;
+        return false;
+    }
+
+    std::list<Entry>::iterator itEntry = it->second;
+    // The regions around the path are checked too because a change there may allow a shorter path
+    const Entry& entry = *itEntry;
+    if(mRegionEpochs.hasChangedSince(entry.mMinX, entry.mMinY, entry.mMaxX, entry.mMaxY, 1, entry.mEpoch))
+    {
+        mEntries.erase(itEntry);
+        mEntriesByKey.erase(it);
+        ++mNbMisses;
+        return false;
+    }
+
+    // The entry is now the most recently used
+    mEntries.splice(mEntries.begin(), mEntries, itEntry);
+    path = itEntry->mPath;
+    ++mNbHits;
+    return true;
+}
+
+void PathCache::addPath(const PathCacheKey& key, const std::list<Tile*>& path,
+    int minX, int minY, int maxX, int maxY)
+{
+    if(mCapacity == 0)
+        return;
+
+    auto it = mEntriesByKey.find(key);
+    if(it != mEntriesByKey.end())
+    {
+        mEntries.erase(it->second);
+        mEntriesByKey.erase(it);
+    }
+    else if(mEntries.size() >= mCapacity)
+    {
+        mEntriesByKey.erase(mEntries.back().mKey);
+        mEntries.pop_back();
+    }
+
+    Entry entry;
+    entry.mKey = key;
+    entry.mPath = path;
+    entry.mMinX = minX;
+    entry.mMinY = minY;
+    entry.mMaxX = maxX;
+    entry.mMaxY = maxY;
+    entry.mEpoch = mRegionEpochs.getEpoch();
+    mEntries.push_front(entry);
+    mEntriesByKey[key] = mEntries.begin();
+}
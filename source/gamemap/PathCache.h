@@ -0,0 +1,117 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "gamemap/RegionEpochs.h"
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+class Tile;
+
+//! \brief Identifies a path query. 2 creatures with the same key will get the same path from GameMap::path
+struct PathCacheKey
+{
+    int mStartX;
+    int mStartY;
+    int mDestX;
+    int mDestY;
+    //! \brief Seat of the creature. Needed because doors are only passable for some seats
+    int mSeatId;
+    //! \brief Movement class (see GameMap::getFloodFillTypeForCreature)
+    uint32_t mFloodFillType;
+    //! \brief The A* weights depend on the creature speeds so we need them to get the same path
+    double mMoveSpeedGround;
+    double mMoveSpeedWater;
+    double mMoveSpeedLava;
+
+    bool operator==(const PathCacheKey& other) const;
+};
+
+struct PathCacheKeyHash
+{
+    std::size_t operator()(const PathCacheKey& key) const;
+};
+
+/*! \brief Bounded LRU cache of the paths computed by GameMap::path.
+ *
+ * The map is cut in square regions (see RegionEpochs). Each time the passability of a tile changes
+ * (digging, door locked/unlocked, bridge built/destroyed, ...), the epoch of its region is bumped. A cached
+ * path is dropped if the epoch of a region overlapping its bounding box (plus a margin of one region) has been
+ * bumped after the path was computed.
+ * Note that a tile becoming passable far from a cached path could allow a shorter path. In this case,
+ * the cached path is still walkable and will be used until it is evicted.
+ */
+class PathCache
+{
+public:
+    PathCache(uint32_t capacity);
+
+    //! \brief Sets the map size. If it changed, the cache is cleared
+    void setMapSize(int mapSizeX, int mapSizeY);
+
+    //! \brief Drops every cached path. Should be called when the tiles are deleted
+    void clear();
+
+    //! \brief Bumps the epoch of the region containing the tile (x, y)
+    void tileChanged(int x, int y);
+
+    //! \brief If a valid path is cached for the given key, fills path with it and returns true.
+    //! Updates the hits/misses counters
+    bool getPath(const PathCacheKey& key, std::list<Tile*>& path);
+
+    //! \brief Adds the given path to the cache. minX, minY, maxX and maxY is the bounding box of
+    //! the path tiles. If the cache is full, the least recently used path is dropped
+    void addPath(const PathCacheKey& key, const std::list<Tile*>& path,
+        int minX, int minY, int maxX, int maxY);
+
+    inline uint32_t getNbHits() const
+    { return mNbHits; }
+
+    inline uint32_t getNbMisses() const
+    { return mNbMisses; }
+
+private:
+    struct Entry
+    {
+        PathCacheKey mKey;
+        std::list<Tile*> mPath;
+        //! \brief Bounding box of the path tiles
+        int mMinX;
+        int mMinY;
+        int mMaxX;
+        int mMaxY;
+        //! \brief Epoch when the path was computed
+        uint64_t mEpoch;
+    };
+
+    uint32_t mCapacity;
+
+    RegionEpochs mRegionEpochs;
+
+    //! \brief Cached paths. The most recently used is at the front
+    std::list<Entry> mEntries;
+    std::unordered_map<PathCacheKey, std::list<Entry>::iterator, PathCacheKeyHash> mEntriesByKey;
+
+    uint32_t mNbHits;
+    uint32_t mNbMisses;
+};
+
+#endif // PATHCACHE_H
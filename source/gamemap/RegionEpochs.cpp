@@ -0,0 +1,76 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/RegionEpochs.h"
+
+#include <algorithm>
+
+const int RegionEpochs::REGION_SIZE = 16;
+
+RegionEpochs::RegionEpochs() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbRegionsX(0),
+    mNbRegionsY(0),
+    mEpoch(0)
+{
+}
+
+bool RegionEpochs::setMapSize(int mapSizeX, int mapSizeY)
+{
+    if((mMapSizeX == mapSizeX) && (mMapSizeY == mapSizeY))
+        return false;
+
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    mNbRegionsX = (mapSizeX + REGION_SIZE - 1) / REGION_SIZE;
+    mNbRegionsY = (mapSizeY + REGION_SIZE - 1) / REGION_SIZE;
+    clear();
+    return true;
+}
+
+void RegionEpochs::clear()
+{
+    mRegionEpochs.assign(static_cast<uint32_t>(mNbRegionsX * mNbRegionsY), 0);
+}
+
+void RegionEpochs::tileChanged(int x, int y)
+{
+    if((x < 0) || (x >= mMapSizeX) || (y < 0) || (y >= mMapSizeY))
+        return;
+
+    ++mEpoch;
+    mRegionEpochs[(y / REGION_SIZE) * mNbRegionsX + (x / REGION_SIZE)] = mEpoch;
+}
+
+bool RegionEpochs::hasChangedSince(int minX, int minY, int maxX, int maxY, int margin, uint64_t epoch) const
+{
+    int minRegionX = std::max(0, std::max(0, minX) / REGION_SIZE - margin);
+    int minRegionY = std::max(0, std::max(0, minY) / REGION_SIZE - margin);
+    int maxRegionX = std::min(mNbRegionsX - 1, std::max(0, maxX) / REGION_SIZE + margin);
+    int maxRegionY = std::min(mNbRegionsY - 1, std::max(0, maxY) / REGION_SIZE + margin);
+    for(int regionY = minRegionY; regionY <= maxRegionY; ++regionY)
+    {
+        for(int regionX = minRegionX; regionX <= maxRegionX; ++regionX)
+        {
+            if(mRegionEpochs[regionY * mNbRegionsX + regionX] > epoch)
+                return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,67 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGIONEPOCHS_H
+#define REGIONEPOCHS_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Keeps track of the last time something changed in each region of the map.
+ *
+ * The map is cut in square regions of REGION_SIZE tiles. A global epoch is incremented each time
+ * a tile changes and the region containing the tile remembers it. Something computed at a given epoch
+ * over some area is still valid as long as hasChangedSince returns false for this area.
+ */
+class RegionEpochs
+{
+public:
+    static const int REGION_SIZE;
+
+    RegionEpochs();
+
+    //! \brief Sets the map size. If it changed, the regions are reset and true is returned
+    bool setMapSize(int mapSizeX, int mapSizeY);
+
+    //! \brief Forgets the changes in every region. The epoch keeps increasing so that
+    //! anything computed before is still considered as older
+    void clear();
+
+    //! \brief Bumps the epoch and marks the region containing the tile (x, y) as changed
+    void tileChanged(int x, int y);
+
+    inline uint64_t getEpoch() const
+    { return mEpoch; }
+
+    //! \brief Returns true if a tile changed after the given epoch in one of the regions overlapping
+    //! the given area (in tile coordinates) with a margin of margin regions
+    bool hasChangedSince(int minX, int minY, int maxX, int maxY, int margin, uint64_t epoch) const;
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    int mNbRegionsX;
+    int mNbRegionsY;
+
+    //! \brief Incremented each time a tile changes
+    uint64_t mEpoch;
+
+    //! \brief Value of mEpoch the last time a tile changed in each region
+    std::vector<uint64_t> mRegionEpochs;
+};
+
+#endif // REGIONEPOCHS_H
@@ -0,0 +1,72 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/SeatRegionIndex.h"
+
+const int SeatRegionIndex::REGION_SIZE = 8;
+
+SeatRegionIndex::SeatRegionIndex() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbRegionsX(0),
+    mNbRegionsY(0)
+{
+}
+
+void SeatRegionIndex::setMapSize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    mNbRegionsX = (mapSizeX + REGION_SIZE - 1) / REGION_SIZE;
+    mNbRegionsY = (mapSizeY + REGION_SIZE - 1) / REGION_SIZE;
+    clear();
+}
+
+void SeatRegionIndex::clear()
+{
+    uint32_t nbRegions = static_cast<uint32_t>(mNbRegionsX * mNbRegionsY);
+    mRegionSeats.assign(nbRegions, 0);
+    mCounts.assign(nbRegions * 64, 0);
+}
+
+void SeatRegionIndex::add(int x, int y, int seatId)
+{
+    if((x < 0) || (x >= mMapSizeX) || (y < 0) || (y >= mMapSizeY))
+        return;
+
+    uint32_t region = static_cast<uint32_t>((y / REGION_SIZE) * mNbRegionsX + (x / REGION_SIZE));
+    uint32_t bitIndex = static_cast<uint32_t>(seatId) % 64;
+    ++mCounts[region * 64 + bitIndex];
+    mRegionSeats[region] |= seatBit(seatId);
+}
+
+void SeatRegionIndex::remove(int x, int y, int seatId)
+{
+    if((x < 0) || (x >= mMapSizeX) || (y < 0) || (y >= mMapSizeY))
+        return;
+
+    uint32_t region = static_cast<uint32_t>((y / REGION_SIZE) * mNbRegionsX + (x / REGION_SIZE));
+    uint32_t bitIndex = static_cast<uint32_t>(seatId) % 64;
+    uint32_t& count = mCounts[region * 64 + bitIndex];
+    // The index is cleared with the map. The entities removed after that are ignored
+    if(count == 0)
+        return;
+
+    --count;
+    if(count == 0)
+        mRegionSeats[region] &= ~seatBit(seatId);
+}
@@ -0,0 +1,80 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEATREGIONINDEX_H
+#define SEATREGIONINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Keeps track of the seats owning creatures or buildings in each region of the map.
+ *
+ * The map is cut in square regions of REGION_SIZE tiles. Each region counts, for each seat, the creatures
+ * standing on its tiles and its tiles covered by a building, and keeps a mask of the seats having at least
+ * one. The queries looking for the entities of some seats (see GameMap::getVisibleForce) skip the tiles of
+ * the regions where none of them is.
+ * The seats are given by their id and mapped to the bits of a 64 bits mask. If 2 seats get the same bit,
+ * a mask can only tell that the entities of one of them may be there, which is still enough to skip tiles.
+ */
+class SeatRegionIndex
+{
+public:
+    static const int REGION_SIZE;
+
+    SeatRegionIndex();
+
+    //! \brief Sets the map size. The regions are emptied
+    void setMapSize(int mapSizeX, int mapSizeY);
+
+    //! \brief Empties every region
+    void clear();
+
+    //! \brief Returns the bit of the given seat id in the masks
+    static inline uint64_t seatBit(int seatId)
+    { return static_cast<uint64_t>(1) << (static_cast<uint32_t>(seatId) % 64); }
+
+    //! \brief Should be called when a creature of the given seat enters the tile (x, y) or when a building
+    //! of the given seat covers it
+    void add(int x, int y, int seatId);
+
+    //! \brief Opposite of add. Should be called with the same seat as add
+    void remove(int x, int y, int seatId);
+
+    //! \brief Returns the mask of the seats (see seatBit) having entities in the region of the tile (x, y)
+    inline uint64_t getSeatsAt(int x, int y) const
+    {
+        if((x < 0) || (x >= mMapSizeX) || (y < 0) || (y >= mMapSizeY))
+            return 0;
+
+        return mRegionSeats[(y / REGION_SIZE) * mNbRegionsX + (x / REGION_SIZE)];
+    }
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    int mNbRegionsX;
+    int mNbRegionsY;
+
+    //! \brief Mask of the seats having entities for each region
+    std::vector<uint64_t> mRegionSeats;
+
+    //! \brief Number of entities for each region and seat bit. The count of the bit b in the region r is
+    //! at index r * 64 + b
+    std::vector<uint32_t> mCounts;
+};
+
+#endif // SEATREGIONINDEX_H
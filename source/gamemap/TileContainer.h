@@ -18,13 +18,17 @@
 #ifndef TILECONTAINER_H
 #define TILECONTAINER_H
 
-#include <cassert>
+#include "gamemap/SeatRegionIndex.h"
+#include "gamemap/TileStore.h"
+#include "gamemap/VisibilityKernel.h"
+
 #include <list>
 #include <vector>
 
 class ODPacket;
-class TileDistance;
 class Tile;
+class TileDeltaReader;
+class TileDeltaWriter;
 
 enum class TileType;
 
@@ -47,21 +51,39 @@ public:
     //! \brief Returns a pointer to the tile at location (x, y) (const version).
     inline Tile* getTile(int xx, int yy) const
     {
-        assert(mTiles != nullptr);
-
         if (xx < getMapSizeX() && yy < getMapSizeY() && xx >= 0 && yy >= 0)
-            return mTiles[xx][yy];
+            return mTiles[mTileStore.getIndex(xx, yy)];
         else
         {
             return nullptr;
         }
     }
 
+    //! \brief Returns the fields of the tiles used by the whole map loops (see TileStore)
+    inline TileStore& getTileStore()
+    { return mTileStore; }
+
+    inline const TileStore& getTileStore() const
+    { return mTileStore; }
+
+    //! \brief Returns the seats owning creatures or buildings in each region. Kept up to date by the tiles
+    inline SeatRegionIndex& getSeatRegionIndex()
+    { return mSeatRegionIndex; }
+
+    inline const SeatRegionIndex& getSeatRegionIndex() const
+    { return mSeatRegionIndex; }
+
     //! \brief This functions exports the needed to retrieve a tile for networking.
     //! The tile informations are not embedded, only the needed to identify the tile
     void tileToPacket(ODPacket& packet, Tile* tile) const;
     Tile* tileFromPacket(ODPacket& packet) const;
 
+    //! \brief Same as tileToPacket for a list of tiles with the compact encoding (see TileDeltaWriter).
+    //! The tiles should be sorted by row to get the smallest packets
+    void tilesToPacket(TileDeltaWriter& writer, const std::vector<Tile*>& tiles) const;
+    //! \brief Fills tiles (cleared first) with the tiles read. Returns false if a tile is invalid
+    bool tilesFromPacket(TileDeltaReader& reader, std::vector<Tile*>& tiles) const;
+
     //! \brief Returns all the valid tiles in the rectangular region specified by the two corner points given.
     std::vector<Tile*> rectangularRegion(int x1, int y1, int x2, int y2);
 
@@ -97,6 +119,16 @@ public:
     //! the furthest
     std::vector<Tile*> visibleTiles(int x, int y, int radius);
 
+    //! \brief Same as above but fills the given vector (cleared first) to avoid allocating a new one at each call
+    void visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles);
+
+    //! \brief Should be called when the given tile may have changed its opacity (see Tile::permitsVision)
+    void refreshTileOpacity(Tile& tile);
+
+    //! \brief Returns the number of tiles where the opacity bitmap does not match Tile::permitsVision. Should
+    //! always be 0 (see refreshTileOpacity). Used for debugging
+    uint32_t countOpacityMismatches();
+
 protected:
     //! \brief The map size
     int mMapSizeX;
@@ -104,20 +136,26 @@ protected:
 
     int mRr;
 
+    //! \brief Helper to compute circular regions and visible tiles more efficiently
+    VisibilityKernel mVisibilityKernel;
+
     //! \brief Set the map size and memory
     bool allocateMapMemory(int xSize, int ySize);
+
+    //! \brief Returns the opacity of every tile. It is built the first time it is needed and kept up to date
+    //! with refreshTileOpacity
+    const OpacityBitmap& getOpacityBitmap();
+
 private:
-    Tile*** mTiles;
+    //! \brief The tiles, indexed like their fields in mTileStore
+    std::vector<Tile*> mTiles;
 
-    //! \brief Fills mTileDistance that will help to compute a vector with sorted Tiles more efficiently
-    void buildTileDistance(int distance);
+    TileStore mTileStore;
 
-    //! \brief Helper to compute tile distances more efficiently
-    std::vector<TileDistance> mTileDistance;
+    SeatRegionIndex mSeatRegionIndex;
 
-    //! \brief Stores the highest distance computed. If a bigger distance is asked, mTileDistance will have to be updated by
-    //! calling buildTileDistance with the higher distance
-    int mTileDistanceComputed;
+    OpacityBitmap mOpacityBitmap;
+    bool mIsOpacityBitmapBuilt;
 };
 
 #endif //TILECONTAINER_H
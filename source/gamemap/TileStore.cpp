@@ -0,0 +1,99 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileStore.h"
+
+#include "entities/Tile.h"
+
+const int32_t TileStore::NO_SEAT = -1;
+const uint32_t TileStore::NO_FLOODFILL;
+const uint32_t TileStore::NB_FLOODFILL_TYPES = static_cast<uint32_t>(FloodFillType::nbValues);
+
+TileStore::TileStore() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbTeams(0)
+{
+}
+
+void TileStore::setMapSize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    uint32_t nbTiles = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    mTypes.assign(nbTiles, TileType::dirt);
+    mFullness.assign(nbTiles, 100.0);
+    mClaimedPercentages.assign(nbTiles, 0.0);
+    mSeatIds.assign(nbTiles, NO_SEAT);
+    mFloodFillValues.assign(nbTiles * mNbTeams * NB_FLOODFILL_TYPES, NO_FLOODFILL);
+    mNbClaimedTiles.clear();
+}
+
+void TileStore::setTeamsNumber(uint32_t nbTeams)
+{
+    mNbTeams = nbTeams;
+    mFloodFillValues.assign(getNbTiles() * mNbTeams * NB_FLOODFILL_TYPES, NO_FLOODFILL);
+}
+
+uint64_t TileStore::getMemorySize() const
+{
+    return mTypes.capacity() * sizeof(TileType)
+        + mFullness.capacity() * sizeof(double)
+        + mClaimedPercentages.capacity() * sizeof(double)
+        + mSeatIds.capacity() * sizeof(int32_t)
+        + mFloodFillValues.capacity() * sizeof(uint32_t)
+        + mNbClaimedTiles.capacity() * sizeof(uint32_t);
+}
+
+void TileStore::setClaimedPercentage(uint32_t index, double claimedPercentage)
+{
+    bool wasClaimed = isClaimed(index);
+    mClaimedPercentages[index] = claimedPercentage;
+    bool claimed = isClaimed(index);
+    if(claimed == wasClaimed)
+        return;
+
+    int32_t seatId = mSeatIds[index];
+    if(claimed)
+    {
+        if(static_cast<uint32_t>(seatId) >= mNbClaimedTiles.size())
+            mNbClaimedTiles.resize(seatId + 1, 0);
+
+        ++mNbClaimedTiles[seatId];
+    }
+    else
+        --mNbClaimedTiles[seatId];
+}
+
+void TileStore::setSeatId(uint32_t index, int32_t seatId)
+{
+    int32_t oldSeatId = mSeatIds[index];
+    if(oldSeatId == seatId)
+        return;
+
+    if(isClaimed(index))
+        --mNbClaimedTiles[oldSeatId];
+
+    mSeatIds[index] = seatId;
+    if(!isClaimed(index))
+        return;
+
+    if(static_cast<uint32_t>(seatId) >= mNbClaimedTiles.size())
+        mNbClaimedTiles.resize(seatId + 1, 0);
+
+    ++mNbClaimedTiles[seatId];
+}
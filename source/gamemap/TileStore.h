@@ -0,0 +1,142 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILESTORE_H
+#define TILESTORE_H
+
+#include <cstdint>
+#include <vector>
+
+enum class TileType;
+
+/*! \brief Flat storage for the tile fields read by the whole map loops.
+ *
+ * Each field is stored in its own array indexed by getIndex(x, y) so that a loop over every tile
+ * reads contiguous memory instead of following a pointer to each Tile. The Tile objects keep their
+ * index and read/write these fields through their accessors.
+ * The vision is not stored here: the vision sources are counted by the VisionTracker (indexed like
+ * this store) and the opacity is kept in the OpacityBitmap of the TileContainer.
+ */
+class TileStore
+{
+public:
+    //! \brief Seat id stored for the tiles with no seat
+    static const int32_t NO_SEAT;
+    //! \brief Floodfill value of the tiles that cannot be walked on (see Tile::NO_FLOODFILL)
+    static const uint32_t NO_FLOODFILL = 0;
+    //! \brief Must be the same as FloodFillType::nbValues
+    static const uint32_t NB_FLOODFILL_TYPES;
+
+    TileStore();
+
+    //! \brief Sets the map size. Every field is reset to its default value
+    void setMapSize(int mapSizeX, int mapSizeY);
+
+    //! \brief Sets the number of teams. The floodfill values of every tile are reset
+    void setTeamsNumber(uint32_t nbTeams);
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    inline uint32_t getIndex(int x, int y) const
+    { return static_cast<uint32_t>(y * mMapSizeX + x); }
+
+    inline uint32_t getNbTiles() const
+    { return static_cast<uint32_t>(mTypes.size()); }
+
+    inline uint32_t getNbTeams() const
+    { return mNbTeams; }
+
+    //! \brief Returns the memory used by the arrays in bytes
+    uint64_t getMemorySize() const;
+
+    inline TileType getType(uint32_t index) const
+    { return mTypes[index]; }
+
+    inline void setType(uint32_t index, TileType type)
+    { mTypes[index] = type; }
+
+    inline double getFullness(uint32_t index) const
+    { return mFullness[index]; }
+
+    inline void setFullness(uint32_t index, double fullness)
+    { mFullness[index] = fullness; }
+
+    inline double getClaimedPercentage(uint32_t index) const
+    { return mClaimedPercentages[index]; }
+
+    //! \brief Sets the claimed percentage and updates the number of tiles claimed by the tile seat
+    void setClaimedPercentage(uint32_t index, double claimedPercentage);
+
+    //! \brief Returns the id of the seat owning the tile or NO_SEAT
+    inline int32_t getSeatId(uint32_t index) const
+    { return mSeatIds[index]; }
+
+    //! \brief Sets the seat owning the tile and updates the number of tiles claimed by the old and new seats
+    void setSeatId(uint32_t index, int32_t seatId);
+
+    //! \brief A tile is claimed if it has a seat and a claimed percentage of 1 (see Tile::isClaimed)
+    inline bool isClaimed(uint32_t index) const
+    { return (mSeatIds[index] >= 0) && (mClaimedPercentages[index] >= 1.0); }
+
+    //! \brief Returns the number of tiles claimed by the given seat. It is kept up to date when the
+    //! tiles are claimed or lost so that the seats do not need to scan the whole map
+    inline uint32_t getNbClaimedTiles(int32_t seatId) const
+    {
+        if((seatId < 0) || (static_cast<uint32_t>(seatId) >= mNbClaimedTiles.size()))
+            return 0;
+
+        return mNbClaimedTiles[seatId];
+    }
+
+    //! \brief Floodfill values of the given tile for the given team. There is one value per FloodFillType.
+    //! Returns nullptr if the team index is not valid
+    inline uint32_t* getFloodFillValues(uint32_t index, uint32_t teamIndex)
+    {
+        if(teamIndex >= mNbTeams)
+            return nullptr;
+
+        return &mFloodFillValues[(index * mNbTeams + teamIndex) * NB_FLOODFILL_TYPES];
+    }
+
+    inline const uint32_t* getFloodFillValues(uint32_t index, uint32_t teamIndex) const
+    {
+        if(teamIndex >= mNbTeams)
+            return nullptr;
+
+        return &mFloodFillValues[(index * mNbTeams + teamIndex) * NB_FLOODFILL_TYPES];
+    }
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    uint32_t mNbTeams;
+
+    std::vector<TileType> mTypes;
+    std::vector<double> mFullness;
+    std::vector<double> mClaimedPercentages;
+    std::vector<int32_t> mSeatIds;
+    //! \brief NB_FLOODFILL_TYPES values per team for each tile
+    std::vector<uint32_t> mFloodFillValues;
+    //! \brief Number of claimed tiles indexed by seat id
+    std::vector<uint32_t> mNbClaimedTiles;
+};
+
+#endif // TILESTORE_H
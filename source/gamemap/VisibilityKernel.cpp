@@ -0,0 +1,503 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/VisibilityKernel.h"
+
+#include <algorithm>
+
+const int VisibilityKernel::OCTANT_COEFS[8][4] =
+{
+    { 1,  0,  0,  1},
+    { 0,  1, -1,  0},
+    {-1,  0,  0, -1},
+    { 0, -1,  1,  0},
+    { 0,  1,  1,  0},
+    { 1,  0,  0, -1},
+    { 0, -1, -1,  0},
+    {-1,  0,  0,  1}
+};
+
+void OpacityBitmap::setMapSize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    mBits.assign((static_cast<uint32_t>(mapSizeX * mapSizeY) + 63) / 64, 0);
+}
+
+void OpacityBitmap::setOpaque(int x, int y, bool opaque)
+{
+    uint32_t index = static_cast<uint32_t>(y * mMapSizeX + x);
+    uint64_t mask = static_cast<uint64_t>(1) << (index % 64);
+    if(opaque)
+        mBits[index / 64] |= mask;
+    else
+        mBits[index / 64] &= ~mask;
+}
+
+static void addHiddenTile(std::vector<VisibilityKernel::HiddenTile>& hiddenTiles, uint32_t indexTile, double hiddenPercent)
+{
+    VisibilityKernel::HiddenTile hiddenTile;
+    hiddenTile.mIndex = indexTile;
+    hiddenTile.mHiddenValue = hiddenPercent;
+    hiddenTiles.push_back(hiddenTile);
+}
+
+//! \brief Computes how much tileDistance is hidden by hidingTile when hidingTile blocks vision
+static void computeHiddenTile(const VisibilityKernel::TileDistance& hidingTile, double coefNorth, double coefSouth,
+    const VisibilityKernel::TileDistance& tileDistance, uint32_t indexTileDistance,
+    std::vector<VisibilityKernel::HiddenTile>& hiddenTilesNorth,
+    std::vector<VisibilityKernel::HiddenTile>& hiddenTilesSouth)
+{
+
+    // A tile can only hide tiles behind (x > tile.x and y > tile.y)
+    if(tileDistance.mDiffX < hidingTile.mDiffX)
+        return;
+    if(tileDistance.mDiffY < hidingTile.mDiffY)
+        return;
+
+    // We don't want a tile to hide itself
+    if((tileDistance.mDiffX == hidingTile.mDiffX) &&
+       (tileDistance.mDiffY == hidingTile.mDiffY))
+    {
+        return;
+    }
+
+    if(hidingTile.mType == VisibilityKernel::TileDistanceType::Horizontal)
+    {
+        // For horizontal tiles, we hide following tiles (x > tile.x). But we process
+        // north tiles normally
+        if(tileDistance.mType == VisibilityKernel::TileDistanceType::Horizontal)
+        {
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, 1.0);
+            return;
+        }
+
+        double xTileDeb = static_cast<double>(tileDistance.mDiffX) - 0.5;
+        double xTileEnd = xTileDeb + 1.0;
+        double yTileDeb = static_cast<double>(tileDistance.mDiffY) - 0.5;
+        double yTileEnd = yTileDeb + 1.0;
+        double yHideDebNorth = coefNorth * xTileDeb;
+        double yHideEndNorth = coefNorth * xTileEnd;
+
+        // If the tile is over the North ray, it is not hidden
+        if(yHideEndNorth <= yTileDeb)
+            return;
+
+        // We check which part of the tile is hidden
+        if((yHideDebNorth >= yTileDeb) &&
+           (yHideEndNorth <= yTileEnd))
+        {
+            // The ray hits the left side of the tile and the right side.
+            // The south part is partially hidden
+            double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+            hiddenArea += yHideDebNorth - yTileDeb;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileDeb) &&
+                (yHideEndNorth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefNorth;
+            double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileEnd) &&
+                (yHideEndNorth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefNorth;
+            double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, 1.0 - visibleArea);
+        }
+        else
+        {
+            // The entire tile is hidden
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, 1.0);
+        }
+
+        return;
+    }
+
+    double xTileDeb = static_cast<double>(tileDistance.mDiffX) - 0.5;
+    double xTileEnd = xTileDeb + 1.0;
+    double yTileDeb = static_cast<double>(tileDistance.mDiffY) - 0.5;
+    double yTileEnd = yTileDeb + 1.0;
+
+    // We check if the current tile is hidden by the tile. To consider that the
+    // tile is hidden by the south, as we know the angle will be between 0 and 45 degrees,
+    // we consider that the tile has to be hit by the ray passing through the hiding tile
+    // on the left side of the tile (otherwise, the hidden part will be too small).
+    double yHideDebSouth = coefSouth * xTileDeb;
+    double yHideEndSouth = coefSouth * xTileEnd;
+    double yHideDebNorth = coefNorth * xTileDeb;
+    double yHideEndNorth = coefNorth * xTileEnd;
+    // We check if at least a part of the tile is hidden
+    if((yHideDebSouth < yTileEnd) &&
+       (yHideEndNorth > yTileDeb))
+    {
+        // At least a part of this tile is hidden
+        if((yHideDebSouth >= yTileDeb) &&
+           (yHideEndSouth <= yTileEnd))
+        {
+            // The ray hits the left side of the tile and the right side.
+            // The south part is partially hidden
+            // The visible part is composed from a square between the tile inferior part and
+            // the triangle made by the ray
+            double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
+            visibleArea += yHideDebSouth - yTileDeb;
+            addHiddenTile(hiddenTilesNorth, indexTileDistance, 1.0 - visibleArea);
+        }
+        else if((yHideDebSouth < yTileDeb) &&
+                (yHideEndSouth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefSouth;
+            double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTile(hiddenTilesNorth, indexTileDistance, 1.0 - visibleArea);
+        }
+        else if((yHideDebSouth < yTileEnd) &&
+                (yHideEndSouth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefSouth;
+            double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTile(hiddenTilesNorth, indexTileDistance, hiddenArea);
+
+        }
+        else if((yHideDebNorth >= yTileDeb) &&
+           (yHideEndNorth <= yTileEnd))
+        {
+            double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+            hiddenArea += yHideDebNorth - yTileDeb;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileDeb) &&
+                (yHideEndNorth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefNorth;
+            double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileEnd) &&
+                (yHideEndNorth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefNorth;
+            double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, 1.0 - visibleArea);
+        }
+        else
+        {
+            // The entire tile is hidden
+            addHiddenTile(hiddenTilesSouth, indexTileDistance, 1.0);
+        }
+    }
+}
+
+static bool sortByDistSquared(const VisibilityKernel::TileDistance& tileDist1, const VisibilityKernel::TileDistance& tileDist2)
+{
+    return tileDist1.mDistSquared < tileDist2.mDistSquared;
+}
+
+VisibilityKernel::VisibilityKernel(int initTileDistance) :
+    mTileDistanceComputed(0)
+{
+    buildTileDistance(initTileDistance);
+}
+
+void VisibilityKernel::buildTileDistance(int distance)
+{
+    if(mTileDistanceComputed >= distance)
+        return;
+
+    // We want to be able to fill a vector of tiles sorted beginning with the closest tile. If we look a grid (each letter
+    // represents a tile at the same distance from the center: a):
+    // jihghij
+    // ifedefi
+    // hecbceh
+    // gdbabdg
+    // hecbceh
+    // ifedefi
+    // jihghij
+    // We can see that there are 3 kind of tiles:
+    // - Vertical/Horizontal tiles (abdg): at each distance, there are 4 of them
+    // - Diagonal tiles (acfj): at each distance, there are 4 of them
+    // - Other tiles (ehi...): at each distance, there are 8 of them
+    // Moreover, we can see a symmetry. We can compute all tiles by computing only 1/8 tiles:
+    //    j
+    //   fi
+    //  ceh
+    // abdg
+
+    // If we compute only the minimum tiles needed, we have no vertical tiles (since each of them can be deduced from the horizontal)
+    // To compute tiles easily, we will compute the 1/8 tiles until distance. Then, we will sort the tiles to begin with
+    // closest distance until farthest
+    mTileDistance.clear();
+    mHiddenTilesNorth.clear();
+    mHiddenTilesSouth.clear();
+    for(int y = 0; y <= distance; ++y)
+    {
+        for(int x = y; x <= distance; ++x)
+        {
+            TileDistance tileDistance;
+            tileDistance.mDiffX = x;
+            tileDistance.mDiffY = y;
+            if(y == 0)
+                tileDistance.mType = TileDistanceType::Horizontal;
+            else if(x == y)
+                tileDistance.mType = TileDistanceType::Diagonal;
+            else
+                tileDistance.mType = TileDistanceType::Other;
+
+            tileDistance.mDistSquared = x * x + y * y;
+            tileDistance.mHiddenNorthBegin = 0;
+            tileDistance.mHiddenNorthEnd = 0;
+            tileDistance.mHiddenSouthBegin = 0;
+            tileDistance.mHiddenSouthEnd = 0;
+            mTileDistance.push_back(tileDistance);
+        }
+    }
+
+    std::sort(mTileDistance.begin(), mTileDistance.end(), sortByDistSquared);
+
+    // We have filled the tile distance vector. Now, we fill how each tile hides the
+    // other ones when they mask vision to help calculate visible tiles
+    for(TileDistance& tileDistance : mTileDistance)
+    {
+        tileDistance.mHiddenNorthBegin = static_cast<uint32_t>(mHiddenTilesNorth.size());
+        tileDistance.mHiddenSouthBegin = static_cast<uint32_t>(mHiddenTilesSouth.size());
+
+        // We don't process the first tile
+        if(tileDistance.mDiffX != 0 || tileDistance.mDiffY != 0)
+        {
+            // Other tiles can hide with their down side and their up side other tiles
+            // or diagonal tiles (but not Horizontal tiles)
+            // We compute the tiles hidden from the south. In this case, only tiles with
+            // x > tile.x can be hidden
+            double coefNorth = (static_cast<double>(tileDistance.mDiffY) + 0.5) / (static_cast<double>(tileDistance.mDiffX) - 0.5);
+            double coefSouth = (static_cast<double>(tileDistance.mDiffY) - 0.5) / (static_cast<double>(tileDistance.mDiffX) + 0.5);
+            for(uint32_t index = 0; index < mTileDistance.size(); ++index)
+            {
+                computeHiddenTile(tileDistance, coefNorth, coefSouth, mTileDistance[index], index,
+                    mHiddenTilesNorth, mHiddenTilesSouth);
+            }
+        }
+
+        tileDistance.mHiddenNorthEnd = static_cast<uint32_t>(mHiddenTilesNorth.size());
+        tileDistance.mHiddenSouthEnd = static_cast<uint32_t>(mHiddenTilesSouth.size());
+    }
+
+    mTileDistanceComputed = distance;
+}
+
+uint32_t VisibilityKernel::getNbTilesWithin(int radius)
+{
+    if(radius > mTileDistanceComputed)
+        buildTileDistance(radius);
+
+    int radiusSquared = radius * radius;
+    auto it = std::upper_bound(mTileDistance.begin(), mTileDistance.end(), radiusSquared,
+        [](int distSquared, const TileDistance& tileDist)
+        {
+            return distSquared < tileDist.mDistSquared;
+        });
+    return static_cast<uint32_t>(it - mTileDistance.begin());
+}
+
+namespace
+{
+class TileDistanceProcess
+{
+public:
+    TileDistanceProcess(const VisibilityKernel::TileDistance& tileDistance, bool isInMap):
+        mTileDistance(tileDistance),
+        mIsInMap(isInMap),
+        mHiddenValueNorth(0.0),
+        mHiddenValueSouth(0.0)
+    {
+    }
+
+    inline const VisibilityKernel::TileDistance& getTileDistance() const
+    {
+        return mTileDistance;
+    }
+
+    void addHiddenValueNorth(double val)
+    {
+        // We only add the highest value
+        if(val <= mHiddenValueNorth)
+            return;
+
+        mHiddenValueNorth = val;
+    }
+
+    void addHiddenValueSouth(double val)
+    {
+        // We only add the highest value
+        if(val <= mHiddenValueSouth)
+            return;
+
+        mHiddenValueSouth = val;
+    }
+
+    inline bool isTileVisible() const
+    {
+        return (mHiddenValueNorth + mHiddenValueSouth) <= 0.5;
+    }
+
+    inline double getHiddenValueNorth() const
+    {
+        return mHiddenValueNorth;
+    }
+
+    inline double getHiddenValueSouth() const
+    {
+        return mHiddenValueSouth;
+    }
+
+    inline bool isInMap() const
+    {
+        return mIsInMap;
+    }
+
+private:
+    const VisibilityKernel::TileDistance& mTileDistance;
+    bool mIsInMap;
+    double mHiddenValueNorth;
+    double mHiddenValueSouth;
+};
+}
+
+void VisibilityKernel::computeVisibleTilesReference(const OpacityBitmap& opacity, int x, int y, int radius,
+    std::vector<std::pair<int, int>>& tiles)
+{
+    tiles.clear();
+    if(radius > mTileDistanceComputed)
+        buildTileDistance(radius);
+
+    int radiusSquared = radius * radius;
+
+    // To have all the tiles around, we process mTileDistance 8 times (one per octant).
+    // Then, we will have to merge diagonal/horizontal tiles
+    // Because we want the index to be correct, we will add tiles even when out of the map in tilesProcess
+    std::vector<TileDistanceProcess> tilesProcess[8];
+    for(uint32_t k = 0; k < 8; ++k)
+    {
+        for(const TileDistance& tileDist : mTileDistance)
+        {
+            if(tileDist.mDistSquared > radiusSquared)
+                break;
+
+            int xx;
+            int yy;
+            octantCoords(k, x, y, tileDist, xx, yy);
+            tilesProcess[k].push_back(TileDistanceProcess(tileDist, opacity.isInMap(xx, yy)));
+        }
+    }
+
+    // The array of tiles is filled. Now, we apply the visibility.
+    for(uint32_t k = 0; k < 8; ++k)
+    {
+        for(TileDistanceProcess& tileDistanceProcess : tilesProcess[k])
+        {
+            if(!tileDistanceProcess.isInMap())
+                continue;
+
+            int xx;
+            int yy;
+            octantCoords(k, x, y, tileDistanceProcess.getTileDistance(), xx, yy);
+            if(!opacity.isOpaque(xx, yy))
+                continue;
+
+            // The tile hides vision. We process tiles it hides
+            const TileDistance& tileDist = tileDistanceProcess.getTileDistance();
+            for(uint32_t h = tileDist.mHiddenNorthBegin; h < tileDist.mHiddenNorthEnd; ++h)
+            {
+                // mTileDistance might be bigger than the actual vector because it can include tiles
+                // farther than the ones currently computed (for example if sight < computedSight)
+                const HiddenTile& hiddenTile = mHiddenTilesNorth[h];
+                if(hiddenTile.mIndex >= tilesProcess[k].size())
+                    continue;
+
+                tilesProcess[k][hiddenTile.mIndex].addHiddenValueNorth(hiddenTile.mHiddenValue);
+            }
+            for(uint32_t h = tileDist.mHiddenSouthBegin; h < tileDist.mHiddenSouthEnd; ++h)
+            {
+                const HiddenTile& hiddenTile = mHiddenTilesSouth[h];
+                if(hiddenTile.mIndex >= tilesProcess[k].size())
+                    continue;
+
+                tilesProcess[k][hiddenTile.mIndex].addHiddenValueSouth(hiddenTile.mHiddenValue);
+            }
+        }
+    }
+
+    // Now, we process all the tiles. Note that horizontal tiles are common for 2 consecutive
+    // vectors in tilesProcess and that diagonal tiles should be merged.
+    // The 8 vectors have the same size
+    for(uint32_t i = 0; i < tilesProcess[0].size(); ++i)
+    {
+        for(uint32_t k = 0; k < 8; ++k)
+        {
+            TileDistanceProcess& tileDistanceProcess = tilesProcess[k][i];
+            if(!tileDistanceProcess.isInMap())
+                continue;
+
+            // We avoid adding several times the center tile
+            if((k > 0) && (tileDistanceProcess.getTileDistance().mDistSquared == 0))
+                continue;
+
+            // Because horizontal tiles are common, we don't process them for the 4 last vectors
+            if((tileDistanceProcess.getTileDistance().mType == TileDistanceType::Horizontal) &&
+               (k > 3))
+            {
+                continue;
+            }
+
+            // Diagonal tiles need to be merged (because south hiding and north hiding are not
+            // computed within the same array). They will be processed for k < 4
+            if((tileDistanceProcess.getTileDistance().mType == TileDistanceType::Diagonal) &&
+               (k > 3))
+            {
+                continue;
+            }
+
+            if(tileDistanceProcess.getTileDistance().mType == TileDistanceType::Diagonal)
+            {
+                // We merge diagonal tiles. Because they are inverted, south hidden value becomes north and vice-versa
+                TileDistanceProcess& tileDistanceProcess2 = tilesProcess[k + 4][i];
+                tileDistanceProcess.addHiddenValueNorth(tileDistanceProcess2.getHiddenValueSouth());
+                tileDistanceProcess.addHiddenValueSouth(tileDistanceProcess2.getHiddenValueNorth());
+            }
+
+            if(!tileDistanceProcess.isTileVisible())
+                continue;
+
+            int xx;
+            int yy;
+            octantCoords(k, x, y, tileDistanceProcess.getTileDistance(), xx, yy);
+            tiles.push_back(std::make_pair(xx, yy));
+        }
+    }
+}
@@ -0,0 +1,236 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VISIBILITYKERNEL_H
+#define VISIBILITYKERNEL_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//! \brief Packed bitmap of the tiles blocking vision. Tiles outside of the map are not opaque
+class OpacityBitmap
+{
+public:
+    OpacityBitmap() :
+        mMapSizeX(0),
+        mMapSizeY(0)
+    {}
+
+    //! \brief Sets the map size. Every tile is set as not opaque
+    void setMapSize(int mapSizeX, int mapSizeY);
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    inline bool isInMap(int x, int y) const
+    { return (x >= 0) && (y >= 0) && (x < mMapSizeX) && (y < mMapSizeY); }
+
+    inline bool isOpaque(int x, int y) const
+    {
+        uint32_t index = static_cast<uint32_t>(y * mMapSizeX + x);
+        return ((mBits[index / 64] >> (index % 64)) & 1) != 0;
+    }
+
+    void setOpaque(int x, int y, bool opaque);
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    std::vector<uint64_t> mBits;
+};
+
+/*! \brief Precomputed tables used to compute the tiles visible from a tile.
+ *
+ * The tiles around the origin are sorted by distance. Because of the symmetry of the square, only 1/8 of them
+ * is computed (see buildTileDistance). For each of these tiles, we precompute which tiles it hides when it
+ * blocks vision and how much of them it hides on their north and south side. A tile is visible if
+ * less than half of it is hidden.
+ *
+ * Since a tile can only hide tiles further than itself, the visible tiles can be computed with a single pass
+ * over the sorted tiles.
+ */
+class VisibilityKernel
+{
+public:
+    enum class TileDistanceType
+    {
+        Horizontal,
+        Diagonal,
+        Other
+    };
+
+    struct HiddenTile
+    {
+        //! \brief Index of the hidden tile in the sorted tiles
+        uint32_t mIndex;
+        //! \brief Hidden part of the tile (between 0 and 1)
+        double mHiddenValue;
+    };
+
+    struct TileDistance
+    {
+        int mDiffX;
+        int mDiffY;
+        TileDistanceType mType;
+        int mDistSquared;
+        //! \brief Range in mHiddenTilesNorth of the tiles hidden by this one on their north side
+        uint32_t mHiddenNorthBegin;
+        uint32_t mHiddenNorthEnd;
+        //! \brief Range in mHiddenTilesSouth of the tiles hidden by this one on their south side
+        uint32_t mHiddenSouthBegin;
+        uint32_t mHiddenSouthEnd;
+    };
+
+    VisibilityKernel(int initTileDistance);
+
+    //! \brief Computes the tables up to the given distance if not already done
+    void buildTileDistance(int distance);
+
+    //! \brief Tiles sorted by distance. Only 1/8 of the tiles are stored (diffX >= diffY >= 0). The
+    //! tables may have been built further than needed: the tiles within a radius are the first
+    //! getNbTilesWithin(radius) ones
+    inline const std::vector<TileDistance>& getTileDistance() const
+    { return mTileDistance; }
+
+    //! \brief Returns the number of tiles in getTileDistance within the given radius
+    uint32_t getNbTilesWithin(int radius);
+
+    /*! \brief Calls addTile(x, y) for each tile visible from (x, y) within radius. The tiles are given
+     * from the closest to the furthest.
+     */
+    template<typename AddTile>
+    void computeVisibleTiles(const OpacityBitmap& opacity, int x, int y, int radius, AddTile addTile);
+
+    /*! \brief Same as computeVisibleTiles but with the former algorithm that builds a vector per octant. Kept to
+     * check and benchmark computeVisibleTiles. The tiles are returned in the same order.
+     */
+    void computeVisibleTilesReference(const OpacityBitmap& opacity, int x, int y, int radius,
+        std::vector<std::pair<int, int>>& tiles);
+
+    //! \brief Returns in x and y the coordinates of the tile tileDist in the given octant (from 0 to 7) around
+    //! (xOrigin, yOrigin). We use the following order (c being the origin):
+    //! 514
+    //! 2c0
+    //! 637
+    static inline void octantCoords(uint32_t octant, int xOrigin, int yOrigin, const TileDistance& tileDist,
+        int& x, int& y)
+    {
+        const int* coefs = OCTANT_COEFS[octant];
+        x = xOrigin + coefs[0] * tileDist.mDiffX + coefs[1] * tileDist.mDiffY;
+        y = yOrigin + coefs[2] * tileDist.mDiffX + coefs[3] * tileDist.mDiffY;
+    }
+
+private:
+    static const int OCTANT_COEFS[8][4];
+
+    std::vector<TileDistance> mTileDistance;
+    std::vector<HiddenTile> mHiddenTilesNorth;
+    std::vector<HiddenTile> mHiddenTilesSouth;
+
+    //! \brief Stores the highest distance computed
+    int mTileDistanceComputed;
+
+    //! \brief Hidden values of the tiles in each octant during computeVisibleTiles. The values for the
+    //! tile i in the octant k are at index k * nbTiles + i
+    std::vector<double> mHiddenValuesNorth;
+    std::vector<double> mHiddenValuesSouth;
+};
+
+template<typename AddTile>
+void VisibilityKernel::computeVisibleTiles(const OpacityBitmap& opacity, int x, int y, int radius, AddTile addTile)
+{
+    uint32_t nbTiles = getNbTilesWithin(radius);
+    mHiddenValuesNorth.assign(8 * nbTiles, 0.0);
+    mHiddenValuesSouth.assign(8 * nbTiles, 0.0);
+
+    for(uint32_t i = 0; i < nbTiles; ++i)
+    {
+        const TileDistance& tileDist = mTileDistance[i];
+
+        // A tile can only be hidden by closer tiles. At this point, its hidden values are known. Note that
+        // the tiles outside the map cannot hide anything and are never visible
+        int xx[8];
+        int yy[8];
+        bool isInMap[8];
+        for(uint32_t k = 0; k < 8; ++k)
+        {
+            octantCoords(k, x, y, tileDist, xx[k], yy[k]);
+            isInMap[k] = opacity.isInMap(xx[k], yy[k]);
+            if(!isInMap[k] || !opacity.isOpaque(xx[k], yy[k]))
+                continue;
+
+            // The tile hides vision. We process tiles it hides. The tables might include tiles further than the
+            // radius if they have been computed for a bigger radius. Since the hidden tiles are sorted by index,
+            // we can stop at the first one out of the radius
+            double* hiddenNorth = &mHiddenValuesNorth[k * nbTiles];
+            for(uint32_t h = tileDist.mHiddenNorthBegin; h < tileDist.mHiddenNorthEnd; ++h)
+            {
+                const HiddenTile& hiddenTile = mHiddenTilesNorth[h];
+                if(hiddenTile.mIndex >= nbTiles)
+                    break;
+                if(hiddenTile.mHiddenValue > hiddenNorth[hiddenTile.mIndex])
+                    hiddenNorth[hiddenTile.mIndex] = hiddenTile.mHiddenValue;
+            }
+            double* hiddenSouth = &mHiddenValuesSouth[k * nbTiles];
+            for(uint32_t h = tileDist.mHiddenSouthBegin; h < tileDist.mHiddenSouthEnd; ++h)
+            {
+                const HiddenTile& hiddenTile = mHiddenTilesSouth[h];
+                if(hiddenTile.mIndex >= nbTiles)
+                    break;
+                if(hiddenTile.mHiddenValue > hiddenSouth[hiddenTile.mIndex])
+                    hiddenSouth[hiddenTile.mIndex] = hiddenTile.mHiddenValue;
+            }
+        }
+
+        // The center tile is common to the 8 octants. Horizontal and diagonal tiles are common
+        // for 2 octants (k and k + 4). Diagonal tiles are hidden from the north in one octant and from the
+        // south in the other so we need to merge them
+        uint32_t nbOctants = (tileDist.mDistSquared == 0) ? 1 : 8;
+        for(uint32_t k = 0; k < nbOctants; ++k)
+        {
+            if(!isInMap[k])
+                continue;
+
+            if((k > 3) && (tileDist.mType != TileDistanceType::Other))
+                continue;
+
+            double hiddenNorth = mHiddenValuesNorth[k * nbTiles + i];
+            double hiddenSouth = mHiddenValuesSouth[k * nbTiles + i];
+            if(tileDist.mType == TileDistanceType::Diagonal)
+            {
+                // Because they are inverted, south hidden value becomes north and vice-versa
+                double hiddenNorth2 = mHiddenValuesSouth[(k + 4) * nbTiles + i];
+                double hiddenSouth2 = mHiddenValuesNorth[(k + 4) * nbTiles + i];
+                if(hiddenNorth2 > hiddenNorth)
+                    hiddenNorth = hiddenNorth2;
+                if(hiddenSouth2 > hiddenSouth)
+                    hiddenSouth = hiddenSouth2;
+            }
+
+            if((hiddenNorth + hiddenSouth) > 0.5)
+                continue;
+
+            addTile(xx[k], yy[k]);
+        }
+    }
+}
+
+#endif // VISIBILITYKERNEL_H
@@ -0,0 +1,299 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/VisionTracker.h"
+
+#include "gamemap/TileStore.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+VisionTracker::VisionTracker(const TileStore& tileStore, VisionListener& listener) :
+    mTileStore(tileStore),
+    mListener(listener),
+    mIsTracking(false),
+    mIsFOWVisionGiven(false),
+    mTurn(0),
+    mMapSizeX(0),
+    mMapSizeY(0)
+{
+}
+
+void VisionTracker::clear()
+{
+    mIsTracking = false;
+    mIsFOWVisionGiven = false;
+    mMapSizeX = 0;
+    mMapSizeY = 0;
+    mTilesVisionSources.clear();
+    mClaimedVisionSeatIds.clear();
+    mAlliedSeatIds.clear();
+    mEntitiesVision.clear();
+    mFOWVisionSeatIds.clear();
+    mOpacityEpochs.clear();
+}
+
+void VisionTracker::checkMapSize()
+{
+    if((mMapSizeX == mTileStore.getMapSizeX()) && (mMapSizeY == mTileStore.getMapSizeY()))
+        return;
+
+    mMapSizeX = mTileStore.getMapSizeX();
+    mMapSizeY = mTileStore.getMapSizeY();
+    mTilesVisionSources.clear();
+    mTilesVisionSources.resize(mTileStore.getNbTiles());
+    mClaimedVisionSeatIds.assign(mTileStore.getNbTiles(), TileStore::NO_SEAT);
+    mEntitiesVision.clear();
+    mOpacityEpochs.setMapSize(mMapSizeX, mMapSizeY);
+}
+
+void VisionTracker::addAlliedSeat(int32_t seatId, int32_t alliedSeatId)
+{
+    mAlliedSeatIds[seatId].push_back(alliedSeatId);
+}
+
+void VisionTracker::beginTurn(bool giveVisionOnAllTiles, const std::vector<int32_t>& seatIds)
+{
+    ++mTurn;
+    checkMapSize();
+
+    if(!mIsTracking)
+    {
+        // First turn: we compute the vision given by every claimed tile. After that, the tiles
+        // will update it when they are claimed or unclaimed
+        mIsTracking = true;
+        for(int yy = 0; yy < mMapSizeY; ++yy)
+        {
+            for(int xx = 0; xx < mMapSizeX; ++xx)
+                refreshClaimedVision(xx, yy);
+        }
+    }
+
+    // If the FOW is deactivated, we allow vision for every seat
+    if(giveVisionOnAllTiles == mIsFOWVisionGiven)
+        return;
+
+    mIsFOWVisionGiven = giveVisionOnAllTiles;
+    if(giveVisionOnAllTiles)
+        mFOWVisionSeatIds = seatIds;
+
+    for(int32_t seatId : mFOWVisionSeatIds)
+    {
+        for(uint32_t index = 0; index < mTileStore.getNbTiles(); ++index)
+        {
+            if(giveVisionOnAllTiles)
+                addVision(index, seatId);
+            else
+                removeVision(index, seatId);
+        }
+    }
+
+    if(!giveVisionOnAllTiles)
+        mFOWVisionSeatIds.clear();
+}
+
+void VisionTracker::refreshEntityVision(const std::string& entityName, int32_t seatId, const std::vector<uint32_t>& tileIndexes)
+{
+    checkMapSize();
+    auto it = mEntitiesVision.find(entityName);
+    if(it == mEntitiesVision.end())
+    {
+        EntityVision& entityVision = mEntitiesVision[entityName];
+        entityVision.mSeatId = seatId;
+        entityVision.mTileIndexes = tileIndexes;
+        entityVision.mTurnRefreshed = mTurn;
+        for(uint32_t index : tileIndexes)
+            addVision(index, seatId);
+
+        return;
+    }
+
+    EntityVision& entityVision = it->second;
+    entityVision.mTurnRefreshed = mTurn;
+    if((entityVision.mSeatId == seatId) && (entityVision.mTileIndexes == tileIndexes))
+        return;
+
+    // We add the new vision before removing the old one so that the tiles seen in both
+    // do not lose vision
+    for(uint32_t index : tileIndexes)
+        addVision(index, seatId);
+
+    for(uint32_t index : entityVision.mTileIndexes)
+        removeVision(index, entityVision.mSeatId);
+
+    entityVision.mSeatId = seatId;
+    entityVision.mTileIndexes = tileIndexes;
+}
+
+void VisionTracker::endTurn()
+{
+    for(auto it = mEntitiesVision.begin(); it != mEntitiesVision.end();)
+    {
+        EntityVision& entityVision = it->second;
+        if(entityVision.mTurnRefreshed == mTurn)
+        {
+            ++it;
+            continue;
+        }
+
+        for(uint32_t index : entityVision.mTileIndexes)
+            removeVision(index, entityVision.mSeatId);
+
+        it = mEntitiesVision.erase(it);
+    }
+}
+
+void VisionTracker::refreshClaimedVision(int x, int y)
+{
+    // Vision sources are only tracked once the game has started
+    if(!mIsTracking)
+        return;
+
+    checkMapSize();
+    uint32_t index = mTileStore.getIndex(x, y);
+    int32_t seatId = mTileStore.isClaimed(index) ? mTileStore.getSeatId(index) : TileStore::NO_SEAT;
+    int32_t oldSeatId = mClaimedVisionSeatIds[index];
+    if(seatId == oldSeatId)
+        return;
+
+    // We add the new vision before removing the old one to avoid notifying a vision loss for nothing
+    if(seatId != TileStore::NO_SEAT)
+        claimedVision(x, y, seatId, true);
+
+    if(oldSeatId != TileStore::NO_SEAT)
+        claimedVision(x, y, oldSeatId, false);
+
+    mClaimedVisionSeatIds[index] = seatId;
+}
+
+void VisionTracker::claimedVision(int x, int y, int32_t seatId, bool vision)
+{
+    // A claimed tile can see it self and its neighbors (see TileContainer::setTileNeighbors)
+    static const int NEIGHBORS[5][2] = { {0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+    for(const int* neighbor : NEIGHBORS)
+    {
+        int xx = x + neighbor[0];
+        int yy = y + neighbor[1];
+        if((xx < 0) || (yy < 0) || (xx >= mMapSizeX) || (yy >= mMapSizeY))
+            continue;
+
+        if(vision)
+            addVision(mTileStore.getIndex(xx, yy), seatId);
+        else
+            removeVision(mTileStore.getIndex(xx, yy), seatId);
+    }
+}
+
+void VisionTracker::addVision(int x, int y, int32_t seatId)
+{
+    checkMapSize();
+    addVision(mTileStore.getIndex(x, y), seatId);
+}
+
+void VisionTracker::removeVision(int x, int y, int32_t seatId)
+{
+    checkMapSize();
+    removeVision(mTileStore.getIndex(x, y), seatId);
+}
+
+uint32_t VisionTracker::getNbVisionSources(int x, int y, int32_t seatId) const
+{
+    if((x < 0) || (y < 0) || (x >= mMapSizeX) || (y >= mMapSizeY))
+        return 0;
+
+    for(const SeatVisionSources& sources : mTilesVisionSources[mTileStore.getIndex(x, y)])
+    {
+        if(sources.mSeatId == seatId)
+            return sources.mNbSources;
+    }
+
+    return 0;
+}
+
+void VisionTracker::addVision(uint32_t index, int32_t seatId)
+{
+    addVisionSource(index, seatId);
+
+    // We also give vision to allied seats
+    auto it = mAlliedSeatIds.find(seatId);
+    if(it == mAlliedSeatIds.end())
+        return;
+
+    for(int32_t alliedSeatId : it->second)
+        addVisionSource(index, alliedSeatId);
+}
+
+void VisionTracker::removeVision(uint32_t index, int32_t seatId)
+{
+    removeVisionSource(index, seatId);
+
+    auto it = mAlliedSeatIds.find(seatId);
+    if(it == mAlliedSeatIds.end())
+        return;
+
+    for(int32_t alliedSeatId : it->second)
+        removeVisionSource(index, alliedSeatId);
+}
+
+void VisionTracker::addVisionSource(uint32_t index, int32_t seatId)
+{
+    std::vector<SeatVisionSources>& tileSources = mTilesVisionSources[index];
+    for(SeatVisionSources& sources : tileSources)
+    {
+        if(sources.mSeatId != seatId)
+            continue;
+
+        ++sources.mNbSources;
+        return;
+    }
+
+    // The seat gains vision on this tile
+    tileSources.push_back({seatId, 1});
+    mListener.seatVisionChanged(static_cast<int>(index) % mMapSizeX, static_cast<int>(index) / mMapSizeX, seatId, true);
+}
+
+void VisionTracker::removeVisionSource(uint32_t index, int32_t seatId)
+{
+    std::vector<SeatVisionSources>& tileSources = mTilesVisionSources[index];
+    for(uint32_t i = 0; i < tileSources.size(); ++i)
+    {
+        SeatVisionSources& sources = tileSources[i];
+        if(sources.mSeatId != seatId)
+            continue;
+
+        --sources.mNbSources;
+        if(sources.mNbSources > 0)
+            return;
+
+        // The seat loses vision on this tile
+        tileSources.erase(tileSources.begin() + i);
+        mListener.seatVisionChanged(static_cast<int>(index) % mMapSizeX, static_cast<int>(index) / mMapSizeX, seatId, false);
+        return;
+    }
+
+    OD_LOG_ERR("index=" + Helper::toString(index) + ", seatId=" + Helper::toString(seatId));
+}
+
+void VisionTracker::tileOpacityChanged(int x, int y)
+{
+    checkMapSize();
+    mOpacityEpochs.tileChanged(x, y);
+}
+
+bool VisionTracker::hasOpacityChangedSince(int minX, int minY, int maxX, int maxY, uint64_t epoch) const
+{
+    return mOpacityEpochs.hasChangedSince(minX, minY, maxX, maxY, 0, epoch);
+}
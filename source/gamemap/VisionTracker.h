@@ -0,0 +1,163 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VISIONTRACKER_H
+#define VISIONTRACKER_H
+
+#include "gamemap/RegionEpochs.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TileStore;
+
+/*! \brief Interface for listening for the seats gaining or losing vision on a tile
+ */
+class VisionListener
+{
+public:
+    virtual ~VisionListener()
+    {}
+
+    //! \brief Called when the seat with the given id gains (hasVision true) or loses vision on the tile
+    virtual void seatVisionChanged(int x, int y, int32_t seatId, bool hasVision) = 0;
+};
+
+/*! \brief Keeps track of the vision sources on the server game map so that vision can be updated incrementally.
+ *
+ * Each tile counts, for each seat, the number of vision sources giving vision on it (see addVision). The
+ * listener is notified only when a seat gains its first vision source on a tile or loses its last one.
+ * The vision sources are:
+ * - claimed tiles (see refreshClaimedVision)
+ * - entities (creatures, spells) that call refreshEntityVision each turn. The tiles they gave vision on during
+ * the previous turn are compared with the new ones and only the differences are applied. The vision
+ * given by an entity that did not call refreshEntityVision during a turn is removed at the end of the turn
+ * - every tile for every seat if the fog of war is deactivated
+ *
+ * It also keeps track of the changes in tiles opacity so that entities can know if their line of
+ * sight should be computed again.
+ */
+class VisionTracker
+{
+public:
+    VisionTracker(const TileStore& tileStore, VisionListener& listener);
+
+    //! \brief Drops every vision source and allied seat without notifying the listener. Should be called
+    //! when the tiles are deleted
+    void clear();
+
+    //! \brief Returns true once the vision sources are tracked (after the first call to beginTurn)
+    inline bool isTracking() const
+    { return mIsTracking; }
+
+    //! \brief The vision given to a seat is also given to its allied seats
+    void addAlliedSeat(int32_t seatId, int32_t alliedSeatId);
+
+    //! \brief Should be called at the beginning of the vision update each turn. If giveVisionOnAllTiles is
+    //! true (no fog of war), the given seats have vision on every tile
+    void beginTurn(bool giveVisionOnAllTiles, const std::vector<int32_t>& seatIds);
+
+    //! \brief Replaces the vision given by the entity with the given name by the given tiles (see
+    //! TileStore::getIndex) for the given seat
+    void refreshEntityVision(const std::string& entityName, int32_t seatId, const std::vector<uint32_t>& tileIndexes);
+
+    //! \brief Should be called at the end of the vision update each turn. Removes the vision of the
+    //! entities that did not refresh it this turn
+    void endTurn();
+
+    //! \brief A claimed tile gives vision on itself and its neighbors to its seat. Updates this vision if the
+    //! claimed state of the tile in the TileStore changed. Does nothing until the vision sources are tracked
+    void refreshClaimedVision(int x, int y);
+
+    //! \brief Adds a vision source on the tile for the given seat and its allied seats. Seats
+    //! with at least one vision source on a tile have vision on it
+    void addVision(int x, int y, int32_t seatId);
+
+    //! \brief Removes a vision source added with addVision
+    void removeVision(int x, int y, int32_t seatId);
+
+    //! \brief Returns the number of vision sources the given seat has on the tile
+    uint32_t getNbVisionSources(int x, int y, int32_t seatId) const;
+
+    //! \brief Should be called when a tile may have changed its opacity (see Tile::permitsVision)
+    void tileOpacityChanged(int x, int y);
+
+    inline uint64_t getOpacityEpoch() const
+    { return mOpacityEpochs.getEpoch(); }
+
+    //! \brief Returns true if the opacity of a tile in the given area may have changed since the given epoch
+    bool hasOpacityChangedSince(int minX, int minY, int maxX, int maxY, uint64_t epoch) const;
+
+private:
+    struct EntityVision
+    {
+        int32_t mSeatId;
+        std::vector<uint32_t> mTileIndexes;
+        uint64_t mTurnRefreshed;
+    };
+
+    struct SeatVisionSources
+    {
+        int32_t mSeatId;
+        uint32_t mNbSources;
+    };
+
+    const TileStore& mTileStore;
+    VisionListener& mListener;
+
+    bool mIsTracking;
+
+    //! \brief True if vision has been given on every tile because the fog of war is deactivated
+    bool mIsFOWVisionGiven;
+
+    //! \brief Incremented at each beginTurn
+    uint64_t mTurn;
+
+    //! \brief Size of the map the vision sources are stored for
+    int mMapSizeX;
+    int mMapSizeY;
+
+    //! \brief Vision sources of the seats with vision on each tile
+    std::vector<std::vector<SeatVisionSources>> mTilesVisionSources;
+
+    //! \brief Seat each tile gives vision to because it is claimed (TileStore::NO_SEAT if none)
+    std::vector<int32_t> mClaimedVisionSeatIds;
+
+    std::unordered_map<int32_t, std::vector<int32_t>> mAlliedSeatIds;
+
+    std::unordered_map<std::string, EntityVision> mEntitiesVision;
+
+    //! \brief Seats that were given vision on every tile because the fog of war is deactivated
+    std::vector<int32_t> mFOWVisionSeatIds;
+
+    RegionEpochs mOpacityEpochs;
+
+    //! \brief Resizes the vision sources to the TileStore map size. The vision sources are dropped if it changed
+    void checkMapSize();
+
+    void addVision(uint32_t index, int32_t seatId);
+    void removeVision(uint32_t index, int32_t seatId);
+    void addVisionSource(uint32_t index, int32_t seatId);
+    void removeVisionSource(uint32_t index, int32_t seatId);
+
+    //! \brief Adds (or removes) the vision given by a claimed tile on itself and its neighbors
+    void claimedVision(int x, int y, int32_t seatId, bool vision);
+};
+
+#endif // VISIONTRACKER_H
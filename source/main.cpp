@@ -83,7 +83,8 @@ int main(int argc, char** argv)
         }
 
         ODApplication od;
-        od.startGame(options);
+        if(!od.startGame(options))
+            return 1;
     }
     catch (Ogre::Exception& e)
     {
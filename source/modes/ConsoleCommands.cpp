@@ -9,6 +9,8 @@
 #include "network/ClientNotification.h"
 #include "network/ODClient.h"
 #include "network/ODServer.h"
+#include "network/PacketCompression.h"
+#include "network/ServerNotification.h"
 #include "render/ODFrameListener.h"
 #include "render/RenderManager.h"
 #include "rooms/Room.h"
@@ -21,7 +23,9 @@
 
 #include <boost/algorithm/string/join.hpp>
 
+#include <fstream>
 #include <functional>
+#include <memory>
 
 namespace
 {
@@ -56,7 +60,15 @@ const std::string HELPMESSAGE =
         "\n\tcatmullspline - Triggers the catmullspline camera movement type."
         "\n\tcirclearound - Triggers the circle camera movement type."
         "\n\tsetcamerafovy - Sets the camera vertical field of view aspect ratio value."
-        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap.";
+        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap."
+        "\n\trecordpaths - Records the pathfinding queries in the given file."
+        "\n\tbenchpaths - Replays the pathfinding queries recorded in the given file and logs the time taken."
+        "\n\tbenchbestpath - Compares the time taken to find the best path to the rooms with one or several searches."
+        "\n\tbenchvision - Compares the time taken to compute the visible tiles with the current and the former algorithm."
+        "\n\tturnstats - Displays the server turns timings or sets the turn scheduling policy."
+        "\n\tbenchcompression - Compresses the packets of the given replay and logs the compression ratio and time."
+        "\n\treplayspeed - Sets the speed of the replay being watched."
+        "\n\treplayseek - Jumps to the given turn of the replay being watched.";
 
 //! \brief Template function to get/set a variable from the ODFrameListener object
 template<typename ValType, typename Getter, typename Setter>
@@ -412,12 +424,207 @@ Command::Result cSrvSetCreatureDest(const Command::ArgumentList_t& args, Console
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvToggleDoor(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    if(args.size() < 3)
+        return Command::Result::INVALID_ARGUMENT;
+
+    int x = Helper::toInt(args[1]);
+    int y = Helper::toInt(args[2]);
+    if(!gameMap.consoleToggleDoor(x, y))
+        return Command::Result::INVALID_ARGUMENT;
+
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvCheckOpacity(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap& gameMap)
+{
+    c.print("Opacity mismatches: " + Helper::toString(gameMap.countOpacityMismatches()));
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cSrvLogFloodFill(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap& gameMap)
 {
     gameMap.logFloodFileTiles();
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvRecordPaths(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    // Without file name, we stop recording
+    if(args.size() < 2)
+    {
+        gameMap.consoleRecordPathQueries("");
+        return Command::Result::SUCCESS;
+    }
+
+    gameMap.consoleRecordPathQueries(args[1]);
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvBenchPaths(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    if(args.size() < 2)
+        return Command::Result::INVALID_ARGUMENT;
+
+    uint32_t nbIterations = 1;
+    if(args.size() >= 3)
+        nbIterations = Helper::toUInt32(args[2]);
+
+    gameMap.consoleBenchmarkPathQueries(args[1], nbIterations);
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvBenchBestPath(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    uint32_t nbIterations = 1;
+    if(args.size() >= 2)
+        nbIterations = Helper::toUInt32(args[1]);
+
+    gameMap.consoleBenchmarkFindBestPath(nbIterations);
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvBenchVision(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    uint32_t nbIterations = 1;
+    if(args.size() >= 2)
+        nbIterations = Helper::toUInt32(args[1]);
+
+    gameMap.consoleBenchmarkVisibleTiles(nbIterations);
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvTurnStats(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    TurnScheduler& scheduler = ODServer::getSingleton().getTurnScheduler();
+    if(args.size() < 2)
+    {
+        c.print("Turn timings: " + scheduler.getStatsString());
+        c.print("Compression: " + ODServer::getSingleton().getCompressionStatsString());
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "reset")
+    {
+        scheduler.clearStats();
+        return Command::Result::SUCCESS;
+    }
+
+    TurnSchedulerPolicy policy;
+    if(!TurnScheduler::fromString(args[1], policy))
+        return Command::Result::INVALID_ARGUMENT;
+
+    scheduler.setPolicy(policy);
+    if(args.size() >= 3)
+        scheduler.setMaxCatchUpTurns(Helper::toUInt32(args[2]));
+
+    c.print("Turn scheduling policy set to " + TurnScheduler::toString(policy));
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cBenchCompression(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    if(args.size() < 2)
+        return Command::Result::INVALID_ARGUMENT;
+
+    int level = 1;
+    if(args.size() >= 3)
+        level = Helper::toInt(args[2]);
+
+    std::ifstream is(args[1], std::ios::in | std::ios::binary);
+    if(!is.is_open())
+    {
+        c.print("Cannot open replay " + args[1]);
+        return Command::Result::FAILED;
+    }
+
+    // Replays may have been recorded compressed or not
+    std::unique_ptr<PacketInflater> inflater;
+    if(ODPacket::readReplayHeader(is))
+        inflater.reset(new PacketInflater);
+
+    PacketDeflater deflater(level);
+    uint32_t nbPackets = 0;
+    uint32_t nbTurns = 0;
+    ODPacket packet;
+    ODPacket packetCompressed;
+    while(packet.readPacket(is, inflater.get()) != -1)
+    {
+        ++nbPackets;
+        if(!deflater.deflatePacket(packet, packetCompressed))
+        {
+            c.print("Error while compressing packet " + Helper::toString(nbPackets));
+            return Command::Result::FAILED;
+        }
+
+        ServerNotificationType type;
+        if((packet >> type) && (type == ServerNotificationType::turnStarted))
+            ++nbTurns;
+    }
+
+    double ratio = (deflater.getNbBytesOut() == 0) ? 0.0 :
+        static_cast<double>(deflater.getNbBytesIn()) / static_cast<double>(deflater.getNbBytesOut());
+    double timePerTurn = (nbTurns == 0) ? 0.0 :
+        static_cast<double>(deflater.getTimeMicroseconds()) / static_cast<double>(nbTurns);
+    c.print("packets=" + Helper::toString(nbPackets)
+        + ", turns=" + Helper::toString(nbTurns)
+        + ", bytesIn=" + Helper::toString(deflater.getNbBytesIn())
+        + ", bytesOut=" + Helper::toString(deflater.getNbBytesOut())
+        + ", ratio=" + Helper::toString(ratio, 3)
+        + ", time=" + Helper::toString(deflater.getTimeMicroseconds()) + "us"
+        + ", timePerTurn=" + Helper::toString(timePerTurn, 3) + "us");
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cReplaySpeed(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    ODClient& client = ODClient::getSingleton();
+    if(args.size() < 2)
+    {
+        c.print("Replay speed: " + Helper::toString(client.getReplaySpeed()));
+        return Command::Result::SUCCESS;
+    }
+
+    uint32_t speed = Helper::toUInt32(args[1]);
+    if(speed == 0)
+        return Command::Result::INVALID_ARGUMENT;
+
+    if(!client.setReplaySpeed(speed))
+    {
+        c.print("No replay is being watched");
+        return Command::Result::FAILED;
+    }
+
+    c.print("Replay speed set to " + Helper::toString(speed));
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cReplaySeek(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    if(args.size() < 2)
+        return Command::Result::INVALID_ARGUMENT;
+
+    ODClient& client = ODClient::getSingleton();
+    const std::vector<ReplayTurn>& turns = client.getReplayIndex().getTurns();
+    if(turns.empty())
+    {
+        c.print("The replay being watched has no index");
+        return Command::Result::FAILED;
+    }
+
+    int64_t turnNum = static_cast<int64_t>(Helper::toUInt32(args[1]));
+    if(!client.seekReplayTurn(turnNum))
+    {
+        c.print("Cannot seek to turn " + args[1] + ". The replay can only go forward, up to turn "
+            + Helper::toString(turns.back().mTurnNum));
+        return Command::Result::FAILED;
+    }
+
+    c.print("Seeking to turn " + args[1]);
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cSetCameraFOVy(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
 {
     Ogre::Camera* cam = ODFrameListener::getSingleton().getCameraManager()->getActiveCamera();
@@ -475,6 +682,18 @@ Command::Result cSrvUnlockSkills(const Command::ArgumentList_t& args, ConsoleInt
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvReloadConfig(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap&)
+{
+    if(!ConfigManager::getSingleton().reloadRoomsTrapsSpells())
+    {
+        c.print("Errors while reloading the rooms, traps and spells configuration. Check the log for details");
+        return Command::Result::FAILED;
+    }
+
+    c.print("Rooms, traps and spells configuration reloaded");
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cKeys(const Command::ArgumentList_t&, ConsoleInterface& c, AbstractModeManager&)
 {
     c.print("|| Action               || US Keyboard layout ||     Mouse      ||\n\
@@ -656,12 +875,93 @@ void addConsoleCommands(ConsoleInterface& cl)
                    cSrvSetCreatureDest,
                    {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR},
                    {"setcreaturedestination"});
+    cl.addCommand("toggledoor",
+                   "'toggledoor' locks or unlocks the door on the given tile as if its owner slapped it.\n\nExample:\n"
+                   "toggledoor 5 14",
+                   cSendCmdToServer,
+                   cSrvToggleDoor,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
     cl.addCommand("logfloodfill",
                    "'logfloodfill' logs the FloodFillValues of all the Tiles in the GameMap.",
                    cSendCmdToServer,
                    cSrvLogFloodFill,
                    {AbstractModeManager::ModeType::GAME},
                    {});
+    cl.addCommand("recordpaths",
+                   "'recordpaths' records every pathfinding query made on the server in the given file. "
+                   "Without argument, stops recording.\n\nExample:\n"
+                   "recordpaths paths.txt",
+                   cSendCmdToServer,
+                   cSrvRecordPaths,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("benchpaths",
+                   "'benchpaths' replays the pathfinding queries recorded with recordpaths the given number of times "
+                   "and logs the time taken.\n\nExample:\n"
+                   "benchpaths paths.txt 10",
+                   cSendCmdToServer,
+                   cSrvBenchPaths,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("benchbestpath",
+                   "'benchbestpath' looks for the best path from each creature to the rooms of its seat the given number "
+                   "of times, with a single search and with one search per destination, and logs the time taken by both.\n\nExample:\n"
+                   "benchbestpath 10",
+                   cSendCmdToServer,
+                   cSrvBenchBestPath,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("benchvision",
+                   "'benchvision' computes the tiles visible from every tile of the map for sight radius from 5 to 20 the given "
+                   "number of times, with the current and the former algorithm, and logs the time taken by both.\n\nExample:\n"
+                   "benchvision 10",
+                   cSendCmdToServer,
+                   cSrvBenchVision,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("checkopacity",
+                   "'checkopacity' checks that the opacity of the tiles used to compute the visible tiles is up to date, logs "
+                   "the tiles where it is not and displays their number.",
+                   cSendCmdToServer,
+                   cSrvCheckOpacity,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("turnstats",
+                   "'turnstats' displays the number of turns run, skipped because a client was late and late because the "
+                   "server was busy, with the histograms of the time spent waiting for the network, simulating and sending the "
+                   "notifications. 'turnstats reset' resets them. 'turnstats skip' and 'turnstats catchup [maxturns]' set "
+                   "what happens to the game time of the skipped turns: it is lost or given to the next turn.\n\nExample:\n"
+                   "turnstats catchup 4",
+                   cSendCmdToServer,
+                   cSrvTurnStats,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("benchcompression",
+                   "'benchcompression' compresses the packets of the given replay with the given zlib level (1 per default) "
+                   "as the server would and logs the compression ratio and the time spent per turn.\n\nExample:\n"
+                   "benchcompression replay.odr 1",
+                   cBenchCompression,
+                   Command::cStubServer,
+                   {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR},
+                   {});
+    cl.addCommand("replayspeed",
+                   "'replayspeed' plays the replay being watched the given number of times faster than it was recorded. "
+                   "The sounds and the chat are skipped when the replay is faster. Without argument, displays the current "
+                   "speed.\n\nExample:\n"
+                   "replayspeed 4",
+                   cReplaySpeed,
+                   Command::cStubServer,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("replayseek",
+                   "'replayseek' applies at once the replay being watched until the given turn. The sounds and the chat "
+                   "are skipped. The replay can only go forward and should have been recorded with its index.\n\nExample:\n"
+                   "replayseek 2400",
+                   cReplaySeek,
+                   Command::cStubServer,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
     cl.addCommand("listmeshanims",
                    "'listmeshanims' lists all the animations for the given mesh.",
                    cListMeshAnims,
@@ -703,6 +1003,13 @@ void addConsoleCommands(ConsoleInterface& cl)
                    cSendCmdToServer,
                    cSrvUnlockSkills,
                    {AbstractModeManager::ModeType::GAME});
+    cl.addCommand("reloadconfig",
+                   "'reloadconfig' reloads rooms.cfg, traps.cfg and spells.cfg on the server. The new values are used "
+                   "from the next turn.\n\nExample:\n"
+                   "reloadconfig",
+                   cSendCmdToServer,
+                   cSrvReloadConfig,
+                   {AbstractModeManager::ModeType::GAME});
 
 }
 
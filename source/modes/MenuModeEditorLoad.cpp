@@ -27,6 +27,7 @@
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
 #include "utils/LogManager.h"
+#include "gamemap/LevelInfoIndex.h"
 #include "gamemap/MapHandler.h"
 #include "utils/ResourceManager.h"
 #include "utils/ConfigManager.h"
@@ -183,6 +184,8 @@ bool MenuModeEditorLoad::updateFilesList(const CEGUI::EventArgs&)
                 officialFileList.clear();
         }
 
+        // The levels info is cached so that the levels are not read each time the menu is opened
+        LevelInfoIndex levelInfoIndex(ResourceManager::getSingleton().getLevelInfoIndexFile());
         for (uint32_t n = 0; n < mFilesList.size(); ++n)
         {
             std::string filename = mFilesList[n];
@@ -191,7 +194,7 @@ bool MenuModeEditorLoad::updateFilesList(const CEGUI::EventArgs&)
             std::string mapName;
             std::string mapDescription;
             bool customMapExists = findFileStemIn(officialFileList, filename);
-            if(MapHandler::getMapInfo(filename, levelInfo))
+            if(levelInfoIndex.getMapInfo(filename, levelInfo))
             {
                 mapName.clear();
                 if (customMapExists)
@@ -213,6 +216,7 @@ bool MenuModeEditorLoad::updateFilesList(const CEGUI::EventArgs&)
             item->setSelectionBrushImage("OpenDungeonsSkin/SelectionBrush");
             levelSelectList->addItem(item);
         }
+        levelInfoIndex.save();
     }
 
     updateDescription();
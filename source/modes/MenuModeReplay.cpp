@@ -25,6 +25,8 @@
 #include "render/ODFrameListener.h"
 #include "network/ODServer.h"
 #include "network/ODClient.h"
+#include "network/PacketCompression.h"
+#include "network/ReplayIndex.h"
 #include "network/ServerNotification.h"
 #include "ODApplication.h"
 #include "utils/LogManager.h"
@@ -35,6 +37,9 @@
 #include <CEGUI/CEGUI.h>
 #include "boost/filesystem.hpp"
 
+#include <fstream>
+#include <memory>
+
 const std::string REPLAY_EXTENSION = ".odr";
 
 MenuModeReplay::MenuModeReplay(ModeManager *modeManager):
@@ -219,35 +224,45 @@ bool MenuModeReplay::checkReplayValid(const std::string& replayFileName, std::st
 {
     // We open the replay to get the level file name
     std::ifstream is(replayFileName, std::ios::in | std::ios::binary);
-    ODPacket packet;
-    ServerNotificationType type;
-    do
-    {
-        packet.readPacket(is);
-        OD_ASSERT_TRUE(packet >> type);
-        if(is.eof())
-            break;
-    } while(type != ServerNotificationType::loadLevel);
+    std::unique_ptr<PacketInflater> inflater;
+    if(ODPacket::readReplayHeader(is))
+        inflater.reset(new PacketInflater);
 
-    if(is.eof())
+    std::string odVersion;
+    ReplayIndex replayIndex;
+    if(replayIndex.readIndex(is))
     {
-        errorMsg = "Invalid replay file";
-        return false;
+        // The level info is in the index at the end of the replay
+        odVersion = replayIndex.getOdVersion();
+        mapDescription = replayIndex.getLevelDescription();
+    }
+    else
+    {
+        // The replay has no index. We look for the loadLevel packet
+        ODPacket packet;
+        ServerNotificationType type;
+        do
+        {
+            if(packet.readPacket(is, inflater.get()) < 0)
+            {
+                errorMsg = "Invalid replay file";
+                return false;
+            }
+        } while(!(packet >> type) || (type != ServerNotificationType::loadLevel));
+
+        std::string tmpStr;
+        int32_t tmpInt;
+        // OD version
+        OD_ASSERT_TRUE(packet >> odVersion);
+        // mapSizeX
+        OD_ASSERT_TRUE(packet >> tmpInt);
+        // mapSizeY
+        OD_ASSERT_TRUE(packet >> tmpInt);
+        // LevelFileName
+        OD_ASSERT_TRUE(packet >> tmpStr);
+        // LevelDescription
+        OD_ASSERT_TRUE(packet >> mapDescription);
     }
-
-    std::string odVersion;
-    std::string tmpStr;
-    int32_t tmpInt;
-    // OD version
-    OD_ASSERT_TRUE(packet >> odVersion);
-    // mapSizeX
-    OD_ASSERT_TRUE(packet >> tmpInt);
-    // mapSizeY
-    OD_ASSERT_TRUE(packet >> tmpInt);
-    // LevelFileName
-    OD_ASSERT_TRUE(packet >> tmpStr);
-    // LevelDescription
-    OD_ASSERT_TRUE(packet >> mapDescription);
 
     if(odVersion.compare(std::string("OpenDungeons V ") + ODApplication::VERSION) != 0)
     {
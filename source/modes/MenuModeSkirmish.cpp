@@ -27,6 +27,7 @@
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
 #include "utils/LogManager.h"
+#include "gamemap/LevelInfoIndex.h"
 #include "gamemap/MapHandler.h"
 #include "utils/ConfigManager.h"
 #include "utils/ResourceManager.h"
@@ -162,6 +163,8 @@ bool MenuModeSkirmish::updateFilesList(const CEGUI::EventArgs&)
 
     if(Helper::fillFilesList(levelPath, mFilesList, MapHandler::LEVEL_EXTENSION))
     {
+        // The levels info is cached so that the levels are not read each time the menu is opened
+        LevelInfoIndex levelInfoIndex(ResourceManager::getSingleton().getLevelInfoIndexFile());
         for (uint32_t n = 0; n < mFilesList.size(); ++n)
         {
             std::string filename = mFilesList[n];
@@ -169,7 +172,7 @@ bool MenuModeSkirmish::updateFilesList(const CEGUI::EventArgs&)
             LevelInfo levelInfo;
             std::string mapName;
             std::string mapDescription;
-            if(MapHandler::getMapInfo(filename, levelInfo))
+            if(levelInfoIndex.getMapInfo(filename, levelInfo))
             {
                 mapName = levelInfo.mLevelName;
                 mapDescription = levelInfo.mLevelDescription;
@@ -186,6 +189,7 @@ bool MenuModeSkirmish::updateFilesList(const CEGUI::EventArgs&)
             item->setSelectionBrushImage("OpenDungeonsSkin/SelectionBrush");
             levelSelectList->addItem(item);
         }
+        levelInfoIndex.save();
     }
 
     updateDescription();
@@ -37,6 +37,7 @@
 #include "network/ODPacket.h"
 #include "network/ServerMode.h"
 #include "network/ServerNotification.h"
+#include "network/TileDelta.h"
 #include "render/ODFrameListener.h"
 #include "render/RenderManager.h"
 #include "sound/MusicPlayer.h"
@@ -82,6 +83,15 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
     OD_LOG_DBG("processMessage type=" + ServerNotification::typeString(cmd));
     switch(cmd)
     {
+        case ServerNotificationType::enableCompression:
+        {
+            // The next packets sent by the server will be compressed. Replays are recorded
+            // after decompression so there is nothing to do when reading one
+            if(getSource() == ODSource::network)
+                enableReceiveCompression();
+            break;
+        }
+
         case ServerNotificationType::loadLevel:
         {
             std::string odVersion;
@@ -757,28 +767,19 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::refreshVisibleTiles:
         {
-            uint32_t nbTiles;
+            TileDeltaReader reader(packetReceived);
+            std::vector<Tile*> tiles;
             // Tiles we gained vision
-            OD_ASSERT_TRUE(packetReceived >> nbTiles);
-            while(nbTiles > 0)
+            OD_ASSERT_TRUE(gameMap->tilesFromPacket(reader, tiles));
+            for(Tile* tile : tiles)
             {
-                --nbTiles;
-                Tile* tile = gameMap->tileFromPacket(packetReceived);
-                if(tile == nullptr)
-                    continue;
-
                 tile->setLocalPlayerHasVision(true);
                 tile->refreshMesh();
             }
             // Tiles we lost vision
-            OD_ASSERT_TRUE(packetReceived >> nbTiles);
-            while(nbTiles > 0)
+            OD_ASSERT_TRUE(gameMap->tilesFromPacket(reader, tiles));
+            for(Tile* tile : tiles)
             {
-                --nbTiles;
-                Tile* tile = gameMap->tileFromPacket(packetReceived);
-                if(tile == nullptr)
-                    continue;
-
                 tile->setLocalPlayerHasVision(false);
                 tile->refreshMesh();
             }
@@ -787,19 +788,12 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::refreshTiles:
         {
-            uint32_t nbTiles;
-            OD_ASSERT_TRUE(packetReceived >> nbTiles);
+            TileDeltaReader reader(packetReceived);
             std::vector<Tile*> tiles;
-            while(nbTiles > 0)
-            {
-                --nbTiles;
-                Tile* gameTile = gameMap->tileFromPacket(packetReceived);
-                if(gameTile == nullptr)
-                    continue;
+            OD_ASSERT_TRUE(gameMap->tilesFromPacket(reader, tiles));
+            for(Tile* tile : tiles)
+                tile->updateFromPacket(reader);
 
-                gameTile->updateFromPacket(packetReceived);
-                tiles.push_back(gameTile);
-            }
             gameMap->refreshBorderingTilesOf(tiles);
             break;
         }
@@ -1030,10 +1024,13 @@ bool ODClient::connect(const std::string& host, const int port, uint32_t timeout
     if(!ODSocketClient::connect(host, port, timeout, outputReplayFilename))
         return false;
 
-    // Send a hello request to start the conversation with the server
+    // Send a hello request to start the conversation with the server. We also tell the server
+    // if we want it to compress the packets it sends
+    bool compression = ConfigManager::getSingleton().getGameValue(Config::NETWORK_COMPRESSION, "Yes", false) == "Yes";
     ODPacket packSend;
     packSend << ClientNotificationType::hello
-        << std::string("OpenDungeons V ") + ODApplication::VERSION;
+        << std::string("OpenDungeons V ") + ODApplication::VERSION
+        << compression;
     send(packSend);
 
     return true;
@@ -17,12 +17,21 @@
 
 #include "network/ODPacket.h"
 
+#include "network/PacketCompression.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
 #define OD_INT64TOINT32H(valInt64)              (static_cast<int32_t>(valInt64 >> 32))
 #define OD_INT64TOINT32L(valInt64)              (static_cast<int32_t>(valInt64))
 #define OD_INT32TOINT64(valInt32h,valInt32l)    ((((static_cast<int64_t>(valInt32h)) << 32) & static_cast<int64_t>(0xFFFFFFFF00000000)) + ((static_cast<int64_t>(valInt32l)) & static_cast<int64_t>(0x00000000FFFFFFFF)))
 
-// The max buffer size when reading packets.
-const int32_t BUFFER_SIZE = 1024;
+// Replays starting with this header have their packets compressed (see PacketDeflater)
+const char REPLAY_MAGIC[4] = { 'O', 'D', 'R', 'Z' };
+const uint32_t REPLAY_VERSION = 1;
 
 ODPacket& ODPacket::operator >>(bool& data)
 {
@@ -243,8 +252,27 @@ void ODPacket::clear()
     mPacket.clear();
 }
 
-void ODPacket::writePacket(int32_t timestamp, std::ofstream& os)
+uint32_t ODPacket::getDataSize() const
+{
+    return static_cast<uint32_t>(mPacket.getDataSize());
+}
+
+void ODPacket::writePacket(int32_t timestamp, std::ofstream& os, PacketDeflater* deflater)
 {
+    if(deflater != nullptr)
+    {
+        ODPacket packetCompressed;
+        if(!deflater->deflatePacket(*this, packetCompressed))
+        {
+            OD_LOG_ERR("Could not compress packet timestamp=" + Helper::toString(timestamp)
+                + ", size=" + Helper::toString(getDataSize()));
+            return;
+        }
+
+        packetCompressed.writePacket(timestamp, os);
+        return;
+    }
+
     int32_t bufferSize = mPacket.getDataSize();
     const char* buffer = static_cast<const char*>(mPacket.getData());
     os.write(reinterpret_cast<const char*>(&timestamp), sizeof(int32_t));
@@ -252,7 +280,7 @@ void ODPacket::writePacket(int32_t timestamp, std::ofstream& os)
     os.write(buffer, bufferSize);
 }
 
-int32_t ODPacket::readPacket(std::ifstream& is)
+int32_t ODPacket::readPacket(std::ifstream& is, PacketInflater* inflater)
 {
     int32_t timestamp;
     int32_t packetSize;
@@ -262,18 +290,49 @@ int32_t ODPacket::readPacket(std::ifstream& is)
         return -1;
 
     is.read(reinterpret_cast<char*>(&packetSize), sizeof(int32_t));
-    if(is.eof())
+    if(is.eof() || (packetSize < 0))
         return -1;
 
     mPacket.clear();
-    char buffer[BUFFER_SIZE];
-    while(packetSize > 0)
+    std::vector<char> buffer(packetSize);
+    is.read(buffer.data(), packetSize);
+    if(is.gcount() != packetSize)
+        return -1;
+
+    if(inflater == nullptr)
     {
-        int32_t sizeToRead = std::min(packetSize, BUFFER_SIZE);
-        is.read(buffer, sizeToRead);
-        mPacket.append(buffer, sizeToRead);
-        packetSize -= sizeToRead;
+        mPacket.append(buffer.data(), packetSize);
+        return timestamp;
     }
 
+    ODPacket packetCompressed;
+    packetCompressed.mPacket.append(buffer.data(), packetSize);
+    if(!inflater->inflatePacket(packetCompressed, *this))
+        return -1;
+
     return timestamp;
 }
+
+void ODPacket::writeReplayHeader(std::ofstream& os)
+{
+    os.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    os.write(reinterpret_cast<const char*>(&REPLAY_VERSION), sizeof(REPLAY_VERSION));
+}
+
+bool ODPacket::readReplayHeader(std::ifstream& is)
+{
+    char magic[sizeof(REPLAY_MAGIC)];
+    uint32_t version = 0;
+    is.read(magic, sizeof(magic));
+    if(is.good() && (std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) == 0))
+    {
+        is.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if(version == REPLAY_VERSION)
+            return true;
+    }
+
+    // Replays recorded by former versions start directly with the packets
+    is.clear();
+    is.seekg(0);
+    return false;
+}
@@ -63,9 +63,14 @@
  * Reception : packet >> creature->mHp;
  * This way, if mHp changes (from float to double for example), it will still work.
  */
+class PacketDeflater;
+class PacketInflater;
+
 class ODPacket
 {
     friend class ODSocketClient;
+    friend class PacketDeflater;
+    friend class PacketInflater;
 
     public:
         ODPacket()
@@ -125,15 +130,31 @@ class ODPacket
          */
         void clear();
 
+        //! \brief Returns the size in bytes of the packet data
+        uint32_t getDataSize() const;
+
         /*! \brief Writes the packet content to the given ofstream.
+         *         If deflater is not null, the packet is compressed with it.
          */
-        void writePacket(int32_t timestamp, std::ofstream& os);
+        void writePacket(int32_t timestamp, std::ofstream& os, PacketDeflater* deflater = nullptr);
 
         /*! \brief Reads the packet content from the given ifstream.
          *         Returns the timestamp at which the packet has been sent.
-         *         If EOF has been reached, returns -1
+         *         If EOF has been reached or if the packet is invalid, returns -1.
+         *         If inflater is not null, the packet is decompressed with it.
+         */
+        int32_t readPacket(std::ifstream& is, PacketInflater* inflater = nullptr);
+
+        /*! \brief Writes the header of a replay file. It should be written before the packets.
+         *         The packets of a replay with a header are compressed
+         */
+        static void writeReplayHeader(std::ofstream& os);
+
+        /*! \brief Reads the header written by writeReplayHeader and returns true if it is valid.
+         *         If it is not (replays written by former versions), the stream is rewound and the
+         *         packets should be read without decompressing them
          */
-        int32_t readPacket(std::ifstream& is);
+        static bool readReplayHeader(std::ifstream& is);
 
         /*! \brief Template function to put arguments in a packet, used for in-place construction.
          */
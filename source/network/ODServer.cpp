@@ -30,6 +30,7 @@
 #include "game/SkillType.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/LevelSnapshot.h"
 #include "gamemap/MapHandler.h"
 #include "modes/ConsoleCommands.h"
 #include "network/ODClient.h"
@@ -46,6 +47,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MasterServer.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
 #include "ODApplication.h"
 
@@ -57,6 +59,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <cmath>
+#include <ctime>
+#include <memory>
+#include <sstream>
+
 
 const std::string SAVEGAME_SKIRMISH_PREFIX = "SK-";
 const std::string SAVEGAME_MULTIPLAYER_PREFIX = "MP-";
@@ -75,7 +82,9 @@ ODServer::ODServer() :
     mSeatsConfigured(false),
     mPlayerConfig(nullptr),
     mConsoleInterface(std::bind(&ODServer::printConsoleMsg, this, std::placeholders::_1)),
-    mMasterServerGameStatusUpdateTime(0)
+    mConsoleCommandPlayer(nullptr),
+    mMasterServerGameStatusUpdateTime(0),
+    mTurnScheduler(1000.0 / ODApplication::turnsPerSecond)
 {
     ConsoleCommands::addConsoleCommands(mConsoleInterface);
 }
@@ -83,6 +92,7 @@ ODServer::ODServer() :
 ODServer::~ODServer()
 {
     delete mGameMap;
+    ServerNotification::clearFreeList();
 }
 
 bool ODServer::startServer(const std::string& creator, const std::string& levelFilename, ServerMode mode, bool useMasterServer)
@@ -114,7 +124,8 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     mServerState = ServerState::StateConfiguration;
     mUniqueNumberPlayer = 0;
     GameMap* gameMap = mGameMap;
-    if (!gameMap->loadLevel(levelFilename))
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+    if (!loadServerLevel(levelFilename, resMgr.hasForcedSeed(), resMgr.getForcedSeed()))
     {
         mServerMode = ServerMode::ModeNone;
         mServerState = ServerState::StateNone;
@@ -232,11 +243,128 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     return true;
 }
 
+bool ODServer::loadServerLevel(const std::string& levelFilename, bool isSeedForced, uint64_t forcedSeed)
+{
+    GameMap* gameMap = mGameMap;
+    // The level can set its own seed. If not, each game is different. The seed forced on the command line
+    // is used for the whole game, including the entities loaded from the level that may use random numbers
+    gameMap->setSeed(isSeedForced ? forcedSeed : static_cast<uint64_t>(std::time(0)));
+    Random::ScopedStream randomScope(gameMap->getRandomStream());
+    if (!gameMap->loadLevel(levelFilename))
+        return false;
+
+    if(isSeedForced)
+        gameMap->setSeed(forcedSeed);
+
+    gameMap->setNbSenseWorkers(ResourceManager::getSingleton().getNbSenseWorkers());
+
+    OD_LOG_INF("Game seed=" + Helper::toString(gameMap->getSeed()));
+    return true;
+}
+
+bool ODServer::runHeadlessGame(const std::string& levelFilename, uint64_t seed, uint32_t nbSenseWorkers, uint32_t nbTurns,
+    std::vector<uint64_t>& stateHashes)
+{
+    if (isConnected())
+    {
+        OD_LOG_ERR("Cannot run a headless game while the server is connected");
+        return false;
+    }
+
+    mServerMode = ServerMode::ModeGameMultiPlayer;
+    mServerState = ServerState::StateGame;
+    GameMap* gameMap = mGameMap;
+    if (!loadServerLevel(levelFilename, true, seed))
+    {
+        OD_LOG_ERR("Couldn't run headless game. The level file can't be loaded: " + levelFilename);
+        mServerMode = ServerMode::ModeNone;
+        mServerState = ServerState::StateNone;
+        return false;
+    }
+
+    gameMap->setNbSenseWorkers(nbSenseWorkers);
+    Random::ScopedStream randomScope(gameMap->getRandomStream());
+
+    // Every seat is played by the AI. As no client is connected, the notifications are dropped
+    const std::vector<std::string>& factions = ConfigManager::getSingleton().getFactions();
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->isRogueSeat())
+            continue;
+
+        if(seat->getFaction().compare(Seat::PLAYER_FACTION_CHOICE) == 0)
+            seat->setFaction(factions.front());
+
+        Player* player = new Player(gameMap, 0);
+        gameMap->addPlayer(player);
+        seat->setPlayer(player);
+        if(seat->getPlayerType().compare(Seat::PLAYER_TYPE_INACTIVE) == 0)
+        {
+            player->setNick("Inactive AI " + Helper::toString(seat->getId()));
+        }
+        else
+        {
+            player->setNick("Keeper AI " + Helper::toString(seat->getId()));
+            gameMap->assignAI(*player, KeeperAIType::normal);
+        }
+
+        const std::vector<int>& availableTeamIds = seat->getAvailableTeamIds();
+        if(!availableTeamIds.empty())
+            seat->setTeamId(availableTeamIds.front());
+
+        seat->setMapSize(gameMap->getMapSizeX(), gameMap->getMapSizeY());
+    }
+
+    for(Seat* seat : gameMap->getSeats())
+        seat->initSeat();
+
+    mSeatsConfigured = true;
+    gameMap->notifySeatsConfigured();
+    launchGame();
+
+    // The turns use the nominal length to not depend on the time they take
+    double timeSinceLastTurn = 1.0 / ODApplication::turnsPerSecond;
+    stateHashes.clear();
+    // Each turn, we check the seat statistics kept up to date during the turn against a full recount.
+    // We log how long both take to compare the turn time with the cost of recounting every turn
+    bool isConsistent = true;
+    int64_t turnsTime = 0;
+    int64_t recountTime = 0;
+    uint64_t nbEntityVisionEvents = 0;
+    sf::Clock clock;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        clock.restart();
+        startNewTurn(timeSinceLastTurn);
+        turnsTime += static_cast<int64_t>(clock.getElapsedTime().asMicroseconds());
+        nbEntityVisionEvents += gameMap->getNbEntityVisionEvents();
+        stateHashes.push_back(gameMap->computeStateHash());
+
+        clock.restart();
+        if(!gameMap->checkSeatStatistics())
+        {
+            OD_LOG_ERR("Seat statistics differ from a full recount at turn " + Helper::toString(turn + 1));
+            isConsistent = false;
+        }
+        recountTime += static_cast<int64_t>(clock.getElapsedTime().asMicroseconds());
+    }
+
+    OD_LOG_INF("Headless game on " + levelFilename + ": " + Helper::toString(nbTurns) + " turns took "
+        + Helper::toString(turnsTime) + " us, recounting the seat statistics would add "
+        + Helper::toString(recountTime) + " us, entities vision events=" + Helper::toString(nbEntityVisionEvents));
+
+    gameMap->clearAll();
+    mSeatsConfigured = false;
+    mServerMode = ServerMode::ModeNone;
+    mServerState = ServerState::StateNone;
+    return isConsistent;
+}
+
 void ODServer::queueServerNotification(ServerNotification* n)
 {
     if ((n == nullptr) || (!isConnected()))
     {
-        delete n;
+        ServerNotification::release(n);
         return;
     }
     mServerNotificationQueue.push_back(n);
@@ -251,9 +379,11 @@ void ODServer::sendMsg(Player* player, ODPacket& packet)
 {
     if(player == nullptr)
     {
-        // If player is nullptr, we send the message to every connected player
+        // If player is nullptr, we send the message to every connected player. The packet is
+        // framed once and the same buffer is sent to every client
+        mBroadcastFrame.clear();
         for (ODSocketClient* client : mSockClients)
-            client->send(packet);
+            client->sendShared(packet, mBroadcastFrame);
 
         return;
     }
@@ -281,7 +411,11 @@ void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std:
         return;
     }
 
-    if(mConsoleInterface.tryExecuteServerCommand(args, *gameMap) != Command::Result::SUCCESS)
+    // The output of the command is only sent to the player who launched it (see printConsoleMsg)
+    mConsoleCommandPlayer = player;
+    Command::Result result = mConsoleInterface.tryExecuteServerCommand(args, *gameMap);
+    mConsoleCommandPlayer = nullptr;
+    if(result != Command::Result::SUCCESS)
     {
         std::string msg = "Cannot execute console command";
         for(const std::string& str : args)
@@ -293,7 +427,7 @@ void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std:
     }
 
     // We notify all players that a console command has been executed
-    ServerNotification *serverNotification = new ServerNotification(
+    ServerNotification *serverNotification = ServerNotification::acquire(
         ServerNotificationType::chatServer, nullptr);
 
     std::string msg = "Console cmd launched: " + args[0];
@@ -301,22 +435,27 @@ void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std:
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
-void ODServer::startNewTurn(double timeSinceLastTurn)
+bool ODServer::haveClientsAckedTurn() const
 {
-    GameMap* gameMap = mGameMap;
-    int64_t turn = gameMap->getTurnNumber();
-
     // We wait until every client acknowledge the turn to start the next one. This way, we ensure
     // synchronisation is not too bad
+    int64_t turn = mGameMap->getTurnNumber();
     for (ODSocketClient* client : mSockClients)
     {
         if(client->getLastTurnAck() != turn)
-            return;
+            return false;
     }
 
+    return true;
+}
+
+void ODServer::startNewTurn(double timeSinceLastTurn)
+{
+    GameMap* gameMap = mGameMap;
+    int64_t turn = gameMap->getTurnNumber();
     gameMap->setTurnNumber(++turn);
 
-    ServerNotification* serverNotification = new ServerNotification(
+    ServerNotification* serverNotification = ServerNotification::acquire(
         ServerNotificationType::turnStarted, nullptr);
     serverNotification->mPacket << turn;
     queueServerNotification(serverNotification);
@@ -332,7 +471,7 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
         Player* player = sock->getPlayer();
         // For now, only the player whose seat changed is notified. If we need it, we could send the event to every player
         // so that they can see how far from the goals the other players are
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::refreshPlayerSeat, player);
         std::string goals = gameMap->getGoalsStringForPlayer(player);
         Seat* seat = player->getSeat();
@@ -354,7 +493,7 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
             {
                 std::string creatureInfos = creature->getStatsText();
 
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::notifyCreatureInfo, player);
                 serverNotification->mPacket << name << creatureInfos;
                 ODServer::getSingleton().queueServerNotification(serverNotification);
@@ -390,17 +529,109 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
     gameMap->processDeletionQueues();
 }
 
+void ODServer::launchGame()
+{
+    GameMap* gameMap = mGameMap;
+
+    // We configure the game for launching
+    const std::vector<Seat*>& seats = gameMap->getSeats();
+    for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+    {
+        for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+        {
+            Tile* tile = gameMap->getTile(ii,jj);
+            tile->setSeats(seats);
+        }
+    }
+
+    // We set allied seats
+    for(Seat* seat : seats)
+    {
+        for(Seat* alliedSeat : seats)
+        {
+            if(alliedSeat == seat)
+                continue;
+            if(!seat->isAlliedSeat(alliedSeat))
+                continue;
+            seat->addAlliedSeat(alliedSeat);
+            gameMap->getVisionTracker().addAlliedSeat(seat->getId(), alliedSeat->getId());
+        }
+    }
+
+    // Every client is connected and ready, we can launch the game
+    // Send turn 0 to init the map
+    ServerNotification* serverNotification = ServerNotification::acquire(
+        ServerNotificationType::turnStarted, nullptr);
+    serverNotification->mPacket << static_cast<int64_t>(0);
+    queueServerNotification(serverNotification);
+
+    OD_LOG_INF("Server ready, starting game");
+    gameMap->setTurnNumber(0);
+    gameMap->setGamePaused(false);
+
+    // In editor mode, we give vision on all the gamemap tiles
+    if(mServerMode == ServerMode::ModeEditor)
+    {
+        for (Seat* seat : gameMap->getSeats())
+        {
+            for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+            {
+                for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+                {
+                    gameMap->getVisionTracker().addVision(ii, jj, seat->getId());
+                }
+            }
+
+            seat->sendVisibleTiles();
+        }
+    }
+
+    gameMap->createAllEntities();
+
+    // Fill starting gold
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->getPlayer() == nullptr)
+            continue;
+
+        // In editor mode, the treasuries do not count their gold for the seat which keeps the
+        // starting gold saved with the level
+        int startingGold = (mServerMode == ServerMode::ModeEditor) ? seat->getGold() : seat->takeStartingGold();
+        if(startingGold > 0)
+            gameMap->addGoldToSeat(startingGold, seat->getId());
+    }
+}
+
+//! \brief Returns the time elapsed since the given clock was restarted in milliseconds
+static double elapsedMs(const sf::Clock& clock)
+{
+    return static_cast<double>(clock.getElapsedTime().asMicroseconds()) / 1000.0;
+}
+
 void ODServer::serverThread()
 {
     GameMap* gameMap = mGameMap;
+    // Everything computed by the server depends on the game seed
+    Random::ScopedStream randomScope(gameMap->getRandomStream());
     sf::Clock clock;
-    double turnLengthMs = 1000.0 / ODApplication::turnsPerSecond;
+    sf::Clock stopwatch;
+    double turnLengthMs = mTurnScheduler.getTurnLengthMs();
+    mTurnScheduler.start(elapsedMs(clock));
     bool isClientConnected = true;
     while(isConnected() && isClientConnected)
     {
-        // doTask should return after the length of 1 turn even if their are communications. When
-        // it returns, we can launch next turn.
-        doTask(static_cast<int32_t>(turnLengthMs));
+        // The turns are due at fixed times. Until the next one is due, we process the
+        // client messages
+        stopwatch.restart();
+        double waitTimeMs = mTurnScheduler.getWaitTimeMs(elapsedMs(clock));
+        int32_t waitTimeMsRounded = static_cast<int32_t>(std::ceil(waitTimeMs));
+        if(waitTimeMsRounded > 0)
+            doTask(waitTimeMsRounded);
+        else
+            pollSockets();
+
+        mTurnScheduler.addIoWaitTime(elapsedMs(stopwatch));
+
         // If all the clients are disconnected during a game, we close the server
         if((mServerState == ServerState::StateGame) &&
            (mSockClients.empty()))
@@ -410,6 +641,9 @@ void ODServer::serverThread()
             continue;
         }
 
+        if(!mTurnScheduler.isTurnDue(elapsedMs(clock)))
+            continue;
+
         if(gameMap->getTurnNumber() == -1)
         {
             // The game is not started
@@ -422,69 +656,11 @@ void ODServer::serverThread()
                     MasterServer::updateGame(mMasterServerGameId, MASTER_SERVER_STATUS_STARTED);
                 }
 
-                // We configure the game for launching
-                const std::vector<Seat*>& seats = gameMap->getSeats();
-                for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                {
-                    for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                    {
-                        Tile* tile = gameMap->getTile(ii,jj);
-                        tile->setSeats(seats);
-                    }
-                }
-
-                // We set allied seats
-                for(Seat* seat : seats)
-                {
-                    for(Seat* alliedSeat : seats)
-                    {
-                        if(alliedSeat == seat)
-                            continue;
-                        if(!seat->isAlliedSeat(alliedSeat))
-                            continue;
-                        seat->addAlliedSeat(alliedSeat);
-                    }
-                }
-
-                // Every client is connected and ready, we can launch the game
-                // Send turn 0 to init the map
-                ServerNotification* serverNotification = new ServerNotification(
-                    ServerNotificationType::turnStarted, nullptr);
-                serverNotification->mPacket << static_cast<int64_t>(0);
-                queueServerNotification(serverNotification);
-
-                OD_LOG_INF("Server ready, starting game");
-                gameMap->setTurnNumber(0);
-                gameMap->setGamePaused(false);
-
-                // In editor mode, we give vision on all the gamemap tiles
-                if(mServerMode == ServerMode::ModeEditor)
-                {
-                    for (Seat* seat : gameMap->getSeats())
-                    {
-                        for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                        {
-                            for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                            {
-                                gameMap->getTile(ii,jj)->notifyVision(seat);
-                            }
-                        }
-
-                        seat->sendVisibleTiles();
-                    }
-                }
-
-                gameMap->createAllEntities();
-
-                // Fill starting gold
-                for(Seat* seat : gameMap->getSeats())
-                {
-                    if(seat->getPlayer() == nullptr)
-                        continue;
+                launchGame();
 
-                    if(seat->getGold() > 0)
-                        gameMap->addGoldToSeat(seat->getGold(), seat->getId());
-                }
+                // The game time starts now. We do not keep the timings measured while waiting for players
+                mTurnScheduler.start(elapsedMs(clock));
+                mTurnScheduler.clearStats();
             }
             else
             {
@@ -510,9 +686,24 @@ void ODServer::serverThread()
         // to wait for server. If server is in advance, he might send commands before the
         // creatures arrive at their destination. That could result in weird issues like
         // creatures going through walls.
-        startNewTurn(static_cast<double>(clock.restart().asSeconds()) * 0.95);
+        // If a client did not acknowledge the last turn, the turn is skipped. What happens to its
+        // time depends on the scheduler policy
+        if(haveClientsAckedTurn())
+        {
+            double timeSinceLastTurn = mTurnScheduler.beginTurn();
+            stopwatch.restart();
+            startNewTurn(timeSinceLastTurn * 0.95);
+            mTurnScheduler.addSimulationTime(elapsedMs(stopwatch));
+        }
+        else
+        {
+            mTurnScheduler.skipTurn();
+        }
 
+        stopwatch.restart();
+        notifySavedGames();
         processServerNotifications();
+        mTurnScheduler.addFlushTime(elapsedMs(stopwatch));
     }
 
     if(!mMasterServerGameId.empty())
@@ -522,6 +713,24 @@ void ODServer::serverThread()
     }
 }
 
+void ODServer::notifySavedGames()
+{
+    for(const AsyncFileWriter::Result& result : mSaveWriter.popResults())
+    {
+        std::string msg = "Map saved successfully as: " + result.mFileName;
+        if(!result.mSuccess)
+        {
+            OD_LOG_ERR("Couldn't write file=" + result.mFileName);
+            msg = "Couldn't not save map file as: " + result.mFileName + "\nPlease check logs.";
+        }
+
+        // We notify all the players that the game was saved
+        ServerNotification notif(ServerNotificationType::chatServer, nullptr);
+        notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+        sendAsyncMsg(notif);
+    }
+}
+
 void ODServer::processServerNotifications()
 {
     GameMap* gameMap = mGameMap;
@@ -581,7 +790,7 @@ void ODServer::processServerNotifications()
                 break;
         }
 
-        delete event;
+        ServerNotification::release(event);
         event = nullptr;
     }
 }
@@ -667,6 +876,17 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                 return false;
             }
 
+            // If the client asked for compression, we tell it before compressing
+            bool compression = false;
+            OD_ASSERT_TRUE(packetReceived >> compression);
+            if(compression)
+            {
+                ODPacket packetCompression;
+                packetCompression << ServerNotificationType::enableCompression;
+                clientSocket->send(packetCompression);
+                clientSocket->enableSendCompression();
+            }
+
             // Tell the client to load the given map
             OD_LOG_INF("Level sent to client: " + gameMap->getLevelName());
             clientSocket->setState("loadLevel");
@@ -1336,7 +1556,7 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             if(!rooms.empty())
                 break;
 
-            ServerNotification *serverNotification = new ServerNotification(
+            ServerNotification *serverNotification = ServerNotification::acquire(
                 ServerNotificationType::chatServer, player);
 
             std::string msg = "You need a workshop to craft the trap!";
@@ -1552,19 +1772,48 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                 levelSave = boost::filesystem::path(savePath);
             }
 
-            // If the file exists, we make a backup
-            if (boost::filesystem::exists(levelSave))
-                boost::filesystem::rename(levelSave, levelSave.string() + ".bak");
+            // The game is copied in memory between 2 turns. The file is written by mSaveWriter so that
+            // the next turns are not delayed. If the file exists, it keeps a backup. The players are
+            // notified when the file is written (see notifySavedGames). The levels saved in the editor
+            // stay in the text format and are formatted here. The savegames are written as snapshots:
+            // their header and entities are formatted here too but the tiles are only copied. They are
+            // compressed and written by mSaveWriter
+            std::ostringstream levelStream;
+            std::shared_ptr<LevelSnapshot> snapshot;
+            bool isSaved;
+            if(mServerMode == ServerMode::ModeEditor)
+            {
+                isSaved = MapHandler::writeGameMapToStream(levelStream, *gameMap);
+            }
+            else
+            {
+                snapshot = std::make_shared<LevelSnapshot>();
+                isSaved = MapHandler::writeGameMapToSnapshot(*snapshot, *gameMap);
+            }
+            if (!isSaved)
+            {
+                std::string msg = "Couldn't not save map file as: " + levelSave.string() + "\nPlease check logs.";
+                ServerNotification notif(ServerNotificationType::chatServer, nullptr);
+                notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+                sendAsyncMsg(notif);
+                break;
+            }
 
-            std::string msg = "Map saved successfully as: " + levelSave.string();
-            if (!MapHandler::writeGameMapToFile(levelSave.string(), *gameMap))
+            if(snapshot == nullptr)
             {
-                msg = "Couldn't not save map file as: " + levelSave.string() + "\nPlease check logs.";
+                mSaveWriter.write(levelSave.string(), levelStream.str());
+                break;
             }
-            // We notify all the players that the game was saved successfully
-            ServerNotification notif(ServerNotificationType::chatServer, nullptr);
-            notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
-            sendAsyncMsg(notif);
+
+            mSaveWriter.write(levelSave.string(), [snapshot](std::string& content)
+            {
+                std::ostringstream snapshotStream;
+                if(!snapshot->writeToStream(snapshotStream))
+                    return false;
+
+                content = snapshotStream.str();
+                return true;
+            });
             break;
         }
 
@@ -1608,7 +1857,6 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             }
             if(!affectedTiles.empty())
             {
-                uint32_t nbTiles = affectedTiles.size();
                 const std::vector<Seat*>& seats = gameMap->getSeats();
                 for(Seat* seat : seats)
                 {
@@ -1618,14 +1866,10 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                         continue;
 
                     ServerNotification notif(ServerNotificationType::refreshTiles, seat->getPlayer());
-                    notif.mPacket << nbTiles;
                     for(Tile* tile : affectedTiles)
-                    {
-                        gameMap->tileToPacket(notif.mPacket, tile);
                         seat->updateTileStateForSeat(tile, false);
-                        tile->exportToPacketForUpdate(notif.mPacket, seat);
 
-                    }
+                    seat->exportTilesToPacket(notif.mPacket, affectedTiles, false);
                     sendAsyncMsg(notif);
                 }
             }
@@ -1882,7 +2126,7 @@ bool ODServer::notifyClientMessage(ODSocketClient *clientSocket)
                 if(!player->getIsHuman())
                     continue;
 
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::chatServer, player);
                 std::string msg = nick.empty() ?
                                   "A client disconnected." :
@@ -1914,9 +2158,10 @@ void ODServer::stopServer()
     // Now that the server is stopped, we can remove all pending messages
     while(!mServerNotificationQueue.empty())
     {
-        delete mServerNotificationQueue.front();
+        ServerNotification::release(mServerNotificationQueue.front());
         mServerNotificationQueue.pop_front();
     }
+    ServerNotification::clearFreeList();
     mGameMap->clearAll();
 }
 
@@ -1924,11 +2169,11 @@ void ODServer::notifyExit()
 {
     while(!mServerNotificationQueue.empty())
     {
-        delete mServerNotificationQueue.front();
+        ServerNotification::release(mServerNotificationQueue.front());
         mServerNotificationQueue.pop_front();
     }
 
-    ServerNotification* exitServerNotification = new ServerNotification(
+    ServerNotification* exitServerNotification = ServerNotification::acquire(
         ServerNotificationType::exit, nullptr);
     queueServerNotification(exitServerNotification);
 }
@@ -2023,9 +2268,44 @@ int32_t ODServer::getNetworkPort() const
     return ConfigManager::getSingleton().getNetworkPort();
 }
 
+std::string ODServer::getCompressionStatsString() const
+{
+    uint32_t nbClients = 0;
+    uint64_t nbBytesIn = 0;
+    uint64_t nbBytesOut = 0;
+    uint64_t timeMicroseconds = 0;
+    for(ODSocketClient* client : mSockClients)
+    {
+        const PacketDeflater* deflater = client->getSendDeflater();
+        if(deflater == nullptr)
+            continue;
+
+        ++nbClients;
+        nbBytesIn += deflater->getNbBytesIn();
+        nbBytesOut += deflater->getNbBytesOut();
+        timeMicroseconds += deflater->getTimeMicroseconds();
+    }
+
+    double ratio = (nbBytesOut == 0) ? 0.0 : static_cast<double>(nbBytesIn) / static_cast<double>(nbBytesOut);
+    return "clients=" + Helper::toString(nbClients)
+        + ", bytesIn=" + Helper::toString(nbBytesIn)
+        + ", bytesOut=" + Helper::toString(nbBytesOut)
+        + ", ratio=" + Helper::toString(ratio, 3)
+        + ", time=" + Helper::toString(timeMicroseconds) + "us";
+}
+
 void ODServer::printConsoleMsg(const std::string& text)
 {
     OD_LOG_INF("Console:" + text);
+
+    // The player who launched the command gets its output. The other players are not notified
+    if(mConsoleCommandPlayer == nullptr)
+        return;
+
+    ServerNotification *serverNotification = ServerNotification::acquire(
+        ServerNotificationType::chatServer, mConsoleCommandPlayer);
+    serverNotification->mPacket << text << EventShortNoticeType::genericGameInfo;
+    queueServerNotification(serverNotification);
 }
 
 ODPacket& operator<<(ODPacket& os, const EventShortNoticeType& type)
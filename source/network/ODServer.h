@@ -20,6 +20,8 @@
 
 #include "ODSocketServer.h"
 #include "modes/ConsoleInterface.h"
+#include "network/TurnScheduler.h"
+#include "utils/AsyncFileWriter.h"
 
 #include <OgreSingleton.h>
 
@@ -77,7 +79,17 @@ class ODServer: public Ogre::Singleton<ODServer>,
     bool startServer(const std::string& creator, const std::string& levelFilename, ServerMode mode, bool useMasterServer);
     void stopServer();
 
-    //! \brief Adds a server notification to the server notification queue. The message will be sent to the concerned player
+    /*! \brief Plays the given number of turns of the given level with the given seed in the calling thread without network.
+     * Every seat is played by the AI. The hash of the game state (see GameMap::computeStateHash) is added to stateHashes
+     * after each turn. Used to check that a game only depends on its seed and not on the number of threads
+     * given by nbSenseWorkers (see GameMap::setNbSenseWorkers). Returns false if the level cannot be loaded or if the seat
+     * statistics differ from a full recount (see GameMap::checkSeatStatistics)
+     */
+    bool runHeadlessGame(const std::string& levelFilename, uint64_t seed, uint32_t nbSenseWorkers, uint32_t nbTurns,
+        std::vector<uint64_t>& stateHashes);
+
+    //! \brief Adds a server notification to the server notification queue. The message will be sent to the concerned player.
+    //! n should have been created with ServerNotification::acquire. It will be released once sent
     void queueServerNotification(ServerNotification* n);
 
     //! \brief Sends an asynchronous message to the concerned player. This function should be used really carefully as it can easily
@@ -95,6 +107,14 @@ class ODServer: public Ogre::Singleton<ODServer>,
 
     int32_t getNetworkPort() const;
 
+    //! \brief Schedules the turns and measures their timings. Should only be used from the server thread
+    inline TurnScheduler& getTurnScheduler()
+    { return mTurnScheduler; }
+
+    //! \brief Returns the number of bytes sent to the clients using compression before and after compression
+    //! and the time spent compressing. Should only be used from the server thread
+    std::string getCompressionStatsString() const;
+
 protected:
     ODSocketClient* notifyNewConnection(sf::TcpListener& sockListener) override;
     bool notifyClientMessage(ODSocketClient *sock) override;
@@ -112,18 +132,42 @@ private:
 
     std::deque<ServerNotification*> mServerNotificationQueue;
 
+    //! \brief Buffer holding the framed packet when a notification is sent to every player. It is
+    //! kept to avoid allocating it for each message
+    std::vector<char> mBroadcastFrame;
+
     std::map<ODSocketClient*, std::vector<std::string>> mCreaturesInfoWanted;
 
     ConsoleInterface mConsoleInterface;
+    //! \brief Player who launched the console command being executed. nullptr outside of handleConsoleCommand
+    Player* mConsoleCommandPlayer;
 
     std::string mMasterServerGameId;
     double mMasterServerGameStatusUpdateTime;
 
+    TurnScheduler mTurnScheduler;
+
+    //! \brief Writes the saved games from its own thread so that the turns are not delayed
+    AsyncFileWriter mSaveWriter;
+
     void printConsoleMsg(const std::string& text);
 
+    //! \brief Tells the players about the saved games written since the last call
+    void notifySavedGames();
+
     ODSocketClient* getClientFromPlayer(Player* player);
     ODSocketClient* getClientFromPlayerId(int32_t playerId);
 
+    //! \brief Returns true if every client acknowledged the current turn. If not, the next turn should not start.
+    bool haveClientsAckedTurn() const;
+
+    //! \brief Loads the level in the server gamemap and seeds it. If isSeedForced is false, the seed is taken from
+    //! the level or the time
+    bool loadServerLevel(const std::string& levelFilename, bool isSeedForced, uint64_t forcedSeed);
+
+    //! \brief Called when every seat is configured to create the entities and start turn 0
+    void launchGame();
+
     //! \brief Called when a new turn started.
     void startNewTurn(double timeSinceLastTurn);
 
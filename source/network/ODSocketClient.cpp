@@ -25,6 +25,9 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 bool ODSocketClient::connect(const std::string& host, const int port, uint32_t timeout, const std::string& outputReplayFilename)
 {
     mSource = ODSource::none;
@@ -44,7 +47,15 @@ bool ODSocketClient::connect(const std::string& host, const int port, uint32_t t
     mOutputReplayFilename = outputReplayFilename;
 
     mReplayOutputStream.open(mOutputReplayFilename, std::ios::out | std::ios::binary);
+    ODPacket::writeReplayHeader(mReplayOutputStream);
+    mReplayDeflater.reset(new PacketDeflater);
+    mReplayIndex.clear();
+    mSendDeflater.reset();
+    mReceiveInflater.reset();
     mGameClock.restart();
+    mGameTimeAtClockRestart = 0;
+    mReplaySpeed = 1;
+    mSeekTimestamp = -1;
     mSource = ODSource::network;
     return true;
 }
@@ -53,14 +64,68 @@ bool ODSocketClient::replay(const std::string& filename)
 {
     OD_LOG_INF("Reading replay from file " + filename);
     mReplayInputStream.open(filename, std::ios::in | std::ios::binary);
+    if(ODPacket::readReplayHeader(mReplayInputStream))
+        mReplayInflater.reset(new PacketInflater);
+    else
+        mReplayInflater.reset();
+
+    if(mReplayIndex.readIndex(mReplayInputStream))
+    {
+        OD_LOG_INF("Replay indexed with nbTurns="
+            + Helper::toString(static_cast<uint32_t>(mReplayIndex.getTurns().size())));
+    }
+
     mGameClock.restart();
+    mGameTimeAtClockRestart = 0;
+    mReplaySpeed = 1;
+    mSeekTimestamp = -1;
     mSource = ODSource::file;
     return true;
 }
 
+bool ODSocketClient::setReplaySpeed(uint32_t speed)
+{
+    if(mSource != ODSource::file)
+        return false;
+
+    mGameTimeAtClockRestart = getGameTimeMillis();
+    mGameClock.restart();
+    mReplaySpeed = std::max(speed, 1u);
+    return true;
+}
+
+bool ODSocketClient::seekReplayTurn(int64_t turnNum)
+{
+    if(mSource != ODSource::file)
+        return false;
+
+    const ReplayTurn* turn = mReplayIndex.findTurn(turnNum);
+    if((turn == nullptr) || (turn->mTimestamp <= getGameTimeMillis()))
+        return false;
+
+    // The game time jumps to the turn so that every packet before is available at once. The packets are
+    // applied by processClientSocketMessages as usual
+    mSeekTimestamp = turn->mTimestamp;
+    mGameTimeAtClockRestart = turn->mTimestamp;
+    mGameClock.restart();
+    return true;
+}
+
+void ODSocketClient::enableSendCompression()
+{
+    mSendDeflater.reset(new PacketDeflater);
+}
+
+void ODSocketClient::enableReceiveCompression()
+{
+    mReceiveInflater.reset(new PacketInflater);
+}
+
 void ODSocketClient::disconnect(bool keepReplay)
 {
     mPendingTimestamp = -1;
+    mSendDeflater.reset();
+    mReceiveInflater.reset();
     ODSource src = mSource;
     mSource = ODSource::none;
     switch(src)
@@ -81,6 +146,7 @@ void ODSocketClient::disconnect(bool keepReplay)
         case ODSource::file:
         {
             mReplayInputStream.close();
+            mReplayIndex.clear();
             return;
         }
         default:
@@ -88,7 +154,14 @@ void ODSocketClient::disconnect(bool keepReplay)
             break;
     }
 
+    // The index is only useful if the replay is kept
+    if(keepReplay)
+        mReplayIndex.writeIndex(mReplayOutputStream);
+    mReplayIndex.clear();
+
     mReplayOutputStream.close();
+    mReplayDeflater.reset();
+    mReplayInflater.reset();
     // Delete the replay newly created if asked to.
     if (!keepReplay)
         boost::filesystem::remove(mOutputReplayFilename);
@@ -117,12 +190,23 @@ bool ODSocketClient::isDataAvailable()
                 return false;
 
             if(mPendingTimestamp == -1)
-                mPendingTimestamp = mPendingPacket.readPacket(mReplayInputStream);
+            {
+                // The index written at the end of the replay is not a packet to replay
+                uint64_t indexOffset = mReplayIndex.getIndexOffset();
+                if((indexOffset > 0) && (static_cast<uint64_t>(mReplayInputStream.tellg()) >= indexOffset))
+                    return false;
+
+                mPendingTimestamp = mPendingPacket.readPacket(mReplayInputStream, mReplayInflater.get());
+            }
 
             if(mPendingTimestamp < 0)
                 return false;
 
-            if(mPendingTimestamp < mGameClock.getElapsedTime().asMilliseconds())
+            // The seeked turn is reached. The next packets are rendered normally
+            if((mSeekTimestamp >= 0) && (mPendingTimestamp >= mSeekTimestamp))
+                mSeekTimestamp = -1;
+
+            if(mPendingTimestamp < getGameTimeMillis())
                 return true;
 
             return false;
@@ -140,7 +224,19 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
     if(mSource != ODSource::network)
         return ODComStatus::OK;
 
-    sf::Socket::Status status = mSockClient.send(s.mPacket);
+    sf::Socket::Status status;
+    if(mSendDeflater != nullptr)
+    {
+        if(!mSendDeflater->deflatePacket(s, mPacketCompressed))
+        {
+            OD_LOG_ERR("Could not compress packet");
+            return ODComStatus::Error;
+        }
+        status = mSockClient.send(mPacketCompressed.mPacket);
+    }
+    else
+        status = mSockClient.send(s.mPacket);
+
     if (status == sf::Socket::Done)
         return ODComStatus::OK;
 
@@ -149,6 +245,34 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
     return ODComStatus::Error;
 }
 
+ODSocketClient::ODComStatus ODSocketClient::sendShared(ODPacket& s, std::vector<char>& frame)
+{
+    if(mSource != ODSource::network)
+        return ODComStatus::OK;
+
+    if(mSendDeflater != nullptr)
+        return send(s);
+
+    if(frame.empty())
+    {
+        // Same framing as sf::TcpSocket::send(sf::Packet&): the size in network byte order then the data
+        uint32_t size = static_cast<uint32_t>(s.mPacket.getDataSize());
+        frame.resize(sizeof(uint32_t) + size);
+        frame[0] = static_cast<char>((size >> 24) & 0xFF);
+        frame[1] = static_cast<char>((size >> 16) & 0xFF);
+        frame[2] = static_cast<char>((size >> 8) & 0xFF);
+        frame[3] = static_cast<char>(size & 0xFF);
+        if(size > 0)
+            std::memcpy(frame.data() + sizeof(uint32_t), s.mPacket.getData(), size);
+    }
+
+    sf::Socket::Status status = mSockClient.send(frame.data(), frame.size());
+    if (status == sf::Socket::Done)
+        return ODComStatus::OK;
+
+    return ODComStatus::Error;
+}
+
 ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
 {
     switch(mSource)
@@ -161,11 +285,24 @@ ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
         }
         case ODSource::network:
         {
-            sf::Socket::Status status = mSockClient.receive(s.mPacket);
+            sf::Socket::Status status;
+            if(mReceiveInflater != nullptr)
+                status = mSockClient.receive(mPacketCompressed.mPacket);
+            else
+                status = mSockClient.receive(s.mPacket);
+
             if (status == sf::Socket::Done)
             {
-                s.writePacket(mGameClock.getElapsedTime().asMilliseconds(),
-                    mReplayOutputStream);
+                if((mReceiveInflater != nullptr) &&
+                   !mReceiveInflater->inflatePacket(mPacketCompressed, s))
+                {
+                    OD_LOG_ERR("Could not decompress packet");
+                    return ODComStatus::Error;
+                }
+
+                mLastRecordTimestamp = getGameTimeMillis();
+                mLastRecordOffset = static_cast<uint64_t>(mReplayOutputStream.tellp());
+                s.writePacket(mLastRecordTimestamp, mReplayOutputStream, mReplayDeflater.get());
                 return ODComStatus::OK;
             }
 
@@ -227,5 +364,43 @@ bool ODSocketClient::processOneClientSocketMessage()
     ServerNotificationType serverCommand;
     OD_ASSERT_TRUE(packetReceived >> serverCommand);
 
+    if(mSource == ODSource::network)
+        indexReplayPacket(serverCommand, packetReceived);
+    else if(((mSeekTimestamp >= 0) || (mReplaySpeed > 1)) &&
+            ServerNotification::isRenderingOnly(serverCommand))
+    {
+        return true;
+    }
+
     return processMessage(serverCommand, packetReceived);
 }
+
+void ODSocketClient::indexReplayPacket(ServerNotificationType cmd, const ODPacket& packetReceived)
+{
+    switch(cmd)
+    {
+        case ServerNotificationType::loadLevel:
+        {
+            // The packet is copied to be read from the current position without changing it
+            ODPacket packet(packetReceived);
+            std::string odVersion;
+            int32_t mapSizeX;
+            int32_t mapSizeY;
+            std::string levelFileName;
+            std::string levelDescription;
+            if(packet >> odVersion >> mapSizeX >> mapSizeY >> levelFileName >> levelDescription)
+                mReplayIndex.setLevelInfo(odVersion, levelFileName, levelDescription, mapSizeX, mapSizeY);
+            break;
+        }
+        case ServerNotificationType::turnStarted:
+        {
+            ODPacket packet(packetReceived);
+            int64_t turnNum;
+            if(packet >> turnNum)
+                mReplayIndex.addTurn(turnNum, mLastRecordTimestamp, mLastRecordOffset);
+            break;
+        }
+        default:
+            break;
+    }
+}
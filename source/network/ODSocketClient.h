@@ -19,12 +19,16 @@
 #define ODSOCKETCLIENT_H
 
 #include "network/ODPacket.h"
+#include "network/PacketCompression.h"
+#include "network/ReplayIndex.h"
 
 #include <SFML/Network.hpp>
 
 #include <string>
 #include <cstdint>
 #include <fstream>
+#include <memory>
+#include <vector>
 
 class Player;
 
@@ -49,7 +53,12 @@ class ODSocketClient
             mSource(ODSource::none),
             mPlayer(nullptr),
             mLastTurnAck(-1),
-            mPendingTimestamp(-1)
+            mPendingTimestamp(-1),
+            mGameTimeAtClockRestart(0),
+            mReplaySpeed(1),
+            mSeekTimestamp(-1),
+            mLastRecordTimestamp(0),
+            mLastRecordOffset(0)
         {}
 
         virtual ~ODSocketClient()
@@ -71,14 +80,43 @@ class ODSocketClient
         void setLastTurnAck(int64_t lastTurnAck) { mLastTurnAck = lastTurnAck; }
         const std::string& getState() {return mState;}
         bool isDataAvailable();
+        //! \brief Time since the game started. When a replay is watched, it is the time in the replay
         int32_t getGameTimeMillis()
-        { return mGameClock.getElapsedTime().asMilliseconds(); }
+        { return mGameTimeAtClockRestart + mGameClock.getElapsedTime().asMilliseconds() * static_cast<int32_t>(mReplaySpeed); }
+
+        //! \brief Replay only. The replay is played speed times faster than it was recorded. 1 is the normal speed.
+        //! The notifications that are only rendered (see ServerNotification::isRenderingOnly) are skipped if speed > 1.
+        //! Returns false if no replay is watched
+        bool setReplaySpeed(uint32_t speed);
+
+        inline uint32_t getReplaySpeed() const
+        { return mReplaySpeed; }
+
+        /*! \brief Replay only. Applies at once the packets until the start of the given turn, without the notifications
+         *         that are only rendered. The replay should have an index (see ReplayIndex). The replay can only go
+         *         forward. Returns false if the turn is already played or is not in the replay
+         */
+        bool seekReplayTurn(int64_t turnNum);
+
+        //! \brief Index of the replay being watched. Empty if the replay has none
+        inline const ReplayIndex& getReplayIndex() const
+        { return mReplayIndex; }
 
         void setState(const std::string& state) {mState = state;}
 
         sf::TcpSocket& getSockClient()
         { return mSockClient; }
 
+        /*! \brief Compresses the packets sent from now on. The peer should be told before (with an uncompressed
+         * packet) so that it calls enableReceiveCompression before reading the next packet
+         */
+        void enableSendCompression();
+        void enableReceiveCompression();
+
+        //! \brief Returns the deflater used to send packets or nullptr if they are not compressed
+        const PacketDeflater* getSendDeflater() const
+        { return mSendDeflater.get(); }
+
         void setSource(ODSource source)
         { mSource = source; }
 
@@ -90,6 +128,12 @@ class ODSocketClient
          */
         ODComStatus send(ODPacket& s);
 
+        /*! \brief Sends a packet sent to several clients. The first call frames the packet in frame
+         * (that should be empty) and the next ones send the same buffer instead of copying the packet
+         * again. The clients using compression have their own stream so they compress the packet instead
+         */
+        ODComStatus sendShared(ODPacket& s, std::vector<char>& frame);
+
         /*! \brief Receives a packet through the network
          * ODPacket should preserve integrity. That means that if an ODSocketClient
          * sends an ODPacket, the server should receive exactly 1 similar ODPacket (same data,
@@ -111,6 +155,9 @@ class ODSocketClient
     private :
         bool processOneClientSocketMessage();
 
+        //! \brief Adds the level info and the turns to the index of the replay being recorded
+        void indexReplayPacket(ServerNotificationType cmd, const ODPacket& packetReceived);
+
         ODSource mSource;
         sf::SocketSelector mSockSelector;
         sf::TcpSocket mSockClient;
@@ -127,6 +174,30 @@ class ODSocketClient
         //! \brief the replay filename being written. Used to later optionally delete it
         //! if asked to.
         std::string mOutputReplayFilename;
+
+        //! \brief Network compression, if negotiated with the peer
+        std::unique_ptr<PacketDeflater> mSendDeflater;
+        std::unique_ptr<PacketInflater> mReceiveInflater;
+        //! \brief Kept to avoid allocating a packet each time one is (de)compressed
+        ODPacket mPacketCompressed;
+
+        //! \brief Compression of the replay being written or read. mReplayInflater is nullptr
+        //! for the replays recorded before they were compressed
+        std::unique_ptr<PacketDeflater> mReplayDeflater;
+        std::unique_ptr<PacketInflater> mReplayInflater;
+
+        //! \brief Game time when mGameClock was restarted. The clock is restarted when the replay speed changes
+        //! or when a replay is seeked
+        int32_t mGameTimeAtClockRestart;
+        uint32_t mReplaySpeed;
+        //! \brief Timestamp of the turn a replay is seeked to. -1 if the replay is not being seeked
+        int32_t mSeekTimestamp;
+
+        //! \brief Index of the replay being recorded or watched
+        ReplayIndex mReplayIndex;
+        //! \brief Timestamp and offset of the last packet recorded in the replay
+        int32_t mLastRecordTimestamp;
+        uint64_t mLastRecordOffset;
 };
 
 #endif // ODSOCKETCLIENT_H
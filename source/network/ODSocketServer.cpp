@@ -69,56 +69,64 @@ void ODSocketServer::doTask(int timeoutMs)
     while((timeoutMs == 0) ||
           (timeoutMs > mClockMainTask.getElapsedTime().asMilliseconds()))
     {
-        bool isSockReady;
         if(timeoutMs != 0)
         {
             // We adapt the timeout so that the function returns after timeoutMs
             // even if events occurred
             int timeoutMsAdjusted = std::max(1, timeoutMs - mClockMainTask.getElapsedTime().asMilliseconds());
-            isSockReady = mSockSelector.wait(sf::milliseconds(timeoutMsAdjusted));
+            processSocketEvents(sf::milliseconds(timeoutMsAdjusted));
         }
         else
         {
-            isSockReady = mSockSelector.wait(sf::Time::Zero);
+            processSocketEvents(sf::Time::Zero);
         }
+    }
+}
+
+void ODSocketServer::pollSockets()
+{
+    // Note that a timeout of 0 would wait forever
+    processSocketEvents(sf::microseconds(1));
+}
 
-        // Check if a client tries to connect or to communicate
-        if(!isSockReady)
-            continue;
+void ODSocketServer::processSocketEvents(sf::Time timeout)
+{
+    // Check if a client tries to connect or to communicate
+    if(!mSockSelector.wait(timeout))
+        return;
 
-        if(mSockSelector.isReady(mSockListener))
+    if(mSockSelector.isReady(mSockListener))
+    {
+        // New connection
+        ODSocketClient* newClient = notifyNewConnection(mSockListener);
+        if (newClient != nullptr)
         {
             // New connection
-            ODSocketClient* newClient = notifyNewConnection(mSockListener);
-            if (newClient != nullptr)
-            {
-                // New connection
-                OD_LOG_INF("New client connected.");
-                // The server wants to keep the client
-                newClient->setSource(ODSocketClient::ODSource::network);
-                mSockSelector.add(newClient->getSockClient());
-                mSockClients.push_back(newClient);
-            }
+            OD_LOG_INF("New client connected.");
+            // The server wants to keep the client
+            newClient->setSource(ODSocketClient::ODSource::network);
+            mSockSelector.add(newClient->getSockClient());
+            mSockClients.push_back(newClient);
         }
-        else
-        {
+    }
+    else
+    {
 
-            for(std::vector<ODSocketClient*>::iterator it = mSockClients.begin(); it != mSockClients.end();)
+        for(std::vector<ODSocketClient*>::iterator it = mSockClients.begin(); it != mSockClients.end();)
+        {
+            ODSocketClient* client = *it;
+            if((mSockSelector.isReady(client->getSockClient())) &&
+                (!notifyClientMessage(client)))
+            {
+                // The server wants to remove the client
+                it = mSockClients.erase(it);
+                mSockSelector.remove(client->getSockClient());
+                client->disconnect();
+                delete client;
+            }
+            else
             {
-                ODSocketClient* client = *it;
-                if((mSockSelector.isReady(client->getSockClient())) &&
-                    (!notifyClientMessage(client)))
-                {
-                    // The server wants to remove the client
-                    it = mSockClients.erase(it);
-                    mSockSelector.remove(client->getSockClient());
-                    client->disconnect();
-                    delete client;
-                }
-                else
-                {
-                    ++it;
-                }
+                ++it;
             }
         }
     }
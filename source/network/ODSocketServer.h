@@ -62,11 +62,19 @@ class ODSocketServer
          * timeoutMs milliseconds, even if new clients connected or clients are sending messages.
          */
         void doTask(int timeoutMs);
+
+        //! \brief Processes the connections and messages already received without waiting
+        void pollSockets();
+
         std::vector<ODSocketClient*> mSockClients;
         virtual void serverThread() = 0;
         sf::Thread* mThread;
 
     private:
+        //! \brief Waits at most timeout for a connection or a message and processes it. Note that
+        //! with sf::Time::Zero, it waits until something is received
+        void processSocketEvents(sf::Time timeout);
+
         sf::TcpListener mSockListener;
         sf::SocketSelector mSockSelector;
         sf::Clock mClockMainTask;
@@ -0,0 +1,163 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/PacketCompression.h"
+
+#include "network/ODPacket.h"
+
+#include <SFML/System/Clock.hpp>
+
+#include <zlib.h>
+
+#include <cstring>
+
+namespace
+{
+    // Size of the chunks used to (de)compress
+    const uint32_t BUFFER_SIZE = 16 * 1024;
+
+    // A sync flush always ends with these 4 bytes. We don't send them and add them back
+    // before decompressing
+    const uint8_t SYNC_FLUSH_TRAILER[] = { 0x00, 0x00, 0xFF, 0xFF };
+    const uint32_t SYNC_FLUSH_TRAILER_SIZE = sizeof(SYNC_FLUSH_TRAILER);
+}
+
+PacketDeflater::PacketDeflater(int level) :
+    mStream(new z_stream_s),
+    mIsValid(false),
+    mBuffer(BUFFER_SIZE),
+    mNbBytesIn(0),
+    mNbBytesOut(0),
+    mTimeMicroseconds(0)
+{
+    std::memset(mStream.get(), 0, sizeof(z_stream_s));
+    mIsValid = (deflateInit(mStream.get(), level) == Z_OK);
+}
+
+PacketDeflater::~PacketDeflater()
+{
+    // Safe even if the initialization failed since the stream was zeroed
+    deflateEnd(mStream.get());
+}
+
+bool PacketDeflater::deflatePacket(const ODPacket& packetIn, ODPacket& packetOut)
+{
+    packetOut.clear();
+    if(!mIsValid)
+        return false;
+
+    // zlib does not flush anything when there is no new input. Empty packets stay empty
+    std::size_t sizeIn = packetIn.mPacket.getDataSize();
+    if(sizeIn == 0)
+        return true;
+
+    sf::Clock clock;
+    z_stream_s& stream = *mStream;
+    // zlib does not modify the input data but its API is not const
+    stream.next_in = static_cast<Bytef*>(const_cast<void*>(packetIn.mPacket.getData()));
+    stream.avail_in = static_cast<uInt>(sizeIn);
+
+    std::vector<uint8_t>& data = mData;
+    data.clear();
+    do
+    {
+        stream.next_out = mBuffer.data();
+        stream.avail_out = static_cast<uInt>(mBuffer.size());
+        if(deflate(&stream, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+        {
+            mIsValid = false;
+            return false;
+        }
+        data.insert(data.end(), mBuffer.data(), mBuffer.data() + (mBuffer.size() - stream.avail_out));
+    }
+    while(stream.avail_out == 0);
+
+    if((data.size() < SYNC_FLUSH_TRAILER_SIZE) ||
+       (std::memcmp(data.data() + data.size() - SYNC_FLUSH_TRAILER_SIZE, SYNC_FLUSH_TRAILER, SYNC_FLUSH_TRAILER_SIZE) != 0))
+    {
+        mIsValid = false;
+        return false;
+    }
+
+    data.resize(data.size() - SYNC_FLUSH_TRAILER_SIZE);
+    packetOut.mPacket.append(data.data(), data.size());
+
+    mNbBytesIn += sizeIn;
+    mNbBytesOut += data.size();
+    mTimeMicroseconds += clock.getElapsedTime().asMicroseconds();
+    return true;
+}
+
+PacketInflater::PacketInflater() :
+    mStream(new z_stream_s),
+    mIsValid(false),
+    mBuffer(BUFFER_SIZE)
+{
+    std::memset(mStream.get(), 0, sizeof(z_stream_s));
+    mIsValid = (inflateInit(mStream.get()) == Z_OK);
+}
+
+PacketInflater::~PacketInflater()
+{
+    inflateEnd(mStream.get());
+}
+
+bool PacketInflater::inflatePacket(const ODPacket& packetIn, ODPacket& packetOut)
+{
+    packetOut.clear();
+    if(!mIsValid)
+        return false;
+
+    std::size_t sizeIn = packetIn.mPacket.getDataSize();
+    if(sizeIn == 0)
+        return true;
+
+    std::vector<uint8_t>& dataIn = mData;
+    dataIn.resize(sizeIn + SYNC_FLUSH_TRAILER_SIZE);
+    std::memcpy(dataIn.data(), packetIn.mPacket.getData(), sizeIn);
+    std::memcpy(dataIn.data() + sizeIn, SYNC_FLUSH_TRAILER, SYNC_FLUSH_TRAILER_SIZE);
+
+    z_stream_s& stream = *mStream;
+    stream.next_in = dataIn.data();
+    stream.avail_in = static_cast<uInt>(dataIn.size());
+    while(true)
+    {
+        stream.next_out = mBuffer.data();
+        stream.avail_out = static_cast<uInt>(mBuffer.size());
+        int ret = inflate(&stream, Z_SYNC_FLUSH);
+        if((ret != Z_OK) && (ret != Z_BUF_ERROR))
+        {
+            mIsValid = false;
+            return false;
+        }
+        packetOut.mPacket.append(mBuffer.data(), mBuffer.size() - stream.avail_out);
+
+        // If the output buffer is not full, the whole input has been processed. If there is
+        // some input left, the data is corrupted
+        if(stream.avail_out == 0)
+            continue;
+
+        if(stream.avail_in == 0)
+            return true;
+
+        if(ret == Z_BUF_ERROR)
+        {
+            mIsValid = false;
+            return false;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKETCOMPRESSION_H
+#define PACKETCOMPRESSION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ODPacket;
+
+struct z_stream_s;
+
+/*! \brief Compresses a stream of packets with zlib.
+ *
+ * The zlib stream is kept from one packet to the next so that each packet can use the previous ones
+ * as dictionary: the notifications sent each turn are very similar so they compress much better than
+ * alone. Each packet is flushed so that it can be decompressed as soon as it is received.
+ * Since the packets depend on the previous ones, they should be decompressed by a single
+ * PacketInflater in the same order.
+ */
+class PacketDeflater
+{
+public:
+    //! \brief level is the zlib compression level. The fastest one is used by default as the
+    //! packets are compressed by the server thread
+    PacketDeflater(int level = 1);
+    ~PacketDeflater();
+
+    //! \brief Compresses the data of packetIn in packetOut (cleared first). Returns false if an error occurred
+    bool deflatePacket(const ODPacket& packetIn, ODPacket& packetOut);
+
+    //! \brief Number of bytes before and after compression since the deflater was created
+    inline uint64_t getNbBytesIn() const
+    { return mNbBytesIn; }
+
+    inline uint64_t getNbBytesOut() const
+    { return mNbBytesOut; }
+
+    //! \brief Time spent compressing
+    inline uint64_t getTimeMicroseconds() const
+    { return mTimeMicroseconds; }
+
+private:
+    PacketDeflater(const PacketDeflater&) = delete;
+    PacketDeflater& operator=(const PacketDeflater&) = delete;
+
+    std::unique_ptr<z_stream_s> mStream;
+    bool mIsValid;
+    std::vector<uint8_t> mBuffer;
+    //! \brief Kept from one packet to the next to avoid allocating it each time
+    std::vector<uint8_t> mData;
+
+    uint64_t mNbBytesIn;
+    uint64_t mNbBytesOut;
+    uint64_t mTimeMicroseconds;
+};
+
+//! \brief Decompresses the packets compressed by a PacketDeflater (see PacketDeflater)
+class PacketInflater
+{
+public:
+    PacketInflater();
+    ~PacketInflater();
+
+    //! \brief Decompresses the data of packetIn in packetOut (cleared first). Returns false if an error occurred
+    bool inflatePacket(const ODPacket& packetIn, ODPacket& packetOut);
+
+private:
+    PacketInflater(const PacketInflater&) = delete;
+    PacketInflater& operator=(const PacketInflater&) = delete;
+
+    std::unique_ptr<z_stream_s> mStream;
+    bool mIsValid;
+    std::vector<uint8_t> mBuffer;
+    //! \brief Kept from one packet to the next to avoid allocating it each time
+    std::vector<uint8_t> mData;
+};
+
+#endif // PACKETCOMPRESSION_H
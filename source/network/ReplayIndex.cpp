@@ -0,0 +1,167 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/ReplayIndex.h"
+
+#include "network/ODPacket.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    // The footer is the offset of the index followed by this magic. It ends the replay
+    const char REPLAY_INDEX_MAGIC[4] = { 'O', 'D', 'R', 'I' };
+    const std::streamoff REPLAY_FOOTER_SIZE = sizeof(uint64_t) + sizeof(REPLAY_INDEX_MAGIC);
+
+    bool isTurnBefore(const ReplayTurn& turn, int64_t turnNum)
+    {
+        return turn.mTurnNum < turnNum;
+    }
+
+    //! \brief The footer offset is written in little endian whatever the platform is
+    void writeFooterOffset(std::ofstream& os, uint64_t offset)
+    {
+        char bytes[sizeof(offset)];
+        for(uint32_t i = 0; i < sizeof(offset); ++i)
+            bytes[i] = static_cast<char>((offset >> (8 * i)) & 0xFF);
+        os.write(bytes, sizeof(bytes));
+    }
+
+    bool readFooterOffset(std::ifstream& is, uint64_t& offset)
+    {
+        unsigned char bytes[sizeof(offset)];
+        if(!is.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+            return false;
+
+        offset = 0;
+        for(uint32_t i = 0; i < sizeof(offset); ++i)
+            offset |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        return true;
+    }
+}
+
+ReplayIndex::ReplayIndex() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mIndexOffset(0)
+{
+}
+
+void ReplayIndex::clear()
+{
+    mOdVersion.clear();
+    mLevelFileName.clear();
+    mLevelDescription.clear();
+    mMapSizeX = 0;
+    mMapSizeY = 0;
+    mTurns.clear();
+    mIndexOffset = 0;
+}
+
+void ReplayIndex::setLevelInfo(const std::string& odVersion, const std::string& levelFileName,
+    const std::string& levelDescription, int32_t mapSizeX, int32_t mapSizeY)
+{
+    mOdVersion = odVersion;
+    mLevelFileName = levelFileName;
+    mLevelDescription = levelDescription;
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+}
+
+void ReplayIndex::addTurn(int64_t turnNum, int32_t timestamp, uint64_t offset)
+{
+    ReplayTurn turn;
+    turn.mTurnNum = turnNum;
+    turn.mTimestamp = timestamp;
+    turn.mOffset = offset;
+    mTurns.push_back(turn);
+}
+
+void ReplayIndex::writeIndex(std::ofstream& os) const
+{
+    ODPacket packet;
+    packet << mOdVersion << mLevelFileName << mLevelDescription << mMapSizeX << mMapSizeY;
+    packet << static_cast<uint32_t>(mTurns.size());
+    for(const ReplayTurn& turn : mTurns)
+        packet << turn.mTurnNum << turn.mTimestamp << turn.mOffset;
+
+    uint64_t offset = static_cast<uint64_t>(os.tellp());
+    packet.writePacket(REPLAY_INDEX_TIMESTAMP, os);
+    writeFooterOffset(os, offset);
+    os.write(REPLAY_INDEX_MAGIC, sizeof(REPLAY_INDEX_MAGIC));
+}
+
+bool ReplayIndex::readIndex(std::ifstream& is)
+{
+    clear();
+    is.clear();
+    std::streampos pos = is.tellg();
+
+    bool isValid = false;
+    is.seekg(0, std::ios::end);
+    std::streamoff size = is.tellg();
+    if(size >= REPLAY_FOOTER_SIZE)
+    {
+        uint64_t offset = 0;
+        char magic[sizeof(REPLAY_INDEX_MAGIC)];
+        is.seekg(size - REPLAY_FOOTER_SIZE);
+        bool isRead = readFooterOffset(is, offset);
+        is.read(magic, sizeof(magic));
+        if(isRead && is.good() &&
+           (std::memcmp(magic, REPLAY_INDEX_MAGIC, sizeof(magic)) == 0) &&
+           (offset < static_cast<uint64_t>(size - REPLAY_FOOTER_SIZE)))
+        {
+            ODPacket packet;
+            is.seekg(static_cast<std::streamoff>(offset));
+            uint32_t nbTurns = 0;
+            if((packet.readPacket(is) == REPLAY_INDEX_TIMESTAMP) &&
+               (packet >> mOdVersion >> mLevelFileName >> mLevelDescription >> mMapSizeX >> mMapSizeY >> nbTurns))
+            {
+                isValid = true;
+                for(uint32_t i = 0; i < nbTurns; ++i)
+                {
+                    ReplayTurn turn;
+                    if(!(packet >> turn.mTurnNum >> turn.mTimestamp >> turn.mOffset))
+                    {
+                        isValid = false;
+                        break;
+                    }
+                    mTurns.push_back(turn);
+                }
+                mIndexOffset = offset;
+            }
+        }
+    }
+
+    if(!isValid)
+        clear();
+
+    is.clear();
+    is.seekg(pos);
+    return isValid;
+}
+
+const ReplayTurn* ReplayIndex::findTurn(int64_t turnNum) const
+{
+    auto it = std::lower_bound(mTurns.begin(), mTurns.end(), turnNum, isTurnBefore);
+    if(it == mTurns.end())
+        return nullptr;
+
+    return &(*it);
+}
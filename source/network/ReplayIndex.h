@@ -0,0 +1,107 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAYINDEX_H
+#define REPLAYINDEX_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//! \brief Where a turn starts in a replay
+struct ReplayTurn
+{
+    int64_t mTurnNum;
+    //! \brief Timestamp of the turnStarted packet
+    int32_t mTimestamp;
+    /*! \brief Offset of the turnStarted packet in the replay file. It is not used to seek yet: the packets are
+     * compressed as a single stream so a turn can only be reached by reading the replay from the beginning.
+     * Seeking from the offset needs keyframes (a restart of the compression and a copy of the game state)
+     */
+    uint64_t mOffset;
+};
+
+/*! \brief Index written at the end of a replay when the client disconnects.
+ *
+ * It gives the level info displayed in the replay menu and where each turn starts so that the replay
+ * can be listed and seeked without reading every packet. The index is written after the packets as a
+ * packet record with the timestamp REPLAY_INDEX_TIMESTAMP (that stops the replay of the packets) followed
+ * by a footer giving the offset of that record (little endian) and a magic. The replays without index (recorded by former versions or
+ * not closed properly) are still valid, they are only read from the beginning.
+ */
+class ReplayIndex
+{
+public:
+    ReplayIndex();
+
+    void clear();
+
+    //! \brief Sets the info sent in the loadLevel packet
+    void setLevelInfo(const std::string& odVersion, const std::string& levelFileName,
+        const std::string& levelDescription, int32_t mapSizeX, int32_t mapSizeY);
+
+    //! \brief Adds a turn. The turns should be added in the order they are recorded
+    void addTurn(int64_t turnNum, int32_t timestamp, uint64_t offset);
+
+    //! \brief Writes the index at the current position of the stream, which should be the end of the replay
+    void writeIndex(std::ofstream& os) const;
+
+    /*! \brief Reads the index at the end of the given replay. Returns false if the replay has no index. The
+     * stream position is restored in any case
+     */
+    bool readIndex(std::ifstream& is);
+
+    //! \brief Returns the first turn starting at turnNum or after. nullptr if there is none
+    const ReplayTurn* findTurn(int64_t turnNum) const;
+
+    inline const std::string& getOdVersion() const
+    { return mOdVersion; }
+
+    inline const std::string& getLevelFileName() const
+    { return mLevelFileName; }
+
+    inline const std::string& getLevelDescription() const
+    { return mLevelDescription; }
+
+    inline int32_t getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int32_t getMapSizeY() const
+    { return mMapSizeY; }
+
+    inline const std::vector<ReplayTurn>& getTurns() const
+    { return mTurns; }
+
+    //! \brief Offset of the index in the replay. The packets are before. 0 if the index was not read
+    inline uint64_t getIndexOffset() const
+    { return mIndexOffset; }
+
+    //! \brief Timestamp of the packet record containing the index
+    static const int32_t REPLAY_INDEX_TIMESTAMP = -2;
+
+private:
+    std::string mOdVersion;
+    std::string mLevelFileName;
+    std::string mLevelDescription;
+    int32_t mMapSizeX;
+    int32_t mMapSizeY;
+    std::vector<ReplayTurn> mTurns;
+    uint64_t mIndexOffset;
+};
+
+#endif // REPLAYINDEX_H
@@ -20,6 +20,24 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Mutex.hpp>
+
+#include <vector>
+
+namespace
+{
+    // Notifications are created by the server thread but also by the main thread while the
+    // level is loaded
+    sf::Mutex freeListLock;
+    std::vector<ServerNotification*> freeList;
+
+    // Number of notifications kept in the free list. A turn rarely sends more
+    const uint32_t FREE_LIST_MAX_SIZE = 1024;
+    // Notifications with a bigger packet are not kept
+    const uint32_t FREE_LIST_MAX_PACKET_SIZE = 16 * 1024;
+}
+
 ServerNotification::ServerNotification(ServerNotificationType type,
     Player* concernedPlayer) :
         mType(type),
@@ -28,6 +46,58 @@ ServerNotification::ServerNotification(ServerNotificationType type,
     mPacket << type;
 }
 
+ServerNotification* ServerNotification::acquire(ServerNotificationType type, Player* concernedPlayer)
+{
+    ServerNotification* notification = nullptr;
+    {
+        sf::Lock lock(freeListLock);
+        if(!freeList.empty())
+        {
+            notification = freeList.back();
+            freeList.pop_back();
+        }
+    }
+
+    if(notification == nullptr)
+        return new ServerNotification(type, concernedPlayer);
+
+    notification->mType = type;
+    notification->mConcernedPlayer = concernedPlayer;
+    notification->mPacket.clear();
+    notification->mPacket << type;
+    return notification;
+}
+
+void ServerNotification::release(ServerNotification* notification)
+{
+    if(notification == nullptr)
+        return;
+
+    if(notification->mPacket.getDataSize() <= FREE_LIST_MAX_PACKET_SIZE)
+    {
+        sf::Lock lock(freeListLock);
+        if(freeList.size() < FREE_LIST_MAX_SIZE)
+        {
+            freeList.push_back(notification);
+            return;
+        }
+    }
+
+    delete notification;
+}
+
+void ServerNotification::clearFreeList()
+{
+    std::vector<ServerNotification*> notifications;
+    {
+        sf::Lock lock(freeListLock);
+        notifications.swap(freeList);
+    }
+
+    for(ServerNotification* notification : notifications)
+        delete notification;
+}
+
 std::string ServerNotification::typeString(ServerNotificationType type)
 {
     switch(type)
@@ -116,6 +186,8 @@ std::string ServerNotification::typeString(ServerNotificationType type)
             return "playerEvents";
         case ServerNotificationType::exit:
             return "exit";
+        case ServerNotificationType::enableCompression:
+            return "enableCompression";
         default:
             OD_LOG_ERR("Unknown enum for ServerNotificationType="
                 + Helper::toString(static_cast<int>(type)));
@@ -123,6 +195,22 @@ std::string ServerNotification::typeString(ServerNotificationType type)
     return "";
 }
 
+bool ServerNotification::isRenderingOnly(ServerNotificationType type)
+{
+    switch(type)
+    {
+        case ServerNotificationType::chat:
+        case ServerNotificationType::chatServer:
+        case ServerNotificationType::entitySlapped:
+        case ServerNotificationType::playSpatialSound:
+        case ServerNotificationType::playRelativeSound:
+        case ServerNotificationType::notifyCreatureInfo:
+            return true;
+        default:
+            return false;
+    }
+}
+
 ODPacket& operator<<(ODPacket& os, const ServerNotificationType& nt)
 {
     os << static_cast<int32_t>(nt);
@@ -86,7 +86,10 @@ enum class ServerNotificationType
 
     playerEvents,
 
-    exit
+    exit,
+
+    // Added last so that the values of the other types stay the same
+    enableCompression // Tells the client that the next packets will be compressed
 };
 
 ODPacket& operator<<(ODPacket& os, const ServerNotificationType& nt);
@@ -109,6 +112,24 @@ class ServerNotification
 
         static std::string typeString(ServerNotificationType type);
 
+        /*! \brief Returns true for the notifications that are only heard or displayed when they are received and
+         *         do not change the client game map. They can be skipped when a replay is fast forwarded or seeked
+         */
+        static bool isRenderingOnly(ServerNotificationType type);
+
+        /*! \brief Same as the constructor but the notification is taken from a free list if possible. Its packet
+         *         keeps the buffer allocated by the previous notification so most notifications do not allocate
+         *         anything. Notifications acquired this way should be given back with release instead of being deleted
+         */
+        static ServerNotification* acquire(ServerNotificationType type, Player* concernedPlayer);
+
+        //! \brief Gives the notification back to the free list. Notifications with a big packet are deleted
+        //! instead so that a few map refreshes do not keep a lot of memory
+        static void release(ServerNotification* notification);
+
+        //! \brief Deletes the notifications kept in the free list. Called when the server stops
+        static void clearFreeList();
+
     private:
         ServerNotificationType mType;
         Player *mConcernedPlayer;
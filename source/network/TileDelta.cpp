@@ -0,0 +1,214 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/TileDelta.h"
+
+#include "network/ODPacket.h"
+
+#include <limits>
+
+namespace
+{
+    // Flags sent in the first byte of each tile
+    const uint8_t FLAG_IS_ROOM = 0x01;
+    const uint8_t FLAG_IS_TRAP = 0x02;
+    const uint8_t FLAG_DISPLAY_TILE_MESH = 0x04;
+    const uint8_t FLAG_COLOR_CUSTOM_MESH = 0x08;
+    const uint8_t FLAG_HAS_BRIDGE = 0x10;
+    const uint8_t FLAG_REFUND_ROOM = 0x20;
+    const uint8_t FLAG_REFUND_TRAP = 0x40;
+    const uint8_t FLAG_SEAT = 0x80;
+}
+
+TileDeltaWriter::TileDeltaWriter(ODPacket& packet) :
+    mPacket(packet)
+{
+    mMeshNames[std::string()] = 0;
+    uint8_t version = TILE_DELTA_VERSION;
+    mPacket << version;
+}
+
+void TileDeltaWriter::writeCoords(const std::vector<std::pair<int, int>>& coords)
+{
+    // A run is a list of consecutive tiles on the same row
+    const uint32_t maxRunLength = std::numeric_limits<uint16_t>::max();
+    std::vector<uint32_t> runLengths;
+    for(uint32_t i = 0; i < coords.size(); ++i)
+    {
+        if(!runLengths.empty() &&
+           (runLengths.back() < maxRunLength) &&
+           (coords[i].second == coords[i - 1].second) &&
+           (coords[i].first == coords[i - 1].first + 1))
+        {
+            ++runLengths.back();
+            continue;
+        }
+
+        runLengths.push_back(1);
+    }
+
+    uint32_t nbRuns = runLengths.size();
+    mPacket << nbRuns;
+    uint32_t index = 0;
+    for(uint32_t runLength : runLengths)
+    {
+        int16_t x = static_cast<int16_t>(coords[index].first);
+        int16_t y = static_cast<int16_t>(coords[index].second);
+        uint16_t length = static_cast<uint16_t>(runLength);
+        mPacket << x << y << length;
+        index += runLength;
+    }
+}
+
+void TileDeltaWriter::writeTile(const TileDeltaData& data)
+{
+    uint8_t flags = 0;
+    if(data.mIsRoom)
+        flags |= FLAG_IS_ROOM;
+    if(data.mIsTrap)
+        flags |= FLAG_IS_TRAP;
+    if(data.mDisplayTileMesh)
+        flags |= FLAG_DISPLAY_TILE_MESH;
+    if(data.mColorCustomMesh)
+        flags |= FLAG_COLOR_CUSTOM_MESH;
+    if(data.mHasBridge)
+        flags |= FLAG_HAS_BRIDGE;
+    if(data.mRefundPriceRoom != 0)
+        flags |= FLAG_REFUND_ROOM;
+    if(data.mRefundPriceTrap != 0)
+        flags |= FLAG_REFUND_TRAP;
+    if(data.mSeatId != -1)
+        flags |= FLAG_SEAT;
+
+    mPacket << flags;
+    if(data.mRefundPriceRoom != 0)
+        mPacket << data.mRefundPriceRoom;
+    if(data.mRefundPriceTrap != 0)
+        mPacket << data.mRefundPriceTrap;
+    if(data.mSeatId != -1)
+    {
+        // Seat ids are small positive numbers
+        uint8_t seatId = static_cast<uint8_t>(data.mSeatId);
+        mPacket << seatId;
+    }
+
+    auto it = mMeshNames.find(data.mMeshName);
+    if(it != mMeshNames.end())
+    {
+        mPacket << it->second;
+    }
+    else
+    {
+        // New mesh name. The reader will add it to its palette
+        uint16_t index = static_cast<uint16_t>(mMeshNames.size());
+        mMeshNames[data.mMeshName] = index;
+        mPacket << index << data.mMeshName;
+    }
+
+    mPacket << data.mTileVisual;
+}
+
+TileDeltaReader::TileDeltaReader(ODPacket& packet) :
+    mPacket(packet),
+    mIsValid(false)
+{
+    mMeshNames.push_back(std::string());
+    uint8_t version;
+    if(!(mPacket >> version))
+        return;
+
+    mIsValid = (version == TILE_DELTA_VERSION);
+}
+
+bool TileDeltaReader::readCoords(std::vector<std::pair<int, int>>& coords)
+{
+    coords.clear();
+    if(!mIsValid)
+        return false;
+
+    uint32_t nbRuns;
+    if(!(mPacket >> nbRuns))
+        return false;
+
+    while(nbRuns > 0)
+    {
+        --nbRuns;
+        int16_t x;
+        int16_t y;
+        uint16_t length;
+        if(!(mPacket >> x >> y >> length))
+            return false;
+
+        for(uint16_t i = 0; i < length; ++i)
+            coords.push_back(std::make_pair(x + i, y));
+    }
+
+    return true;
+}
+
+bool TileDeltaReader::readTile(TileDeltaData& data)
+{
+    if(!mIsValid)
+        return false;
+
+    uint8_t flags;
+    if(!(mPacket >> flags))
+        return false;
+
+    data.mIsRoom = (flags & FLAG_IS_ROOM) != 0;
+    data.mIsTrap = (flags & FLAG_IS_TRAP) != 0;
+    data.mDisplayTileMesh = (flags & FLAG_DISPLAY_TILE_MESH) != 0;
+    data.mColorCustomMesh = (flags & FLAG_COLOR_CUSTOM_MESH) != 0;
+    data.mHasBridge = (flags & FLAG_HAS_BRIDGE) != 0;
+
+    data.mRefundPriceRoom = 0;
+    if(((flags & FLAG_REFUND_ROOM) != 0) && !(mPacket >> data.mRefundPriceRoom))
+        return false;
+
+    data.mRefundPriceTrap = 0;
+    if(((flags & FLAG_REFUND_TRAP) != 0) && !(mPacket >> data.mRefundPriceTrap))
+        return false;
+
+    data.mSeatId = -1;
+    if((flags & FLAG_SEAT) != 0)
+    {
+        uint8_t seatId;
+        if(!(mPacket >> seatId))
+            return false;
+
+        data.mSeatId = seatId;
+    }
+
+    uint16_t meshIndex;
+    if(!(mPacket >> meshIndex))
+        return false;
+
+    if(meshIndex == mMeshNames.size())
+    {
+        std::string meshName;
+        if(!(mPacket >> meshName))
+            return false;
+
+        mMeshNames.push_back(meshName);
+    }
+    else if(meshIndex > mMeshNames.size())
+        return false;
+
+    data.mMeshName = mMeshNames[meshIndex];
+
+    return static_cast<bool>(mPacket >> data.mTileVisual);
+}
@@ -0,0 +1,117 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDELTA_H
+#define TILEDELTA_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ODPacket;
+
+//! \brief Should be bumped each time the encoding of TileDeltaWriter changes
+const uint8_t TILE_DELTA_VERSION = 1;
+
+//! \brief State of a tile as seen by a seat. This is what is sent to the client when a tile changes
+//! (see Seat::exportTileToPacket and Tile::updateFromPacket)
+struct TileDeltaData
+{
+    TileDeltaData() :
+        mIsRoom(false),
+        mIsTrap(false),
+        mDisplayTileMesh(true),
+        mColorCustomMesh(false),
+        mHasBridge(false),
+        mRefundPriceRoom(0),
+        mRefundPriceTrap(0),
+        mSeatId(-1),
+        mTileVisual(0)
+    {}
+
+    bool mIsRoom;
+    bool mIsTrap;
+    bool mDisplayTileMesh;
+    bool mColorCustomMesh;
+    bool mHasBridge;
+    uint32_t mRefundPriceRoom;
+    uint32_t mRefundPriceTrap;
+    //! \brief -1 if the client should not see any seat on the tile
+    int32_t mSeatId;
+    std::string mMeshName;
+    //! \brief TileVisual value
+    uint8_t mTileVisual;
+};
+
+/*! \brief Compact encoding of the tiles sent in refreshTiles and refreshVisibleTiles.
+ *
+ * The payload starts with TILE_DELTA_VERSION. Tile coordinates are sent as runs of consecutive tiles on the
+ * same row (x, y, length) so that a revealed area or a big room costs a few bytes per row instead of 8 bytes
+ * per tile. The tile data uses a byte of flags, only sends the refund prices and seat when they are set and
+ * sends the mesh names through a palette: the first time a mesh name is used in a packet, it is sent
+ * after a new index. Then, only the index is sent.
+ * The palette is local to the writer/reader so a packet can be decoded alone.
+ */
+class TileDeltaWriter
+{
+public:
+    //! \brief Writes the version in the given packet
+    TileDeltaWriter(ODPacket& packet);
+
+    //! \brief Writes the given coordinates as runs. The order is kept. Sorting the tiles by row
+    //! (y then x) gives the longest runs
+    void writeCoords(const std::vector<std::pair<int, int>>& coords);
+
+    void writeTile(const TileDeltaData& data);
+
+    inline ODPacket& getPacket()
+    { return mPacket; }
+
+private:
+    ODPacket& mPacket;
+
+    //! \brief Index of the mesh names already sent. The empty mesh has index 0
+    std::map<std::string, uint16_t> mMeshNames;
+};
+
+class TileDeltaReader
+{
+public:
+    //! \brief Reads the version from the given packet. If it does not match TILE_DELTA_VERSION,
+    //! isValid will return false and nothing should be read
+    TileDeltaReader(ODPacket& packet);
+
+    inline bool isValid() const
+    { return mIsValid; }
+
+    //! \brief Reads coordinates written by TileDeltaWriter::writeCoords. coords is cleared first
+    bool readCoords(std::vector<std::pair<int, int>>& coords);
+
+    bool readTile(TileDeltaData& data);
+
+    inline ODPacket& getPacket()
+    { return mPacket; }
+
+private:
+    ODPacket& mPacket;
+    bool mIsValid;
+    std::vector<std::string> mMeshNames;
+};
+
+#endif // TILEDELTA_H
@@ -0,0 +1,230 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/TurnScheduler.h"
+
+#include "utils/Helper.h"
+
+#include <cmath>
+
+const uint32_t TimingHistogram::NB_BUCKETS = 12;
+
+TimingHistogram::TimingHistogram() :
+    mBuckets(NB_BUCKETS, 0),
+    mNbValues(0),
+    mTotalValue(0.0),
+    mMaxValue(0.0)
+{
+}
+
+void TimingHistogram::addValue(double valueMs)
+{
+    uint32_t bucket = 0;
+    double bucketMax = 1.0;
+    while((bucket < NB_BUCKETS - 1) && (valueMs >= bucketMax))
+    {
+        ++bucket;
+        bucketMax *= 2.0;
+    }
+
+    ++mBuckets[bucket];
+    ++mNbValues;
+    mTotalValue += valueMs;
+    if(valueMs > mMaxValue)
+        mMaxValue = valueMs;
+}
+
+void TimingHistogram::clear()
+{
+    mBuckets.assign(NB_BUCKETS, 0);
+    mNbValues = 0;
+    mTotalValue = 0.0;
+    mMaxValue = 0.0;
+}
+
+double TimingHistogram::getAverageValue() const
+{
+    if(mNbValues == 0)
+        return 0.0;
+
+    return mTotalValue / static_cast<double>(mNbValues);
+}
+
+std::string TimingHistogram::toString() const
+{
+    std::string str = "avg=" + Helper::toString(getAverageValue(), 3) + "ms, max=" + Helper::toString(mMaxValue, 3) + "ms";
+    uint32_t bucketMax = 1;
+    for(uint32_t bucket = 0; bucket < NB_BUCKETS; ++bucket)
+    {
+        if(mBuckets[bucket] > 0)
+        {
+            if(bucket < NB_BUCKETS - 1)
+                str += ", <" + Helper::toString(bucketMax) + "ms:";
+            else
+                str += ", >=" + Helper::toString(bucketMax / 2) + "ms:";
+
+            str += Helper::toString(mBuckets[bucket]);
+        }
+        bucketMax *= 2;
+    }
+    return str;
+}
+
+TurnScheduler::TurnScheduler(double turnLengthMs) :
+    mTurnLengthMs(turnLengthMs),
+    mPolicy(TurnSchedulerPolicy::skip),
+    mMaxCatchUpTurns(4),
+    mNextTurnMs(0.0),
+    mPendingTimeMs(0.0),
+    mNbTurns(0),
+    mNbSkippedTurns(0),
+    mNbLateTurns(0)
+{
+}
+
+void TurnScheduler::start(double timeMs)
+{
+    mNextTurnMs = timeMs + mTurnLengthMs;
+    mPendingTimeMs = 0.0;
+}
+
+double TurnScheduler::getWaitTimeMs(double timeMs) const
+{
+    if(timeMs >= mNextTurnMs)
+        return 0.0;
+
+    return mNextTurnMs - timeMs;
+}
+
+bool TurnScheduler::isTurnDue(double timeMs)
+{
+    if(timeMs < mNextTurnMs)
+        return false;
+
+    // If we are late by more than one turn, the next turn will be due at the next time of the schedule
+    uint64_t nbTurnsElapsed = 1 + static_cast<uint64_t>(std::floor((timeMs - mNextTurnMs) / mTurnLengthMs));
+    mNbLateTurns += nbTurnsElapsed - 1;
+    mNextTurnMs += static_cast<double>(nbTurnsElapsed) * mTurnLengthMs;
+    mPendingTimeMs += static_cast<double>(nbTurnsElapsed) * mTurnLengthMs;
+    return true;
+}
+
+void TurnScheduler::skipTurn()
+{
+    ++mNbSkippedTurns;
+    switch(mPolicy)
+    {
+        case TurnSchedulerPolicy::catchUp:
+        {
+            double maxPendingTimeMs = static_cast<double>(mMaxCatchUpTurns + 1) * mTurnLengthMs;
+            if(mPendingTimeMs > maxPendingTimeMs)
+                mPendingTimeMs = maxPendingTimeMs;
+            break;
+        }
+        case TurnSchedulerPolicy::skip:
+        default:
+            mPendingTimeMs = 0.0;
+            break;
+    }
+}
+
+double TurnScheduler::beginTurn()
+{
+    ++mNbTurns;
+    double turnTimeMs;
+    switch(mPolicy)
+    {
+        case TurnSchedulerPolicy::catchUp:
+        {
+            double maxPendingTimeMs = static_cast<double>(mMaxCatchUpTurns + 1) * mTurnLengthMs;
+            turnTimeMs = (mPendingTimeMs < maxPendingTimeMs) ? mPendingTimeMs : maxPendingTimeMs;
+            break;
+        }
+        case TurnSchedulerPolicy::skip:
+        default:
+            turnTimeMs = mTurnLengthMs;
+            break;
+    }
+    mPendingTimeMs = 0.0;
+    return turnTimeMs / 1000.0;
+}
+
+void TurnScheduler::addIoWaitTime(double timeMs)
+{
+    mIoWaitTimes.addValue(timeMs);
+}
+
+void TurnScheduler::addSimulationTime(double timeMs)
+{
+    mSimulationTimes.addValue(timeMs);
+}
+
+void TurnScheduler::addFlushTime(double timeMs)
+{
+    mFlushTimes.addValue(timeMs);
+}
+
+std::string TurnScheduler::getStatsString() const
+{
+    std::string str = "policy=" + toString(mPolicy)
+        + ", turnLength=" + Helper::toString(mTurnLengthMs, 3) + "ms"
+        + ", turns=" + Helper::toString(mNbTurns)
+        + ", skipped=" + Helper::toString(mNbSkippedTurns)
+        + ", late=" + Helper::toString(mNbLateTurns);
+    str += "\nI/O wait: " + mIoWaitTimes.toString();
+    str += "\nSimulation: " + mSimulationTimes.toString();
+    str += "\nNotifications flush: " + mFlushTimes.toString();
+    return str;
+}
+
+void TurnScheduler::clearStats()
+{
+    mNbTurns = 0;
+    mNbSkippedTurns = 0;
+    mNbLateTurns = 0;
+    mIoWaitTimes.clear();
+    mSimulationTimes.clear();
+    mFlushTimes.clear();
+}
+
+std::string TurnScheduler::toString(TurnSchedulerPolicy policy)
+{
+    switch(policy)
+    {
+        case TurnSchedulerPolicy::skip:
+            return "skip";
+        case TurnSchedulerPolicy::catchUp:
+            return "catchup";
+        default:
+            return "unknown";
+    }
+}
+
+bool TurnScheduler::fromString(const std::string& str, TurnSchedulerPolicy& policy)
+{
+    if(str == "skip")
+    {
+        policy = TurnSchedulerPolicy::skip;
+        return true;
+    }
+    if(str == "catchup")
+    {
+        policy = TurnSchedulerPolicy::catchUp;
+        return true;
+    }
+    return false;
+}
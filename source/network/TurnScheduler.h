@@ -0,0 +1,165 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TURNSCHEDULER_H
+#define TURNSCHEDULER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! \brief Histogram of durations in milliseconds. The bucket i counts the values below 2^i ms (and above the
+//! previous bucket). The last bucket counts everything above
+class TimingHistogram
+{
+public:
+    static const uint32_t NB_BUCKETS;
+
+    TimingHistogram();
+
+    void addValue(double valueMs);
+
+    void clear();
+
+    inline uint64_t getNbValues() const
+    { return mNbValues; }
+
+    inline double getMaxValue() const
+    { return mMaxValue; }
+
+    double getAverageValue() const;
+
+    inline uint64_t getBucketCount(uint32_t bucket) const
+    { return mBuckets[bucket]; }
+
+    //! \brief Returns a one line description with the average, the max and the non empty buckets
+    std::string toString() const;
+
+private:
+    std::vector<uint64_t> mBuckets;
+    uint64_t mNbValues;
+    double mTotalValue;
+    double mMaxValue;
+};
+
+//! \brief What the scheduler does with the game time of the turns that could not be run on time
+enum class TurnSchedulerPolicy
+{
+    //! \brief The time is lost: each turn simulates one turn length. The game slows down when the
+    //! server or a client is late
+    skip,
+    //! \brief The time is simulated by the next turn that runs (up to the max catch up turns). The game time
+    //! stays in sync with the real time when a client is briefly late
+    catchUp
+};
+
+/*! \brief Fixed timestep turn scheduler for the server.
+ *
+ * The turns are due at fixed times (start time + n * turn length) whatever the time spent waiting for
+ * the sockets or simulating. The server waits for the sockets until the next turn is due (see getWaitTimeMs),
+ * checks if it is due with isTurnDue then either runs it (beginTurn) or skips it (skipTurn) if a client did not
+ * acknowledge the previous turn.
+ * The time spent waiting for the sockets, simulating and flushing the notifications is measured separately.
+ */
+class TurnScheduler
+{
+public:
+    TurnScheduler(double turnLengthMs);
+
+    inline TurnSchedulerPolicy getPolicy() const
+    { return mPolicy; }
+
+    inline void setPolicy(TurnSchedulerPolicy policy)
+    { mPolicy = policy; }
+
+    //! \brief Max number of turns that can be caught up by a single turn with the catchUp policy
+    inline void setMaxCatchUpTurns(uint32_t maxCatchUpTurns)
+    { mMaxCatchUpTurns = maxCatchUpTurns; }
+
+    inline double getTurnLengthMs() const
+    { return mTurnLengthMs; }
+
+    //! \brief Sets the time of the first turn. The next turn will be due one turn length later
+    void start(double timeMs);
+
+    //! \brief Returns how long we can wait before the next turn is due
+    double getWaitTimeMs(double timeMs) const;
+
+    //! \brief Returns true if a turn is due at the given time. In this case, the next turn will be due at
+    //! the next time of the fixed schedule. If several turns were missed, they are counted as late turns
+    //! and their time will be given to the next turn with the catchUp policy
+    bool isTurnDue(double timeMs);
+
+    //! \brief Called when a turn is due but cannot be run
+    void skipTurn();
+
+    //! \brief Called when a due turn is run. Returns the game time in seconds it should simulate
+    double beginTurn();
+
+    void addIoWaitTime(double timeMs);
+    void addSimulationTime(double timeMs);
+    void addFlushTime(double timeMs);
+
+    inline uint64_t getNbTurns() const
+    { return mNbTurns; }
+
+    inline uint64_t getNbSkippedTurns() const
+    { return mNbSkippedTurns; }
+
+    inline uint64_t getNbLateTurns() const
+    { return mNbLateTurns; }
+
+    inline const TimingHistogram& getIoWaitTimes() const
+    { return mIoWaitTimes; }
+
+    inline const TimingHistogram& getSimulationTimes() const
+    { return mSimulationTimes; }
+
+    inline const TimingHistogram& getFlushTimes() const
+    { return mFlushTimes; }
+
+    //! \brief Returns the counters and histograms (one line each)
+    std::string getStatsString() const;
+
+    void clearStats();
+
+    static std::string toString(TurnSchedulerPolicy policy);
+
+    //! \brief Returns false if the given string is not a valid policy
+    static bool fromString(const std::string& str, TurnSchedulerPolicy& policy);
+
+private:
+    double mTurnLengthMs;
+    TurnSchedulerPolicy mPolicy;
+    uint32_t mMaxCatchUpTurns;
+
+    //! \brief Time when the next turn is due
+    double mNextTurnMs;
+
+    //! \brief Game time elapsed since the last turn that ran and not simulated yet
+    double mPendingTimeMs;
+
+    uint64_t mNbTurns;
+    uint64_t mNbSkippedTurns;
+    uint64_t mNbLateTurns;
+
+    TimingHistogram mIoWaitTimes;
+    TimingHistogram mSimulationTimes;
+    TimingHistogram mFlushTimes;
+};
+
+#endif // TURNSCHEDULER_H
@@ -589,16 +589,10 @@ void Room::restoreInitialEntityState()
         if(!p.first->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::refreshTiles, p.first->getPlayer());
         std::vector<Tile*>& tilesRefresh = p.second;
-        uint32_t nbTiles = tilesRefresh.size();
-        serverNotification->mPacket << nbTiles;
-        for(Tile* tile : tilesRefresh)
-        {
-            getGameMap()->tileToPacket(serverNotification->mPacket, tile);
-            tile->exportToPacketForUpdate(serverNotification->mPacket, p.first);
-        }
+        p.first->exportTilesToPacket(serverNotification->mPacket, tilesRefresh, false);
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
 }
@@ -701,7 +695,7 @@ void Room::fireRoomSound(Tile& tile, const std::string& soundFamily)
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playSpatialSound, seat->getPlayer());
         serverNotification->mPacket << sound << tile.getX() << tile.getY();
         ODServer::getSingleton().queueServerNotification(serverNotification);
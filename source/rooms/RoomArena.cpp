@@ -26,7 +26,7 @@
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
@@ -35,6 +35,9 @@ const std::string RoomArenaName = "Arena";
 const std::string RoomArenaNameDisplay = "Arena room";
 const RoomType RoomArena::mRoomType = RoomType::arena;
 
+const ConfigParam<int32_t> RoomArenaCostPerTile(ConfigParamFile::rooms, "ArenaCostPerTile");
+const ConfigParam<uint32_t> RoomArenaMaxTrainingLevel(ConfigParamFile::rooms, "ArenaMaxTrainingLevel");
+
 namespace
 {
 class RoomArenaFactory : public RoomFactory
@@ -49,7 +52,7 @@ class RoomArenaFactory : public RoomFactory
     { return RoomArenaNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("ArenaCostPerTile"); }
+    { return RoomArenaCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -137,7 +140,7 @@ bool RoomArena::hasOpenCreatureSpot(Creature* c)
         return false;
 
     // We allow using arena only if level is not too high
-    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32("ArenaMaxTrainingLevel"))
+    if (c->getLevel() >= RoomArenaMaxTrainingLevel.get())
         return false;
 
     return true;
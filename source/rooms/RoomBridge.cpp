@@ -281,6 +281,9 @@ void RoomBridge::setupRoom(const std::string& name, Seat* seat, const std::vecto
 
     for(Seat* s : getGameMap()->getSeats())
         updateFloodFillPathCreated(s, tiles);
+
+    for(Tile* tile : tiles)
+        getGameMap()->tilePassabilityChanged(*tile);
 }
 
 void RoomBridge::restoreInitialEntityState()
@@ -289,6 +292,9 @@ void RoomBridge::restoreInitialEntityState()
 
     for(Seat* s : getGameMap()->getSeats())
         updateFloodFillPathCreated(s, getCoveredTiles());
+
+    for(Tile* tile : getCoveredTiles())
+        getGameMap()->tilePassabilityChanged(*tile);
 }
 
 void RoomBridge::exportToStream(std::ostream& os) const
@@ -333,6 +339,8 @@ bool RoomBridge::removeCoveredTile(Tile* t)
     for(Seat* seat : getGameMap()->getSeats())
         updateFloodFillTileRemoved(seat, t);
 
+    getGameMap()->tilePassabilityChanged(*t);
+
     return true;
 }
 
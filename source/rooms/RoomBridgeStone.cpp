@@ -24,13 +24,15 @@
 #include "modes/InputManager.h"
 #include "network/ODPacket.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string RoomBridgeStoneName = "StoneBridge";
 const std::string RoomBridgeStoneNameDisplay = "Stone Bridge room";
 const RoomType RoomBridgeStone::mRoomType = RoomType::bridgeStone;
+
+const ConfigParam<int32_t> RoomStoneBridgeCostPerTile(ConfigParamFile::rooms, "StoneBridgeCostPerTile");
 static const std::vector<TileVisual> allowedTilesVisual = {TileVisual::waterGround, TileVisual::lavaGround};
 
 namespace
@@ -47,7 +49,7 @@ class RoomBridgeStoneFactory : public BridgeRoomFactory
     { return RoomBridgeStoneNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("StoneBridgeCostPerTile"); }
+    { return RoomStoneBridgeCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
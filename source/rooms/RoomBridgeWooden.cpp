@@ -24,13 +24,15 @@
 #include "modes/InputManager.h"
 #include "network/ODPacket.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string RoomBridgeWoodenName = "WoodenBridge";
 const std::string RoomBridgeWoodenNameDisplay = "Wooden Bridge room";
 const RoomType RoomBridgeWooden::mRoomType = RoomType::bridgeWooden;
+
+const ConfigParam<int32_t> RoomWoodenBridgeCostPerTile(ConfigParamFile::rooms, "WoodenBridgeCostPerTile");
 static const std::vector<TileVisual> allowedTilesVisual = {TileVisual::waterGround};
 
 namespace
@@ -47,7 +49,7 @@ class RoomBridgeWoodenFactory : public BridgeRoomFactory
     { return RoomBridgeWoodenNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("WoodenBridgeCostPerTile"); }
+    { return RoomWoodenBridgeCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
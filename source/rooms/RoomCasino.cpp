@@ -30,7 +30,7 @@
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -40,6 +40,13 @@ const std::string RoomCasinoName = "Casino";
 const std::string RoomCasinoNameDisplay = "Casino room";
 const RoomType RoomCasino::mRoomType = RoomType::casino;
 
+const ConfigParam<int32_t> RoomCasinoBet(ConfigParamFile::rooms, "CasinoBet");
+const ConfigParam<uint32_t> RoomCasinoCooldownWorkMax(ConfigParamFile::rooms, "CasinoCooldownWorkMax");
+const ConfigParam<uint32_t> RoomCasinoCooldownWorkMin(ConfigParamFile::rooms, "CasinoCooldownWorkMin");
+const ConfigParam<int32_t> RoomCasinoCostPerTile(ConfigParamFile::rooms, "CasinoCostPerTile");
+const ConfigParam<double> RoomCasinoFee(ConfigParamFile::rooms, "CasinoFee");
+const ConfigParam<double> RoomCasinoWakefulnessPerWork(ConfigParamFile::rooms, "CasinoWakefulnessPerWork");
+
 namespace
 {
 class RoomCasinoFactory : public RoomFactory
@@ -54,7 +61,7 @@ class RoomCasinoFactory : public RoomFactory
     { return RoomCasinoNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("CasinoCostPerTile"); }
+    { return RoomCasinoCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -375,11 +382,11 @@ void RoomCasino::doUpkeep()
         // TODO: we could use the wall active spots to change feePercent/bets
 
         // We set anim for both creatures
-        uint32_t cooldown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMin"),
-            ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMax"));
-        double feePercent = std::min(ConfigManager::getSingleton().getRoomConfigDouble("CasinoFee"), 1.0);
-        double wakefullness = ConfigManager::getSingleton().getRoomConfigDouble("CasinoWakefulnessPerWork");
-        int32_t creatureBet = ConfigManager::getSingleton().getRoomConfigInt32("CasinoBet");
+        uint32_t cooldown = Random::Uint(RoomCasinoCooldownWorkMin.get(),
+            RoomCasinoCooldownWorkMax.get());
+        double feePercent = std::min(RoomCasinoFee.get(), 1.0);
+        double wakefullness = RoomCasinoWakefulnessPerWork.get();
+        int32_t creatureBet = RoomCasinoBet.get();
         creatureBet = std::min(creatureBet, p.second.mCreature1.mCreature->getGoldCarried());
         creatureBet = std::min(creatureBet, p.second.mCreature2.mCreature->getGoldCarried());
         int32_t totalBet = 0;
@@ -29,6 +29,7 @@
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
 #include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
@@ -36,6 +37,12 @@ const std::string RoomCryptName = "Crypt";
 const std::string RoomCryptNameDisplay = "Crypt room";
 const RoomType RoomCrypt::mRoomType = RoomType::crypt;
 
+const ConfigParam<double> RoomCryptBonusWallActiveSpot(ConfigParamFile::rooms, "CryptBonusWallActiveSpot");
+const ConfigParam<int32_t> RoomCryptCostPerTile(ConfigParamFile::rooms, "CryptCostPerTile");
+const ConfigParam<int32_t> RoomCryptPointsForSpawn(ConfigParamFile::rooms, "CryptPointsForSpawn");
+const ConfigParam<int32_t> RoomCryptRotNbTurns(ConfigParamFile::rooms, "CryptRotNbTurns");
+const ConfigParam<std::string> RoomCryptSpawnClass(ConfigParamFile::rooms, "CryptSpawnClass");
+
 namespace
 {
 class RoomCryptFactory : public RoomFactory
@@ -50,7 +57,7 @@ class RoomCryptFactory : public RoomFactory
     { return RoomCryptNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("CryptCostPerTile"); }
+    { return RoomCryptCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -219,11 +226,11 @@ void RoomCrypt::doUpkeep()
         ConfigManager& configManager = ConfigManager::getSingleton();
 
         ++p.second.second;
-        if(p.second.second < configManager.getRoomConfigInt32("CryptRotNbTurns"))
+        if(p.second.second < RoomCryptRotNbTurns.get())
             continue;
 
         // We add the rotten creature points to the room and release the active spot
-        double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * configManager.getRoomConfigDouble("CryptBonusWallActiveSpot");
+        double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * RoomCryptBonusWallActiveSpot.get();
         Creature* c = p.second.first;
         mRottenPoints += static_cast<int32_t>(c->getMaxHp() * coef);
 
@@ -234,13 +241,13 @@ void RoomCrypt::doUpkeep()
 
         int32_t maxCreatures = configManager.getMaxCreaturesPerSeatAbsolute();
         int32_t numCreatures = getGameMap()->getCreaturesBySeat(getSeat()).size();
-        int32_t cryptPointsForSpawn = configManager.getRoomConfigInt32("CryptPointsForSpawn");
+        int32_t cryptPointsForSpawn = RoomCryptPointsForSpawn.get();
         if((numCreatures < maxCreatures) &&
            (mRottenPoints >= cryptPointsForSpawn))
         {
             Tile* tileSpawn = p.first;
             mRottenPoints -= cryptPointsForSpawn;
-            const std::string& className = configManager.getRoomConfigString("CryptSpawnClass");
+            const std::string& className = RoomCryptSpawnClass.get();
             const CreatureDefinition* classToSpawn = getGameMap()->getClassDescription(className);
             if(classToSpawn == nullptr)
             {
@@ -252,7 +259,7 @@ void RoomCrypt::doUpkeep()
                getSeat()->getPlayer()->getIsHuman() &&
                !getSeat()->getPlayer()->getHasLost())
             {
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::chatServer, getSeat()->getPlayer());
                 std::string msg = "A creature has raised in your crypt thanks to the blood of the creatures rotting there";
                 serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
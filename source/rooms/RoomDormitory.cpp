@@ -27,7 +27,7 @@
 #include "game/Player.h"
 #include "gamemap/GameMap.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -36,6 +36,8 @@ const std::string RoomDormitoryName = "Dormitory";
 const std::string RoomDormitoryNameDisplay = "Dormitory room";
 const RoomType RoomDormitory::mRoomType = RoomType::dormitory;
 
+const ConfigParam<int32_t> RoomDormitoryCostPerTile(ConfigParamFile::rooms, "DormitoryCostPerTile");
+
 namespace
 {
 class RoomDormitoryFactory : public RoomFactory
@@ -50,7 +52,7 @@ class RoomDormitoryFactory : public RoomFactory
     { return RoomDormitoryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("DormitoryCostPerTile"); }
+    { return RoomDormitoryCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
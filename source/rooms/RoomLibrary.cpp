@@ -28,7 +28,7 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
@@ -37,6 +37,13 @@ const std::string RoomLibraryName = "Library";
 const std::string RoomLibraryNameDisplay = "Library room";
 const RoomType RoomLibrary::mRoomType = RoomType::library;
 
+const ConfigParam<uint32_t> RoomLibraryCooldownWorkMax(ConfigParamFile::rooms, "LibraryCooldownWorkMax");
+const ConfigParam<uint32_t> RoomLibraryCooldownWorkMin(ConfigParamFile::rooms, "LibraryCooldownWorkMin");
+const ConfigParam<int32_t> RoomLibraryCostPerTile(ConfigParamFile::rooms, "LibraryCostPerTile");
+const ConfigParam<double> RoomLibraryPointsPerWork(ConfigParamFile::rooms, "LibraryPointsPerWork");
+const ConfigParam<int32_t> RoomLibrarySkillPointsBook(ConfigParamFile::rooms, "LibrarySkillPointsBook");
+const ConfigParam<double> RoomLibraryWakefulnessPerWork(ConfigParamFile::rooms, "LibraryWakefulnessPerWork");
+
 namespace
 {
 class RoomLibraryFactory : public RoomFactory
@@ -51,7 +58,7 @@ class RoomLibraryFactory : public RoomFactory
     { return RoomLibraryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("LibraryCostPerTile"); }
+    { return RoomLibraryCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -324,7 +331,7 @@ void RoomLibrary::doUpkeep()
 
 bool RoomLibrary::useRoom(Creature& creature, bool forced)
 {
-    int32_t skillEntityPoints = ConfigManager::getSingleton().getRoomConfigInt32("LibrarySkillPointsBook");
+    int32_t skillEntityPoints = RoomLibrarySkillPointsBook.get();
     auto it = mCreaturesSpots.find(&creature);
     if(it == mCreaturesSpots.end())
     {
@@ -374,10 +381,10 @@ bool RoomLibrary::useRoom(Creature& creature, bool forced)
     OD_ASSERT_TRUE_MSG(creatureRoomAffinity.getRoomType() == getType(), "name=" + getName() + ", creature=" + creature.getName()
         + ", creatureRoomAffinityType=" + Helper::toString(static_cast<int>(creatureRoomAffinity.getRoomType())));
 
-    int32_t pointsEarned = static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("LibraryPointsPerWork"));
-    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("LibraryWakefulnessPerWork"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("LibraryCooldownWorkMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("LibraryCooldownWorkMax")));
+    int32_t pointsEarned = static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * RoomLibraryPointsPerWork.get());
+    creature.jobDone(RoomLibraryWakefulnessPerWork.get());
+    creature.setJobCooldown(Random::Uint(RoomLibraryCooldownWorkMin.get(),
+        RoomLibraryCooldownWorkMax.get()));
 
     // We check if we have enough points to create a skill entity
     mSkillPoints += pointsEarned;
@@ -211,16 +211,12 @@ bool RoomFactory::buildRoomDefault(GameMap* gameMap, Room* room, Seat* seat, con
 
         for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
         {
-            uint32_t nbTiles = p.second.size();
             ServerNotification serverNotification(
                 ServerNotificationType::refreshTiles, p.first->getPlayer());
-            serverNotification.mPacket << nbTiles;
             for(Tile* tile : p.second)
-            {
-                gameMap->tileToPacket(serverNotification.mPacket, tile);
                 p.first->updateTileStateForSeat(tile, false);
-                tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-            }
+
+            p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
             ODServer::getSingleton().sendAsyncMsg(serverNotification);
         }
     }
@@ -606,16 +602,12 @@ void RoomManager::sellRoomTiles(GameMap* gameMap, Player* player, ODPacket& pack
 
     for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
     {
-        uint32_t nbTiles = p.second.size();
         ServerNotification serverNotification(
             ServerNotificationType::refreshTiles, p.first->getPlayer());
-        serverNotification.mPacket << nbTiles;
         for(Tile* tile : p.second)
-        {
-            gameMap->tileToPacket(serverNotification.mPacket, tile);
             p.first->updateTileStateForSeat(tile, false);
-            tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-        }
+
+        p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
         ODServer::getSingleton().sendAsyncMsg(serverNotification);
     }
 
@@ -732,16 +724,12 @@ void RoomManager::sellRoomTilesEditor(GameMap* gameMap, ODPacket& packet)
 
     for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
     {
-        uint32_t nbTiles = p.second.size();
         ServerNotification serverNotification(
             ServerNotificationType::refreshTiles, p.first->getPlayer());
-        serverNotification.mPacket << nbTiles;
         for(Tile* tile : p.second)
-        {
-            gameMap->tileToPacket(serverNotification.mPacket, tile);
             p.first->updateTileStateForSeat(tile, false);
-            tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-        }
+
+        p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
         ODServer::getSingleton().sendAsyncMsg(serverNotification);
     }
 
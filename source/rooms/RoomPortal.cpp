@@ -29,6 +29,7 @@
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
 #include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
@@ -39,6 +40,9 @@ const std::string RoomPortalName = "Portal";
 const std::string RoomPortalNameDisplay = "Portal room";
 const RoomType RoomPortal::mRoomType = RoomType::portal;
 
+const ConfigParam<uint32_t> RoomPortalCooldownSpawnMax(ConfigParamFile::rooms, "PortalCooldownSpawnMax");
+const ConfigParam<uint32_t> RoomPortalCooldownSpawnMin(ConfigParamFile::rooms, "PortalCooldownSpawnMin");
+
 namespace
 {
 class RoomPortalFactory : public RoomFactory
@@ -216,8 +220,8 @@ void RoomPortal::doUpkeep()
         --mSpawnCreatureCountdown;
         return;
     }
-    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMax"));
+    mSpawnCreatureCountdown = Random::Uint(RoomPortalCooldownSpawnMin.get(),
+        RoomPortalCooldownSpawnMax.get());
 
     if (mCoveredTiles.empty())
         return;
@@ -342,16 +346,12 @@ void RoomPortal::restoreInitialEntityState()
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        uint32_t nbTiles = tilesToNotify.size();
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::refreshTiles, seat->getPlayer());
-        serverNotification->mPacket << nbTiles;
         for(Tile* tile : tilesToNotify)
-        {
-            getGameMap()->tileToPacket(serverNotification->mPacket, tile);
             seat->updateTileStateForSeat(tile, true);
-            tile->exportToPacketForUpdate(serverNotification->mPacket, seat, true);
-        }
+
+        seat->exportTilesToPacket(serverNotification->mPacket, tilesToNotify, true);
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
 
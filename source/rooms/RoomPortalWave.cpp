@@ -401,7 +401,7 @@ void RoomPortalWave::handleAttack()
                tileSeat->getPlayer()->getIsHuman() &&
                !tileSeat->getPlayer()->getHasLost())
             {
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::chatServer, tileSeat->getPlayer());
 
                 std::string msg = "Your evil presence has soiled this holy land for too long. You shall be crushed by our blessed swords !";
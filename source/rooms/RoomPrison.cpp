@@ -29,7 +29,7 @@
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -39,6 +39,10 @@ const std::string RoomPrisonName = "Prison";
 const std::string RoomPrisonNameDisplay = "Prison room";
 const RoomType RoomPrison::mRoomType = RoomType::prison;
 
+const ConfigParam<int32_t> RoomPrisonCostPerTile(ConfigParamFile::rooms, "PrisonCostPerTile");
+const ConfigParam<double> RoomPrisonDamagePerTurn(ConfigParamFile::rooms, "PrisonDamagePerTurn");
+const ConfigParam<std::string> RoomPrisonSpawnClass(ConfigParamFile::rooms, "PrisonSpawnClass");
+
 namespace
 {
 class RoomPrisonFactory : public RoomFactory
@@ -53,7 +57,7 @@ class RoomPrisonFactory : public RoomFactory
     { return RoomPrisonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("PrisonCostPerTile"); }
+    { return RoomPrisonCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -210,7 +214,7 @@ void RoomPrison::doUpkeep()
 
             ++nbCreatures;
             // We slightly damage the prisoner
-            double damage = ConfigManager::getSingleton().getRoomConfigDouble("PrisonDamagePerTurn");
+            double damage = RoomPrisonDamagePerTurn.get();
             creature->takeDamage(this, damage, 0.0, 0.0, 0.0, creatureTile, false);
             creature->increaseTurnsPrison();
 
@@ -224,7 +228,7 @@ void RoomPrison::doUpkeep()
                getSeat()->getPlayer()->getIsHuman() &&
                !getSeat()->getPlayer()->getHasLost())
             {
-                ServerNotification *serverNotification = new ServerNotification(
+                ServerNotification *serverNotification = ServerNotification::acquire(
                     ServerNotificationType::chatServer, getSeat()->getPlayer());
                 std::string msg = "A creature died starving in your prison";
                 serverNotification->mPacket << msg << EventShortNoticeType::aboutCreatures;
@@ -235,7 +239,7 @@ void RoomPrison::doUpkeep()
             creature->removeFromGameMap();
             creature->deleteYourself();
 
-            const std::string& className = ConfigManager::getSingleton().getRoomConfigString("PrisonSpawnClass");
+            const std::string& className = RoomPrisonSpawnClass.get();
             const CreatureDefinition* classToSpawn = getGameMap()->getClassDescription(className);
             if(classToSpawn == nullptr)
             {
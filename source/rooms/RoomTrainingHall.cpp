@@ -24,7 +24,7 @@
 #include "game/Player.h"
 #include "gamemap/GameMap.h"
 #include "rooms/RoomManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
@@ -33,6 +33,14 @@ const std::string RoomTrainingHallName = "TrainingHall";
 const std::string RoomTrainingHallNameDisplay = "Training hall room";
 const RoomType RoomTrainingHall::mRoomType = RoomType::trainingHall;
 
+const ConfigParam<double> RoomTrainHallBonusWallActiveSpot(ConfigParamFile::rooms, "TrainHallBonusWallActiveSpot");
+const ConfigParam<uint32_t> RoomTrainHallCooldownHitMax(ConfigParamFile::rooms, "TrainHallCooldownHitMax");
+const ConfigParam<uint32_t> RoomTrainHallCooldownHitMin(ConfigParamFile::rooms, "TrainHallCooldownHitMin");
+const ConfigParam<int32_t> RoomTrainHallCostPerTile(ConfigParamFile::rooms, "TrainHallCostPerTile");
+const ConfigParam<uint32_t> RoomTrainHallMaxTrainingLevel(ConfigParamFile::rooms, "TrainHallMaxTrainingLevel");
+const ConfigParam<double> RoomTrainHallWakefulnessPerAttack(ConfigParamFile::rooms, "TrainHallWakefulnessPerAttack");
+const ConfigParam<double> RoomTrainHallXpPerAttack(ConfigParamFile::rooms, "TrainHallXpPerAttack");
+
 namespace
 {
 class RoomTrainingHallFactory : public RoomFactory
@@ -47,7 +55,7 @@ class RoomTrainingHallFactory : public RoomFactory
     { return RoomTrainingHallNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("TrainHallCostPerTile"); }
+    { return RoomTrainHallCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -266,7 +274,7 @@ void RoomTrainingHall::refreshCreaturesDummies()
 
 bool RoomTrainingHall::hasOpenCreatureSpot(Creature* c)
 {
-    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallMaxTrainingLevel"))
+    if (c->getLevel() >= RoomTrainHallMaxTrainingLevel.get())
         return false;
 
     // We accept all creatures as soon as there are free dummies
@@ -389,14 +397,14 @@ bool RoomTrainingHall::useRoom(Creature& creature, bool forced)
         + ", creatureRoomAffinityType=" + Helper::toString(static_cast<int>(creatureRoomAffinity.getRoomType())));
 
     // We add a bonus per wall active spots
-    double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * ConfigManager::getSingleton().getRoomConfigDouble("TrainHallBonusWallActiveSpot");
-    double expReceived = creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("TrainHallXpPerAttack");
+    double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * RoomTrainHallBonusWallActiveSpot.get();
+    double expReceived = creatureRoomAffinity.getEfficiency() * RoomTrainHallXpPerAttack.get();
     expReceived *= coef;
 
     creature.receiveExp(expReceived);
-    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("TrainHallWakefulnessPerAttack"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMax")));
+    creature.jobDone(RoomTrainHallWakefulnessPerAttack.get());
+    creature.setJobCooldown(Random::Uint(RoomTrainHallCooldownHitMin.get(),
+        RoomTrainHallCooldownHitMax.get()));
 
     return false;
 }
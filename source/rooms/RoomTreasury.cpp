@@ -31,7 +31,7 @@
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
 #include "sound/SoundEffectsManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
@@ -42,6 +42,8 @@ const std::string RoomTreasuryName = "Treasury";
 const std::string RoomTreasuryNameDisplay = "Treasury room";
 const RoomType RoomTreasury::mRoomType = RoomType::treasury;
 
+const ConfigParam<int32_t> RoomTreasuryCostPerTile(ConfigParamFile::rooms, "TreasuryCostPerTile");
+
 namespace
 {
 class RoomTreasuryFactory : public RoomFactory
@@ -56,7 +58,7 @@ class RoomTreasuryFactory : public RoomFactory
     { return RoomTreasuryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("TreasuryCostPerTile"); }
+    { return RoomTreasuryCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -165,16 +167,12 @@ class RoomTreasuryFactory : public RoomFactory
 
             for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
             {
-                uint32_t nbTiles = p.second.size();
                 ServerNotification serverNotification(
                     ServerNotificationType::refreshTiles, p.first->getPlayer());
-                serverNotification.mPacket << nbTiles;
                 for(Tile* tile : p.second)
-                {
-                    gameMap->tileToPacket(serverNotification.mPacket, tile);
                     p.first->updateTileStateForSeat(tile, false);
-                    tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-                }
+
+                p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
                 ODServer::getSingleton().sendAsyncMsg(serverNotification);
             }
         }
@@ -237,15 +235,42 @@ static const int maxGoldinTile = 1000;
 
 RoomTreasury::RoomTreasury(GameMap* gameMap) :
     Room(gameMap),
-    mGoldChanged(false)
+    mGoldChanged(false),
+    mIsInGameMap(false),
+    mCountedSeat(nullptr),
+    mCountedGold(0),
+    mCountedGoldMax(0)
 {
     setMeshName("Treasury");
 }
 
+void RoomTreasury::addToGameMap()
+{
+    Room::addToGameMap();
+    mIsInGameMap = true;
+    updateSeatGold();
+}
+
+void RoomTreasury::removeFromGameMap()
+{
+    Room::removeFromGameMap();
+    mIsInGameMap = false;
+    updateSeatGold();
+}
+
+void RoomTreasury::seatChanged(Seat* oldSeat)
+{
+    Room::seatChanged(oldSeat);
+    updateSeatGold();
+}
+
 void RoomTreasury::doUpkeep()
 {
     Room::doUpkeep();
 
+    // The covered tiles may have changed since the last upkeep (room absorbed or tiles repaired)
+    updateSeatGold();
+
     if (mCoveredTiles.empty())
         return;
 
@@ -287,7 +312,9 @@ bool RoomTreasury::removeCoveredTile(Tile* t)
 
     roomTreasuryTileData->mMeshOfTile.clear();
     roomTreasuryTileData->mGoldInTile = 0;
-    return Room::removeCoveredTile(t);
+    bool isRemoved = Room::removeCoveredTile(t);
+    updateSeatGold();
+    return isRemoved;
 }
 
 int RoomTreasury::getTotalGoldStorage() const
@@ -344,6 +371,7 @@ int RoomTreasury::depositGold(int gold, Tile *tile)
         return wasDeposited;
 
     mGoldChanged = true;
+    updateSeatGold();
 
     // Tells the client to play a deposit gold sound. For now, we only send it to the players
     // with vision on tile
@@ -377,9 +405,40 @@ int RoomTreasury::withdrawGold(int gold)
         }
     }
 
+    updateSeatGold();
     return withdrawlAmount;
 }
 
+void RoomTreasury::updateSeatGold()
+{
+    // In editor mode, the seat gold is the starting gold saved with the level
+    GameMap* gameMap = getGameMap();
+    if(!gameMap->isServerGameMap() || gameMap->isInEditorMode())
+        return;
+
+    Seat* seat = mIsInGameMap ? getSeat() : nullptr;
+    int gold = 0;
+    int goldMax = 0;
+    if(seat != nullptr)
+    {
+        gold = getTotalGoldStored();
+        goldMax = getTotalGoldStorage();
+    }
+
+    if((seat == mCountedSeat) && (gold == mCountedGold) && (goldMax == mCountedGoldMax))
+        return;
+
+    if(mCountedSeat != nullptr)
+        mCountedSeat->addTreasuryGold(-mCountedGold, -mCountedGoldMax);
+
+    if(seat != nullptr)
+        seat->addTreasuryGold(gold, goldMax);
+
+    mCountedSeat = seat;
+    mCountedGold = gold;
+    mCountedGoldMax = goldMax;
+}
+
 void RoomTreasury::updateMeshesForTile(Tile* tile, RoomTreasuryTileData* roomTreasuryTileData)
 {
     int gold = roomTreasuryTileData->mGoldInTile;
@@ -56,6 +56,8 @@ public:
 
     // Functions overriding virtual functions in the Room base class.
     bool removeCoveredTile(Tile* t);
+    void addToGameMap() override;
+    void removeFromGameMap() override;
 
     // Functions specific to this class.
     virtual void doUpkeep();
@@ -81,9 +83,23 @@ protected:
     void notifyActiveSpotRemoved(ActiveSpotPlace place, Tile* tile)
     {}
 
+    void seatChanged(Seat* oldSeat) override;
+
 private:
     void updateMeshesForTile(Tile* tile, RoomTreasuryTileData* roomTreasuryTileData);
+
+    //! \brief Gives the seat the difference between the gold stored in the room and the one it
+    //! was last given. The seats do not have to sum the gold of every room each turn
+    void updateSeatGold();
+
     bool mGoldChanged;
+
+    //! \brief True between addToGameMap and removeFromGameMap. Only the rooms in the gamemap are counted
+    bool mIsInGameMap;
+    //! \brief Seat the gold below has been added to (or nullptr)
+    Seat* mCountedSeat;
+    int mCountedGold;
+    int mCountedGoldMax;
 };
 
 #endif // ROOMTREASURY_H
@@ -30,7 +30,7 @@
 #include "traps/Trap.h"
 #include "traps/TrapManager.h"
 #include "traps/TrapType.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
@@ -39,6 +39,12 @@ const std::string RoomWorkshopName = "Workshop";
 const std::string RoomWorkshopNameDisplay = "Workshop room";
 const RoomType RoomWorkshop::mRoomType = RoomType::workshop;
 
+const ConfigParam<uint32_t> RoomWorkshopCooldownWorkMax(ConfigParamFile::rooms, "WorkshopCooldownWorkMax");
+const ConfigParam<uint32_t> RoomWorkshopCooldownWorkMin(ConfigParamFile::rooms, "WorkshopCooldownWorkMin");
+const ConfigParam<int32_t> RoomWorkshopCostPerTile(ConfigParamFile::rooms, "WorkshopCostPerTile");
+const ConfigParam<double> RoomWorkshopPointsPerWork(ConfigParamFile::rooms, "WorkshopPointsPerWork");
+const ConfigParam<double> RoomWorkshopWakefulnessPerWork(ConfigParamFile::rooms, "WorkshopWakefulnessPerWork");
+
 namespace
 {
 class RoomWorkshopFactory : public RoomFactory
@@ -53,7 +59,7 @@ class RoomWorkshopFactory : public RoomFactory
     { return RoomWorkshopNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("WorkshopCostPerTile"); }
+    { return RoomWorkshopCostPerTile.get(); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -471,10 +477,10 @@ bool RoomWorkshop::useRoom(Creature& creature, bool forced)
     OD_ASSERT_TRUE_MSG(creatureRoomAffinity.getRoomType() == getType(), "name=" + getName() + ", creature=" + creature.getName()
         + ", creatureRoomAffinityType=" + Helper::toString(static_cast<int>(creatureRoomAffinity.getRoomType())));
 
-    mPoints += static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("WorkshopPointsPerWork"));
-    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("WorkshopWakefulnessPerWork"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("WorkshopCooldownWorkMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("WorkshopCooldownWorkMax")));
+    mPoints += static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * RoomWorkshopPointsPerWork.get());
+    creature.jobDone(RoomWorkshopWakefulnessPerWork.get());
+    creature.setJobCooldown(Random::Uint(RoomWorkshopCooldownWorkMin.get(),
+        RoomWorkshopCooldownWorkMax.get()));
 
     return false;
 }
@@ -121,6 +121,7 @@ void Spell::notifySeatsWithVision(const std::vector<Seat*>& seats)
 
         // we remove vision
         it = mSeatsWithVisionNotified.erase(it);
+        getGameMap()->countEntityVisionEvent();
 
         if(seat->getPlayer() == nullptr)
             continue;
@@ -138,6 +139,7 @@ void Spell::notifySeatsWithVision(const std::vector<Seat*>& seats)
             continue;
 
         mSeatsWithVisionNotified.push_back(seat);
+        getGameMap()->countEntityVisionEvent();
 
         if(seat->getPlayer() == nullptr)
             continue;
@@ -157,6 +159,7 @@ void Spell::notifySeatsWithVision(const std::vector<Seat*>& seats)
             continue;
 
         mSeatsWithVisionNotified.push_back(seat);
+        getGameMap()->countEntityVisionEvent();
 
         if(seat->getPlayer() == nullptr)
             continue;
@@ -193,7 +196,7 @@ void Spell::fireSpellSound(Tile& tile, const std::string& soundFamily)
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playSpatialSound, seat->getPlayer());
         serverNotification->mPacket << sound << tile.getX() << tile.getY();
         ODServer::getSingleton().queueServerNotification(serverNotification);
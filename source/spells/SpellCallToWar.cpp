@@ -26,15 +26,18 @@
 #include "modes/InputManager.h"
 #include "network/ODClient.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCallToWarName = "callToWar";
 const std::string SpellCallToWarNameDisplay = "Call to war";
-const std::string SpellCallToWarCooldownKey = "CallToWarCooldown";
+const ConfigParam<uint32_t> SpellCallToWarCooldown(ConfigParamFile::spells, "CallToWarCooldown");
 const SpellType SpellCallToWar::mSpellType = SpellType::callToWar;
 
+const ConfigParam<int32_t> SpellCallToWarNbTurnsMax(ConfigParamFile::spells, "CallToWarNbTurnsMax");
+const ConfigParam<int32_t> SpellCallToWarPrice(ConfigParamFile::spells, "CallToWarPrice");
+
 namespace
 {
 class SpellCallToWarFactory : public SpellFactory
@@ -45,8 +48,8 @@ class SpellCallToWarFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCallToWarName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCallToWarCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCallToWarCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCallToWarNameDisplay; }
@@ -70,7 +73,7 @@ static SpellRegister reg(new SpellCallToWarFactory);
 
 SpellCallToWar::SpellCallToWar(GameMap* gameMap) :
     Spell(gameMap, SpellManager::getSpellNameFromSpellType(SpellType::callToWar), "WarBanner", 0.0,
-        ConfigManager::getSingleton().getSpellConfigInt32("CallToWarNbTurnsMax"))
+        SpellCallToWarNbTurnsMax.get())
 {
     mPrevAnimationState = "Loop";
     mPrevAnimationStateLoop = true;
@@ -110,7 +113,7 @@ void SpellCallToWar::checkSpellCast(GameMap* gameMap, const InputManager& inputM
         return;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("CallToWarPrice");
+    int32_t price = SpellCallToWarPrice.get();
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
         if(playerMana < price)
@@ -153,7 +156,7 @@ bool SpellCallToWar::castSpell(GameMap* gameMap, Player* player, ODPacket& packe
         return false;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32("CallToWarPrice");
+    int32_t manaCost = SpellCallToWarPrice.get();
     if(playerMana < manaCost)
         return false;
 
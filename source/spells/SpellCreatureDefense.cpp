@@ -31,15 +31,19 @@
 #include "sound/SoundEffectsManager.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureDefenseName = "creatureDefense";
 const std::string SpellCreatureDefenseNameDisplay = "Creature defense";
-const std::string SpellCreatureDefenseCooldownKey = "CreatureDefenseCooldown";
+const ConfigParam<uint32_t> SpellCreatureDefenseCooldown(ConfigParamFile::spells, "CreatureDefenseCooldown");
 const SpellType SpellCreatureDefense::mSpellType = SpellType::creatureDefense;
 
+const ConfigParam<uint32_t> SpellCreatureDefenseDuration(ConfigParamFile::spells, "CreatureDefenseDuration");
+const ConfigParam<int32_t> SpellCreatureDefensePrice(ConfigParamFile::spells, "CreatureDefensePrice");
+const ConfigParam<double> SpellCreatureDefenseValue(ConfigParamFile::spells, "CreatureDefenseValue");
+
 namespace
 {
 class SpellCreatureDefenseFactory : public SpellFactory
@@ -50,8 +54,8 @@ class SpellCreatureDefenseFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureDefenseName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureDefenseCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureDefenseCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureDefenseNameDisplay; }
@@ -76,7 +80,7 @@ static SpellRegister reg(new SpellCreatureDefenseFactory);
 void SpellCreatureDefense::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureDefensePrice");
+    int32_t pricePerTarget = SpellCreatureDefensePrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -194,13 +198,13 @@ bool SpellCreatureDefense::castSpell(GameMap* gameMap, Player* player, ODPacket&
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureDefensePrice");
+    int32_t pricePerTarget = SpellCreatureDefensePrice.get();
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureDefenseDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureDefenseValue");
+    uint32_t duration = SpellCreatureDefenseDuration.get();
+    double value = SpellCreatureDefenseValue.get();
     CreatureEffectDefense* effect = new CreatureEffectDefense(duration, value, 0.0, 0.0, "SpellCreatureDefense");
     creature->addCreatureEffect(effect);
 
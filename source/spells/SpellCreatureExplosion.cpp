@@ -29,15 +29,19 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureExplosionName = "creatureExplosion";
 const std::string SpellCreatureExplosionNameDisplay = "Creature explosion";
-const std::string SpellCreatureExplosionCooldownKey = "CreatureExplosionCooldown";
+const ConfigParam<uint32_t> SpellCreatureExplosionCooldown(ConfigParamFile::spells, "CreatureExplosionCooldown");
 const SpellType SpellCreatureExplosion::mSpellType = SpellType::creatureExplosion;
 
+const ConfigParam<uint32_t> SpellCreatureExplosionDuration(ConfigParamFile::spells, "CreatureExplosionDuration");
+const ConfigParam<int32_t> SpellCreatureExplosionPrice(ConfigParamFile::spells, "CreatureExplosionPrice");
+const ConfigParam<double> SpellCreatureExplosionValue(ConfigParamFile::spells, "CreatureExplosionValue");
+
 namespace
 {
 class SpellCreatureExplosionFactory : public SpellFactory
@@ -48,8 +52,8 @@ class SpellCreatureExplosionFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureExplosionName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureExplosionCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureExplosionCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureExplosionNameDisplay; }
@@ -75,7 +79,7 @@ void SpellCreatureExplosion::checkSpellCast(GameMap* gameMap, const InputManager
 {
     Player* player = gameMap->getLocalPlayer();
     int32_t priceTotal = 0;
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureExplosionPrice");
+    int32_t pricePerTarget = SpellCreatureExplosionPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -205,7 +209,7 @@ bool SpellCreatureExplosion::castSpell(GameMap* gameMap, Player* player, ODPacke
     if(creatures.empty())
         return false;
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureExplosionPrice");
+    int32_t pricePerTarget = SpellCreatureExplosionPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     uint32_t nbTargets = std::min(static_cast<uint32_t>(playerMana / pricePerTarget), static_cast<uint32_t>(creatures.size()));
     int32_t priceTotal = nbTargets * pricePerTarget;
@@ -216,8 +220,8 @@ bool SpellCreatureExplosion::castSpell(GameMap* gameMap, Player* player, ODPacke
     if(!player->getSeat()->takeMana(priceTotal))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureExplosionDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureExplosionValue");
+    uint32_t duration = SpellCreatureExplosionDuration.get();
+    double value = SpellCreatureExplosionValue.get();
     for(Creature* creature : creatures)
     {
         CreatureEffectExplosion* effect = new CreatureEffectExplosion(duration, value, "SpellCreatureExplosion");
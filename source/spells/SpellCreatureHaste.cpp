@@ -30,15 +30,19 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureHasteName = "creatureHaste";
 const std::string SpellCreatureHasteNameDisplay = "Creature haste";
-const std::string SpellCreatureHasteCooldownKey = "CreatureHasteCooldown";
+const ConfigParam<uint32_t> SpellCreatureHasteCooldown(ConfigParamFile::spells, "CreatureHasteCooldown");
 const SpellType SpellCreatureHaste::mSpellType = SpellType::creatureHaste;
 
+const ConfigParam<uint32_t> SpellCreatureHasteDuration(ConfigParamFile::spells, "CreatureHasteDuration");
+const ConfigParam<int32_t> SpellCreatureHastePrice(ConfigParamFile::spells, "CreatureHastePrice");
+const ConfigParam<double> SpellCreatureHasteValue(ConfigParamFile::spells, "CreatureHasteValue");
+
 namespace
 {
 class SpellCreatureHasteFactory : public SpellFactory
@@ -49,8 +53,8 @@ class SpellCreatureHasteFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureHasteName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureHasteCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureHasteCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureHasteNameDisplay; }
@@ -75,7 +79,7 @@ static SpellRegister reg(new SpellCreatureHasteFactory);
 void SpellCreatureHaste::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHastePrice");
+    int32_t pricePerTarget = SpellCreatureHastePrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +197,13 @@ bool SpellCreatureHaste::castSpell(GameMap* gameMap, Player* player, ODPacket& p
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHastePrice");
+    int32_t pricePerTarget = SpellCreatureHastePrice.get();
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureHasteDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureHasteValue");
+    uint32_t duration = SpellCreatureHasteDuration.get();
+    double value = SpellCreatureHasteValue.get();
     CreatureEffectSpeedChange* effect = new CreatureEffectSpeedChange(duration, value, "SpellCreatureHaste");
     creature->addCreatureEffect(effect);
 
@@ -30,15 +30,19 @@
 #include "sound/SoundEffectsManager.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureHealName = "creatureHeal";
 const std::string SpellCreatureHealNameDisplay = "Creature heal";
-const std::string SpellCreatureHealCooldownKey = "CreatureHealCooldown";
+const ConfigParam<uint32_t> SpellCreatureHealCooldown(ConfigParamFile::spells, "CreatureHealCooldown");
 const SpellType SpellCreatureHeal::mSpellType = SpellType::creatureHeal;
 
+const ConfigParam<uint32_t> SpellCreatureHealDuration(ConfigParamFile::spells, "CreatureHealDuration");
+const ConfigParam<int32_t> SpellCreatureHealPrice(ConfigParamFile::spells, "CreatureHealPrice");
+const ConfigParam<double> SpellCreatureHealValue(ConfigParamFile::spells, "CreatureHealValue");
+
 namespace
 {
 class SpellCreatureHealFactory : public SpellFactory
@@ -49,8 +53,8 @@ class SpellCreatureHealFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureHealName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureHealCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureHealCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureHealNameDisplay; }
@@ -76,7 +80,7 @@ void SpellCreatureHeal::checkSpellCast(GameMap* gameMap, const InputManager& inp
 {
     Player* player = gameMap->getLocalPlayer();
     int32_t priceTotal = 0;
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHealPrice");
+    int32_t pricePerTarget = SpellCreatureHealPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -233,7 +237,7 @@ bool SpellCreatureHeal::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
     if(creatures.empty())
         return false;
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHealPrice");
+    int32_t pricePerTarget = SpellCreatureHealPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     uint32_t nbTargets = std::min(static_cast<uint32_t>(playerMana / pricePerTarget), static_cast<uint32_t>(creatures.size()));
     int32_t priceTotal = nbTargets * pricePerTarget;
@@ -244,8 +248,8 @@ bool SpellCreatureHeal::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
     if(!player->getSeat()->takeMana(priceTotal))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureHealDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureHealValue");
+    uint32_t duration = SpellCreatureHealDuration.get();
+    double value = SpellCreatureHealValue.get();
     std::vector<Tile*> affectedTiles;
     for(Creature* creature : creatures)
     {
@@ -30,15 +30,19 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureSlowName = "creatureSlow";
 const std::string SpellCreatureSlowNameDisplay = "Creature Slow";
-const std::string SpellCreatureSlowCooldownKey = "CreatureSlowCooldown";
+const ConfigParam<uint32_t> SpellCreatureSlowCooldown(ConfigParamFile::spells, "CreatureSlowCooldown");
 const SpellType SpellCreatureSlow::mSpellType = SpellType::creatureSlow;
 
+const ConfigParam<uint32_t> SpellCreatureSlowDuration(ConfigParamFile::spells, "CreatureSlowDuration");
+const ConfigParam<int32_t> SpellCreatureSlowPrice(ConfigParamFile::spells, "CreatureSlowPrice");
+const ConfigParam<double> SpellCreatureSlowValue(ConfigParamFile::spells, "CreatureSlowValue");
+
 namespace
 {
 class SpellCreatureSlowFactory : public SpellFactory
@@ -49,8 +53,8 @@ class SpellCreatureSlowFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureSlowName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureSlowCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureSlowCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureSlowNameDisplay; }
@@ -75,7 +79,7 @@ static SpellRegister reg(new SpellCreatureSlowFactory);
 void SpellCreatureSlow::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureSlowPrice");
+    int32_t pricePerTarget = SpellCreatureSlowPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +197,13 @@ bool SpellCreatureSlow::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureSlowPrice");
+    int32_t pricePerTarget = SpellCreatureSlowPrice.get();
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureSlowDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureSlowValue");
+    uint32_t duration = SpellCreatureSlowDuration.get();
+    double value = SpellCreatureSlowValue.get();
     CreatureEffectSpeedChange* effect = new CreatureEffectSpeedChange(duration, value, "SpellCreatureSlow");
     creature->addCreatureEffect(effect);
 
@@ -30,15 +30,19 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureStrengthName = "creatureStrength";
 const std::string SpellCreatureStrengthNameDisplay = "Creature Strength";
-const std::string SpellCreatureStrengthCooldownKey = "CreatureStrengthCooldown";
+const ConfigParam<uint32_t> SpellCreatureStrengthCooldown(ConfigParamFile::spells, "CreatureStrengthCooldown");
 const SpellType SpellCreatureStrength::mSpellType = SpellType::creatureStrength;
 
+const ConfigParam<uint32_t> SpellCreatureStrengthDuration(ConfigParamFile::spells, "CreatureStrengthDuration");
+const ConfigParam<int32_t> SpellCreatureStrengthPrice(ConfigParamFile::spells, "CreatureStrengthPrice");
+const ConfigParam<double> SpellCreatureStrengthValue(ConfigParamFile::spells, "CreatureStrengthValue");
+
 namespace
 {
 class SpellCreatureStrengthFactory : public SpellFactory
@@ -49,8 +53,8 @@ class SpellCreatureStrengthFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureStrengthName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureStrengthCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureStrengthCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureStrengthNameDisplay; }
@@ -75,7 +79,7 @@ static SpellRegister reg(new SpellCreatureStrengthFactory);
 void SpellCreatureStrength::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = SpellCreatureStrengthPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +197,13 @@ bool SpellCreatureStrength::castSpell(GameMap* gameMap, Player* player, ODPacket
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = SpellCreatureStrengthPrice.get();
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureStrengthDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureStrengthValue");
+    uint32_t duration = SpellCreatureStrengthDuration.get();
+    double value = SpellCreatureStrengthValue.get();
     CreatureEffectStrengthChange* effect = new CreatureEffectStrengthChange(duration, value, "SpellCreatureStrength");
     creature->addCreatureEffect(effect);
 
@@ -30,15 +30,19 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellCreatureWeakName = "creatureWeak";
 const std::string SpellCreatureWeakNameDisplay = "Creature Weak";
-const std::string SpellCreatureWeakCooldownKey = "CreatureWeakCooldown";
+const ConfigParam<uint32_t> SpellCreatureWeakCooldown(ConfigParamFile::spells, "CreatureWeakCooldown");
 const SpellType SpellCreatureWeak::mSpellType = SpellType::creatureWeak;
 
+const ConfigParam<uint32_t> SpellCreatureWeakDuration(ConfigParamFile::spells, "CreatureWeakDuration");
+const ConfigParam<int32_t> SpellCreatureWeakPrice(ConfigParamFile::spells, "CreatureWeakPrice");
+const ConfigParam<double> SpellCreatureWeakValue(ConfigParamFile::spells, "CreatureWeakValue");
+
 namespace
 {
 class SpellCreatureWeakFactory : public SpellFactory
@@ -49,8 +53,8 @@ class SpellCreatureWeakFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureWeakName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureWeakCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellCreatureWeakCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureWeakNameDisplay; }
@@ -75,7 +79,7 @@ static SpellRegister reg(new SpellCreatureWeakFactory);
 void SpellCreatureWeak::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureWeakPrice");
+    int32_t pricePerTarget = SpellCreatureWeakPrice.get();
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +197,13 @@ bool SpellCreatureWeak::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureWeakPrice");
+    int32_t pricePerTarget = SpellCreatureWeakPrice.get();
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureWeakDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureWeakValue");
+    uint32_t duration = SpellCreatureWeakDuration.get();
+    double value = SpellCreatureWeakValue.get();
     CreatureEffectStrengthChange* effect = new CreatureEffectStrengthChange(duration, value, "SpellCreatureWeak");
     creature->addCreatureEffect(effect);
 
@@ -26,15 +26,19 @@
 #include "modes/InputManager.h"
 #include "network/ODClient.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellEyeEvilName = "eyeEvil";
 const std::string SpellEyeEvilNameDisplay = "Eye of Evil";
-const std::string SpellEyeEvilCooldownKey = "EyeEvilCooldown";
+const ConfigParam<uint32_t> SpellEyeEvilCooldown(ConfigParamFile::spells, "EyeEvilCooldown");
 const SpellType SpellEyeEvil::mSpellType = SpellType::eyeEvil;
 
+const ConfigParam<int32_t> SpellEyeEvilNbTurns(ConfigParamFile::spells, "EyeEvilNbTurns");
+const ConfigParam<int32_t> SpellEyeEvilPrice(ConfigParamFile::spells, "EyeEvilPrice");
+const ConfigParam<uint32_t> SpellEyeEvilRadiusTiles(ConfigParamFile::spells, "EyeEvilRadiusTiles");
+
 namespace
 {
 class SpellEyeEvilFactory : public SpellFactory
@@ -45,8 +49,8 @@ class SpellEyeEvilFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellEyeEvilName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellEyeEvilCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellEyeEvilCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellEyeEvilNameDisplay; }
@@ -70,7 +74,7 @@ static SpellRegister reg(new SpellEyeEvilFactory);
 
 SpellEyeEvil::SpellEyeEvil(GameMap* gameMap) :
     Spell(gameMap, SpellManager::getSpellNameFromSpellType(getSpellType()), "FlyingSkull", 0.0,
-        ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilNbTurns"))
+        SpellEyeEvilNbTurns.get())
 {
     mPrevAnimationState = "Triggered";
     mPrevAnimationStateLoop = true;
@@ -82,7 +86,7 @@ SpellEyeEvil::~SpellEyeEvil()
 
 void SpellEyeEvil::computeVisibleTiles()
 {
-    uint32_t radius = ConfigManager::getSingleton().getSpellConfigUInt32("EyeEvilRadiusTiles");
+    uint32_t radius = SpellEyeEvilRadiusTiles.get();
     Tile* posTile = getPositionTile();
     if(posTile == nullptr)
     {
@@ -91,8 +95,12 @@ void SpellEyeEvil::computeVisibleTiles()
     }
 
     std::vector<Tile*> tiles = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), radius);
+    std::vector<uint32_t> tileIndexes;
+    tileIndexes.reserve(tiles.size());
     for(Tile* tile : tiles)
-        tile->notifyVision(getSeat());
+        tileIndexes.push_back(tile->getTileIndex());
+
+    getGameMap()->getVisionTracker().refreshEntityVision(getName(), getSeat()->getId(), tileIndexes);
 }
 
 void SpellEyeEvil::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
@@ -104,7 +112,7 @@ void SpellEyeEvil::checkSpellCast(GameMap* gameMap, const InputManager& inputMan
         return;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t price = SpellEyeEvilPrice.get();
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
         if(playerMana < price)
@@ -147,7 +155,7 @@ bool SpellEyeEvil::castSpell(GameMap* gameMap, Player* player, ODPacket& packet)
         return false;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t manaCost = SpellEyeEvilPrice.get();
     if(playerMana < manaCost)
         return false;
 
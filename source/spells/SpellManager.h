@@ -31,6 +31,8 @@ class Player;
 class Seat;
 class Spell;
 
+template<typename T> class ConfigParam;
+
 enum class SpellType;
 
 //! \brief Factory class to register a new spell
@@ -43,7 +45,7 @@ public:
     virtual SpellType getSpellType() const = 0;
     virtual const std::string& getName() const = 0;
     virtual const std::string& getNameReadable() const = 0;
-    virtual const std::string& getCooldownKey() const = 0;
+    virtual const ConfigParam<uint32_t>& getCooldown() const = 0;
 
     virtual void checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const = 0;
     virtual bool castSpell(GameMap* gameMap, Player* player, ODPacket& packet) const = 0;
@@ -29,15 +29,18 @@
 #include "network/ODClient.h"
 #include "spells/SpellType.h"
 #include "spells/SpellManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 const std::string SpellSummonWorkerName = "summonWorker";
 const std::string SpellSummonWorkerNameDisplay = "Summon worker";
-const std::string SpellSummonWorkerCooldownKey = "SummonWorkerCooldown";
+const ConfigParam<uint32_t> SpellSummonWorkerCooldown(ConfigParamFile::spells, "SummonWorkerCooldown");
 const SpellType SpellSummonWorker::mSpellType = SpellType::summonWorker;
 
+const ConfigParam<int32_t> SpellSummonWorkerBasePrice(ConfigParamFile::spells, "SummonWorkerBasePrice");
+const ConfigParam<int32_t> SpellSummonWorkerNbFree(ConfigParamFile::spells, "SummonWorkerNbFree");
+
 namespace
 {
 class SpellSummonWorkerFactory : public SpellFactory
@@ -48,8 +51,8 @@ class SpellSummonWorkerFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellSummonWorkerName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellSummonWorkerCooldownKey; }
+    const ConfigParam<uint32_t>& getCooldown() const override
+    { return SpellSummonWorkerCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellSummonWorkerNameDisplay; }
@@ -97,9 +100,9 @@ void SpellSummonWorker::checkSpellCast(GameMap* gameMap, const InputManager& inp
     gameMap->playerSelects(targets, inputManager.mXPos, inputManager.mYPos, inputManager.mLStartDragX,
         inputManager.mLStartDragY, SelectionTileAllowed::groundClaimedAllied, SelectionEntityWanted::tiles, player);
 
-    int32_t nbFreeWorkers = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerNbFree");
+    int32_t nbFreeWorkers = SpellSummonWorkerNbFree.get();
     int32_t nbWorkers = player->getSeat()->getNumCreaturesWorkers();
-    int32_t pricePerWorker = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerBasePrice");
+    int32_t pricePerWorker = SpellSummonWorkerBasePrice.get();
     if(nbWorkers > nbFreeWorkers)
         pricePerWorker *= std::pow(2, nbWorkers - nbFreeWorkers);
 
@@ -187,9 +190,9 @@ bool SpellSummonWorker::summonWorkersOnTiles(GameMap* gameMap, Player* player, c
         return false;
     }
 
-    int32_t nbFreeWorkers = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerNbFree");
+    int32_t nbFreeWorkers = SpellSummonWorkerNbFree.get();
     int32_t nbWorkers = player->getSeat()->getNumCreaturesWorkers();
-    int32_t pricePerWorker = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerBasePrice");
+    int32_t pricePerWorker = SpellSummonWorkerBasePrice.get();
     if(nbWorkers > nbFreeWorkers)
         pricePerWorker *= std::pow(2, nbWorkers - nbFreeWorkers);
 
@@ -238,11 +241,11 @@ bool SpellSummonWorker::summonWorkersOnTiles(GameMap* gameMap, Player* player, c
 int32_t SpellSummonWorker::getNextWorkerPriceForPlayer(GameMap* gameMap, Player* player)
 {
     int32_t nbWorkers = player->getSeat()->getNumCreaturesWorkers();
-    int32_t nbFreeWorkers = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerNbFree");
+    int32_t nbFreeWorkers = SpellSummonWorkerNbFree.get();
     if(nbWorkers < nbFreeWorkers)
         return 0;
 
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("SummonWorkerBasePrice");
+    int32_t price = SpellSummonWorkerBasePrice.get();
     price *= std::pow(2, nbWorkers - nbFreeWorkers);
 
     return price;
@@ -66,10 +66,13 @@ bool ODClientTest::connect(const std::string& host, const int port, uint32_t tim
             return false;
     }
 
-    // Send a hello request to start the conversation with the server
+    // Send a hello request to start the conversation with the server. We ask for compression
+    // so that the tests go through it
+    bool compression = true;
     ODPacket packSend;
     packSend << ClientNotificationType::hello
-        << std::string("OpenDungeons V ") + OD_VERSION_STR;
+        << std::string("OpenDungeons V ") + OD_VERSION_STR
+        << compression;
     send(packSend);
 
     return true;
@@ -88,6 +91,12 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
     OD_LOG_INF("ServerNotificationType=" + ServerNotification::typeString(cmd));
     switch(cmd)
     {
+        case ServerNotificationType::enableCompression:
+        {
+            enableReceiveCompression();
+            break;
+        }
+
         case ServerNotificationType::loadLevel:
         {
             std::string odVersion;
@@ -394,6 +403,15 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             BOOST_CHECK(packetReceived >> mPlayers[mLocalPlayerIndex].mGoals);
             break;
         }
+        case ServerNotificationType::chatServer:
+        {
+            std::string msg;
+            int32_t noticeType;
+            BOOST_CHECK(packetReceived >> msg >> noticeType);
+            OD_LOG_INF("server message=" + msg);
+            serverMessageReceived(msg);
+            break;
+        }
         case ServerNotificationType::setObjectAnimationState:
         {
             std::string entityName;
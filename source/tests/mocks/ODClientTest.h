@@ -79,6 +79,9 @@ protected:
     virtual void animationPlayed(const std::string& entityName, const std::string& animState,
         bool loop, bool playIdleWhenAnimationEnds, bool shouldSetWalkDirection, const Ogre::Vector3& walkDirection)
     {}
+    //! \brief Called when the server sends a message to display (for example, the output of a console command)
+    virtual void serverMessageReceived(const std::string& msg)
+    {}
 
     //! \brief This boolean can be used in the handle* functions to stop the processing loop
     //! before the end of the timeout
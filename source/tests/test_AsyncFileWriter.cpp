@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/AsyncFileWriter.h"
+
+#define BOOST_TEST_MODULE AsyncFileWriter
+#include "BoostTestTargetConfig.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+static std::string readFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_AsyncFileWriterWritesAndKeepsBackup)
+{
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(dir);
+    std::string fileName = (dir / "save.level").string();
+
+    {
+        AsyncFileWriter writer;
+        writer.write(fileName, "first");
+        writer.flush();
+        writer.write(fileName, std::string(100000, 'x'));
+        writer.flush();
+
+        std::vector<AsyncFileWriter::Result> results = writer.popResults();
+        BOOST_CHECK(results.size() == 2);
+        for(const AsyncFileWriter::Result& result : results)
+        {
+            BOOST_CHECK(result.mFileName == fileName);
+            BOOST_CHECK(result.mSuccess);
+        }
+        BOOST_CHECK(writer.popResults().empty());
+    }
+
+    BOOST_CHECK(readFile(fileName) == std::string(100000, 'x'));
+    BOOST_CHECK(readFile(fileName + ".bak") == "first");
+    BOOST_CHECK(!boost::filesystem::exists(fileName + ".tmp"));
+
+    // The pending files are written when the writer is destroyed
+    {
+        AsyncFileWriter writer;
+        writer.write(fileName, "last");
+    }
+    BOOST_CHECK(readFile(fileName) == "last");
+    // An existing backup is replaced
+    BOOST_CHECK(readFile(fileName + ".bak") == std::string(100000, 'x'));
+
+    boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_AsyncFileWriterContentWriter)
+{
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(dir);
+    std::string fileName = (dir / "save.level").string();
+
+    AsyncFileWriter writer;
+    std::string data = "content";
+    writer.write(fileName, [data](std::string& content) { content = data + " built by the thread"; return true; });
+    writer.flush();
+    // If the content cannot be built, the file is kept as it is
+    writer.write(fileName, [](std::string& content) { content = "invalid"; return false; });
+    writer.flush();
+
+    std::vector<AsyncFileWriter::Result> results = writer.popResults();
+    BOOST_REQUIRE(results.size() == 2);
+    BOOST_CHECK(results[0].mSuccess);
+    BOOST_CHECK(!results[1].mSuccess);
+    BOOST_CHECK(readFile(fileName) == "content built by the thread");
+    BOOST_CHECK(!boost::filesystem::exists(fileName + ".bak"));
+
+    boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_AsyncFileWriterReportsFailure)
+{
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    std::string fileName = (dir / "missing" / "save.level").string();
+
+    AsyncFileWriter writer;
+    writer.write(fileName, "content");
+    writer.flush();
+    std::vector<AsyncFileWriter::Result> results = writer.popResults();
+    BOOST_CHECK(results.size() == 1);
+    BOOST_CHECK(!results[0].mSuccess);
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ConfigParam
+#include "BoostTestTargetConfig.h"
+
+#include "utils/ConfigParam.h"
+#include "utils/LogManager.h"
+
+BOOST_AUTO_TEST_CASE(test_ParseValues)
+{
+    int32_t valInt = 0;
+    BOOST_CHECK(parseConfigParam("-12", valInt) && (valInt == -12));
+    BOOST_CHECK(!parseConfigParam("12x", valInt));
+    BOOST_CHECK(!parseConfigParam("", valInt));
+
+    uint32_t valUInt = 0;
+    BOOST_CHECK(parseConfigParam("12", valUInt) && (valUInt == 12));
+    BOOST_CHECK(!parseConfigParam("-12", valUInt));
+
+    double valDouble = 0.0;
+    BOOST_CHECK(parseConfigParam("0.25", valDouble) && (valDouble == 0.25));
+    BOOST_CHECK(!parseConfigParam("0,25", valDouble));
+}
+
+BOOST_AUTO_TEST_CASE(test_LoadParams)
+{
+    LogManager logMgr;
+
+    const ConfigParam<int32_t> paramCost(ConfigParamFile::rooms, "TestCostPerTile");
+    const ConfigParam<double> paramRate(ConfigParamFile::rooms, "TestRate");
+    const ConfigParam<std::string> paramMesh(ConfigParamFile::traps, "TestMesh");
+
+    std::map<const std::string, std::string> rooms;
+    rooms["TestCostPerTile"] = "150";
+    // Missing parameter
+    BOOST_CHECK(!ConfigParamBase::loadParams(ConfigParamFile::rooms, rooms, "rooms.cfg"));
+
+    // Invalid parameter
+    rooms["TestRate"] = "fast";
+    BOOST_CHECK(!ConfigParamBase::loadParams(ConfigParamFile::rooms, rooms, "rooms.cfg"));
+
+    // Unused values are allowed
+    rooms["TestRate"] = "0.5";
+    rooms["TestUnused"] = "1";
+    BOOST_CHECK(ConfigParamBase::loadParams(ConfigParamFile::rooms, rooms, "rooms.cfg"));
+    BOOST_CHECK(paramCost.get() == 150);
+    BOOST_CHECK(paramRate.get() == 0.5);
+
+    // Reloading updates the values
+    rooms["TestCostPerTile"] = "200";
+    BOOST_CHECK(ConfigParamBase::loadParams(ConfigParamFile::rooms, rooms, "rooms.cfg"));
+    BOOST_CHECK(paramCost.get() == 200);
+
+    // Parameters from another file are not affected
+    std::map<const std::string, std::string> traps;
+    traps["TestMesh"] = "Cannon";
+    BOOST_CHECK(ConfigParamBase::loadParams(ConfigParamFile::traps, traps, "traps.cfg"));
+    BOOST_CHECK(paramMesh.get() == "Cannon");
+    BOOST_CHECK(paramCost.get() == 200);
+}
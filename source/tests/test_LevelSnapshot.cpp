@@ -0,0 +1,278 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/LevelSnapshot.h"
+#include "utils/LogManager.h"
+#include "utils/TextTokenizer.h"
+
+#define BOOST_TEST_MODULE LevelSnapshot
+#include "BoostTestTargetConfig.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+const char* LEVELS[] =
+{
+    "/multiplayer/TestMultiplayerSmall1v1.level",
+    "/multiplayer/TestBigMap.level",
+    "/skirmish/TestSingleplayerSmall.level"
+};
+
+std::string readFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+void writeFile(const std::string& fileName, const std::string& data)
+{
+    std::ofstream file(fileName.c_str(), std::ofstream::out | std::ofstream::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+std::string writeSnapshot(const LevelSnapshot& snapshot)
+{
+    std::ostringstream ss;
+    BOOST_REQUIRE(snapshot.writeToStream(ss));
+    return ss.str();
+}
+
+bool readLevelText(const std::string& text, LevelSnapshot& snapshot)
+{
+    TextTokenizer tokenizer;
+    tokenizer.setText(text);
+    return snapshot.readFromLevelText(tokenizer);
+}
+
+//! \brief Section the snapshot reader does not know
+std::string unknownSection()
+{
+    std::string section;
+    // Id 99 then the size (5) in little endian
+    section += std::string("\x63\0\0\0", 4);
+    section += std::string("\x05\0\0\0\0\0\0\0", 8);
+    section += "abcde";
+    return section;
+}
+
+void checkSameSnapshots(const LevelSnapshot& snapshot1, const LevelSnapshot& snapshot2)
+{
+    BOOST_CHECK(snapshot1.getHeader() == snapshot2.getHeader());
+    BOOST_CHECK(snapshot1.getEntities() == snapshot2.getEntities());
+    BOOST_REQUIRE(snapshot1.getMapSizeX() == snapshot2.getMapSizeX());
+    BOOST_REQUIRE(snapshot1.getMapSizeY() == snapshot2.getMapSizeY());
+    uint32_t nbDifferentTiles = 0;
+    for(int32_t xx = 0; xx < snapshot1.getMapSizeX(); ++xx)
+    {
+        for(int32_t yy = 0; yy < snapshot1.getMapSizeY(); ++yy)
+        {
+            const LevelSnapshot::TileData& tile1 = snapshot1.getTileData(xx, yy);
+            const LevelSnapshot::TileData& tile2 = snapshot2.getTileData(xx, yy);
+            if((tile1.mType != tile2.mType) || (tile1.mFullness != tile2.mFullness) || (tile1.mSeatId != tile2.mSeatId))
+                ++nbDifferentTiles;
+        }
+    }
+    BOOST_CHECK(nbDifferentTiles == 0);
+    BOOST_CHECK(snapshot1.getFloodFillTeamIds() == snapshot2.getFloodFillTeamIds());
+    BOOST_CHECK(snapshot1.getNbFloodFillTypes() == snapshot2.getNbFloodFillTypes());
+    BOOST_CHECK(snapshot1.getFloodFillValues() == snapshot2.getFloodFillValues());
+}
+
+struct TempDir
+{
+    TempDir() :
+        mPath(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+    {
+        boost::filesystem::create_directories(mPath);
+    }
+
+    ~TempDir()
+    {
+        boost::filesystem::remove_all(mPath);
+    }
+
+    std::string file(const std::string& name) const
+    {
+        return (mPath / name).string();
+    }
+
+    boost::filesystem::path mPath;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_TextSnapshotText)
+{
+    LogManager logMgr;
+    TempDir dir;
+    for(const char* level : LEVELS)
+    {
+        BOOST_TEST_MESSAGE(level);
+        TextTokenizer tokenizer;
+        BOOST_REQUIRE(tokenizer.loadFile(std::string(OD_TEST_LEVELS_PATH) + level));
+        LevelSnapshot snapshotText;
+        BOOST_REQUIRE(snapshotText.readFromLevelText(tokenizer));
+
+        // The snapshot read from the binary file should be the one read from the text
+        std::string fileName = dir.file("level.snapshot");
+        writeFile(fileName, writeSnapshot(snapshotText));
+        BOOST_REQUIRE(LevelSnapshot::isSnapshotFile(fileName));
+        LevelSnapshot snapshotFile;
+        BOOST_REQUIRE(snapshotFile.readFromFile(fileName, false));
+        checkSameSnapshots(snapshotText, snapshotFile);
+
+        // Written back as text, the level should be read the same as the original one
+        std::ostringstream text;
+        BOOST_REQUIRE(snapshotFile.writeToLevelText(text));
+        LevelSnapshot snapshotTextAgain;
+        BOOST_REQUIRE(readLevelText(text.str(), snapshotTextAgain));
+        checkSameSnapshots(snapshotText, snapshotTextAgain);
+
+        std::ostringstream textAgain;
+        BOOST_REQUIRE(snapshotTextAgain.writeToLevelText(textAgain));
+        BOOST_CHECK(text.str() == textAgain.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_SnapshotTextSnapshot)
+{
+    LogManager logMgr;
+    TempDir dir;
+    for(const char* level : LEVELS)
+    {
+        BOOST_TEST_MESSAGE(level);
+        std::string textFileName = dir.file("level.level");
+        std::string snapshotFileName = dir.file("level.snapshot");
+        std::string textAgainFileName = dir.file("levelAgain.level");
+        std::string snapshotAgainFileName = dir.file("levelAgain.snapshot");
+        writeFile(textFileName, readFile(std::string(OD_TEST_LEVELS_PATH) + level));
+
+        // The snapshot written from its text conversion should be the same file
+        BOOST_REQUIRE(LevelSnapshot::convertFile(textFileName, snapshotFileName));
+        BOOST_REQUIRE(LevelSnapshot::convertFile(snapshotFileName, textAgainFileName));
+        BOOST_CHECK(!LevelSnapshot::isSnapshotFile(textAgainFileName));
+        BOOST_REQUIRE(LevelSnapshot::convertFile(textAgainFileName, snapshotAgainFileName));
+        BOOST_CHECK(readFile(snapshotFileName) == readFile(snapshotAgainFileName));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_SnapshotFloodFill)
+{
+    LogManager logMgr;
+    TempDir dir;
+    TextTokenizer tokenizer;
+    BOOST_REQUIRE(tokenizer.loadFile(std::string(OD_TEST_LEVELS_PATH) + LEVELS[0]));
+    LevelSnapshot snapshot;
+    BOOST_REQUIRE(snapshot.readFromLevelText(tokenizer));
+    BOOST_CHECK(!snapshot.hasFloodFill());
+
+    std::vector<int32_t> teamIds = { 0, 1, 2 };
+    uint32_t nbFloodFillTypes = 4;
+    std::size_t nbValues = teamIds.size() * nbFloodFillTypes * static_cast<std::size_t>(snapshot.getMapSizeX() * snapshot.getMapSizeY());
+    std::vector<uint32_t> values(nbValues);
+    for(std::size_t i = 0; i < nbValues; ++i)
+        values[i] = static_cast<uint32_t>(i % 7);
+
+    // A size not matching the map is refused
+    snapshot.setFloodFill(teamIds, nbFloodFillTypes + 1, values);
+    BOOST_CHECK(!snapshot.hasFloodFill());
+
+    snapshot.setFloodFill(teamIds, nbFloodFillTypes, values);
+    BOOST_REQUIRE(snapshot.hasFloodFill());
+
+    std::string fileName = dir.file("level.snapshot");
+    writeFile(fileName, writeSnapshot(snapshot));
+    LevelSnapshot snapshotFile;
+    BOOST_REQUIRE(snapshotFile.readFromFile(fileName, false));
+    BOOST_CHECK(snapshotFile.hasFloodFill());
+    checkSameSnapshots(snapshot, snapshotFile);
+
+    // A text level has no floodfill
+    std::ostringstream text;
+    BOOST_REQUIRE(snapshotFile.writeToLevelText(text));
+    LevelSnapshot snapshotText;
+    BOOST_REQUIRE(readLevelText(text.str(), snapshotText));
+    BOOST_CHECK(!snapshotText.hasFloodFill());
+}
+
+BOOST_AUTO_TEST_CASE(test_SnapshotTruncated)
+{
+    LogManager logMgr;
+    TempDir dir;
+    TextTokenizer tokenizer;
+    BOOST_REQUIRE(tokenizer.loadFile(std::string(OD_TEST_LEVELS_PATH) + LEVELS[0]));
+    LevelSnapshot snapshot;
+    BOOST_REQUIRE(snapshot.readFromLevelText(tokenizer));
+    std::string data = writeSnapshot(snapshot);
+
+    // The entities are the last section so any truncated file misses a part of a required section
+    std::string fileName = dir.file("level.snapshot");
+    std::size_t step = 1 + data.size() / 97;
+    for(std::size_t size = 0; size < data.size(); size += step)
+    {
+        writeFile(fileName, data.substr(0, size));
+        LevelSnapshot snapshotTruncated;
+        BOOST_CHECK_MESSAGE(!snapshotTruncated.readFromFile(fileName, false), "size=" << size);
+    }
+
+    writeFile(fileName, data.substr(0, data.size() - 1));
+    LevelSnapshot snapshotTruncated;
+    BOOST_CHECK(!snapshotTruncated.readFromFile(fileName, false));
+
+    // Reading only the header fails too if the header is truncated. The magic string and the format
+    // version take 12 bytes, then the header section starts with its id and its size
+    writeFile(fileName, data.substr(0, 12 + 12 + 1));
+    BOOST_CHECK(!snapshotTruncated.readFromFile(fileName, true));
+}
+
+BOOST_AUTO_TEST_CASE(test_SnapshotUnknownSection)
+{
+    LogManager logMgr;
+    TempDir dir;
+    TextTokenizer tokenizer;
+    BOOST_REQUIRE(tokenizer.loadFile(std::string(OD_TEST_LEVELS_PATH) + LEVELS[0]));
+    LevelSnapshot snapshot;
+    BOOST_REQUIRE(snapshot.readFromLevelText(tokenizer));
+    std::string data = writeSnapshot(snapshot);
+
+    // Sections written by a later version are skipped wherever they are. The magic string and the
+    // format version take 12 bytes
+    std::string dataUnknown = data.substr(0, 12) + unknownSection() + data.substr(12) + unknownSection();
+    std::string fileName = dir.file("level.snapshot");
+    writeFile(fileName, dataUnknown);
+    LevelSnapshot snapshotUnknown;
+    BOOST_REQUIRE(snapshotUnknown.readFromFile(fileName, false));
+    checkSameSnapshots(snapshot, snapshotUnknown);
+
+    LevelSnapshot snapshotHeader;
+    BOOST_REQUIRE(snapshotHeader.readFromFile(fileName, true));
+    BOOST_CHECK(snapshotHeader.getHeader() == snapshot.getHeader());
+    BOOST_CHECK(snapshotHeader.getMapSizeX() == snapshot.getMapSizeX());
+    BOOST_CHECK(snapshotHeader.getMapSizeY() == snapshot.getMapSizeY());
+
+    // An unknown section larger than the file is a truncated file
+    std::string dataTruncated = data + unknownSection();
+    dataTruncated.resize(dataTruncated.size() - 1);
+    writeFile(fileName, dataTruncated);
+    LevelSnapshot snapshotTruncated;
+    BOOST_CHECK(!snapshotTruncated.readFromFile(fileName, false));
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LogManager
+#include "BoostTestTargetConfig.h"
+
+#include "utils/LogManager.h"
+#include "utils/LogSinkAsync.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+//! \brief Sink keeping the messages written
+class LogSinkTest : public LogSink
+{
+public:
+    LogSinkTest(std::vector<std::string>& messages) :
+        mMessages(messages)
+    {}
+
+    virtual void write(LogMessageLevel, const std::string& module, const std::string&, const std::string&, int, const std::string& message) override
+    {
+        mMessages.push_back(module + ":" + message);
+    }
+
+private:
+    std::vector<std::string>& mMessages;
+};
+
+uint32_t nbMessagesBuilt = 0;
+
+std::string buildMessage(const std::string& message)
+{
+    ++nbMessagesBuilt;
+    return message;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_LogLevels)
+{
+    std::vector<std::string> messages;
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkTest(messages)));
+    logMgr.setLevel(LogMessageLevel::NORMAL);
+
+    // Messages below the level should not even be built
+    nbMessagesBuilt = 0;
+    for(uint32_t i = 0; i < 10; ++i)
+        OD_LOG_DBG(buildMessage("debug"));
+    OD_LOG_INF(buildMessage("info"));
+    OD_LOG_ERR(buildMessage("error"));
+    BOOST_CHECK(nbMessagesBuilt == 2);
+    BOOST_REQUIRE(messages.size() == 2);
+    BOOST_CHECK(messages[0] == "test_LogManager:info");
+    BOOST_CHECK(messages[1] == "test_LogManager:error");
+
+    // A module level overrides the global one
+    messages.clear();
+    logMgr.setModuleLevel("test_LogManager", LogMessageLevel::TRIVIAL);
+    OD_LOG_DBG("debug");
+    logMgr.setModuleLevel("test_LogManager", LogMessageLevel::CRITICAL);
+    logMgr.setLevel(LogMessageLevel::CRITICAL);
+    OD_LOG_WRN("warning");
+    BOOST_REQUIRE(messages.size() == 1);
+    BOOST_CHECK(messages[0] == "test_LogManager:debug");
+
+    // Same module, same id
+    BOOST_CHECK(LogManager::getModuleId("dir/test_LogManager.cpp") == LogManager::getModuleId(__FILE__));
+    BOOST_CHECK(LogManager::getModuleId("dir/test_LogManager.cpp") != LogManager::getModuleId("dir/LogManager.cpp"));
+}
+
+BOOST_AUTO_TEST_CASE(test_LogSinkAsync)
+{
+    // With a small buffer, the logging thread has to wait for the sink thread
+    std::vector<std::string> messages;
+    {
+        LogSinkAsync sink(16);
+        sink.addSink(std::unique_ptr<LogSink>(new LogSinkTest(messages)));
+        for(uint32_t i = 0; i < 1000; ++i)
+            sink.write(LogMessageLevel::NORMAL, "module", "00:00:00", "file.cpp", i, std::to_string(i));
+
+        sink.flush();
+        BOOST_CHECK(messages.size() == 1000);
+
+        // Critical messages are written before write returns
+        sink.write(LogMessageLevel::CRITICAL, "module", "00:00:00", "file.cpp", 0, "critical");
+        BOOST_CHECK(messages.size() == 1001);
+
+        // The pending messages are written when the sink is destroyed
+        sink.write(LogMessageLevel::NORMAL, "module", "00:00:00", "file.cpp", 0, "last");
+    }
+    BOOST_REQUIRE(messages.size() == 1002);
+    for(uint32_t i = 0; i < 1000; ++i)
+        BOOST_CHECK(messages[i] == "module:" + std::to_string(i));
+    BOOST_CHECK(messages[1001] == "module:last");
+}
@@ -18,7 +18,22 @@
 #define BOOST_TEST_MODULE ODPacket
 #include "BoostTestTargetConfig.h"
 
+#include "entities/TileType.h"
+#include "gamemap/VisibilityKernel.h"
 #include "network/ODPacket.h"
+#include "network/PacketCompression.h"
+#include "network/ReplayIndex.h"
+#include "network/TileDelta.h"
+#include "rooms/RoomType.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_ODPacket)
 {
@@ -54,3 +69,559 @@ BOOST_AUTO_TEST_CASE(test_ODPacket)
 
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_TileDelta)
+{
+    // Coordinates. The order should be kept
+    std::vector<std::pair<int, int>> coords;
+    for(int xx = 3; xx < 20; ++xx)
+        coords.push_back(std::make_pair(xx, 7));
+    coords.push_back(std::make_pair(0, 0));
+    coords.push_back(std::make_pair(5, 8));
+    coords.push_back(std::make_pair(4, 8));
+
+    std::vector<TileDeltaData> tiles(3);
+    tiles[0].mSeatId = 2;
+    tiles[0].mTileVisual = 9;
+    tiles[1].mIsRoom = true;
+    tiles[1].mDisplayTileMesh = false;
+    tiles[1].mRefundPriceRoom = 75;
+    tiles[1].mSeatId = 1;
+    tiles[1].mMeshName = "Dormitory.mesh";
+    tiles[2] = tiles[1];
+    tiles[2].mHasBridge = true;
+    tiles[2].mColorCustomMesh = true;
+    tiles[2].mRefundPriceRoom = 0;
+    tiles[2].mRefundPriceTrap = 12;
+    tiles[2].mIsTrap = true;
+
+    ODPacket packet;
+    TileDeltaWriter writer(packet);
+    writer.writeCoords(coords);
+    for(const TileDeltaData& tile : tiles)
+        writer.writeTile(tile);
+
+    TileDeltaReader reader(packet);
+    BOOST_REQUIRE(reader.isValid());
+    std::vector<std::pair<int, int>> coordsRead;
+    BOOST_REQUIRE(reader.readCoords(coordsRead));
+    BOOST_CHECK(coordsRead == coords);
+    for(const TileDeltaData& tile : tiles)
+    {
+        TileDeltaData tileRead;
+        BOOST_REQUIRE(reader.readTile(tileRead));
+        BOOST_CHECK(tileRead.mIsRoom == tile.mIsRoom);
+        BOOST_CHECK(tileRead.mIsTrap == tile.mIsTrap);
+        BOOST_CHECK(tileRead.mDisplayTileMesh == tile.mDisplayTileMesh);
+        BOOST_CHECK(tileRead.mColorCustomMesh == tile.mColorCustomMesh);
+        BOOST_CHECK(tileRead.mHasBridge == tile.mHasBridge);
+        BOOST_CHECK(tileRead.mRefundPriceRoom == tile.mRefundPriceRoom);
+        BOOST_CHECK(tileRead.mRefundPriceTrap == tile.mRefundPriceTrap);
+        BOOST_CHECK(tileRead.mSeatId == tile.mSeatId);
+        BOOST_CHECK(tileRead.mMeshName == tile.mMeshName);
+        BOOST_CHECK(tileRead.mTileVisual == tile.mTileVisual);
+    }
+
+    // A packet with another version should be refused
+    ODPacket packetWrongVersion;
+    uint8_t version = TILE_DELTA_VERSION + 1;
+    packetWrongVersion << version;
+    TileDeltaReader readerWrongVersion(packetWrongVersion);
+    BOOST_CHECK(!readerWrongVersion.isValid());
+    BOOST_CHECK(!readerWrongVersion.readCoords(coordsRead));
+}
+
+namespace
+{
+//! \brief Tiles of a level as seen by the seat 1 player
+struct LevelTiles
+{
+    int mMapSizeX = 0;
+    int mMapSizeY = 0;
+    std::vector<TileDeltaData> mTiles;
+    OpacityBitmap mOpacity;
+
+    TileDeltaData& getTile(int x, int y)
+    { return mTiles[y * mMapSizeX + x]; }
+};
+
+//! \brief Mesh of the room tiles as set by the constructor of each Room class. Portals only show their own entity
+std::string getRoomMeshName(RoomType roomType)
+{
+    switch(roomType)
+    {
+        case RoomType::dungeonTemple: return "DungeonTemple";
+        case RoomType::dormitory: return "Dormitory";
+        case RoomType::treasury: return "Treasury";
+        case RoomType::workshop: return "Workshop";
+        case RoomType::trainingHall: return "Dojo";
+        case RoomType::library: return "Library";
+        case RoomType::hatchery: return "Farm";
+        case RoomType::crypt: return "Crypt";
+        case RoomType::prison: return "PrisonGround";
+        case RoomType::bridgeWooden: return "WoodBridge";
+        case RoomType::bridgeStone: return "StoneBridge";
+        case RoomType::arena: return "Arena";
+        case RoomType::casino: return "Casino";
+        case RoomType::torture: return "TortureGround";
+        default: return "";
+    }
+}
+
+//! \brief Reads the tiles and the rooms of the given level. The tile visuals and the room meshes are the ones
+//! the server would send. Returns false if the file could not be read
+bool loadLevelTiles(const std::string& fileName, LevelTiles& level)
+{
+    std::ifstream levelFile(fileName);
+    if(!levelFile.good())
+        return false;
+
+    std::string line;
+    while(std::getline(levelFile, line))
+    {
+        if(line.compare(0, 7, "[Tiles]") == 0)
+            break;
+    }
+
+    // The map size is on the next lines, then the tiles. Tiles not in the file are full dirt tiles
+    std::vector<int> mapSize;
+    while((mapSize.size() < 2) && std::getline(levelFile, line))
+    {
+        std::stringstream ss(line.substr(0, line.find('#')));
+        int value;
+        while(ss >> value)
+            mapSize.push_back(value);
+    }
+    if(mapSize.size() < 2)
+        return false;
+
+    level.mMapSizeX = mapSize[0];
+    level.mMapSizeY = mapSize[1];
+    level.mTiles.assign(level.mMapSizeX * level.mMapSizeY, TileDeltaData());
+    level.mOpacity.setMapSize(level.mMapSizeX, level.mMapSizeY);
+    uint32_t dirtFull = static_cast<uint32_t>(tileVisualFromState(TileType::dirt, 100.0, false));
+    for(int yy = 0; yy < level.mMapSizeY; ++yy)
+    {
+        for(int xx = 0; xx < level.mMapSizeX; ++xx)
+        {
+            level.getTile(xx, yy).mTileVisual = dirtFull;
+            level.mOpacity.setOpaque(xx, yy, true);
+        }
+    }
+
+    while(std::getline(levelFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        if(line.compare(0, 8, "[/Tiles]") == 0)
+            break;
+
+        // posX posY type fullness [seatId]
+        int x;
+        int y;
+        TileType type;
+        double fullness;
+        std::stringstream ss(line);
+        if(!(ss >> x >> y >> type >> fullness))
+            continue;
+
+        // Water and lava ignore the fullness and only dirt or gold ground tiles can be claimed (see Tile::loadFromData)
+        if((type == TileType::water) || (type == TileType::lava))
+            fullness = 0.0;
+
+        int32_t seatId;
+        bool isClaimed = (ss >> seatId) &&
+            ((type == TileType::dirt) || ((type == TileType::gold) && (fullness == 0.0)));
+        TileDeltaData& tile = level.getTile(x, y);
+        level.mOpacity.setOpaque(x, y, fullness > 0.0);
+        tile.mTileVisual = static_cast<uint32_t>(tileVisualFromState(type, fullness, isClaimed));
+        if(isClaimed)
+            tile.mSeatId = seatId;
+    }
+
+    // Rooms: typeRoom name seatId numTiles then the tiles
+    while(std::getline(levelFile, line))
+    {
+        if(line.compare(0, 7, "[Rooms]") == 0)
+            break;
+    }
+    while(std::getline(levelFile, line))
+    {
+        if(line.compare(0, 8, "[/Rooms]") == 0)
+            break;
+        if(line.compare(0, 6, "[Room]") != 0)
+            continue;
+
+        RoomType roomType;
+        std::string name;
+        int seatId;
+        int nbTiles;
+        if(!std::getline(levelFile, line))
+            return false;
+        std::stringstream ss(line);
+        if(!(ss >> roomType >> name >> seatId >> nbTiles))
+            return false;
+
+        // The server sends the mesh file name (see Seat::exportTileToPacket)
+        std::string meshName = getRoomMeshName(roomType);
+        if(!meshName.empty())
+            meshName += ".mesh";
+
+        for(int i = 0; i < nbTiles; ++i)
+        {
+            int x;
+            int y;
+            if(!(levelFile >> x >> y))
+                return false;
+
+            TileDeltaData& tile = level.getTile(x, y);
+            tile.mIsRoom = true;
+            tile.mSeatId = seatId;
+            tile.mMeshName = meshName;
+            tile.mDisplayTileMesh = (roomType != RoomType::portal);
+            // The player can sell its own rooms. The price does not change the size of the former encoding
+            if(seatId == 1)
+                tile.mRefundPriceRoom = 50;
+        }
+    }
+
+    return true;
+}
+
+//! \brief Writes the tiles as refreshTiles did before TileDeltaWriter: the number of tiles, then for each tile
+//! its coordinates (TileContainer::tileToPacket), the effects (GameEntity::exportToPacketForUpdate) and
+//! the fields written by Seat::exportTileToPacket
+void writeTilesFormer(ODPacket& packet, LevelTiles& level, const std::vector<std::pair<int, int>>& coords)
+{
+    uint32_t nbTiles = coords.size();
+    packet << nbTiles;
+    for(const std::pair<int, int>& coord : coords)
+    {
+        int32_t x = coord.first;
+        int32_t y = coord.second;
+        uint32_t nbEffects = 0;
+        const TileDeltaData& tile = level.getTile(coord.first, coord.second);
+        uint32_t tileVisual = tile.mTileVisual;
+        packet << x << y << nbEffects << tile.mIsRoom << tile.mIsTrap << tile.mRefundPriceRoom
+            << tile.mRefundPriceTrap << tile.mDisplayTileMesh << tile.mColorCustomMesh << tile.mHasBridge
+            << tile.mSeatId << tile.mMeshName << tileVisual;
+    }
+}
+
+//! \brief Writes the tiles as refreshTiles does now (see Seat::exportTilesToPacket). The coordinates should
+//! be sorted by row
+void writeTiles(ODPacket& packet, LevelTiles& level, const std::vector<std::pair<int, int>>& coords)
+{
+    TileDeltaWriter writer(packet);
+    writer.writeCoords(coords);
+    for(const std::pair<int, int>& coord : coords)
+    {
+        uint32_t nbEffects = 0;
+        packet << nbEffects;
+        writer.writeTile(level.getTile(coord.first, coord.second));
+    }
+}
+
+//! \brief Writes the coordinates as refreshVisibleTiles did before TileDeltaWriter (see TileContainer::tileToPacket)
+void writeCoordsFormer(ODPacket& packet, const std::vector<std::pair<int, int>>& coords)
+{
+    uint32_t nbTiles = coords.size();
+    packet << nbTiles;
+    for(const std::pair<int, int>& coord : coords)
+    {
+        int32_t x = coord.first;
+        int32_t y = coord.second;
+        packet << x << y;
+    }
+}
+
+bool compareCoordsByRow(const std::pair<int, int>& c1, const std::pair<int, int>& c2)
+{
+    if(c1.second != c2.second)
+        return c1.second < c2.second;
+
+    return c1.first < c2.first;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_TileDelta_BigMap)
+{
+    // We compare the former and the compact encodings on what the server sends during a game on TestBigMap:
+    // a creature (sight radius 15 as in the creature definitions) takes every step from a ground tile to the
+    // next one on the east. For each step, refreshVisibleTiles sends the tiles it gains and loses vision on
+    // and refreshTiles sends the tiles it gains vision on
+    LevelTiles level;
+    BOOST_REQUIRE(loadLevelTiles(std::string(OD_TEST_LEVELS_PATH) + "/multiplayer/TestBigMap.level", level));
+
+    const int sightRadius = 15;
+    VisibilityKernel kernel(sightRadius);
+    std::vector<std::pair<int, int>> visibleFrom;
+    std::vector<std::pair<int, int>> visibleTo;
+    std::vector<std::pair<int, int>> tilesGained;
+    std::vector<std::pair<int, int>> tilesLost;
+    uint64_t nbSteps = 0;
+    uint64_t sizeTilesFormer = 0;
+    uint64_t sizeTiles = 0;
+    uint64_t sizeVisionFormer = 0;
+    uint64_t sizeVision = 0;
+    for(int yy = 0; yy < level.mMapSizeY; ++yy)
+    {
+        for(int xx = 0; xx + 1 < level.mMapSizeX; ++xx)
+        {
+            if(level.mOpacity.isOpaque(xx, yy) || level.mOpacity.isOpaque(xx + 1, yy))
+                continue;
+
+            visibleFrom.clear();
+            kernel.computeVisibleTiles(level.mOpacity, xx, yy, sightRadius, [&visibleFrom](int x, int y)
+                {
+                    visibleFrom.push_back(std::make_pair(x, y));
+                });
+            visibleTo.clear();
+            kernel.computeVisibleTiles(level.mOpacity, xx + 1, yy, sightRadius, [&visibleTo](int x, int y)
+                {
+                    visibleTo.push_back(std::make_pair(x, y));
+                });
+
+            // The server sorts the tiles by row before sending them
+            std::sort(visibleFrom.begin(), visibleFrom.end(), compareCoordsByRow);
+            std::sort(visibleTo.begin(), visibleTo.end(), compareCoordsByRow);
+            tilesGained.clear();
+            std::set_difference(visibleTo.begin(), visibleTo.end(), visibleFrom.begin(), visibleFrom.end(),
+                std::back_inserter(tilesGained), compareCoordsByRow);
+            tilesLost.clear();
+            std::set_difference(visibleFrom.begin(), visibleFrom.end(), visibleTo.begin(), visibleTo.end(),
+                std::back_inserter(tilesLost), compareCoordsByRow);
+
+            ODPacket packetVisionFormer;
+            writeCoordsFormer(packetVisionFormer, tilesGained);
+            writeCoordsFormer(packetVisionFormer, tilesLost);
+            ODPacket packetVision;
+            TileDeltaWriter writerVision(packetVision);
+            writerVision.writeCoords(tilesGained);
+            writerVision.writeCoords(tilesLost);
+
+            ODPacket packetTilesFormer;
+            writeTilesFormer(packetTilesFormer, level, tilesGained);
+            ODPacket packetTiles;
+            writeTiles(packetTiles, level, tilesGained);
+
+            ++nbSteps;
+            sizeVisionFormer += packetVisionFormer.getDataSize();
+            sizeVision += packetVision.getDataSize();
+            sizeTilesFormer += packetTilesFormer.getDataSize();
+            sizeTiles += packetTiles.getDataSize();
+        }
+    }
+    BOOST_REQUIRE(nbSteps > 0);
+
+    BOOST_TEST_MESSAGE("TestBigMap " << nbSteps << " steps, bytes per step: refreshTiles former="
+        << (sizeTilesFormer / nbSteps) << " compact=" << (sizeTiles / nbSteps)
+        << ", refreshVisibleTiles former=" << (sizeVisionFormer / nbSteps) << " compact=" << (sizeVision / nbSteps));
+    // On the steps of TestBigMap, the refreshTiles payload is about 2.9 times smaller and the refreshVisibleTiles
+    // one about 1.7 times smaller: the tiles gained or lost on a step give short runs
+    BOOST_CHECK(sizeTiles * 2 < sizeTilesFormer);
+    BOOST_CHECK(sizeVision * 3 < sizeVisionFormer * 2);
+}
+
+namespace
+{
+// Packets similar to the ones sent each turn, followed by an empty one and a big one
+const uint32_t NB_TURN_PACKETS = 50;
+const int32_t BIG_PACKET_SIZE = 100000;
+
+void buildPackets(std::vector<ODPacket>& packets)
+{
+    packets.resize(NB_TURN_PACKETS + 2);
+    for(uint32_t i = 0; i < NB_TURN_PACKETS; ++i)
+    {
+        int32_t turn = i;
+        packets[i] << std::string("turnStarted") << turn;
+        for(int32_t j = 0; j < 100; ++j)
+            packets[i] << std::string("Creature_Kobold_") << j << (j % 7) << (turn % 3);
+    }
+    for(int32_t j = 0; j < BIG_PACKET_SIZE; ++j)
+        packets[NB_TURN_PACKETS + 1] << j;
+}
+
+bool checkPacket(ODPacket& packet, uint32_t index)
+{
+    if(index == NB_TURN_PACKETS)
+        return packet.getDataSize() == 0;
+
+    if(index == NB_TURN_PACKETS + 1)
+    {
+        for(int32_t j = 0; j < BIG_PACKET_SIZE; ++j)
+        {
+            int32_t val;
+            if(!(packet >> val) || (val != j))
+                return false;
+        }
+        return true;
+    }
+
+    std::string str;
+    int32_t turn;
+    if(!(packet >> str >> turn) || (str != "turnStarted") || (turn != static_cast<int32_t>(index)))
+        return false;
+
+    for(int32_t j = 0; j < 100; ++j)
+    {
+        int32_t val1;
+        int32_t val2;
+        int32_t val3;
+        if(!(packet >> str >> val1 >> val2 >> val3))
+            return false;
+        if((str != "Creature_Kobold_") || (val1 != j) || (val2 != j % 7) || (val3 != turn % 3))
+            return false;
+    }
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_PacketCompression)
+{
+    // Each packet should be decompressed alone in the order they were compressed
+    std::vector<ODPacket> packets;
+    buildPackets(packets);
+
+    PacketDeflater deflater;
+    PacketInflater inflater;
+    uint32_t sizeCompressed = 0;
+    uint32_t sizeUncompressed = 0;
+    for(uint32_t i = 0; i < packets.size(); ++i)
+    {
+        ODPacket packetCompressed;
+        BOOST_REQUIRE(deflater.deflatePacket(packets[i], packetCompressed));
+        ODPacket packetInflated;
+        BOOST_REQUIRE(inflater.inflatePacket(packetCompressed, packetInflated));
+        BOOST_CHECK(packetInflated.getDataSize() == packets[i].getDataSize());
+        BOOST_CHECK(checkPacket(packetInflated, i));
+        sizeCompressed += packetCompressed.getDataSize();
+        sizeUncompressed += packets[i].getDataSize();
+    }
+    BOOST_TEST_MESSAGE("Compression: uncompressed=" << sizeUncompressed << " compressed=" << sizeCompressed);
+    BOOST_CHECK(sizeCompressed * 3 < sizeUncompressed);
+    BOOST_CHECK(deflater.getNbBytesIn() == sizeUncompressed);
+    BOOST_CHECK(deflater.getNbBytesOut() == sizeCompressed);
+
+    // Replays are compressed the same way
+    const std::string replayFile = "test_PacketCompression.odr";
+    {
+        std::ofstream os(replayFile, std::ios::out | std::ios::binary);
+        ODPacket::writeReplayHeader(os);
+        PacketDeflater replayDeflater;
+        for(uint32_t i = 0; i < packets.size(); ++i)
+            packets[i].writePacket(i, os, &replayDeflater);
+    }
+    {
+        std::ifstream is(replayFile, std::ios::in | std::ios::binary);
+        BOOST_REQUIRE(ODPacket::readReplayHeader(is));
+        PacketInflater replayInflater;
+        for(uint32_t i = 0; i < packets.size(); ++i)
+        {
+            ODPacket packet;
+            BOOST_REQUIRE(packet.readPacket(is, &replayInflater) == static_cast<int32_t>(i));
+            BOOST_CHECK(checkPacket(packet, i));
+        }
+        ODPacket packet;
+        BOOST_CHECK(packet.readPacket(is, &replayInflater) == -1);
+    }
+
+    // Replays without header are read without decompression
+    {
+        std::ofstream os(replayFile, std::ios::out | std::ios::binary);
+        packets[0].writePacket(12, os);
+    }
+    {
+        std::ifstream is(replayFile, std::ios::in | std::ios::binary);
+        BOOST_CHECK(!ODPacket::readReplayHeader(is));
+        ODPacket packet;
+        BOOST_CHECK(packet.readPacket(is) == 12);
+        BOOST_CHECK(checkPacket(packet, 0));
+    }
+    std::remove(replayFile.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_ReplayIndex)
+{
+    std::vector<ODPacket> packets;
+    buildPackets(packets);
+
+    // The index is written after the packets. Each packet is indexed as a turn
+    const std::string replayFile = "test_ReplayIndex.odr";
+    {
+        std::ofstream os(replayFile, std::ios::out | std::ios::binary);
+        ODPacket::writeReplayHeader(os);
+        PacketDeflater replayDeflater;
+        ReplayIndex replayIndex;
+        replayIndex.setLevelInfo("OpenDungeons V test", "level.level", "Description", 30, 40);
+        for(uint32_t i = 0; i < packets.size(); ++i)
+        {
+            replayIndex.addTurn(i * 2, i * 100, static_cast<uint64_t>(os.tellp()));
+            packets[i].writePacket(i * 100, os, &replayDeflater);
+        }
+        replayIndex.writeIndex(os);
+    }
+    {
+        std::ifstream is(replayFile, std::ios::in | std::ios::binary);
+        BOOST_REQUIRE(ODPacket::readReplayHeader(is));
+        std::streampos pos = is.tellg();
+        ReplayIndex replayIndex;
+        BOOST_REQUIRE(replayIndex.readIndex(is));
+        BOOST_CHECK(is.tellg() == pos);
+        BOOST_CHECK(replayIndex.getOdVersion() == "OpenDungeons V test");
+        BOOST_CHECK(replayIndex.getLevelFileName() == "level.level");
+        BOOST_CHECK(replayIndex.getLevelDescription() == "Description");
+        BOOST_CHECK(replayIndex.getMapSizeX() == 30);
+        BOOST_CHECK(replayIndex.getMapSizeY() == 40);
+        BOOST_REQUIRE(replayIndex.getTurns().size() == packets.size());
+
+        // Turns are found from their number and the first packet of the turn is at the indexed offset
+        const ReplayTurn* turn = replayIndex.findTurn(5);
+        BOOST_REQUIRE(turn != nullptr);
+        BOOST_CHECK(turn->mTurnNum == 6);
+        BOOST_CHECK(turn->mTimestamp == 300);
+        BOOST_CHECK(replayIndex.findTurn(static_cast<int64_t>(packets.size()) * 2) == nullptr);
+
+        // The packets are compressed as a single stream so they are read from the beginning
+        PacketInflater replayInflater;
+        for(uint32_t i = 0; i < packets.size(); ++i)
+        {
+            BOOST_CHECK(static_cast<uint64_t>(is.tellg()) == replayIndex.getTurns()[i].mOffset);
+            ODPacket packet;
+            BOOST_REQUIRE(packet.readPacket(is, &replayInflater) == static_cast<int32_t>(i * 100));
+            BOOST_CHECK(checkPacket(packet, i));
+        }
+        BOOST_CHECK(static_cast<uint64_t>(is.tellg()) == replayIndex.getIndexOffset());
+    }
+
+    // The footer offset is in little endian whatever the platform is
+    {
+        std::ifstream is(replayFile, std::ios::in | std::ios::binary);
+        ReplayIndex replayIndex;
+        BOOST_REQUIRE(replayIndex.readIndex(is));
+        is.seekg(-12, std::ios::end);
+        unsigned char footer[12];
+        BOOST_REQUIRE(is.read(reinterpret_cast<char*>(footer), sizeof(footer)));
+        uint64_t offset = 0;
+        for(uint32_t i = 0; i < 8; ++i)
+            offset |= static_cast<uint64_t>(footer[i]) << (8 * i);
+        BOOST_CHECK(offset == replayIndex.getIndexOffset());
+        BOOST_CHECK(std::memcmp(footer + 8, "ODRI", 4) == 0);
+    }
+
+    // Replays without index are still valid
+    {
+        std::ofstream os(replayFile, std::ios::out | std::ios::binary);
+        ODPacket::writeReplayHeader(os);
+        packets[0].writePacket(12, os);
+    }
+    {
+        std::ifstream is(replayFile, std::ios::in | std::ios::binary);
+        BOOST_REQUIRE(ODPacket::readReplayHeader(is));
+        ReplayIndex replayIndex;
+        BOOST_CHECK(!replayIndex.readIndex(is));
+        BOOST_CHECK(replayIndex.getTurns().empty());
+        BOOST_CHECK(replayIndex.getIndexOffset() == 0);
+    }
+    std::remove(replayFile.c_str());
+}
@@ -18,7 +18,17 @@
 #define BOOST_TEST_MODULE Random
 #include "BoostTestTargetConfig.h"
 
+#include "entities/Tile.h"
+#include "gamemap/AstarSearch.h"
+#include "gamemap/FloodFillSets.h"
+#include "gamemap/HierarchicalPathfinding.h"
+#include "gamemap/PathCache.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/TileStore.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
 
 struct Point
 {
@@ -30,6 +40,202 @@ struct Point
     { return y; }
 };
 
+//! \brief Fills tileStore with the tiles of the given level file. Only the type and the fullness are used:
+//! rooms, traps and seats are ignored. Returns false if the file could not be read
+static bool loadLevelTiles(const std::string& fileName, TileStore& tileStore)
+{
+    std::ifstream levelFile(fileName);
+    if(!levelFile.good())
+        return false;
+
+    std::string line;
+    while(std::getline(levelFile, line))
+    {
+        if(line.compare(0, 7, "[Tiles]") == 0)
+            break;
+    }
+
+    // The map size is on the next lines, then the tiles. Tiles not in the file are full dirt tiles
+    std::vector<int> values;
+    bool mapSizeRead = false;
+    while(std::getline(levelFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        if(line.compare(0, 8, "[/Tiles]") == 0)
+            return mapSizeRead;
+
+        std::stringstream ss(line);
+        int value;
+        while(ss >> value)
+            values.push_back(value);
+
+        if(!mapSizeRead)
+        {
+            if(values.size() < 2)
+                continue;
+
+            tileStore.setMapSize(values[0], values[1]);
+            mapSizeRead = true;
+            values.clear();
+            continue;
+        }
+
+        // posX posY type fullness [seatId]
+        if(values.size() >= 4)
+        {
+            uint32_t index = tileStore.getIndex(values[0], values[1]);
+            tileStore.setType(index, static_cast<TileType>(values[2]));
+            tileStore.setFullness(index, static_cast<double>(values[3]));
+        }
+
+        values.clear();
+    }
+
+    return false;
+}
+
+//! \brief Digs every dirt and gold tile of the map
+static void digTiles(TileStore& tileStore)
+{
+    for(uint32_t index = 0; index < tileStore.getNbTiles(); ++index)
+    {
+        if((tileStore.getType(index) == TileType::dirt) || (tileStore.getType(index) == TileType::gold))
+            tileStore.setFullness(index, 0.0);
+    }
+}
+
+static bool isGroundTile(const TileStore& tileStore, int x, int y)
+{
+    uint32_t index = tileStore.getIndex(x, y);
+    if(tileStore.getFullness(index) > 0.0)
+        return false;
+
+    return (tileStore.getType(index) != TileType::water) && (tileStore.getType(index) != TileType::lava);
+}
+
+static inline uint32_t& groundFloodFill(TileStore& tileStore, int x, int y)
+{
+    return tileStore.getFloodFillValues(tileStore.getIndex(x, y), 0)[static_cast<uint32_t>(FloodFillType::ground)];
+}
+
+//! \brief Gives the same ground floodfill value to the contiguous ground tiles of team 0. Tiles that
+//! already have a value are not changed
+static void fillGroundFloodFill(TileStore& tileStore, int startX, int startY, uint32_t color)
+{
+    std::vector<std::pair<int, int>> tiles;
+    tiles.push_back(std::make_pair(startX, startY));
+    groundFloodFill(tileStore, startX, startY) = color;
+    while(!tiles.empty())
+    {
+        int x = tiles.back().first;
+        int y = tiles.back().second;
+        tiles.pop_back();
+        static const int DIRS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for(const int* dir : DIRS)
+        {
+            int neighX = x + dir[0];
+            int neighY = y + dir[1];
+            if((neighX < 0) || (neighX >= tileStore.getMapSizeX()) || (neighY < 0) || (neighY >= tileStore.getMapSizeY()))
+                continue;
+            if(!isGroundTile(tileStore, neighX, neighY))
+                continue;
+            if(groundFloodFill(tileStore, neighX, neighY) != TileStore::NO_FLOODFILL)
+                continue;
+
+            groundFloodFill(tileStore, neighX, neighY) = color;
+            tiles.push_back(std::make_pair(neighX, neighY));
+        }
+    }
+}
+
+//! \brief Computes the ground floodfill of a single team like GameMap::enableFloodFill does
+static void computeGroundFloodFill(TileStore& tileStore)
+{
+    tileStore.setTeamsNumber(1);
+    uint32_t nextColor = TileStore::NO_FLOODFILL + 1;
+    for(int y = 0; y < tileStore.getMapSizeY(); ++y)
+    {
+        for(int x = 0; x < tileStore.getMapSizeX(); ++x)
+        {
+            if(!isGroundTile(tileStore, x, y))
+                continue;
+            if(groundFloodFill(tileStore, x, y) != TileStore::NO_FLOODFILL)
+                continue;
+
+            fillGroundFloodFill(tileStore, x, y, nextColor);
+            ++nextColor;
+        }
+    }
+}
+
+//! \brief Returns the ground floodfill value of team 0 once the merged areas are taken into account
+static uint32_t findGroundFloodFill(TileStore& tileStore, const FloodFillSets& sets, int x, int y)
+{
+    uint32_t color = groundFloodFill(tileStore, x, y);
+    if(color == TileStore::NO_FLOODFILL)
+        return color;
+
+    return sets.find(color);
+}
+
+//! \brief Computes the length of the shortest path from (startX, startY) to every tile with the same ground
+//! floodfill value. Only the 4 direct neighbors are used, like the clusters graph. Tiles not reachable are -1.
+//! If stopIndex is given, the search stops once the distance to this tile is known
+static void computeFlatDistances(TileStore& tileStore, const FloodFillSets& sets, int startX, int startY,
+    std::vector<int>& distances, uint32_t stopIndex = AstarSearch::NO_NODE)
+{
+    distances.assign(tileStore.getNbTiles(), -1);
+    uint32_t color = findGroundFloodFill(tileStore, sets, startX, startY);
+    std::vector<uint32_t> queue;
+    distances[tileStore.getIndex(startX, startY)] = 0;
+    queue.push_back(tileStore.getIndex(startX, startY));
+    for(uint32_t queueIndex = 0; queueIndex < queue.size(); ++queueIndex)
+    {
+        if(queue[queueIndex] == stopIndex)
+            return;
+
+        int x = static_cast<int>(queue[queueIndex]) % tileStore.getMapSizeX();
+        int y = static_cast<int>(queue[queueIndex]) / tileStore.getMapSizeX();
+        static const int DIRS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for(const int* dir : DIRS)
+        {
+            int neighX = x + dir[0];
+            int neighY = y + dir[1];
+            if((neighX < 0) || (neighX >= tileStore.getMapSizeX()) || (neighY < 0) || (neighY >= tileStore.getMapSizeY()))
+                continue;
+
+            uint32_t neighIndex = tileStore.getIndex(neighX, neighY);
+            if(distances[neighIndex] >= 0)
+                continue;
+            if(findGroundFloodFill(tileStore, sets, neighX, neighY) != color)
+                continue;
+
+            distances[neighIndex] = distances[queue[queueIndex]] + 1;
+            queue.push_back(neighIndex);
+        }
+    }
+}
+
+//! \brief Returns the length of the path going through the given waypoints or -1 if 2 consecutive
+//! waypoints are not connected
+static int waypointsPathLength(TileStore& tileStore, const FloodFillSets& sets, int startX, int startY,
+    const std::vector<uint32_t>& waypoints)
+{
+    int length = 0;
+    std::vector<int> distances;
+    for(uint32_t waypoint : waypoints)
+    {
+        computeFlatDistances(tileStore, sets, startX, startY, distances, waypoint);
+        if(distances[waypoint] < 0)
+            return -1;
+
+        length += distances[waypoint];
+        startX = static_cast<int>(waypoint) % tileStore.getMapSizeX();
+        startY = static_cast<int>(waypoint) / tileStore.getMapSizeX();
+    }
+    return length;
+}
+
 BOOST_AUTO_TEST_CASE(test_Pathfinding)
 {
     Point a{9,1};
@@ -39,3 +245,334 @@ BOOST_AUTO_TEST_CASE(test_Pathfinding)
     BOOST_CHECK((Pathfinding::distanceTile(a, b) - std::sqrt(128.0f)) < 0.0001f);
     BOOST_CHECK(Pathfinding::squaredDistance(9,1,1,9) == 128);
 }
+
+BOOST_AUTO_TEST_CASE(test_AstarSearch)
+{
+    AstarSearch search;
+    search.startSearch(10, 10);
+    uint32_t start = search.nodeIndex(2, 3);
+    BOOST_CHECK(search.nodeX(start) == 2);
+    BOOST_CHECK(search.nodeY(start) == 3);
+    BOOST_CHECK(!search.isVisited(start));
+
+    search.open(start, AstarSearch::NO_NODE, 0.0, 5.0);
+    uint32_t index;
+    BOOST_CHECK(search.popBest(index));
+    BOOST_CHECK(index == start);
+    BOOST_CHECK(search.isClosed(start));
+
+    // Nodes with the same fCost are popped in insertion order
+    uint32_t n1 = search.nodeIndex(3, 3);
+    uint32_t n2 = search.nodeIndex(1, 3);
+    uint32_t n3 = search.nodeIndex(2, 4);
+    search.open(n1, start, 1.0, 4.0);
+    search.open(n2, start, 1.0, 6.0);
+    search.open(n3, start, 2.0, 3.0);
+    BOOST_CHECK(!search.isClosed(n1));
+
+    // Only a lower cost updates the node
+    BOOST_CHECK(!search.decreaseCost(n2, start, 1.5));
+    BOOST_CHECK(search.decreaseCost(n2, n1, 0.5));
+    BOOST_CHECK(search.getParent(n2) == n1);
+
+    BOOST_CHECK(search.popBest(index));
+    BOOST_CHECK(index == n1);
+    BOOST_CHECK(search.popBest(index));
+    BOOST_CHECK(index == n3);
+    BOOST_CHECK(search.popBest(index));
+    BOOST_CHECK(index == n2);
+    BOOST_CHECK(!search.popBest(index));
+
+    // A new search invalidates every node
+    search.startSearch(10, 10);
+    BOOST_CHECK(!search.isVisited(start));
+    BOOST_CHECK(!search.isVisited(n1));
+}
+
+BOOST_AUTO_TEST_CASE(test_PathCache)
+{
+    PathCache cache(2);
+    cache.setMapSize(64, 64);
+
+    PathCacheKey key1{1, 1, 10, 1, 1, 0, 1.0, 0.0, 0.0};
+    PathCacheKey key2{1, 1, 10, 1, 2, 0, 1.0, 0.0, 0.0};
+    PathCacheKey key3{40, 40, 50, 50, 1, 0, 1.0, 0.0, 0.0};
+    std::list<Tile*> path(10, nullptr);
+    std::list<Tile*> result;
+
+    BOOST_CHECK(!cache.getPath(key1, result));
+    cache.addPath(key1, path, 1, 1, 10, 1);
+    BOOST_CHECK(cache.getPath(key1, result));
+    BOOST_CHECK(result.size() == 10);
+    // The seat is part of the key
+    BOOST_CHECK(!cache.getPath(key2, result));
+    BOOST_CHECK(cache.getNbHits() == 1);
+    BOOST_CHECK(cache.getNbMisses() == 2);
+
+    // A change far from the path does not invalidate it but a close one does
+    cache.tileChanged(60, 60);
+    BOOST_CHECK(cache.getPath(key1, result));
+    cache.tileChanged(20, 5);
+    BOOST_CHECK(!cache.getPath(key1, result));
+
+    // The least recently used path is dropped when the cache is full
+    cache.addPath(key1, path, 1, 1, 10, 1);
+    cache.addPath(key2, path, 1, 1, 10, 1);
+    BOOST_CHECK(cache.getPath(key1, result));
+    cache.addPath(key3, path, 40, 40, 50, 50);
+    BOOST_CHECK(cache.getPath(key1, result));
+    BOOST_CHECK(!cache.getPath(key2, result));
+    BOOST_CHECK(cache.getPath(key3, result));
+}
+
+BOOST_AUTO_TEST_CASE(test_FloodFillSets)
+{
+    FloodFillSets sets;
+    // Values never merged are their own representative
+    BOOST_CHECK(sets.find(0) == 0);
+    BOOST_CHECK(sets.find(42) == 42);
+
+    sets.unite(1, 2);
+    sets.unite(3, 4);
+    BOOST_CHECK(sets.find(1) == sets.find(2));
+    BOOST_CHECK(sets.find(3) == sets.find(4));
+    BOOST_CHECK(sets.find(1) != sets.find(3));
+
+    uint32_t root = sets.unite(2, 4);
+    BOOST_CHECK(sets.find(1) == root);
+    BOOST_CHECK(sets.find(3) == root);
+    BOOST_CHECK(sets.find(5) == 5);
+    BOOST_CHECK(sets.unite(1, 3) == root);
+
+    sets.clear();
+    BOOST_CHECK(sets.find(2) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_HierarchicalPathfindingLongRoutes)
+{
+    TileStore tileStore;
+    BOOST_REQUIRE(loadLevelTiles(std::string(OD_TEST_LEVELS_PATH) + "/skirmish/StoneKeep.level", tileStore));
+    // Once dug, the rock, water and lava tiles are the only obstacles on the long routes
+    digTiles(tileStore);
+    computeGroundFloodFill(tileStore);
+    std::vector<FloodFillSets> floodFillSets(TileStore::NB_FLOODFILL_TYPES);
+    HierarchicalPathfinding hpa(tileStore, floodFillSets);
+
+    // Routes between ground tiles at least 4 clusters away from each other
+    std::vector<std::pair<int, int>> groundTiles;
+    for(int y = 0; y < tileStore.getMapSizeY(); y += 3)
+    {
+        for(int x = 0; x < tileStore.getMapSizeX(); x += 3)
+        {
+            if(isGroundTile(tileStore, x, y))
+                groundTiles.push_back(std::make_pair(x, y));
+        }
+    }
+
+    uint32_t nbRoutes = 0;
+    std::vector<int> distances;
+    std::vector<uint32_t> waypoints;
+    for(uint32_t i = 0; (i < groundTiles.size() / 2) && (nbRoutes < 20); i += 7)
+    {
+        const std::pair<int, int>& start = groundTiles[i];
+        const std::pair<int, int>& dest = groundTiles[groundTiles.size() - 1 - i];
+        if(Pathfinding::squaredDistance(start.first, start.second, dest.first, dest.second) <
+            16 * HierarchicalPathfinding::CLUSTER_SIZE * HierarchicalPathfinding::CLUSTER_SIZE)
+        {
+            continue;
+        }
+
+        computeFlatDistances(tileStore, floodFillSets[0], start.first, start.second, distances);
+        int flatLength = distances[tileStore.getIndex(dest.first, dest.second)];
+        bool isFound = hpa.findAbstractPath(0, FloodFillType::ground, start.first, start.second, dest.first, dest.second, waypoints);
+        BOOST_REQUIRE(isFound == (flatLength >= 0));
+        if(!isFound)
+            continue;
+
+        // The route through the clusters is not always the shortest one but it should stay close
+        BOOST_REQUIRE(!waypoints.empty());
+        BOOST_CHECK(waypoints.back() == tileStore.getIndex(dest.first, dest.second));
+        int hpaLength = waypointsPathLength(tileStore, floodFillSets[0], start.first, start.second, waypoints);
+        BOOST_CHECK(hpaLength >= flatLength);
+        BOOST_CHECK_MESSAGE(hpaLength <= flatLength + flatLength / 10 + 2 * HierarchicalPathfinding::CLUSTER_SIZE,
+            "start=" << start.first << "," << start.second << " dest=" << dest.first << "," << dest.second
+            << " flat=" << flatLength << " hpa=" << hpaLength);
+        ++nbRoutes;
+    }
+    BOOST_CHECK(nbRoutes == 20);
+}
+
+BOOST_AUTO_TEST_CASE(test_HierarchicalPathfindingTileChanged)
+{
+    TileStore tileStore;
+    BOOST_REQUIRE(loadLevelTiles(std::string(OD_TEST_LEVELS_PATH) + "/skirmish/StoneKeep.level", tileStore));
+    computeGroundFloodFill(tileStore);
+    std::vector<FloodFillSets> floodFillSets(TileStore::NB_FLOODFILL_TYPES);
+    HierarchicalPathfinding hpa(tileStore, floodFillSets);
+
+    // We look for a full dirt tile next to a ground tile inside a cluster (not on its edges) and for 2 ground
+    // tiles connected to it far away from each other
+    int digX = -1;
+    int digY = -1;
+    for(int y = 0; (y < tileStore.getMapSizeY()) && (digX < 0); ++y)
+    {
+        for(int x = 1; x < tileStore.getMapSizeX(); ++x)
+        {
+            if((x % HierarchicalPathfinding::CLUSTER_SIZE == 0) || (x % HierarchicalPathfinding::CLUSTER_SIZE == HierarchicalPathfinding::CLUSTER_SIZE - 1) ||
+               (y % HierarchicalPathfinding::CLUSTER_SIZE == 0) || (y % HierarchicalPathfinding::CLUSTER_SIZE == HierarchicalPathfinding::CLUSTER_SIZE - 1))
+            {
+                continue;
+            }
+            uint32_t index = tileStore.getIndex(x, y);
+            if((tileStore.getType(index) != TileType::dirt) || (tileStore.getFullness(index) <= 0.0))
+                continue;
+            if(!isGroundTile(tileStore, x - 1, y))
+                continue;
+
+            digX = x;
+            digY = y;
+            break;
+        }
+    }
+    BOOST_REQUIRE(digX >= 0);
+
+    std::vector<int> distances;
+    computeFlatDistances(tileStore, floodFillSets[0], digX - 1, digY, distances);
+    uint32_t destIndex = static_cast<uint32_t>(std::max_element(distances.begin(), distances.end()) - distances.begin());
+    int destX = static_cast<int>(destIndex) % tileStore.getMapSizeX();
+    int destY = static_cast<int>(destIndex) / tileStore.getMapSizeX();
+    BOOST_REQUIRE(distances[destIndex] > 2 * HierarchicalPathfinding::CLUSTER_SIZE);
+
+    // The first search computes every cluster
+    std::vector<uint32_t> waypoints;
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX - 1, digY, destX, destY, waypoints));
+    uint32_t nbClusters = static_cast<uint32_t>(
+        ((tileStore.getMapSizeX() + HierarchicalPathfinding::CLUSTER_SIZE - 1) / HierarchicalPathfinding::CLUSTER_SIZE) *
+        ((tileStore.getMapSizeY() + HierarchicalPathfinding::CLUSTER_SIZE - 1) / HierarchicalPathfinding::CLUSTER_SIZE));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters);
+
+    // Nothing changed, nothing is computed again
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX - 1, digY, destX, destY, waypoints));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters);
+
+    // Digging a tile only computes its cluster again
+    tileStore.setFullness(tileStore.getIndex(digX, digY), 0.0);
+    groundFloodFill(tileStore, digX, digY) = groundFloodFill(tileStore, digX - 1, digY);
+    hpa.tileChanged(digX, digY);
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX, digY, destX, destY, waypoints));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters + 1);
+
+    // Claiming it does not change the floodfill but the cluster is computed again too
+    hpa.tileChanged(digX, digY);
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX, digY, destX, destY, waypoints));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters + 2);
+
+    // A tile on a cluster edge also changes the transitions with the neighbor cluster
+    int edgeX = HierarchicalPathfinding::clusterCoord(digX) * HierarchicalPathfinding::CLUSTER_SIZE;
+    hpa.tileChanged(edgeX, digY);
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX, digY, destX, destY, waypoints));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters + (edgeX > 0 ? 4 : 3));
+
+    // Dropping the graphs computes every cluster again
+    hpa.invalidateAll();
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, digX, digY, destX, destY, waypoints));
+    BOOST_CHECK(hpa.getNbClustersComputed() == nbClusters);
+}
+
+BOOST_AUTO_TEST_CASE(test_HierarchicalPathfindingClosedDoor)
+{
+    TileStore tileStore;
+    BOOST_REQUIRE(loadLevelTiles(std::string(OD_TEST_LEVELS_PATH) + "/skirmish/StoneKeep.level", tileStore));
+    computeGroundFloodFill(tileStore);
+    std::vector<FloodFillSets> floodFillSets(TileStore::NB_FLOODFILL_TYPES);
+    HierarchicalPathfinding hpa(tileStore, floodFillSets);
+
+    // We look for a corridor (a ground tile with ground tiles only on its left and its right) that splits
+    // the ground in 2 areas far enough from each other
+    int doorX = -1;
+    int doorY = -1;
+    int startX = -1;
+    int startY = -1;
+    int destX = -1;
+    int destY = -1;
+    std::vector<int> distancesLeft;
+    std::vector<int> distancesRight;
+    for(int y = 1; (y < tileStore.getMapSizeY() - 1) && (doorX < 0); ++y)
+    {
+        for(int x = 1; x < tileStore.getMapSizeX() - 1; ++x)
+        {
+            if(!isGroundTile(tileStore, x, y) || !isGroundTile(tileStore, x - 1, y) || !isGroundTile(tileStore, x + 1, y))
+                continue;
+            if(isGroundTile(tileStore, x, y - 1) || isGroundTile(tileStore, x, y + 1))
+                continue;
+
+            // We close the door like GameMap::doorLock does: the tile cannot be walked on anymore and the
+            // tiles on its right get a new floodfill value if they are not connected to the left anymore
+            uint32_t color = groundFloodFill(tileStore, x, y);
+            groundFloodFill(tileStore, x, y) = TileStore::NO_FLOODFILL;
+            computeFlatDistances(tileStore, floodFillSets[0], x - 1, y, distancesLeft);
+            if(distancesLeft[tileStore.getIndex(x + 1, y)] >= 0)
+            {
+                groundFloodFill(tileStore, x, y) = color;
+                continue;
+            }
+
+            std::vector<uint32_t> tilesRight;
+            for(uint32_t index = 0; index < tileStore.getNbTiles(); ++index)
+            {
+                if((tileStore.getFloodFillValues(index, 0)[static_cast<uint32_t>(FloodFillType::ground)] == color) &&
+                   (distancesLeft[index] < 0))
+                {
+                    tilesRight.push_back(index);
+                }
+            }
+            computeFlatDistances(tileStore, floodFillSets[0], x + 1, y, distancesRight);
+            uint32_t farLeft = static_cast<uint32_t>(std::max_element(distancesLeft.begin(), distancesLeft.end()) - distancesLeft.begin());
+            uint32_t farRight = static_cast<uint32_t>(std::max_element(distancesRight.begin(), distancesRight.end()) - distancesRight.begin());
+            if((distancesLeft[farLeft] < 2 * HierarchicalPathfinding::CLUSTER_SIZE) ||
+               (distancesRight[farRight] < 2 * HierarchicalPathfinding::CLUSTER_SIZE))
+            {
+                groundFloodFill(tileStore, x, y) = color;
+                continue;
+            }
+
+            // Before the door is closed, the graph is computed with the route through the door
+            groundFloodFill(tileStore, x, y) = color;
+            startX = static_cast<int>(farLeft) % tileStore.getMapSizeX();
+            startY = static_cast<int>(farLeft) / tileStore.getMapSizeX();
+            destX = static_cast<int>(farRight) % tileStore.getMapSizeX();
+            destY = static_cast<int>(farRight) / tileStore.getMapSizeX();
+            std::vector<uint32_t> waypoints;
+            BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, startX, startY, destX, destY, waypoints));
+
+            groundFloodFill(tileStore, x, y) = TileStore::NO_FLOODFILL;
+            hpa.tileChanged(x, y);
+            uint32_t newColor = color + static_cast<uint32_t>(tileStore.getNbTiles());
+            for(uint32_t index : tilesRight)
+            {
+                tileStore.getFloodFillValues(index, 0)[static_cast<uint32_t>(FloodFillType::ground)] = newColor;
+                hpa.tileChanged(static_cast<int>(index) % tileStore.getMapSizeX(), static_cast<int>(index) / tileStore.getMapSizeX());
+            }
+
+            doorX = x;
+            doorY = y;
+            break;
+        }
+    }
+    BOOST_REQUIRE(doorX >= 0);
+
+    // The route through the closed door is refused. The tiles on each side can still be reached
+    std::vector<uint32_t> waypoints;
+    BOOST_CHECK(!hpa.findAbstractPath(0, FloodFillType::ground, startX, startY, destX, destY, waypoints));
+    BOOST_CHECK(waypoints.empty());
+    BOOST_CHECK(!hpa.findAbstractPath(0, FloodFillType::ground, startX, startY, doorX, doorY, waypoints));
+    BOOST_CHECK(hpa.findAbstractPath(0, FloodFillType::ground, startX, startY, doorX - 1, doorY, waypoints));
+    BOOST_CHECK(hpa.findAbstractPath(0, FloodFillType::ground, destX, destY, doorX + 1, doorY, waypoints));
+
+    // Opening it merges the areas again (see GameMap::doorLock). The route goes through the door
+    groundFloodFill(tileStore, doorX, doorY) = groundFloodFill(tileStore, doorX - 1, doorY);
+    floodFillSets[0].unite(groundFloodFill(tileStore, doorX - 1, doorY), groundFloodFill(tileStore, doorX + 1, doorY));
+    hpa.tileChanged(doorX, doorY);
+    BOOST_REQUIRE(hpa.findAbstractPath(0, FloodFillType::ground, startX, startY, destX, destY, waypoints));
+    BOOST_CHECK(waypointsPathLength(tileStore, floodFillSets[0], startX, startY, waypoints) >= 0);
+}
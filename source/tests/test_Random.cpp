@@ -20,8 +20,50 @@
 #define BOOST_TEST_MODULE Random
 #include "BoostTestTargetConfig.h"
 
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(test_Random)
 {
     Random::initialize();
     BOOST_CHECK (Random::Int(1, 2 ) <= 2);
 }
+
+BOOST_AUTO_TEST_CASE(test_RandomStreamDeterministic)
+{
+    RandomStream stream1(42);
+    RandomStream stream2(42);
+    for(uint32_t i = 0; i < 1000; ++i)
+    {
+        int val = stream1.Int(-3, 7);
+        BOOST_CHECK(val == stream2.Int(-3, 7));
+        BOOST_CHECK((val >= -3) && (val <= 7));
+        double valDouble = stream1.Double(0.5, 1.5);
+        BOOST_CHECK(valDouble == stream2.Double(0.5, 1.5));
+        BOOST_CHECK((valDouble >= 0.5) && (valDouble < 1.5));
+    }
+
+    // Derived streams only depend on the seed and the key
+    BOOST_CHECK(RandomStream::deriveSeed(42, "Creature1") == RandomStream::deriveSeed(42, "Creature1"));
+    BOOST_CHECK(RandomStream::deriveSeed(42, "Creature1") != RandomStream::deriveSeed(42, "Creature2"));
+    BOOST_CHECK(RandomStream::deriveSeed(42, "Creature1") != RandomStream::deriveSeed(43, "Creature1"));
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomScopedStream)
+{
+    RandomStream expected(7);
+    std::vector<unsigned int> values;
+    for(uint32_t i = 0; i < 10; ++i)
+        values.push_back(expected.Uint(0, 1000));
+
+    RandomStream stream(7);
+    {
+        Random::ScopedStream scope(stream);
+        for(unsigned int value : values)
+            BOOST_CHECK(Random::Uint(0, 1000) == value);
+    }
+
+    // Once the scope is left, the stream is not used anymore
+    RandomStream copy = stream;
+    Random::Uint(0, 1000);
+    BOOST_CHECK(copy.next() == stream.next());
+}
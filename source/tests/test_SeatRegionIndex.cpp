@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/SeatRegionIndex.h"
+
+#define BOOST_TEST_MODULE SeatRegionIndex
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_SeatRegionIndexCounts)
+{
+    SeatRegionIndex index;
+    index.setMapSize(20, 12);
+    const int size = SeatRegionIndex::REGION_SIZE;
+    const uint64_t seat1 = SeatRegionIndex::seatBit(1);
+    const uint64_t seat2 = SeatRegionIndex::seatBit(2);
+
+    BOOST_CHECK(index.getSeatsAt(0, 0) == 0);
+
+    // 2 entities of the same seat in the same region
+    index.add(1, 1, 1);
+    index.add(size - 1, size - 1, 1);
+    index.add(size, 0, 2);
+    BOOST_CHECK(index.getSeatsAt(0, 0) == seat1);
+    BOOST_CHECK(index.getSeatsAt(size - 1, 2) == seat1);
+    BOOST_CHECK(index.getSeatsAt(size, 0) == seat2);
+    BOOST_CHECK(index.getSeatsAt(0, size) == 0);
+
+    // The seat stays in the region until its last entity leaves
+    index.remove(1, 1, 1);
+    BOOST_CHECK(index.getSeatsAt(0, 0) == seat1);
+    index.remove(size - 1, size - 1, 1);
+    BOOST_CHECK(index.getSeatsAt(0, 0) == 0);
+    BOOST_CHECK(index.getSeatsAt(size, 0) == seat2);
+
+    // Removing from an empty region or outside of the map does nothing
+    index.remove(0, 0, 1);
+    index.add(-1, 0, 1);
+    index.add(20, 0, 1);
+    BOOST_CHECK(index.getSeatsAt(0, 0) == 0);
+    BOOST_CHECK(index.getSeatsAt(-1, 0) == 0);
+    BOOST_CHECK(index.getSeatsAt(20, 0) == 0);
+
+    // Seats sharing a bit are counted together
+    index.add(0, 0, 3);
+    index.add(0, 0, 3 + 64);
+    index.remove(0, 0, 3);
+    BOOST_CHECK(index.getSeatsAt(0, 0) == SeatRegionIndex::seatBit(3));
+
+    index.clear();
+    BOOST_CHECK(index.getSeatsAt(size, 0) == 0);
+}
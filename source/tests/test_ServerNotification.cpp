@@ -0,0 +1,49 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ServerNotification
+#include "BoostTestTargetConfig.h"
+
+#include "network/ServerNotification.h"
+
+BOOST_AUTO_TEST_CASE(test_ServerNotificationFreeList)
+{
+    ServerNotification::clearFreeList();
+
+    // With an empty free list, a new notification is created
+    ServerNotification* notification = ServerNotification::acquire(ServerNotificationType::chatServer, nullptr);
+    BOOST_REQUIRE(notification != nullptr);
+    notification->mPacket << std::string("Some text");
+    ServerNotification::release(notification);
+
+    // The released notification is reused with a packet containing only the new type
+    ServerNotification* reused = ServerNotification::acquire(ServerNotificationType::turnStarted, nullptr);
+    BOOST_CHECK(reused == notification);
+    ServerNotificationType type;
+    BOOST_REQUIRE(reused->mPacket >> type);
+    BOOST_CHECK(type == ServerNotificationType::turnStarted);
+    std::string text;
+    BOOST_CHECK(!(reused->mPacket >> text));
+
+    // The free list is empty again so another notification is created
+    ServerNotification* other = ServerNotification::acquire(ServerNotificationType::chat, nullptr);
+    BOOST_CHECK(other != reused);
+
+    ServerNotification::release(reused);
+    ServerNotification::release(other);
+    ServerNotification::clearFreeList();
+}
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TextTokenizer.h"
+
+#define BOOST_TEST_MODULE TextTokenizer
+#include "BoostTestTargetConfig.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerLines)
+{
+    TextTokenizer tokenizer;
+    tokenizer.setText("[Tiles] # Comment\n  10 # MapSizeX\n\n1\t2\t\t3\r\n[/Tiles]");
+
+    TextRef token;
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    BOOST_CHECK(token == "[Tiles]");
+    BOOST_REQUIRE(tokenizer.nextToken(token));
+    BOOST_CHECK(token == "10");
+
+    // The rest of the line after the token
+    TextRef line;
+    BOOST_REQUIRE(tokenizer.nextLine(line));
+    BOOST_CHECK(line == " ");
+    BOOST_REQUIRE(tokenizer.nextLine(line));
+    BOOST_CHECK(line.empty());
+
+    std::vector<TextRef> fields;
+    BOOST_REQUIRE(tokenizer.nextLine(line));
+    TextTokenizer::split(TextTokenizer::trim(line), '\t', fields);
+    BOOST_REQUIRE(fields.size() == 4);
+    BOOST_CHECK(fields[0] == "1");
+    BOOST_CHECK(fields[1] == "2");
+    BOOST_CHECK(fields[2].empty());
+    BOOST_CHECK(fields[3] == "3");
+
+    std::stringstream ss;
+    BOOST_CHECK(tokenizer.copyLinesUntil("[/Tiles]", ss));
+    BOOST_CHECK(ss.str() == "[/Tiles]\n");
+    BOOST_CHECK(tokenizer.isEnd());
+    BOOST_CHECK(!tokenizer.nextLine(line));
+    BOOST_CHECK(!tokenizer.nextToken(token));
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerNumbers)
+{
+    const char* valid[] = { "0", "100", "-5", "+7", " 42\r", "2147483647", "-2147483648" };
+    for(const char* str : valid)
+    {
+        int32_t value = 0;
+        BOOST_CHECK(TextTokenizer::toInt(TextRef(str, std::strlen(str)), value));
+        BOOST_CHECK(value == std::stoi(str));
+    }
+
+    const char* invalid[] = { "", "-", "1.5", "12a", "2147483648", "-2147483649" };
+    for(const char* str : invalid)
+    {
+        int32_t value = 0;
+        BOOST_CHECK(!TextTokenizer::toInt(TextRef(str, std::strlen(str)), value));
+    }
+
+    // The doubles are parsed the same way as the streams do
+    const char* doubles[] = { "0", "100.00", "0.5", "-0.25", "33.333333", ".5", "5.", "1e3", "2.5E-3",
+        "0.1", "0.30000000000000004", "123456789.123456789", "1e-30" };
+    for(const char* str : doubles)
+    {
+        double value = 0.0;
+        BOOST_CHECK(TextTokenizer::toDouble(TextRef(str, std::strlen(str)), value));
+        std::istringstream ss(str);
+        double expected = 0.0;
+        ss >> expected;
+        BOOST_CHECK(value == expected);
+    }
+
+    const char* invalidDoubles[] = { "", ".", "-", "1.5x", "1e" };
+    for(const char* str : invalidDoubles)
+    {
+        double value = 0.0;
+        BOOST_CHECK(!TextTokenizer::toDouble(TextRef(str, std::strlen(str)), value));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_TextTokenizerLevel)
+{
+    // The tokens should be the ones read from the level without comments with operator>>
+    std::string fileName = std::string(OD_TEST_LEVELS_PATH) + "/multiplayer/TestBigMap.level";
+    std::ifstream levelFile(fileName.c_str());
+    BOOST_REQUIRE(levelFile.good());
+    std::stringstream levelStream;
+    std::string line;
+    while(std::getline(levelFile, line))
+        levelStream << line.substr(0, line.find('#')) << "\n";
+
+    TextTokenizer tokenizer;
+    BOOST_REQUIRE(tokenizer.loadFile(fileName));
+
+    uint32_t nbTokens = 0;
+    std::string expected;
+    TextRef token;
+    while(levelStream >> expected)
+    {
+        BOOST_REQUIRE(tokenizer.nextToken(token));
+        BOOST_REQUIRE(token == expected);
+        ++nbTokens;
+    }
+    BOOST_CHECK(!tokenizer.nextToken(token));
+    BOOST_CHECK(nbTokens > 0);
+}
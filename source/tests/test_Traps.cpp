@@ -34,6 +34,7 @@ public:
 
     std::string mAwaitedEntityName;
     std::string mAwaitedEntityAnimation;
+    std::string mAwaitedServerMessage;
     bool mResultTest;
 
     virtual void animationPlayed(const std::string& entityName, const std::string& animState, bool loop,
@@ -51,6 +52,17 @@ public:
         mContinueLoop = false;
         mResultTest = true;
     }
+
+    virtual void serverMessageReceived(const std::string& msg) override
+    {
+        if(mAwaitedServerMessage.empty())
+            return;
+        if(msg.compare(0, mAwaitedServerMessage.size(), mAwaitedServerMessage) != 0)
+            return;
+
+        mContinueLoop = false;
+        mResultTest = (msg == mAwaitedServerMessage + "0");
+    }
 };
 
 BOOST_AUTO_TEST_CASE(test_Creatures)
@@ -169,6 +181,40 @@ BOOST_AUTO_TEST_CASE(test_Creatures)
 
     BOOST_CHECK(!client.mResultTest);
 
+    // We check that the opacity used to compute the visible tiles is right. That also makes sure it is
+    // computed before the door changes
+    client.mAwaitedEntityName.clear();
+    client.mAwaitedServerMessage = "Opacity mismatches: ";
+    cmd = "checkopacity";
+    client.sendConsoleCmd(cmd);
+
+    client.mResultTest = false;
+    client.runFor(5000);
+
+    BOOST_CHECK(client.mResultTest);
+
+    // We lock the seat 1 door and check that the opacity follows
+    cmd = "toggledoor 5 14";
+    client.sendConsoleCmd(cmd);
+    cmd = "checkopacity";
+    client.sendConsoleCmd(cmd);
+
+    client.mResultTest = false;
+    client.runFor(5000);
+
+    BOOST_CHECK(client.mResultTest);
+
+    // We unlock it and check again
+    cmd = "toggledoor 5 14";
+    client.sendConsoleCmd(cmd);
+    cmd = "checkopacity";
+    client.sendConsoleCmd(cmd);
+
+    client.mResultTest = false;
+    client.runFor(5000);
+
+    BOOST_CHECK(client.mResultTest);
+
     // We expect to have reached at least turn 10
     OD_LOG_INF("turnNum=" + Helper::toString(client.mTurnNum));
     BOOST_CHECK(client.mTurnNum > 0);
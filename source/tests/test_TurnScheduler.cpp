@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/TurnScheduler.h"
+
+#define BOOST_TEST_MODULE TurnScheduler
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_TurnSchedulerFixedSchedule)
+{
+    TurnScheduler scheduler(100.0);
+    scheduler.start(1000.0);
+    BOOST_CHECK_CLOSE(scheduler.getWaitTimeMs(1030.0), 70.0, 1e-9);
+    BOOST_CHECK(!scheduler.isTurnDue(1099.0));
+    BOOST_CHECK(scheduler.isTurnDue(1120.0));
+    BOOST_CHECK(scheduler.getNbLateTurns() == 0);
+
+    // The next turn is due on the schedule, not one turn length after the late one
+    BOOST_CHECK_CLOSE(scheduler.getWaitTimeMs(1150.0), 50.0, 1e-9);
+    BOOST_CHECK(scheduler.getWaitTimeMs(1250.0) == 0.0);
+
+    // The turns missed while the server was busy are counted as late
+    BOOST_CHECK(scheduler.isTurnDue(1450.0));
+    BOOST_CHECK(scheduler.getNbLateTurns() == 2);
+    BOOST_CHECK_CLOSE(scheduler.getWaitTimeMs(1450.0), 50.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnSchedulerSkipPolicy)
+{
+    TurnScheduler scheduler(100.0);
+    BOOST_CHECK(scheduler.getPolicy() == TurnSchedulerPolicy::skip);
+    scheduler.start(0.0);
+
+    // Each turn simulates one turn length, even when it is late
+    BOOST_REQUIRE(scheduler.isTurnDue(350.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.1, 1e-9);
+
+    // The time of the skipped turns is lost
+    BOOST_REQUIRE(scheduler.isTurnDue(400.0));
+    scheduler.skipTurn();
+    BOOST_REQUIRE(scheduler.isTurnDue(500.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.1, 1e-9);
+
+    BOOST_CHECK(scheduler.getNbTurns() == 2);
+    BOOST_CHECK(scheduler.getNbSkippedTurns() == 1);
+    BOOST_CHECK(scheduler.getNbLateTurns() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnSchedulerCatchUpPolicy)
+{
+    TurnScheduler scheduler(100.0);
+    scheduler.setPolicy(TurnSchedulerPolicy::catchUp);
+    scheduler.setMaxCatchUpTurns(2);
+    scheduler.start(0.0);
+
+    // A late turn simulates the time of the missed turns
+    BOOST_REQUIRE(scheduler.isTurnDue(250.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.2, 1e-9);
+
+    // The time of a skipped turn is given to the next one that runs
+    BOOST_REQUIRE(scheduler.isTurnDue(300.0));
+    scheduler.skipTurn();
+    BOOST_REQUIRE(scheduler.isTurnDue(400.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.2, 1e-9);
+
+    // Up to the max catch up turns plus the turn itself
+    BOOST_REQUIRE(scheduler.isTurnDue(1000.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.3, 1e-9);
+
+    // The pending time is also bounded while the turns are skipped
+    for(double timeMs = 1100.0; timeMs < 1600.0; timeMs += 100.0)
+    {
+        BOOST_REQUIRE(scheduler.isTurnDue(timeMs));
+        scheduler.skipTurn();
+    }
+    BOOST_REQUIRE(scheduler.isTurnDue(1600.0));
+    BOOST_CHECK_CLOSE(scheduler.beginTurn(), 0.3, 1e-9);
+
+    BOOST_CHECK(scheduler.getNbTurns() == 4);
+    BOOST_CHECK(scheduler.getNbSkippedTurns() == 6);
+
+    scheduler.clearStats();
+    BOOST_CHECK(scheduler.getNbTurns() == 0);
+    BOOST_CHECK(scheduler.getNbSkippedTurns() == 0);
+    BOOST_CHECK(scheduler.getNbLateTurns() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnSchedulerPolicyNames)
+{
+    for(TurnSchedulerPolicy policy : {TurnSchedulerPolicy::skip, TurnSchedulerPolicy::catchUp})
+    {
+        TurnSchedulerPolicy policyRead = (policy == TurnSchedulerPolicy::skip) ? TurnSchedulerPolicy::catchUp : TurnSchedulerPolicy::skip;
+        BOOST_CHECK(TurnScheduler::fromString(TurnScheduler::toString(policy), policyRead));
+        BOOST_CHECK(policyRead == policy);
+    }
+
+    TurnSchedulerPolicy policy = TurnSchedulerPolicy::skip;
+    BOOST_CHECK(!TurnScheduler::fromString("fast", policy));
+    BOOST_CHECK(policy == TurnSchedulerPolicy::skip);
+}
+
+BOOST_AUTO_TEST_CASE(test_TimingHistogram)
+{
+    TimingHistogram histogram;
+    histogram.addValue(0.5);
+    histogram.addValue(1.0);
+    histogram.addValue(3.0);
+    histogram.addValue(100000.0);
+    BOOST_CHECK(histogram.getNbValues() == 4);
+    BOOST_CHECK(histogram.getBucketCount(0) == 1);
+    BOOST_CHECK(histogram.getBucketCount(1) == 1);
+    BOOST_CHECK(histogram.getBucketCount(2) == 1);
+    BOOST_CHECK(histogram.getBucketCount(TimingHistogram::NB_BUCKETS - 1) == 1);
+    BOOST_CHECK(histogram.getMaxValue() == 100000.0);
+
+    histogram.clear();
+    BOOST_CHECK(histogram.getNbValues() == 0);
+    BOOST_CHECK(histogram.getAverageValue() == 0.0);
+}
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Visibility
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/VisibilityKernel.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//! \brief Fills opacity with the tiles of the given level file. Only the fullness is used: rooms and traps
+//! are ignored. Returns false if the file could not be read
+static bool loadOpacity(const std::string& fileName, OpacityBitmap& opacity)
+{
+    std::ifstream levelFile(fileName);
+    if(!levelFile.good())
+        return false;
+
+    std::string line;
+    while(std::getline(levelFile, line))
+    {
+        if(line.compare(0, 7, "[Tiles]") == 0)
+            break;
+    }
+
+    // The map size is on the next lines, then the tiles
+    std::vector<int> values;
+    bool mapSizeRead = false;
+    while(std::getline(levelFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        if(line.compare(0, 8, "[/Tiles]") == 0)
+            return mapSizeRead;
+
+        std::stringstream ss(line);
+        int value;
+        while(ss >> value)
+            values.push_back(value);
+
+        if(!mapSizeRead)
+        {
+            if(values.size() < 2)
+                continue;
+
+            // Tiles not in the file are full dirt tiles
+            opacity.setMapSize(values[0], values[1]);
+            for(int yy = 0; yy < values[1]; ++yy)
+            {
+                for(int xx = 0; xx < values[0]; ++xx)
+                    opacity.setOpaque(xx, yy, true);
+            }
+            mapSizeRead = true;
+            values.clear();
+            continue;
+        }
+
+        // posX posY type fullness [seatId]
+        if(values.size() >= 4)
+            opacity.setOpaque(values[0], values[1], values[3] > 0);
+
+        values.clear();
+    }
+
+    return false;
+}
+
+BOOST_AUTO_TEST_CASE(test_VisibilityKernel_SmallMap)
+{
+    OpacityBitmap opacity;
+    opacity.setMapSize(10, 10);
+    BOOST_CHECK(opacity.isInMap(9, 9));
+    BOOST_CHECK(!opacity.isInMap(10, 9));
+    BOOST_CHECK(!opacity.isInMap(-1, 0));
+
+    // A wall at distance 2 on the east hides the tiles behind it
+    opacity.setOpaque(7, 5, true);
+    BOOST_CHECK(opacity.isOpaque(7, 5));
+    BOOST_CHECK(!opacity.isOpaque(6, 5));
+
+    VisibilityKernel kernel(5);
+    std::vector<std::pair<int, int>> tiles;
+    kernel.computeVisibleTiles(opacity, 5, 5, 4, [&tiles](int x, int y)
+        {
+            tiles.push_back(std::make_pair(x, y));
+        });
+
+    // The center tile comes first
+    BOOST_REQUIRE(!tiles.empty());
+    BOOST_CHECK(tiles[0] == std::make_pair(5, 5));
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), std::make_pair(7, 5)) != tiles.end());
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), std::make_pair(8, 5)) == tiles.end());
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), std::make_pair(5, 8)) != tiles.end());
+
+    std::vector<std::pair<int, int>> tilesReference;
+    kernel.computeVisibleTilesReference(opacity, 5, 5, 4, tilesReference);
+    BOOST_CHECK(tiles == tilesReference);
+
+    opacity.setOpaque(7, 5, false);
+    BOOST_CHECK(!opacity.isOpaque(7, 5));
+}
+
+BOOST_AUTO_TEST_CASE(test_VisibilityKernel_BundledLevels)
+{
+    const std::vector<std::string> levels =
+    {
+        "multiplayer/Angel.level",
+        "multiplayer/TheBridge.level",
+        "skirmish/DuelToDeath.level",
+        "skirmish/FallingKeeper.level",
+        "skirmish/StoneKeep.level"
+    };
+
+    VisibilityKernel kernel(5);
+    std::vector<std::pair<int, int>> tiles;
+    std::vector<std::pair<int, int>> tilesReference;
+    for(const std::string& level : levels)
+    {
+        OpacityBitmap opacity;
+        BOOST_REQUIRE_MESSAGE(loadOpacity(std::string(OD_TEST_LEVELS_PATH) + "/" + level, opacity), level);
+
+        uint32_t nbDifferences = 0;
+        for(int radius = 5; radius <= 20; radius += 5)
+        {
+            // We check a sample of the tiles the creatures can be on
+            for(int yy = 0; yy < opacity.getMapSizeY(); yy += 3)
+            {
+                for(int xx = 0; xx < opacity.getMapSizeX(); xx += 3)
+                {
+                    if(opacity.isOpaque(xx, yy))
+                        continue;
+
+                    tiles.clear();
+                    kernel.computeVisibleTiles(opacity, xx, yy, radius, [&tiles](int x, int y)
+                        {
+                            tiles.push_back(std::make_pair(x, y));
+                        });
+                    kernel.computeVisibleTilesReference(opacity, xx, yy, radius, tilesReference);
+
+                    std::sort(tiles.begin(), tiles.end());
+                    std::sort(tilesReference.begin(), tilesReference.end());
+                    if(tiles != tilesReference)
+                        ++nbDifferences;
+                }
+            }
+        }
+        BOOST_CHECK_MESSAGE(nbDifferences == 0, level);
+    }
+}
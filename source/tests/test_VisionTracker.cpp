@@ -0,0 +1,223 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileStore.h"
+#include "gamemap/VisionTracker.h"
+#include "utils/LogManager.h"
+
+#define BOOST_TEST_MODULE VisionTracker
+#include "BoostTestTargetConfig.h"
+
+#include <set>
+#include <tuple>
+
+namespace
+{
+//! \brief Keeps the tiles each seat has vision on as the game map does
+class VisionListenerTest : public VisionListener
+{
+public:
+    VisionListenerTest() :
+        mNbChanges(0)
+    {}
+
+    void seatVisionChanged(int x, int y, int32_t seatId, bool hasVision) override
+    {
+        ++mNbChanges;
+        std::tuple<int, int, int32_t> seatTile(x, y, seatId);
+        // The listener should be notified only when the vision changes
+        if(hasVision)
+            BOOST_CHECK(mSeatsTiles.insert(seatTile).second);
+        else
+            BOOST_CHECK(mSeatsTiles.erase(seatTile) == 1);
+    }
+
+    bool hasVision(int x, int y, int32_t seatId) const
+    {
+        return mSeatsTiles.count(std::make_tuple(x, y, seatId)) > 0;
+    }
+
+    std::set<std::tuple<int, int, int32_t>> mSeatsTiles;
+    uint32_t mNbChanges;
+};
+
+const int MAP_SIZE_X = 10;
+const int MAP_SIZE_Y = 8;
+}
+
+BOOST_AUTO_TEST_CASE(test_EntitiesVisionOverlap)
+{
+    LogManager logMgr;
+    TileStore tileStore;
+    tileStore.setMapSize(MAP_SIZE_X, MAP_SIZE_Y);
+    VisionListenerTest listener;
+    VisionTracker tracker(tileStore, listener);
+    std::vector<int32_t> seatIds = { 1, 2 };
+
+    // Both creatures see the tile (3, 3)
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(2, 3), tileStore.getIndex(3, 3) });
+    tracker.refreshEntityVision("Creature2", 1, { tileStore.getIndex(3, 3), tileStore.getIndex(4, 3) });
+    tracker.endTurn();
+    BOOST_CHECK(tracker.getNbVisionSources(3, 3, 1) == 2);
+    BOOST_CHECK(listener.hasVision(2, 3, 1));
+    BOOST_CHECK(listener.hasVision(3, 3, 1));
+    BOOST_CHECK(listener.hasVision(4, 3, 1));
+    BOOST_CHECK(!listener.hasVision(3, 3, 2));
+    BOOST_CHECK(listener.mNbChanges == 3);
+
+    // The first creature leaves. The seat keeps vision on the tile seen by the second one
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(6, 6) });
+    tracker.refreshEntityVision("Creature2", 1, { tileStore.getIndex(3, 3), tileStore.getIndex(4, 3) });
+    tracker.endTurn();
+    BOOST_CHECK(tracker.getNbVisionSources(3, 3, 1) == 1);
+    BOOST_CHECK(!listener.hasVision(2, 3, 1));
+    BOOST_CHECK(listener.hasVision(3, 3, 1));
+    BOOST_CHECK(listener.hasVision(6, 6, 1));
+
+    // The second creature does not refresh its vision (it died). Its vision is removed at the end of the turn
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(6, 6) });
+    BOOST_CHECK(listener.hasVision(3, 3, 1));
+    tracker.endTurn();
+    BOOST_CHECK(tracker.getNbVisionSources(3, 3, 1) == 0);
+    BOOST_CHECK(!listener.hasVision(3, 3, 1));
+    BOOST_CHECK(!listener.hasVision(4, 3, 1));
+    BOOST_CHECK(listener.hasVision(6, 6, 1));
+
+    tracker.beginTurn(false, seatIds);
+    tracker.endTurn();
+    BOOST_CHECK(listener.mSeatsTiles.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_AlliedSeatsVision)
+{
+    LogManager logMgr;
+    TileStore tileStore;
+    tileStore.setMapSize(MAP_SIZE_X, MAP_SIZE_Y);
+    VisionListenerTest listener;
+    VisionTracker tracker(tileStore, listener);
+    std::vector<int32_t> seatIds = { 1, 2, 3 };
+    tracker.addAlliedSeat(1, 2);
+    tracker.addAlliedSeat(2, 1);
+
+    // The vision of a seat is shared with its allies only
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(5, 5) });
+    tracker.refreshEntityVision("Creature2", 2, { tileStore.getIndex(5, 5) });
+    tracker.endTurn();
+    BOOST_CHECK(listener.hasVision(5, 5, 1));
+    BOOST_CHECK(listener.hasVision(5, 5, 2));
+    BOOST_CHECK(!listener.hasVision(5, 5, 3));
+    BOOST_CHECK(tracker.getNbVisionSources(5, 5, 1) == 2);
+    BOOST_CHECK(tracker.getNbVisionSources(5, 5, 2) == 2);
+
+    // When the creature of the seat 2 leaves, both seats still see the tile thanks to the seat 1
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(5, 5) });
+    tracker.endTurn();
+    BOOST_CHECK(listener.hasVision(5, 5, 1));
+    BOOST_CHECK(listener.hasVision(5, 5, 2));
+
+    tracker.beginTurn(false, seatIds);
+    tracker.endTurn();
+    BOOST_CHECK(!listener.hasVision(5, 5, 1));
+    BOOST_CHECK(!listener.hasVision(5, 5, 2));
+
+    // Without fog of war, every seat sees every tile until the fog of war is activated again
+    tracker.beginTurn(true, seatIds);
+    tracker.endTurn();
+    BOOST_CHECK(listener.mSeatsTiles.size() == seatIds.size() * tileStore.getNbTiles());
+    BOOST_CHECK(tracker.getNbVisionSources(0, 0, 3) == 1);
+    tracker.beginTurn(false, seatIds);
+    tracker.endTurn();
+    BOOST_CHECK(listener.mSeatsTiles.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_ClaimedTilesVision)
+{
+    LogManager logMgr;
+    TileStore tileStore;
+    tileStore.setMapSize(MAP_SIZE_X, MAP_SIZE_Y);
+    VisionListenerTest listener;
+    VisionTracker tracker(tileStore, listener);
+    std::vector<int32_t> seatIds = { 1, 2 };
+
+    // The tiles claimed before the game starts give vision on the first turn
+    uint32_t index = tileStore.getIndex(0, 0);
+    tileStore.setSeatId(index, 1);
+    tileStore.setClaimedPercentage(index, 1.0);
+    tracker.refreshClaimedVision(0, 0);
+    BOOST_CHECK(listener.mSeatsTiles.empty());
+    tracker.beginTurn(false, seatIds);
+    tracker.endTurn();
+    BOOST_CHECK(listener.hasVision(0, 0, 1));
+    BOOST_CHECK(listener.hasVision(1, 0, 1));
+    BOOST_CHECK(listener.hasVision(0, 1, 1));
+    BOOST_CHECK(listener.mSeatsTiles.size() == 3);
+
+    // A claimed tile gives vision on itself and its 4 neighbors
+    index = tileStore.getIndex(4, 4);
+    tileStore.setSeatId(index, 1);
+    tileStore.setClaimedPercentage(index, 0.5);
+    tracker.refreshClaimedVision(4, 4);
+    BOOST_CHECK(!listener.hasVision(4, 4, 1));
+    tileStore.setClaimedPercentage(index, 1.0);
+    tracker.refreshClaimedVision(4, 4);
+    BOOST_CHECK(listener.mSeatsTiles.size() == 8);
+    BOOST_CHECK(listener.hasVision(4, 4, 1));
+    BOOST_CHECK(listener.hasVision(3, 4, 1));
+    BOOST_CHECK(listener.hasVision(5, 4, 1));
+    BOOST_CHECK(listener.hasVision(4, 3, 1));
+    BOOST_CHECK(listener.hasVision(4, 5, 1));
+    BOOST_CHECK(!listener.hasVision(5, 5, 1));
+
+    // Refreshing a tile that did not change does not add a vision source
+    tracker.refreshClaimedVision(4, 4);
+    BOOST_CHECK(tracker.getNbVisionSources(4, 4, 1) == 1);
+
+    // A creature seeing a tile claimed by its seat
+    tracker.beginTurn(false, seatIds);
+    tracker.refreshEntityVision("Creature1", 1, { tileStore.getIndex(5, 4) });
+    tracker.endTurn();
+    BOOST_CHECK(tracker.getNbVisionSources(5, 4, 1) == 2);
+
+    // The tile is claimed by the seat 2: the seat 1 loses the vision it gave except on the tile seen by the creature
+    tileStore.setSeatId(index, 2);
+    tracker.refreshClaimedVision(4, 4);
+    BOOST_CHECK(!listener.hasVision(4, 4, 1));
+    BOOST_CHECK(!listener.hasVision(3, 4, 1));
+    BOOST_CHECK(listener.hasVision(5, 4, 1));
+    BOOST_CHECK(listener.hasVision(4, 4, 2));
+    BOOST_CHECK(listener.hasVision(4, 5, 2));
+
+    // The tile is lost
+    tileStore.setClaimedPercentage(index, 0.0);
+    tileStore.setSeatId(index, TileStore::NO_SEAT);
+    tracker.refreshClaimedVision(4, 4);
+    BOOST_CHECK(!listener.hasVision(4, 4, 2));
+    BOOST_CHECK(!listener.hasVision(4, 5, 2));
+    BOOST_CHECK(listener.mSeatsTiles.size() == 4);
+
+    // Clearing the tracker drops the vision sources without notifying
+    uint32_t nbChanges = listener.mNbChanges;
+    tracker.clear();
+    BOOST_CHECK(!tracker.isTracking());
+    BOOST_CHECK(tracker.getNbVisionSources(0, 0, 1) == 0);
+    BOOST_CHECK(listener.mNbChanges == nbChanges);
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/WorkerPool.h"
+
+#define BOOST_TEST_MODULE WorkerPool
+#include "BoostTestTargetConfig.h"
+
+#include <atomic>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_WorkerPoolRunsEachTaskOnce)
+{
+    for(uint32_t nbWorkers : {0u, 1u, 3u, 7u})
+    {
+        WorkerPool pool(nbWorkers);
+        BOOST_CHECK(pool.getNbWorkers() == nbWorkers);
+
+        // The same pool is used for several loops of various sizes, as the server does for each turn
+        for(uint32_t nbTasks : {0u, 1u, 2u, 5u, 100u, 1000u})
+        {
+            std::vector<std::atomic<uint32_t>> counts(nbTasks);
+            for(std::atomic<uint32_t>& count : counts)
+                count = 0;
+
+            pool.parallelFor(nbTasks, [&counts](uint32_t index)
+            {
+                ++counts[index];
+            });
+
+            for(uint32_t i = 0; i < nbTasks; ++i)
+                BOOST_CHECK(counts[i] == 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_WorkerPoolSameResultAsSerial)
+{
+    // Each task writes its own slot so the result should not depend on the number of threads
+    const uint32_t nbTasks = 5000;
+    std::vector<uint64_t> expected(nbTasks);
+    for(uint32_t i = 0; i < nbTasks; ++i)
+        expected[i] = static_cast<uint64_t>(i) * i + 7;
+
+    WorkerPool pool(4);
+    std::vector<uint64_t> results(nbTasks, 0);
+    pool.parallelFor(nbTasks, [&results](uint32_t index)
+    {
+        results[index] = static_cast<uint64_t>(index) * index + 7;
+    });
+    BOOST_CHECK(results == expected);
+}
@@ -248,6 +248,8 @@ void Trap::activate(Tile* tile)
     trapTileData->setActivated(true);
     trapTileData->setNbShootsBeforeDeactivation(mNbShootsBeforeDeactivation);
     trapTileData->setReloadTime(0);
+    // Some traps (like doors) change passability when activated
+    getGameMap()->tilePassabilityChanged(*tile);
 
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
@@ -263,6 +265,7 @@ void Trap::deactivate(Tile* tile)
 
     TrapTileData* trapTileData = static_cast<TrapTileData*>(mTileData[tile]);
     trapTileData->setActivated(false);
+    getGameMap()->tilePassabilityChanged(*tile);
 
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
@@ -646,7 +649,7 @@ void Trap::fireTrapSound(Tile& tile, const std::string& soundFamily)
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        ServerNotification *serverNotification = new ServerNotification(
+        ServerNotification *serverNotification = ServerNotification::acquire(
             ServerNotificationType::playSpatialSound, seat->getPlayer());
         serverNotification->mPacket << sound << tile.getX() << tile.getY();
         ODServer::getSingleton().queueServerNotification(serverNotification);
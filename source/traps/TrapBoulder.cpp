@@ -24,7 +24,7 @@
 #include "gamemap/GameMap.h"
 #include "network/ODPacket.h"
 #include "traps/TrapManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Random.h"
 #include "utils/LogManager.h"
 
@@ -32,6 +32,13 @@ const std::string TrapBoulderName = "Boulder";
 const std::string TrapBoulderNameDisplay = "Boulder trap";
 const TrapType TrapBoulder::mTrapType = TrapType::boulder;
 
+const ConfigParam<int32_t> TrapBoulderCostPerTile(ConfigParamFile::traps, "BoulderCostPerTile");
+const ConfigParam<double> TrapBoulderDamagePerHitMax(ConfigParamFile::traps, "BoulderDamagePerHitMax");
+const ConfigParam<double> TrapBoulderDamagePerHitMin(ConfigParamFile::traps, "BoulderDamagePerHitMin");
+const ConfigParam<uint32_t> TrapBoulderNbShootsBeforeDeactivation(ConfigParamFile::traps, "BoulderNbShootsBeforeDeactivation");
+const ConfigParam<uint32_t> TrapBoulderReloadTurns(ConfigParamFile::traps, "BoulderReloadTurns");
+const ConfigParam<double> TrapBoulderSpeed(ConfigParamFile::traps, "BoulderSpeed");
+
 namespace
 {
 class TrapBoulderFactory : public TrapFactory
@@ -46,7 +53,7 @@ class TrapBoulderFactory : public TrapFactory
     { return TrapBoulderNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("BoulderCostPerTile"); }
+    { return TrapBoulderCostPerTile.get(); }
 
     const std::string& getMeshName() const override
     {
@@ -114,10 +121,10 @@ static TrapRegister reg(new TrapBoulderFactory);
 TrapBoulder::TrapBoulder(GameMap* gameMap) :
     Trap(gameMap)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("BoulderReloadTurns");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("BoulderDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("BoulderDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("BoulderNbShootsBeforeDeactivation");
+    mReloadTime = TrapBoulderReloadTurns.get();
+    mMinDamage = TrapBoulderDamagePerHitMin.get();
+    mMaxDamage = TrapBoulderDamagePerHitMax.get();
+    mNbShootsBeforeDeactivation = TrapBoulderNbShootsBeforeDeactivation.get();
     setMeshName("");
 }
 
@@ -150,7 +157,7 @@ bool TrapBoulder::shoot(Tile* tile)
     position.z = 0;
     direction.normalise();
     MissileBoulder* missile = new MissileBoulder(getGameMap(), getSeat(), getName(), "Boulder",
-        direction, ConfigManager::getSingleton().getTrapConfigDouble("BoulderSpeed"),
+        direction, TrapBoulderSpeed.get(),
         Random::Double(mMinDamage, mMaxDamage), nullptr, true);
     missile->addToGameMap();
     missile->createMesh();
@@ -25,7 +25,7 @@
 #include "network/ODPacket.h"
 #include "sound/SoundEffectsManager.h"
 #include "traps/TrapManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Random.h"
 #include "utils/LogManager.h"
 
@@ -33,6 +33,17 @@ const std::string TrapCannonName = "Cannon";
 const std::string TrapCannonNameDisplay = "Cannon trap";
 const TrapType TrapCannon::mTrapType = TrapType::cannon;
 
+const ConfigParam<int32_t> TrapCannonCostPerTile(ConfigParamFile::traps, "CannonCostPerTile");
+const ConfigParam<double> TrapCannonDamagePerHitMax(ConfigParamFile::traps, "CannonDamagePerHitMax");
+const ConfigParam<double> TrapCannonDamagePerHitMin(ConfigParamFile::traps, "CannonDamagePerHitMin");
+const ConfigParam<double> TrapCannonEleDef(ConfigParamFile::traps, "CannonEleDef");
+const ConfigParam<double> TrapCannonMagDef(ConfigParamFile::traps, "CannonMagDef");
+const ConfigParam<uint32_t> TrapCannonNbShootsBeforeDeactivation(ConfigParamFile::traps, "CannonNbShootsBeforeDeactivation");
+const ConfigParam<double> TrapCannonPhyDef(ConfigParamFile::traps, "CannonPhyDef");
+const ConfigParam<uint32_t> TrapCannonRange(ConfigParamFile::traps, "CannonRange");
+const ConfigParam<uint32_t> TrapCannonReloadTurns(ConfigParamFile::traps, "CannonReloadTurns");
+const ConfigParam<double> TrapCannonSpeed(ConfigParamFile::traps, "CannonSpeed");
+
 namespace
 {
 class TrapCannonFactory : public TrapFactory
@@ -47,7 +58,7 @@ class TrapCannonFactory : public TrapFactory
     { return TrapCannonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("CannonCostPerTile"); }
+    { return TrapCannonCostPerTile.get(); }
 
     const std::string& getMeshName() const override
     {
@@ -118,11 +129,11 @@ TrapCannon::TrapCannon(GameMap* gameMap) :
     Trap(gameMap),
     mRange(0)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("CannonReloadTurns");
-    mRange = ConfigManager::getSingleton().getTrapConfigUInt32("CannonRange");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("CannonNbShootsBeforeDeactivation");
+    mReloadTime = TrapCannonReloadTurns.get();
+    mRange = TrapCannonRange.get();
+    mMinDamage = TrapCannonDamagePerHitMin.get();
+    mMaxDamage = TrapCannonDamagePerHitMax.get();
+    mNbShootsBeforeDeactivation = TrapCannonNbShootsBeforeDeactivation.get();
     setMeshName("");
 }
 
@@ -149,7 +160,7 @@ bool TrapCannon::shoot(Tile* tile)
     direction = direction - position;
     direction.normalise();
     MissileOneHit* missile = new MissileOneHit(getGameMap(), getSeat(), getName(), "Cannonball",
-        "", direction, ConfigManager::getSingleton().getTrapConfigDouble("CannonSpeed"),
+        "", direction, TrapCannonSpeed.get(),
         Random::Double(mMinDamage, mMaxDamage), 0.0, 0.0, nullptr, false, false, true);
     missile->addToGameMap();
     missile->createMesh();
@@ -171,15 +182,15 @@ TrapEntity* TrapCannon::getTrapEntity(Tile* tile)
 
 double TrapCannon::getPhysicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonPhyDef");
+    return TrapCannonPhyDef.get();
 }
 
 double TrapCannon::getMagicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonMagDef");
+    return TrapCannonMagDef.get();
 }
 
 double TrapCannon::getElementDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonEleDef");
+    return TrapCannonEleDef.get();
 }
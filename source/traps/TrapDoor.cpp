@@ -31,7 +31,7 @@
 #include "modes/InputManager.h"
 #include "network/ODClient.h"
 #include "traps/TrapManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/Random.h"
 #include "utils/LogManager.h"
@@ -40,6 +40,8 @@ const std::string TrapDoorName = "DoorWooden";
 const std::string TrapDoorNameDisplay = "Wooden door";
 const TrapType TrapDoor::mTrapType = TrapType::doorWooden;
 
+const ConfigParam<int32_t> TrapWoodenDoorCostPerTile(ConfigParamFile::traps, "WoodenDoorCostPerTile");
+
 namespace
 {
 class TrapDoorFactory : public TrapFactory
@@ -54,7 +56,7 @@ class TrapDoorFactory : public TrapFactory
     { return TrapDoorNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("WoodenDoorCostPerTile"); }
+    { return TrapWoodenDoorCostPerTile.get(); }
 
     const std::string& getMeshName() const override
     {
@@ -311,6 +313,10 @@ TrapEntity* TrapDoor::getTrapEntity(Tile* tile)
 
 void TrapDoor::doUpkeep()
 {
+    // The state is updated before changing the doors because the tiles read it (see permitsVision)
+    // when their opacity is refreshed
+    bool isStateChanged = (mIsLockedState != mIsLocked);
+    mIsLockedState = mIsLocked;
     for(Tile* tile : mCoveredTiles)
     {
         if(!canDoorBeOnTile(getGameMap(), tile))
@@ -330,33 +336,15 @@ void TrapDoor::doUpkeep()
         // from covered tiles
         if (mTileData[tile]->mHP <= 0.0)
             getGameMap()->doorLock(tile, getSeat(), false);
-        else if(mIsLockedState != mIsLocked)
+        else if(isStateChanged)
         {
-            RenderedMovableEntity* entity = getBuildingObjectFromTile(tile);
-            if(entity == nullptr)
-            {
-                OD_LOG_ERR("nullptr entity trap=" + getName() + ", tile=" + Tile::displayAsString(tile));
+            DoorEntity* doorEntity = getDoorEntity(tile);
+            if(doorEntity == nullptr)
                 continue;
-            }
 
-            if(entity->getObjectType() != GameEntityType::trapEntity)
-            {
-                OD_LOG_ERR("wrong entity type trap=" + getName() + ", tile=" + Tile::displayAsString(tile) + ", entity=" + entity->getName());
-                continue;
-            }
-
-            TrapEntity* trapEntity = static_cast<TrapEntity*>(entity);
-            if(trapEntity->getTrapEntityType() != TrapEntityType::doorEntity)
-            {
-                OD_LOG_ERR("wrong entity type trap=" + getName() + ", tile=" + Tile::displayAsString(tile) + ", entity=" + entity->getName());
-                continue;
-            }
-
-            DoorEntity* doorEntity = static_cast<DoorEntity*>(entity);
             changeDoorState(doorEntity, tile, mIsLocked);
         }
     }
-    mIsLockedState = mIsLocked;
 
     Trap::doUpkeep();
 }
@@ -364,9 +352,33 @@ void TrapDoor::doUpkeep()
 void TrapDoor::notifyDoorSlapped(DoorEntity* doorEntity, Tile* tile)
 {
     mIsLocked = !mIsLocked;
+    mIsLockedState = mIsLocked;
     changeDoorState(doorEntity, tile, mIsLocked);
+}
 
-    mIsLockedState = mIsLocked;
+DoorEntity* TrapDoor::getDoorEntity(Tile* tile)
+{
+    RenderedMovableEntity* entity = getBuildingObjectFromTile(tile);
+    if(entity == nullptr)
+    {
+        OD_LOG_ERR("nullptr entity trap=" + getName() + ", tile=" + Tile::displayAsString(tile));
+        return nullptr;
+    }
+
+    if(entity->getObjectType() != GameEntityType::trapEntity)
+    {
+        OD_LOG_ERR("wrong entity type trap=" + getName() + ", tile=" + Tile::displayAsString(tile) + ", entity=" + entity->getName());
+        return nullptr;
+    }
+
+    TrapEntity* trapEntity = static_cast<TrapEntity*>(entity);
+    if(trapEntity->getTrapEntityType() != TrapEntityType::doorEntity)
+    {
+        OD_LOG_ERR("wrong entity type trap=" + getName() + ", tile=" + Tile::displayAsString(tile) + ", entity=" + entity->getName());
+        return nullptr;
+    }
+
+    return static_cast<DoorEntity*>(entity);
 }
 
 void TrapDoor::changeDoorState(DoorEntity* doorEntity, Tile* tile, bool locked)
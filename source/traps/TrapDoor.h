@@ -53,6 +53,9 @@ public:
 
     void notifyDoorSlapped(DoorEntity* doorEntity, Tile* tile);
 
+    //! \brief Returns the door entity on the given tile or nullptr (and logs an error) if there is none
+    DoorEntity* getDoorEntity(Tile* tile);
+
     TrapEntity* getTrapEntity(Tile* tile) override;
 
     double getCreatureSpeed(const Creature* creature, Tile* tile) const override;
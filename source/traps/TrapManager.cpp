@@ -30,10 +30,15 @@
 #include "network/ServerNotification.h"
 #include "traps/Trap.h"
 #include "traps/TrapType.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
+const ConfigParam<int32_t> TrapBoulderWorkshopPointsPerTile(ConfigParamFile::traps, "BoulderWorkshopPointsPerTile");
+const ConfigParam<int32_t> TrapCannonWorkshopPointsPerTile(ConfigParamFile::traps, "CannonWorkshopPointsPerTile");
+const ConfigParam<int32_t> TrapSpikeWorkshopPointsPerTile(ConfigParamFile::traps, "SpikeWorkshopPointsPerTile");
+const ConfigParam<int32_t> TrapWoodenDoorPointsPerTile(ConfigParamFile::traps, "WoodenDoorPointsPerTile");
+
 static const std::string EMPTY_STRING;
 
 namespace
@@ -170,16 +175,12 @@ bool TrapFactory::buildTrapDefault(GameMap* gameMap, Trap* trap, Seat* seat, con
 
         for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
         {
-            uint32_t nbTiles = p.second.size();
             ServerNotification serverNotification(
                 ServerNotificationType::refreshTiles, p.first->getPlayer());
-            serverNotification.mPacket << nbTiles;
             for(Tile* tile : p.second)
-            {
-                gameMap->tileToPacket(serverNotification.mPacket, tile);
                 p.first->updateTileStateForSeat(tile, false);
-                tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-            }
+
+            p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
             ODServer::getSingleton().sendAsyncMsg(serverNotification);
         }
     }
@@ -603,16 +604,12 @@ void TrapManager::sellTrapTiles(GameMap* gameMap, Seat* seatSell, ODPacket& pack
 
     for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
     {
-        uint32_t nbTiles = p.second.size();
         ServerNotification serverNotification(
             ServerNotificationType::refreshTiles, p.first->getPlayer());
-        serverNotification.mPacket << nbTiles;
         for(Tile* tile : p.second)
-        {
-            gameMap->tileToPacket(serverNotification.mPacket, tile);
             p.first->updateTileStateForSeat(tile, false);
-            tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-        }
+
+        p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
         ODServer::getSingleton().sendAsyncMsg(serverNotification);
     }
 
@@ -717,16 +714,12 @@ void TrapManager::sellTrapTilesEditor(GameMap* gameMap, ODPacket& packet)
 
     for(const std::pair<Seat* const,std::vector<Tile*>>& p : tilesPerSeat)
     {
-        uint32_t nbTiles = p.second.size();
         ServerNotification serverNotification(
             ServerNotificationType::refreshTiles, p.first->getPlayer());
-        serverNotification.mPacket << nbTiles;
         for(Tile* tile : p.second)
-        {
-            gameMap->tileToPacket(serverNotification.mPacket, tile);
             p.first->updateTileStateForSeat(tile, false);
-            tile->exportToPacketForUpdate(serverNotification.mPacket, p.first);
-        }
+
+        p.first->exportTilesToPacket(serverNotification.mPacket, p.second, false);
         ODServer::getSingleton().sendAsyncMsg(serverNotification);
     }
 
@@ -784,13 +777,13 @@ int32_t TrapManager::getNeededWorkshopPointsPerTrap(TrapType trapType)
         case TrapType::nullTrapType:
             return 0;
         case TrapType::cannon:
-            return ConfigManager::getSingleton().getTrapConfigInt32("CannonWorkshopPointsPerTile");
+            return TrapCannonWorkshopPointsPerTile.get();
         case TrapType::spike:
-            return ConfigManager::getSingleton().getTrapConfigInt32("SpikeWorkshopPointsPerTile");
+            return TrapSpikeWorkshopPointsPerTile.get();
         case TrapType::boulder:
-            return ConfigManager::getSingleton().getTrapConfigInt32("BoulderWorkshopPointsPerTile");
+            return TrapBoulderWorkshopPointsPerTile.get();
         case TrapType::doorWooden:
-            return ConfigManager::getSingleton().getTrapConfigInt32("WoodenDoorPointsPerTile");
+            return TrapWoodenDoorPointsPerTile.get();
         default:
             OD_LOG_ERR("Asked for wrong trap type=" + getTrapNameFromTrapType(trapType));
             break;
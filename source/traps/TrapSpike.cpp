@@ -23,7 +23,7 @@
 #include "game/Player.h"
 #include "gamemap/GameMap.h"
 #include "traps/TrapManager.h"
-#include "utils/ConfigManager.h"
+#include "utils/ConfigParam.h"
 #include "utils/Random.h"
 #include "utils/LogManager.h"
 
@@ -31,6 +31,12 @@ const std::string TrapSpikeName = "Spike";
 const std::string TrapSpikeNameDisplay = "Spike trap";
 const TrapType TrapSpike::mTrapType = TrapType::spike;
 
+const ConfigParam<int32_t> TrapSpikeCostPerTile(ConfigParamFile::traps, "SpikeCostPerTile");
+const ConfigParam<double> TrapSpikeDamagePerHitMax(ConfigParamFile::traps, "SpikeDamagePerHitMax");
+const ConfigParam<double> TrapSpikeDamagePerHitMin(ConfigParamFile::traps, "SpikeDamagePerHitMin");
+const ConfigParam<uint32_t> TrapSpikeNbShootsBeforeDeactivation(ConfigParamFile::traps, "SpikeNbShootsBeforeDeactivation");
+const ConfigParam<uint32_t> TrapSpikeReloadTurns(ConfigParamFile::traps, "SpikeReloadTurns");
+
 namespace
 {
 class TrapSpikeFactory : public TrapFactory
@@ -45,7 +51,7 @@ class TrapSpikeFactory : public TrapFactory
     { return TrapSpikeNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("SpikeCostPerTile"); }
+    { return TrapSpikeCostPerTile.get(); }
 
     const std::string& getMeshName() const override
     {
@@ -113,10 +119,10 @@ static TrapRegister reg(new TrapSpikeFactory);
 TrapSpike::TrapSpike(GameMap* gameMap) :
     Trap(gameMap)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("SpikeReloadTurns");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("SpikeDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("SpikeDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("SpikeNbShootsBeforeDeactivation");
+    mReloadTime = TrapSpikeReloadTurns.get();
+    mMinDamage = TrapSpikeDamagePerHitMin.get();
+    mMaxDamage = TrapSpikeDamagePerHitMax.get();
+    mNbShootsBeforeDeactivation = TrapSpikeNbShootsBeforeDeactivation.get();
     setMeshName("");
 }
 
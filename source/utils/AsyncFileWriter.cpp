@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/AsyncFileWriter.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+AsyncFileWriter::AsyncFileWriter() :
+    mNbQueued(0),
+    mNbWritten(0),
+    mStop(false),
+    mThread(&AsyncFileWriter::run, this)
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondQueued.notify_one();
+    mThread.join();
+}
+
+void AsyncFileWriter::write(const std::string& fileName, std::string content)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRequests.push_back(Request());
+    Request& request = mRequests.back();
+    request.mFileName = fileName;
+    request.mContent.swap(content);
+    ++mNbQueued;
+    mCondQueued.notify_one();
+}
+
+void AsyncFileWriter::write(const std::string& fileName, std::function<bool(std::string&)> contentWriter)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRequests.push_back(Request());
+    Request& request = mRequests.back();
+    request.mFileName = fileName;
+    request.mContentWriter.swap(contentWriter);
+    ++mNbQueued;
+    mCondQueued.notify_one();
+}
+
+std::vector<AsyncFileWriter::Result> AsyncFileWriter::popResults()
+{
+    std::vector<Result> results;
+    std::lock_guard<std::mutex> lock(mMutex);
+    results.swap(mResults);
+    return results;
+}
+
+void AsyncFileWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    uint64_t fileIndex = mNbQueued;
+    mCondWritten.wait(lock, [this, fileIndex]() { return mNbWritten >= fileIndex; });
+}
+
+bool AsyncFileWriter::writeFile(const std::string& fileName, const std::string& content)
+{
+    std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream file(tmpFileName.c_str(), std::ofstream::out | std::ofstream::binary);
+        if(!file.good())
+            return false;
+
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        file.close();
+        if(file.fail())
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpFileName, ec);
+            return false;
+        }
+    }
+
+    // If the file exists, we make a backup. The file is linked (or copied if the file system does not allow it)
+    // instead of being renamed so that it exists until the new one replaces it with a single rename
+    boost::system::error_code ec;
+    if(boost::filesystem::exists(fileName, ec))
+    {
+        std::string bakFileName = fileName + ".bak";
+        boost::filesystem::remove(bakFileName, ec);
+        boost::filesystem::create_hard_link(fileName, bakFileName, ec);
+        if(ec)
+        {
+            ec.clear();
+            boost::filesystem::copy_file(fileName, bakFileName, ec);
+        }
+        if(ec)
+        {
+            boost::filesystem::remove(tmpFileName, ec);
+            return false;
+        }
+    }
+
+    boost::filesystem::rename(tmpFileName, fileName, ec);
+    return !ec;
+}
+
+void AsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while(true)
+    {
+        mCondQueued.wait(lock, [this]() { return mStop || !mRequests.empty(); });
+        // We write all the pending files before stopping
+        if(mRequests.empty())
+            return;
+
+        Request request;
+        request.mFileName.swap(mRequests.front().mFileName);
+        request.mContent.swap(mRequests.front().mContent);
+        request.mContentWriter.swap(mRequests.front().mContentWriter);
+        mRequests.pop_front();
+
+        lock.unlock();
+        Result result;
+        result.mFileName = request.mFileName;
+        result.mSuccess = (!request.mContentWriter || request.mContentWriter(request.mContent)) &&
+            writeFile(request.mFileName, request.mContent);
+        lock.lock();
+
+        mResults.push_back(result);
+        ++mNbWritten;
+        mCondWritten.notify_all();
+    }
+}
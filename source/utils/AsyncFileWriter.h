@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ASYNCFILEWRITER_H_
+#define _ASYNCFILEWRITER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! \brief Writes files from its own thread.
+ *
+ * The content is built in memory by the calling thread which does not wait for the disk. It can also
+ * be built by the thread from data copied by the calling thread. Each file
+ * is written next to its final name then renamed so that a file being written is never seen
+ * truncated. If a file with the same name exists, it is kept with the ".bak" extension and stays in place
+ * until the new one replaces it.
+ * The results are collected by the calling thread with popResults.
+ */
+class AsyncFileWriter
+{
+public:
+    struct Result
+    {
+        std::string mFileName;
+        bool mSuccess;
+    };
+
+    AsyncFileWriter();
+    //! \brief Writes the pending files before returning
+    ~AsyncFileWriter();
+
+    //! \brief Queues the given content to be written in the given file
+    void write(const std::string& fileName, std::string content);
+
+    //! \brief Queues a file whose content is built by contentWriter from the thread. If contentWriter returns
+    //! false, the file is not written and the result is a failure. contentWriter should only use data it owns
+    void write(const std::string& fileName, std::function<bool(std::string&)> contentWriter);
+
+    //! \brief Returns the results of the files written since the last call
+    std::vector<Result> popResults();
+
+    //! \brief Waits until every file given to write has been written
+    void flush();
+
+    //! \brief Writes the content in the given file the way the thread does. Returns true on success
+    static bool writeFile(const std::string& fileName, const std::string& content);
+
+private:
+    struct Request
+    {
+        std::string mFileName;
+        std::string mContent;
+        //! \brief If set, builds mContent before it is written
+        std::function<bool(std::string&)> mContentWriter;
+    };
+
+    void run();
+
+    std::deque<Request> mRequests;
+    std::vector<Result> mResults;
+    //! \brief Number of files queued and written since the beginning. Used to wait for the pending ones
+    uint64_t mNbQueued;
+    uint64_t mNbWritten;
+    bool mStop;
+
+    std::mutex mMutex;
+    std::condition_variable mCondQueued;
+    std::condition_variable mCondWritten;
+    std::thread mThread;
+};
+
+#endif // _ASYNCFILEWRITER_H_
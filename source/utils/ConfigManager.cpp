@@ -23,6 +23,7 @@
 #include "game/Skill.h"
 #include "gamemap/TileSet.h"
 #include "spawnconditions/SpawnCondition.h"
+#include "utils/ConfigParam.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
@@ -42,6 +43,7 @@ template<> ConfigManager* Ogre::Singleton<ConfigManager>::msSingleton = nullptr;
 
 ConfigManager::ConfigManager(const std::string& configPath, const std::string& userConfigPath,
         const std::string& soundPath) :
+    mConfigPath(configPath),
     mNetworkPort(0),
     mClientConnectionTimeout(5000),
     mBaseSpawnPoint(10),
@@ -171,6 +173,15 @@ ConfigManager::~ConfigManager()
     mTileSets.clear();
 }
 
+bool ConfigManager::reloadRoomsTrapsSpells()
+{
+    // We load every file even if one fails to report all the errors at once
+    bool isOk = loadRooms(mConfigPath + mFilenameRooms);
+    isOk = loadTraps(mConfigPath + mFilenameTraps) && isOk;
+    isOk = loadSpellConfig(mConfigPath + mFilenameSpells) && isOk;
+    return isOk;
+}
+
 bool ConfigManager::loadGlobalConfig(const std::string& configPath)
 {
     std::stringstream configFile;
@@ -927,6 +938,7 @@ bool ConfigManager::loadRooms(const std::string& fileName)
         return false;
     }
 
+    std::map<const std::string, std::string> values;
     std::string nextParam;
     // Read in the creature class descriptions
     defFile >> nextParam;
@@ -944,10 +956,10 @@ bool ConfigManager::loadRooms(const std::string& fileName)
         if (nextParam == "[/Rooms]")
             break;
 
-        defFile >> mRoomsConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    return ConfigParamBase::loadParams(ConfigParamFile::rooms, values, fileName);
 }
 
 bool ConfigManager::loadTraps(const std::string& fileName)
@@ -960,6 +972,7 @@ bool ConfigManager::loadTraps(const std::string& fileName)
         return false;
     }
 
+    std::map<const std::string, std::string> values;
     std::string nextParam;
     // Read in the creature class descriptions
     defFile >> nextParam;
@@ -977,10 +990,10 @@ bool ConfigManager::loadTraps(const std::string& fileName)
         if (nextParam == "[/Traps]")
             break;
 
-        defFile >> mTrapsConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    return ConfigParamBase::loadParams(ConfigParamFile::traps, values, fileName);
 }
 
 bool ConfigManager::loadSpellConfig(const std::string& fileName)
@@ -993,6 +1006,7 @@ bool ConfigManager::loadSpellConfig(const std::string& fileName)
         return false;
     }
 
+    std::map<const std::string, std::string> values;
     std::string nextParam;
     // Read in the creature class descriptions
     defFile >> nextParam;
@@ -1010,10 +1024,10 @@ bool ConfigManager::loadSpellConfig(const std::string& fileName)
         if (nextParam == "[/Spells]")
             break;
 
-        defFile >> mSpellConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    return ConfigParamBase::loadParams(ConfigParamFile::spells, values, fileName);
 }
 
 bool ConfigManager::loadSkills(const std::string& fileName)
@@ -1372,150 +1386,6 @@ const std::string ConfigManager::getUserValue(Config::Ctg category,
     return it->second;
 }
 
-const std::string& ConfigManager::getRoomConfigString(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getRoomConfigUInt32(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getRoomConfigInt32(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getRoomConfigDouble(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getTrapConfigString(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getTrapConfigUInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getTrapConfigInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getTrapConfigDouble(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getSpellConfigString(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getSpellConfigUInt32(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getSpellConfigInt32(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getSpellConfigDouble(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
 int32_t ConfigManager::getSkillPoints(const std::string& res) const
 {
     auto it = mSkillPoints.find(res);
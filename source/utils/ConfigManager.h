@@ -62,6 +62,7 @@ const std::string NICKNAME = "Nickname";
 const std::string KEEPERVOICE = "KeeperVoice";
 const std::string MINIMAP_TYPE = "MinimapType";
 const std::string LIGHT_FACTOR = "LightFactor";
+const std::string NETWORK_COMPRESSION = "NetworkCompression";
 }
 
 //! \brief This class is used to manage global configuration such as network configuration, global creature stats, ...
@@ -174,23 +175,10 @@ public:
     inline const std::vector<std::string>& getFactions() const
     { return mFactions; }
 
-    //! Rooms configuration
-    const std::string& getRoomConfigString(const std::string& param) const;
-    uint32_t getRoomConfigUInt32(const std::string& param) const;
-    int32_t getRoomConfigInt32(const std::string& param) const;
-    double getRoomConfigDouble(const std::string& param) const;
-
-    //! Traps configuration
-    const std::string& getTrapConfigString(const std::string& param) const;
-    uint32_t getTrapConfigUInt32(const std::string& param) const;
-    int32_t getTrapConfigInt32(const std::string& param) const;
-    double getTrapConfigDouble(const std::string& param) const;
-
-    //! Spells configuration
-    const std::string& getSpellConfigString(const std::string& param) const;
-    uint32_t getSpellConfigUInt32(const std::string& param) const;
-    int32_t getSpellConfigInt32(const std::string& param) const;
-    double getSpellConfigDouble(const std::string& param) const;
+    /*! \brief Reloads rooms.cfg, traps.cfg and spells.cfg. The typed parameters (see ConfigParam) get
+     * the new values. Returns false if one of the files is not valid
+     */
+    bool reloadRoomsTrapsSpells();
 
     int32_t getSkillPoints(const std::string& res) const;
 
@@ -286,6 +274,7 @@ private:
     std::string mFilenameSkills;
     std::string mFilenameTilesets;
     std::string mFilenameUserCfg;
+    std::string mConfigPath;
     uint32_t mNetworkPort;
     uint32_t mClientConnectionTimeout;
     uint32_t mBaseSpawnPoint;
@@ -317,9 +306,6 @@ private:
     std::map<const std::string, std::string> mFactionDefaultWorkerClass;
 
     std::vector<std::string> mFactions;
-    std::map<const std::string, std::string> mRoomsConfig;
-    std::map<const std::string, std::string> mTrapsConfig;
-    std::map<const std::string, std::string> mSpellConfig;
     std::map<const std::string, int32_t> mSkillPoints;
 
     //! \brief Default definition for the editor. At map loading, it will spawn a creature from
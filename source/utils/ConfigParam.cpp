@@ -0,0 +1,140 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ConfigParam.h"
+
+#include "utils/LogManager.h"
+
+#include <algorithm>
+#include <locale>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    //! \brief Parameters declared so far. As they are declared as global constants, we cannot
+    //! rely on the initialization order of a global vector
+    std::vector<ConfigParamBase*>& getParams()
+    {
+        static std::vector<ConfigParamBase*> params;
+        return params;
+    }
+
+    const char* getFileName(ConfigParamFile file)
+    {
+        switch(file)
+        {
+            case ConfigParamFile::rooms:
+                return "rooms";
+            case ConfigParamFile::traps:
+                return "traps";
+            case ConfigParamFile::spells:
+                return "spells";
+            default:
+                return "unknown";
+        }
+    }
+
+    //! \brief Parses the whole string as a number. The decimal separator does not depend on the locale
+    template<typename T>
+    bool parseNumber(const std::string& str, T& value)
+    {
+        std::istringstream ss(str);
+        ss.imbue(std::locale::classic());
+        T number;
+        if(!(ss >> number) || !ss.eof())
+            return false;
+
+        value = number;
+        return true;
+    }
+}
+
+ConfigParamBase::ConfigParamBase(ConfigParamFile file, const std::string& name) :
+    mFile(file),
+    mName(name)
+{
+    getParams().push_back(this);
+}
+
+ConfigParamBase::~ConfigParamBase()
+{
+    std::vector<ConfigParamBase*>& params = getParams();
+    params.erase(std::remove(params.begin(), params.end(), this), params.end());
+}
+
+bool ConfigParamBase::loadParams(ConfigParamFile file, const std::map<const std::string, std::string>& values,
+    const std::string& fileName)
+{
+    bool isOk = true;
+    std::set<std::string> usedValues;
+    for(ConfigParamBase* param : getParams())
+    {
+        if(param->getFile() != file)
+            continue;
+
+        auto it = values.find(param->getName());
+        if(it == values.end())
+        {
+            OD_LOG_ERR("Missing " + std::string(getFileName(file)) + " parameter " + param->getName() + " in " + fileName);
+            isOk = false;
+            continue;
+        }
+
+        usedValues.insert(it->first);
+        if(!param->parse(it->second))
+        {
+            OD_LOG_ERR("Invalid value for " + std::string(getFileName(file)) + " parameter " + param->getName()
+                + "=" + it->second + " in " + fileName);
+            isOk = false;
+        }
+    }
+
+    for(const std::pair<const std::string, std::string>& value : values)
+    {
+        if(usedValues.count(value.first) == 0)
+            OD_LOG_WRN("Unused " + std::string(getFileName(file)) + " parameter " + value.first + " in " + fileName);
+    }
+
+    return isOk;
+}
+
+bool parseConfigParam(const std::string& str, std::string& value)
+{
+    value = str;
+    return true;
+}
+
+bool parseConfigParam(const std::string& str, int32_t& value)
+{
+    return parseNumber(str, value);
+}
+
+bool parseConfigParam(const std::string& str, uint32_t& value)
+{
+    // Streams accept negative numbers for unsigned types
+    if(!str.empty() && (str[0] == '-'))
+        return false;
+
+    return parseNumber(str, value);
+}
+
+bool parseConfigParam(const std::string& str, double& value)
+{
+    return parseNumber(str, value);
+}
@@ -0,0 +1,98 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIGPARAM_H
+#define CONFIGPARAM_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+//! \brief Configuration files containing parameters read through ConfigParam
+enum class ConfigParamFile
+{
+    rooms,
+    traps,
+    spells
+};
+
+/*! \brief Base class of the typed parameters of rooms.cfg, traps.cfg and spells.cfg.
+ *
+ * The parameters are declared as constants where they are used. They register themselves so that
+ * ConfigManager can give them their value when it loads the file: the values are parsed once and
+ * reading a parameter does not need any lookup. A parameter missing from the file (or with a value that
+ * cannot be parsed) is an error while loading the file. Values from the file not used by any parameter are logged.
+ */
+class ConfigParamBase
+{
+public:
+    virtual ~ConfigParamBase();
+
+    inline ConfigParamFile getFile() const
+    { return mFile; }
+
+    inline const std::string& getName() const
+    { return mName; }
+
+    /*! \brief Sets the value of every parameter of the given file from the given values (param name -> value).
+     * Returns false if a parameter is missing or cannot be parsed. Can be called again to reload the file.
+     */
+    static bool loadParams(ConfigParamFile file, const std::map<const std::string, std::string>& values,
+        const std::string& fileName);
+
+protected:
+    ConfigParamBase(ConfigParamFile file, const std::string& name);
+
+    //! \brief Parses the value read from the file. Returns false if it is not valid
+    virtual bool parse(const std::string& value) const = 0;
+
+private:
+    ConfigParamBase(const ConfigParamBase&) = delete;
+    ConfigParamBase& operator=(const ConfigParamBase&) = delete;
+
+    ConfigParamFile mFile;
+    std::string mName;
+};
+
+//! \brief Functions used to parse the parameters depending on their type
+bool parseConfigParam(const std::string& str, std::string& value);
+bool parseConfigParam(const std::string& str, int32_t& value);
+bool parseConfigParam(const std::string& str, uint32_t& value);
+bool parseConfigParam(const std::string& str, double& value);
+
+template<typename T>
+class ConfigParam : public ConfigParamBase
+{
+public:
+    ConfigParam(ConfigParamFile file, const std::string& name) :
+        ConfigParamBase(file, name),
+        mValue()
+    {}
+
+    inline const T& get() const
+    { return mValue; }
+
+protected:
+    bool parse(const std::string& value) const override
+    { return parseConfigParam(value, mValue); }
+
+private:
+    //! \brief The parameters are declared as constants but their value is set when the file is loaded
+    mutable T mValue;
+};
+
+#endif // CONFIGPARAM_H
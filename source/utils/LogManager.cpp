@@ -17,19 +17,58 @@
 
 #include "utils/LogManager.h"
 
-#include <boost/filesystem.hpp>
-
-#include <iomanip>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <map>
 
 template<> LogManager* Ogre::Singleton<LogManager>::msSingleton = nullptr;
 
 //! \brief Log filename used when OD Application throws errors without using Ogre default logger.
 const std::string LogManager::GAMELOG_NAME = "gameLog";
 
-LogManager::LogManager()
-    : mLevel(LogMessageLevel::NORMAL)
+namespace
 {
+    //! \brief Returns the file name without the directories
+    const char* getFilename(const char* filepath)
+    {
+        const char* filename = filepath;
+        for (const char* c = filepath; *c != 0; ++c)
+        {
+            if ((*c == '/') || (*c == '\\'))
+                filename = c + 1;
+        }
+        return filename;
+    }
+
+    //! \brief Module names and ids are shared by every LogManager since the ids are cached
+    //! at the call sites. The deque keeps the references to its names valid when it grows
+    struct ModuleRegistry
+    {
+        sf::Mutex mLock;
+        std::map<std::string, uint32_t> mIds;
+        std::deque<std::string> mNames;
+    };
+
+    ModuleRegistry& getModuleRegistry()
+    {
+        static ModuleRegistry registry;
+        return registry;
+    }
+
+    const std::string& getModuleName(uint32_t moduleId)
+    {
+        ModuleRegistry& registry = getModuleRegistry();
+        sf::Lock locked(registry.mLock);
+        return registry.mNames[moduleId];
+    }
+}
 
+LogManager::LogManager()
+    : mLevel(static_cast<int>(LogMessageLevel::NORMAL))
+{
+    for (std::atomic<int>& moduleLevel : mModuleLevels)
+        moduleLevel.store(MODULE_LEVEL_UNSET);
 }
 
 LogManager::~LogManager()
@@ -39,64 +78,66 @@ LogManager::~LogManager()
 
 void LogManager::addSink(std::unique_ptr<LogSink> sink)
 {
+    sf::Lock locked(mLock);
     mSinks.push_back(std::move(sink));
 }
 
 void LogManager::setLevel(LogMessageLevel level)
 {
-    mLevel = level;
+    mLevel.store(static_cast<int>(level));
 }
 
 void LogManager::setModuleLevel(const char* module, LogMessageLevel level)
 {
-    mModuleLevel[module] = level;
+    uint32_t moduleId = getModuleId(module);
+    if (moduleId >= MAX_NB_MODULES)
+        return;
+
+    mModuleLevels[moduleId].store(static_cast<int>(level));
 }
 
-void LogManager::logMessage(LogMessageLevel level, const char* filepath, int line, const std::string& message)
+uint32_t LogManager::getModuleId(const char* filepath)
 {
-    sf::Lock locked(mLock);
-
-    // module
-
-    const boost::filesystem::path strippedPath(filepath);
-    std::string module = strippedPath.stem().string();
-
-    // Check if the message fails the global threshold.
-
-    if (mLevel > level)
-    {
-        // Allow per-module overrides of the global logging level.
-
-        if (mModuleLevel.empty())
-        {
-            return;
-        }
+    // The module is the file name without extension
+    std::string module = getFilename(filepath);
+    std::size_t dot = module.find('.');
+    if (dot != std::string::npos)
+        module.resize(dot);
+
+    ModuleRegistry& registry = getModuleRegistry();
+    sf::Lock locked(registry.mLock);
+    auto it = registry.mIds.find(module);
+    if (it != registry.mIds.end())
+        return it->second;
+
+    uint32_t moduleId = static_cast<uint32_t>(registry.mNames.size());
+    registry.mIds[module] = moduleId;
+    registry.mNames.push_back(module);
+    return moduleId;
+}
 
-        auto found = mModuleLevel.find(module);
-        if (found == mModuleLevel.end() ||
-            found->second > level)
-        {
-            return;
-        }
-    }
+void LogManager::logMessage(LogMessageLevel level, const char* filepath, int line, const std::string& message)
+{
+    uint32_t moduleId = getModuleId(filepath);
+    if (!isLogged(level, moduleId))
+        return;
 
-    // filename
+    logMessage(level, moduleId, filepath, line, message);
+}
 
-    std::string filename = strippedPath.filename().string();
+void LogManager::logMessage(LogMessageLevel level, uint32_t moduleId, const char* filepath, int line, const std::string& message)
+{
+    const std::string& module = getModuleName(moduleId);
+    std::string filename = getFilename(filepath);
 
     // timestamp
 
     time_t current_time = ::time(0);
-    struct tm* now = ::localtime(&current_time);
-
-    mTimestampStream.str("");
-    mTimestampStream
-        << std::setfill('0') << std::setw(2) << now->tm_hour << ':'
-        << std::setfill('0') << std::setw(2) << now->tm_min << ':'
-        << std::setfill('0') << std::setw(2) << now->tm_sec;
-
-    std::string timestamp = mTimestampStream.str();
+    char timestampBuffer[16];
+    std::strftime(timestampBuffer, sizeof(timestampBuffer), "%H:%M:%S", ::localtime(&current_time));
+    std::string timestamp = timestampBuffer;
 
+    sf::Lock locked(mLock);
     for (const auto& sink : mSinks)
     {
         sink->write(level, module, timestamp, filename, line, message);
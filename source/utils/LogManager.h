@@ -18,6 +18,8 @@
 #ifndef LOGMANAGER_H
 #define LOGMANAGER_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -29,10 +31,33 @@
 #include "utils/LogMessageLevel.h"
 #include "utils/LogSink.h"
 
-#define OD_LOG_ERR(_message)                      LogManager::getSingleton().logMessage(LogMessageLevel::CRITICAL, __FILE__, __LINE__, (std::string("") + _message))
-#define OD_LOG_WRN(_message)                      LogManager::getSingleton().logMessage(LogMessageLevel::WARNING, __FILE__, __LINE__, (std::string("") + _message))
-#define OD_LOG_INF(_message)                      LogManager::getSingleton().logMessage(LogMessageLevel::NORMAL, __FILE__, __LINE__, (std::string("") + _message))
-#define OD_LOG_DBG(_message)                      LogManager::getSingleton().logMessage(LogMessageLevel::TRIVIAL, __FILE__, __LINE__, (std::string("") + _message))
+//! \brief Logs the message if its level is enabled. The message is only built if it will be logged. The module id
+//! is computed once per call site.
+#define OD_LOG_LEVEL(_level, _message) \
+    do \
+    { \
+        static const uint32_t odLogModuleId = LogManager::getModuleId(__FILE__); \
+        LogManager& odLogManager = LogManager::getSingleton(); \
+        if (odLogManager.isLogged(_level, odLogModuleId)) \
+            odLogManager.logMessage(_level, odLogModuleId, __FILE__, __LINE__, (std::string("") + _message)); \
+    } while (false)
+
+#define OD_LOG_ERR(_message)                      OD_LOG_LEVEL(LogMessageLevel::CRITICAL, _message)
+#define OD_LOG_WRN(_message)                      OD_LOG_LEVEL(LogMessageLevel::WARNING, _message)
+#define OD_LOG_INF(_message)                      OD_LOG_LEVEL(LogMessageLevel::NORMAL, _message)
+
+// If OD_STRIP_TRIVIAL_LOGS is defined, debug logs are removed at compile time. The message is still compiled
+// (but never run) so that the variables only used by logs do not trigger warnings.
+#ifdef OD_STRIP_TRIVIAL_LOGS
+#define OD_LOG_DBG(_message) \
+    do \
+    { \
+        if (false) \
+            LogManager::getSingleton().logMessage(LogMessageLevel::TRIVIAL, __FILE__, __LINE__, (std::string("") + _message)); \
+    } while (false)
+#else
+#define OD_LOG_DBG(_message)                      OD_LOG_LEVEL(LogMessageLevel::TRIVIAL, _message)
+#endif
 
 #define OD_ASSERT_TRUE(_condition)                if (!(_condition)) LogManager::getSingleton().logMessage(LogMessageLevel::CRITICAL, __FILE__, __LINE__, std::string(#_condition))
 #define OD_ASSERT_TRUE_MSG(_condition, _message)  if (!(_condition)) LogManager::getSingleton().logMessage(LogMessageLevel::CRITICAL, __FILE__, __LINE__, (std::string("") + _message))
@@ -53,19 +78,43 @@ public:
     //! \brief Set the minimum logging level per module.
     void setModuleLevel(const char* module, LogMessageLevel level);
 
+    //! \brief Returns true if a message with the given level from the given module should be logged.
+    inline bool isLogged(LogMessageLevel level, uint32_t moduleId) const
+    {
+        if (static_cast<int>(level) >= mLevel.load(std::memory_order_relaxed))
+            return true;
+
+        // Allow per-module overrides of the global logging level.
+        if (moduleId >= MAX_NB_MODULES)
+            return false;
+
+        int moduleLevel = mModuleLevels[moduleId].load(std::memory_order_relaxed);
+        return (moduleLevel != MODULE_LEVEL_UNSET) && (static_cast<int>(level) >= moduleLevel);
+    }
+
     //! \brief Log a message to the sinks.
     void logMessage(LogMessageLevel level, const char* filepath, int line, const std::string& message);
 
+    //! \brief Log a message to the sinks. The level is expected to have been checked with isLogged.
+    void logMessage(LogMessageLevel level, uint32_t moduleId, const char* filepath, int line, const std::string& message);
+
+    //! \brief Returns the id of the module (the source file name without extension) of the given file. The
+    //! same id is returned for every file with the same module name.
+    static uint32_t getModuleId(const char* filepath);
+
     static const std::string GAMELOG_NAME;
 private:
     LogManager(const LogManager&) = delete;
     LogManager& operator=(const LogManager&) = delete;
 
-    LogMessageLevel mLevel;
-    std::map<std::string, LogMessageLevel> mModuleLevel;
+    static const uint32_t MAX_NB_MODULES = 1024;
+    static const int MODULE_LEVEL_UNSET = -1;
+
+    //! \brief Levels are atomic since they are checked without locking before building the messages
+    std::atomic<int> mLevel;
+    std::atomic<int> mModuleLevels[MAX_NB_MODULES];
     sf::Mutex mLock;
     std::vector<std::unique_ptr<LogSink>> mSinks;
-    std::stringstream mTimestampStream;
 };
 
 #endif // LOGMANAGER_H
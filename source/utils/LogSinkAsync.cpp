@@ -0,0 +1,109 @@
+/*
+*  Copyright (C) 2011-2016  OpenDungeons Team
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "utils/LogSinkAsync.h"
+
+LogSinkAsync::LogSinkAsync(uint32_t capacity) :
+    mEntries(capacity > 0 ? capacity : 1),
+    mFirst(0),
+    mNbPending(0),
+    mNbQueued(0),
+    mNbWritten(0),
+    mStop(false),
+    mThread(&LogSinkAsync::run, this)
+{
+}
+
+LogSinkAsync::~LogSinkAsync()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondQueued.notify_one();
+    mThread.join();
+}
+
+void LogSinkAsync::addSink(std::unique_ptr<LogSink> sink)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSinks.push_back(std::move(sink));
+}
+
+void LogSinkAsync::write(LogMessageLevel level, const std::string& module, const std::string& timestamp, const std::string& filename, int line, const std::string& message)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    uint32_t capacity = static_cast<uint32_t>(mEntries.size());
+    mCondWritten.wait(lock, [this, capacity]() { return mNbPending < capacity; });
+
+    Entry& entry = mEntries[(mFirst + mNbPending) % capacity];
+    entry.mLevel = level;
+    entry.mModule = module;
+    entry.mTimestamp = timestamp;
+    entry.mFilename = filename;
+    entry.mLine = line;
+    entry.mMessage = message;
+    ++mNbPending;
+    uint64_t messageIndex = ++mNbQueued;
+    mCondQueued.notify_one();
+
+    if (level < LogMessageLevel::CRITICAL)
+        return;
+
+    mCondWritten.wait(lock, [this, messageIndex]() { return mNbWritten >= messageIndex; });
+}
+
+void LogSinkAsync::flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    uint64_t messageIndex = mNbQueued;
+    mCondWritten.wait(lock, [this, messageIndex]() { return mNbWritten >= messageIndex; });
+}
+
+void LogSinkAsync::run()
+{
+    // The entry being written. Its strings are swapped with the ones in the buffer so that
+    // both keep their capacity
+    Entry entry;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mCondQueued.wait(lock, [this]() { return mStop || (mNbPending > 0); });
+        // We write all the pending messages before stopping
+        if (mNbPending == 0)
+            return;
+
+        Entry& pending = mEntries[mFirst];
+        entry.mLevel = pending.mLevel;
+        entry.mModule.swap(pending.mModule);
+        entry.mTimestamp.swap(pending.mTimestamp);
+        entry.mFilename.swap(pending.mFilename);
+        entry.mLine = pending.mLine;
+        entry.mMessage.swap(pending.mMessage);
+        mFirst = (mFirst + 1) % static_cast<uint32_t>(mEntries.size());
+        --mNbPending;
+
+        // The sinks are only used by this thread
+        lock.unlock();
+        for (const auto& sink : mSinks)
+            sink->write(entry.mLevel, entry.mModule, entry.mTimestamp, entry.mFilename, entry.mLine, entry.mMessage);
+        lock.lock();
+
+        ++mNbWritten;
+        mCondWritten.notify_all();
+    }
+}
@@ -0,0 +1,83 @@
+/*
+*  Copyright (C) 2011-2016  OpenDungeons Team
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LOGSINKASYNC_H_
+#define _LOGSINKASYNC_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LogSink.h"
+
+/*! \brief Sink writing the messages to other sinks from its own thread.
+ *
+ * The messages are copied in a ring buffer so that the thread logging does not wait for the
+ * file or the console. The entries of the ring buffer keep their strings from one message to
+ * the next so that they do not allocate once the messages have been seen once.
+ * If the buffer is full, the logging thread waits. Critical messages are written before write
+ * returns so that they are not lost if the game crashes right after.
+ */
+class LogSinkAsync : public LogSink
+{
+public:
+    LogSinkAsync(uint32_t capacity = 4096);
+    //! \brief Writes the pending messages before returning
+    ~LogSinkAsync();
+
+    //! \brief Adds a sink the messages will be written to. Should be called before logging
+    void addSink(std::unique_ptr<LogSink> sink);
+
+    virtual void write(LogMessageLevel level, const std::string& module, const std::string& timestamp, const std::string& filename, int line, const std::string& message) override;
+
+    //! \brief Waits until every message given to write has been written to the sinks
+    void flush();
+
+private:
+    struct Entry
+    {
+        LogMessageLevel mLevel;
+        std::string mModule;
+        std::string mTimestamp;
+        std::string mFilename;
+        int mLine;
+        std::string mMessage;
+    };
+
+    void run();
+
+    std::vector<std::unique_ptr<LogSink>> mSinks;
+
+    std::vector<Entry> mEntries;
+    //! \brief Index of the oldest entry not written yet
+    uint32_t mFirst;
+    uint32_t mNbPending;
+    //! \brief Number of messages queued and written since the beginning. Used to wait for a given message
+    uint64_t mNbQueued;
+    uint64_t mNbWritten;
+    bool mStop;
+
+    std::mutex mMutex;
+    std::condition_variable mCondQueued;
+    std::condition_variable mCondWritten;
+    std::thread mThread;
+};
+
+#endif // _LOGSINKASYNC_H_
@@ -27,84 +27,131 @@
 #include <cmath>
 #include <ctime>
 
-unsigned long myRandomSeed;
-const unsigned long MAX = 32768;
-
-static unsigned long randgen()
+namespace
 {
-    myRandomSeed = myRandomSeed * 1103515245 + 12345;
-    //TODO: What is the purpose of the cast?
-    unsigned long returnVal = static_cast<unsigned int>(myRandomSeed / 65536) % MAX;
+    //! \brief splitmix64 finalizer. Consecutive inputs give unrelated outputs
+    uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
 
-    return returnVal;
-}
+    uint64_t timeSeed()
+    {
+        // We mix the address of a thread local variable so that threads seeded at the same time differ
+        static thread_local char threadMarker;
+        return mix(static_cast<uint64_t>(std::time(0))) ^ reinterpret_cast<uintptr_t>(&threadMarker);
+    }
 
-//! \brief uniformly distributed number [0;1)
-static double uniform()
-{
-    return randgen() * 1.0 / static_cast<double>(MAX);
-}
+    thread_local RandomStream threadStream(timeSeed());
+    thread_local RandomStream* currentStream = nullptr;
 
-//! \brief uniformly distributed number [lo;hi)
-static double uniform(double lo, double hi)
-{
-    return uniform() * (hi - lo) + lo;
-}
+    RandomStream& getStream()
+    {
+        if(currentStream != nullptr)
+            return *currentStream;
 
-//! \brief random integer [lo;hi]
-static int randint(int lo, int hi)
-{
-    return static_cast<int>(uniform() * (hi - lo + 1) + lo);
+        return threadStream;
+    }
 }
 
-//! \brief random unsigned integer [lo;hi]
-static unsigned int randuint(unsigned int lo, unsigned int hi)
+uint64_t RandomStream::deriveSeed(uint64_t seed, const std::string& key)
 {
-    return static_cast<unsigned int>(uniform() * (hi - lo + 1) + lo);
+    // FNV-1a hash of the key
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(char c : key)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ULL;
+    }
+    return mix(seed ^ mix(hash));
 }
 
-
-namespace Random
+uint64_t RandomStream::next()
 {
+    mState += 0x9E3779B97F4A7C15ULL;
+    return mix(mState);
+}
 
-void initialize()
+double RandomStream::uniform()
 {
-    myRandomSeed = static_cast<unsigned long>(std::time(0));
+    // 53 bits fit exactly in a double
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
 }
 
-double Double(double min, double max)
+double RandomStream::Double(double min, double max)
 {
     if (min > max)
     {
         std::swap(min, max);
     }
 
-    return uniform(min, max);
+    return uniform() * (max - min) + min;
 }
 
-int Int(int min, int max)
+int RandomStream::Int(int min, int max)
 {
     if (min > max)
     {
         std::swap(min, max);
     }
 
-    return randint(min, max);
+    return static_cast<int>(uniform() * (static_cast<double>(max) - min + 1) + min);
 }
 
-unsigned int Uint(unsigned int min, unsigned int max)
+unsigned int RandomStream::Uint(unsigned int min, unsigned int max)
 {
     if (min > max)
     {
         std::swap(min, max);
     }
 
-    return randuint(min, max);
+    return static_cast<unsigned int>(uniform() * (static_cast<double>(max) - min + 1) + min);
 }
 
-double gaussianRandomDouble()
+double RandomStream::gaussianRandomDouble()
 {
     return std::sqrt(-2.0 * log(Double(0.0, 1.0))) * cos(2.0 * PI * Double(0.0, 1.0));
 }
 
+namespace Random
+{
+
+void initialize()
+{
+    threadStream.setSeed(timeSeed());
+}
+
+ScopedStream::ScopedStream(RandomStream& stream) :
+    mPreviousStream(currentStream)
+{
+    currentStream = &stream;
+}
+
+ScopedStream::~ScopedStream()
+{
+    currentStream = mPreviousStream;
+}
+
+double Double(double min, double max)
+{
+    return getStream().Double(min, max);
+}
+
+int Int(int min, int max)
+{
+    return getStream().Int(min, max);
+}
+
+unsigned int Uint(unsigned int min, unsigned int max)
+{
+    return getStream().Uint(min, max);
+}
+
+double gaussianRandomDouble()
+{
+    return getStream().gaussianRandomDouble();
+}
+
 } // namespace Random
@@ -23,11 +23,67 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <cstdint>
+#include <string>
+
+/*! \brief Deterministic random number generator (splitmix64).
+ *
+ * The same seed always gives the same sequence on every platform. The game map owns a stream seeded
+ * from the level or the command line and each entity gets its own stream derived from it (see deriveSeed)
+ * so that the numbers an entity draws do not depend on the order the entities are processed in.
+ */
+class RandomStream
+{
+public:
+    explicit RandomStream(uint64_t seed = 0) :
+        mState(seed)
+    {}
+
+    inline void setSeed(uint64_t seed)
+    { mState = seed; }
+
+    //! \brief Returns the seed of the stream identified by key in the game seeded with seed
+    static uint64_t deriveSeed(uint64_t seed, const std::string& key);
+
+    uint64_t next();
+
+    //! \brief See the functions with the same name in the Random namespace
+    double Double(double min, double max);
+    int Int(int min, int max);
+    unsigned int Uint(unsigned int min, unsigned int max);
+    double gaussianRandomDouble();
+
+private:
+    //! \brief uniformly distributed number [0;1)
+    double uniform();
+
+    uint64_t mState;
+};
+
+/*! \brief The functions of this namespace use the stream set for the calling thread by ScopedStream. If there is
+ * none, they use a stream local to the thread seeded from the time
+ */
 namespace Random
 {
-    //! \brief initializes the semaphore and seeds the generator
+    //! \brief seeds the generator of the calling thread from the time
     void initialize();
 
+    /*! \brief Makes the Random functions called by this thread use the given stream until it is destroyed.
+     * The server uses it to make the game depend only on the game map seed
+     */
+    class ScopedStream
+    {
+    public:
+        explicit ScopedStream(RandomStream& stream);
+        ~ScopedStream();
+
+    private:
+        ScopedStream(const ScopedStream&) = delete;
+        ScopedStream& operator=(const ScopedStream&) = delete;
+
+        RandomStream* mPreviousStream;
+    };
+
     /*! \brief generate a random double
      *
      *  \param min, max One or both can be negative
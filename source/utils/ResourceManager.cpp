@@ -54,6 +54,9 @@
 
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <thread>
+
 template<> ResourceManager* Ogre::Singleton<ResourceManager>::msSingleton = nullptr;
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 && defined(OD_DEBUG)
 //On windows, if the application is compiled in debug mode, use the plugins with debug prefix.
@@ -71,6 +74,7 @@ const std::string ResourceManager::SHADERCACHESUBPATH = "shaderCache/";
 const std::string ResourceManager::LOGFILENAME = "opendungeons.log";
 const std::string ResourceManager::CEGUILOGFILENAME = "CEGUI.log";
 const std::string ResourceManager::USERCFGFILENAME = "config.cfg";
+const std::string ResourceManager::LEVELINFOINDEXFILENAME = "levelInfo.index";
 
 const std::string ResourceManager::RESOURCEGROUPMUSIC = "Music";
 const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
@@ -85,6 +89,11 @@ const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
 ResourceManager::ResourceManager(boost::program_options::variables_map& options) :
         mServerMode(false),
         mForcedNetworkPort(-1),
+        mHasForcedSeed(false),
+        mForcedSeed(0),
+        mDeterminismCheckTurns(0),
+        mLevelLoadBenchmarkRuns(0),
+        mNbSenseWorkers(std::max(std::thread::hardware_concurrency(), 1u) - 1),
         mLogLevel(LogMessageLevel::NORMAL),
         mGameDataPath("./"),
         mUserDataPath("./"),
@@ -433,9 +442,33 @@ void ResourceManager::setupUserDataFolders(boost::program_options::variables_map
     if(itOption != options.end())
         mLogLevel = static_cast<LogMessageLevel>(itOption->second.as<int32_t>());
 
+    itOption = options.find("seed");
+    if(itOption != options.end())
+    {
+        mHasForcedSeed = true;
+        mForcedSeed = itOption->second.as<uint64_t>();
+    }
+
+    itOption = options.find("determinismcheck");
+    if(itOption != options.end())
+        mDeterminismCheckTurns = itOption->second.as<uint32_t>();
+
+    itOption = options.find("levelloadbenchmark");
+    if(itOption != options.end())
+        mLevelLoadBenchmarkRuns = itOption->second.as<uint32_t>();
+
+    itOption = options.find("convertlevel");
+    if(itOption != options.end())
+        mConvertLevelFiles = itOption->second.as<std::vector<std::string>>();
+
+    itOption = options.find("sensethreads");
+    if(itOption != options.end())
+        mNbSenseWorkers = itOption->second.as<uint32_t>();
+
     mUserConfigFile = mUserConfigPath + USERCFGFILENAME;
     mCeguiLogFile = mUserDataPath + CEGUILOGFILENAME;
     mShaderCachePath = mUserDataPath + SHADERCACHESUBPATH;
+    mLevelInfoIndexFile = mUserDataPath + LEVELINFOINDEXFILENAME;
 
     // Backup the Ogre log files from the previous three instances
     try
@@ -578,6 +611,15 @@ void ResourceManager::buildCommandOptions(boost::program_options::options_descri
         ("mscreator", boost::program_options::value<std::string>(), "Sets the creator for this map to connect to the master server. server/servercustom/serversave option needs to be on")
         ("port", boost::program_options::value<int32_t>(), "Sets the port used. Note that the port is used for both single and multi player")
         ("loglevel", boost::program_options::value<int32_t>(), "Sets the log level (between 0=Trivial and 3=Critical)")
+        ("seed", boost::program_options::value<uint64_t>(), "Sets the seed of the random numbers of the game launched in server mode. Overrides the seed of the level")
+        ("determinismcheck", boost::program_options::value<uint32_t>(), "Runs the given number of turns of the server level twice "
+            "with AI players only and checks that the game state is the same after each turn. The first game is run on one thread")
+        ("levelloadbenchmark", boost::program_options::value<uint32_t>(), "Loads each bundled level the given number "
+            "of times and logs how long it takes")
+        ("convertlevel", boost::program_options::value<std::vector<std::string>>()->multitoken(), "Takes an input "
+            "and an output file. Converts a text level into a savegame snapshot or a savegame snapshot into a text level")
+        ("sensethreads", boost::program_options::value<uint32_t>(), "Sets the number of threads the server uses in addition to its own "
+            "to compute what the creatures see. 0 computes it on the server thread only. Defaults to the number of cores minus one")
     ;
 }
 
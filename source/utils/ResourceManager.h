@@ -24,6 +24,7 @@
 #define RESOURCEMANAGER_H_
 
 #include <string>
+#include <vector>
 
 #include <OgreSingleton.h>
 #include <OgreStringVector.h>
@@ -129,6 +130,10 @@ public:
     inline const std::string& getCeguiLogFile() const
     { return mCeguiLogFile; }
 
+    //! \brief File where the info of the levels listed in the menus is cached (see LevelInfoIndex)
+    inline const std::string& getLevelInfoIndexFile() const
+    { return mLevelInfoIndexFile; }
+
     std::string getGameLevelPathSkirmish() const;
     std::string getUserLevelPathSkirmish() const
     { return mUserSkirmishLevelsPath; }
@@ -148,6 +153,24 @@ public:
     inline int32_t getForcedNetworkPort() const
     { return mForcedNetworkPort; }
 
+    inline bool hasForcedSeed() const
+    { return mHasForcedSeed; }
+
+    inline uint64_t getForcedSeed() const
+    { return mForcedSeed; }
+
+    inline uint32_t getDeterminismCheckTurns() const
+    { return mDeterminismCheckTurns; }
+
+    inline uint32_t getLevelLoadBenchmarkRuns() const
+    { return mLevelLoadBenchmarkRuns; }
+
+    inline const std::vector<std::string>& getConvertLevelFiles() const
+    { return mConvertLevelFiles; }
+
+    inline uint32_t getNbSenseWorkers() const
+    { return mNbSenseWorkers; }
+
     inline LogMessageLevel getLogLevel() const
     { return mLogLevel; }
 
@@ -160,6 +183,22 @@ private:
     //! \brief used when the network port is forced
     int32_t mForcedNetworkPort;
 
+    //! \brief used when the seed of the game is forced
+    bool mHasForcedSeed;
+    uint64_t mForcedSeed;
+
+    //! \brief Number of turns of the determinism check. 0 if it is not asked
+    uint32_t mDeterminismCheckTurns;
+
+    //! \brief Number of times each bundled level is loaded by the level load benchmark. 0 if it is not asked
+    uint32_t mLevelLoadBenchmarkRuns;
+
+    //! \brief Input and output files of the level conversion. Empty if it is not asked
+    std::vector<std::string> mConvertLevelFiles;
+
+    //! \brief Number of threads computing what the creatures see in addition to the server thread
+    uint32_t mNbSenseWorkers;
+
     //! \brief The log level
     LogMessageLevel mLogLevel;
 
@@ -186,6 +225,7 @@ private:
     std::string mOgreLogFile;
     std::string mCeguiLogFile;
     std::string mShaderCachePath;
+    std::string mLevelInfoIndexFile;
 
     //! \brief Specific data sub-paths.
     std::string mConfigPath;
@@ -210,6 +250,7 @@ private:
     static const std::string LOGFILENAME;
     static const std::string CEGUILOGFILENAME;
     static const std::string USERCFGFILENAME;
+    static const std::string LEVELINFOINDEXFILENAME;
 
     static const std::string RESOURCEGROUPMUSIC;
     static const std::string RESOURCEGROUPSOUND;
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TextTokenizer.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+//! \brief Doubles with at most this number of digits are exactly represented by their mantissa
+static const int MAX_EXACT_DIGITS = 15;
+//! \brief Powers of 10 exactly represented by a double
+static const double EXACT_POWERS_OF_TEN[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int MAX_EXACT_POWER_OF_TEN = 22;
+
+static inline bool isSpace(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '\v') || (c == '\f');
+}
+
+static inline bool isDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+bool TextRef::operator==(const std::string& str) const
+{
+    return (mSize == str.size()) && (std::memcmp(mBegin, str.data(), mSize) == 0);
+}
+
+TextTokenizer::TextTokenizer() :
+    mPos(0)
+{
+}
+
+bool TextTokenizer::loadFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!file.good())
+        return false;
+
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if(size < 0)
+        return false;
+
+    file.seekg(0, std::ios::beg);
+    mText.resize(static_cast<std::size_t>(size));
+    if(size > 0)
+        file.read(&mText[0], size);
+
+    mPos = 0;
+    return !file.fail();
+}
+
+void TextTokenizer::setText(std::string text)
+{
+    mText.swap(text);
+    mPos = 0;
+}
+
+bool TextTokenizer::nextLine(TextRef& line)
+{
+    if(isEnd())
+        return false;
+
+    const char* text = mText.data();
+    std::size_t size = mText.size();
+    const char* eol = static_cast<const char*>(std::memchr(text + mPos, '\n', size - mPos));
+    std::size_t end = (eol == nullptr) ? size : static_cast<std::size_t>(eol - text);
+    const char* comment = static_cast<const char*>(std::memchr(text + mPos, '#', end - mPos));
+    std::size_t lineEnd = (comment == nullptr) ? end : static_cast<std::size_t>(comment - text);
+
+    line = TextRef(text + mPos, lineEnd - mPos);
+    mPos = end + 1;
+    return true;
+}
+
+bool TextTokenizer::nextToken(TextRef& token)
+{
+    const char* text = mText.data();
+    std::size_t size = mText.size();
+    while(mPos < size)
+    {
+        char c = text[mPos];
+        if(isSpace(c))
+        {
+            ++mPos;
+            continue;
+        }
+
+        if(c == '#')
+        {
+            const char* eol = static_cast<const char*>(std::memchr(text + mPos, '\n', size - mPos));
+            mPos = (eol == nullptr) ? size : static_cast<std::size_t>(eol - text);
+            continue;
+        }
+
+        std::size_t begin = mPos;
+        while((mPos < size) && !isSpace(text[mPos]) && (text[mPos] != '#'))
+            ++mPos;
+
+        token = TextRef(text + begin, mPos - begin);
+        return true;
+    }
+
+    return false;
+}
+
+bool TextTokenizer::copyLinesUntil(const std::string& endTag, std::ostream& stream)
+{
+    TextRef line;
+    while(nextLine(line))
+    {
+        stream.write(line.mBegin, static_cast<std::streamsize>(line.mSize));
+        stream << "\n";
+        if(trim(line) == endTag)
+            return true;
+    }
+
+    return false;
+}
+
+void TextTokenizer::copyRemainingLines(std::ostream& stream)
+{
+    TextRef line;
+    while(nextLine(line))
+    {
+        stream.write(line.mBegin, static_cast<std::streamsize>(line.mSize));
+        stream << "\n";
+    }
+}
+
+TextRef TextTokenizer::trim(const TextRef& text)
+{
+    const char* begin = text.mBegin;
+    const char* end = text.mBegin + text.mSize;
+    while((begin < end) && isSpace(*begin))
+        ++begin;
+
+    while((end > begin) && isSpace(*(end - 1)))
+        --end;
+
+    return TextRef(begin, static_cast<std::size_t>(end - begin));
+}
+
+void TextTokenizer::split(const TextRef& text, char delimiter, std::vector<TextRef>& fields)
+{
+    fields.clear();
+    const char* begin = text.mBegin;
+    const char* end = text.mBegin + text.mSize;
+    while(true)
+    {
+        const char* next = static_cast<const char*>(std::memchr(begin, delimiter, static_cast<std::size_t>(end - begin)));
+        if(next == nullptr)
+        {
+            fields.push_back(TextRef(begin, static_cast<std::size_t>(end - begin)));
+            return;
+        }
+
+        fields.push_back(TextRef(begin, static_cast<std::size_t>(next - begin)));
+        begin = next + 1;
+    }
+}
+
+bool TextTokenizer::toInt(const TextRef& text, int32_t& value)
+{
+    TextRef str = trim(text);
+    const char* it = str.mBegin;
+    const char* end = str.mBegin + str.mSize;
+
+    bool isNegative = false;
+    if((it < end) && ((*it == '-') || (*it == '+')))
+    {
+        isNegative = (*it == '-');
+        ++it;
+    }
+
+    if(it == end)
+        return false;
+
+    int64_t number = 0;
+    for(; it < end; ++it)
+    {
+        if(!isDigit(*it))
+            return false;
+
+        number = number * 10 + (*it - '0');
+        if(number > static_cast<int64_t>(std::numeric_limits<int32_t>::max()) + 1)
+            return false;
+    }
+
+    if(isNegative)
+        number = -number;
+
+    if(number > std::numeric_limits<int32_t>::max())
+        return false;
+
+    value = static_cast<int32_t>(number);
+    return true;
+}
+
+bool TextTokenizer::toDouble(const TextRef& text, double& value)
+{
+    TextRef str = trim(text);
+    const char* it = str.mBegin;
+    const char* end = str.mBegin + str.mSize;
+
+    bool isNegative = false;
+    if((it < end) && ((*it == '-') || (*it == '+')))
+    {
+        isNegative = (*it == '-');
+        ++it;
+    }
+
+    uint64_t mantissa = 0;
+    int nbDigits = 0;
+    int exponent = 0;
+    bool hasDigit = false;
+    for(; (it < end) && isDigit(*it); ++it)
+    {
+        hasDigit = true;
+        if((mantissa == 0) && (*it == '0'))
+            continue;
+
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+        ++nbDigits;
+    }
+
+    if((it < end) && (*it == '.'))
+    {
+        for(++it; (it < end) && isDigit(*it); ++it)
+        {
+            hasDigit = true;
+            --exponent;
+            if((mantissa == 0) && (*it == '0'))
+                continue;
+
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+            ++nbDigits;
+        }
+    }
+
+    if(!hasDigit || (nbDigits > MAX_EXACT_DIGITS))
+    {
+        // Not a number or a precision we cannot handle exactly. We let the standard library parse it
+        std::istringstream ss(str.toString());
+        ss.imbue(std::locale::classic());
+        double number;
+        if(!(ss >> number) || !(ss >> std::ws).eof())
+            return false;
+
+        value = number;
+        return true;
+    }
+
+    if((it < end) && ((*it == 'e') || (*it == 'E')))
+    {
+        int32_t exp;
+        if(!toInt(TextRef(it + 1, static_cast<std::size_t>(end - it - 1)), exp))
+            return false;
+
+        exponent += exp;
+        it = end;
+    }
+
+    if(it != end)
+        return false;
+
+    // The mantissa and the power of 10 are exact doubles so the division or the multiplication is correctly rounded
+    double number = static_cast<double>(mantissa);
+    if(mantissa == 0)
+        number = 0.0;
+    else if((exponent >= 0) && (exponent <= MAX_EXACT_POWER_OF_TEN))
+        number *= EXACT_POWERS_OF_TEN[exponent];
+    else if((exponent < 0) && (-exponent <= MAX_EXACT_POWER_OF_TEN))
+        number /= EXACT_POWERS_OF_TEN[-exponent];
+    else
+    {
+        std::istringstream ss(str.toString());
+        ss.imbue(std::locale::classic());
+        if(!(ss >> number))
+            return false;
+
+        value = number;
+        return true;
+    }
+
+    value = isNegative ? -number : number;
+    return true;
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TEXTTOKENIZER_H_
+#define _TEXTTOKENIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//! \brief Part of a text owned by someone else. The text must stay valid while the TextRef is used
+struct TextRef
+{
+    TextRef() :
+        mBegin(nullptr),
+        mSize(0)
+    {}
+
+    TextRef(const char* begin, std::size_t size) :
+        mBegin(begin),
+        mSize(size)
+    {}
+
+    inline bool empty() const
+    { return mSize == 0; }
+
+    inline std::string toString() const
+    { return (mBegin == nullptr) ? std::string() : std::string(mBegin, mSize); }
+
+    bool operator==(const std::string& str) const;
+    inline bool operator!=(const std::string& str) const
+    { return !(*this == str); }
+
+    const char* mBegin;
+    std::size_t mSize;
+};
+
+/*! \brief Reads a text file the way the level files are read with Helper::readFileWithoutComments and
+ * operator>>, but without copying it in a stream.
+ *
+ * The file is read in memory at once. The lines, the tokens and the fields are returned as TextRef
+ * pointing in that buffer. Everything from '#' to the end of a line is a comment and is skipped. The
+ * numbers are parsed without streams so that they do not depend on the locale. The parts of the file
+ * read by functions taking a std::istream can be copied in a stream with copyLinesUntil.
+ */
+class TextTokenizer
+{
+public:
+    TextTokenizer();
+
+    //! \brief Reads the given file. Returns false if it cannot be read
+    bool loadFile(const std::string& fileName);
+
+    //! \brief Uses the given text as if it was the content of a file
+    void setText(std::string text);
+
+    inline bool isEnd() const
+    { return mPos >= mText.size(); }
+
+    //! \brief Returns the rest of the current line without the comment and moves to the next line.
+    //! Returns false if the end of the text is reached
+    bool nextLine(TextRef& line);
+
+    //! \brief Returns the next word, like operator>> on a stream. Returns false if there is none
+    bool nextToken(TextRef& token);
+
+    /*! \brief Copies the lines without comment into the given stream until the line containing only
+     * endTag. That line is copied too. Returns false if endTag was not found, in which case the whole
+     * remaining text is copied.
+     */
+    bool copyLinesUntil(const std::string& endTag, std::ostream& stream);
+
+    //! \brief Copies the remaining lines without comment into the given stream
+    void copyRemainingLines(std::ostream& stream);
+
+    //! \brief Returns the text without the spaces at its beginning and its end
+    static TextRef trim(const TextRef& text);
+
+    //! \brief Splits the text with the given delimiter. The empty fields are kept
+    static void split(const TextRef& text, char delimiter, std::vector<TextRef>& fields);
+
+    //! \brief Parses the whole text (spaces around excepted) as a number. Returns false if it is not one
+    static bool toInt(const TextRef& text, int32_t& value);
+    static bool toDouble(const TextRef& text, double& value);
+
+private:
+    std::string mText;
+    std::size_t mPos;
+};
+
+#endif // _TEXTTOKENIZER_H_
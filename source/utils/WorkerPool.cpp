@@ -0,0 +1,131 @@
+/*
+*  Copyright (C) 2011-2016  OpenDungeons Team
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "utils/WorkerPool.h"
+
+WorkerPool::WorkerPool(uint32_t nbWorkers) :
+    mRanges(new Range[nbWorkers + 1]),
+    mTask(nullptr),
+    mLoopIndex(0),
+    mNbBusy(0),
+    mStop(false)
+{
+    for(uint32_t i = 0; i <= nbWorkers; ++i)
+    {
+        mRanges[i].mNext = 0;
+        mRanges[i].mEnd = 0;
+    }
+
+    mWorkers.reserve(nbWorkers);
+    for(uint32_t i = 0; i < nbWorkers; ++i)
+        mWorkers.emplace_back(&WorkerPool::run, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondStart.notify_all();
+    for(std::thread& worker : mWorkers)
+        worker.join();
+}
+
+void WorkerPool::parallelFor(uint32_t nbTasks, const std::function<void(uint32_t)>& task)
+{
+    if(nbTasks == 0)
+        return;
+
+    uint32_t nbWorkers = getNbWorkers();
+    if((nbWorkers == 0) || (nbTasks == 1))
+    {
+        for(uint32_t index = 0; index < nbTasks; ++index)
+            task(index);
+
+        return;
+    }
+
+    // We split the indexes in contiguous ranges, one for each thread
+    uint32_t nbRanges = nbWorkers + 1;
+    uint32_t begin = 0;
+    for(uint32_t i = 0; i < nbRanges; ++i)
+    {
+        uint32_t end = static_cast<uint32_t>((static_cast<uint64_t>(nbTasks) * (i + 1)) / nbRanges);
+        mRanges[i].mNext.store(begin, std::memory_order_relaxed);
+        mRanges[i].mEnd = end;
+        begin = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &task;
+        mNbBusy = nbWorkers;
+        ++mLoopIndex;
+    }
+    mCondStart.notify_all();
+
+    runTasks(nbWorkers);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondDone.wait(lock, [this]() { return mNbBusy == 0; });
+    mTask = nullptr;
+}
+
+void WorkerPool::run(uint32_t rangeIndex)
+{
+    uint64_t loopIndex = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondStart.wait(lock, [this, loopIndex]() { return mStop || (mLoopIndex != loopIndex); });
+            if(mStop)
+                return;
+
+            loopIndex = mLoopIndex;
+        }
+
+        runTasks(rangeIndex);
+
+        bool isLast;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            isLast = (--mNbBusy == 0);
+        }
+        if(isLast)
+            mCondDone.notify_one();
+    }
+}
+
+void WorkerPool::runTasks(uint32_t rangeIndex)
+{
+    const std::function<void(uint32_t)>& task = *mTask;
+    uint32_t nbRanges = getNbWorkers() + 1;
+    for(uint32_t i = 0; i < nbRanges; ++i)
+    {
+        Range& range = mRanges[(rangeIndex + i) % nbRanges];
+        while(true)
+        {
+            uint32_t index = range.mNext.fetch_add(1, std::memory_order_relaxed);
+            if(index >= range.mEnd)
+                break;
+
+            task(index);
+        }
+    }
+}
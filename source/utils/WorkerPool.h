@@ -0,0 +1,90 @@
+/*
+*  Copyright (C) 2011-2016  OpenDungeons Team
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _WORKERPOOL_H_
+#define _WORKERPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \brief Threads running the iterations of a loop in parallel.
+ *
+ * Each thread (the calling one included) gets a range of the indexes. When it is done with its
+ * range, it steals the remaining indexes of the others so that a thread given slow iterations does
+ * not keep the others waiting. The threads are created once and wait between two loops.
+ */
+class WorkerPool
+{
+public:
+    //! \brief Creates the given number of threads. With 0, parallelFor runs on the calling thread only
+    WorkerPool(uint32_t nbWorkers);
+    ~WorkerPool();
+
+    inline uint32_t getNbWorkers() const
+    { return static_cast<uint32_t>(mWorkers.size()); }
+
+    /*! \brief Calls task(index) for each index in [0, nbTasks) and returns when they are all done. The
+     * order the tasks are run in is not defined so they should not depend on each other.
+     * Should be called from one thread at a time.
+     */
+    void parallelFor(uint32_t nbTasks, const std::function<void(uint32_t)>& task);
+
+private:
+    //! \brief Size the ranges are padded to
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    /*! \brief Indexes not run yet of a thread. Padded to a cache line so that the fields of two threads are
+     * never in the same cache line. The padding is used instead of alignas because operator new does not
+     * honour over-aligned types before C++17
+     */
+    struct Range
+    {
+        std::atomic<uint32_t> mNext;
+        uint32_t mEnd;
+        char mPadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>) - sizeof(uint32_t)];
+    };
+    static_assert(sizeof(Range) == CACHE_LINE_SIZE, "Range should fill a cache line");
+
+    void run(uint32_t rangeIndex);
+
+    //! \brief Runs the tasks of the given range then steals the ones of the others
+    void runTasks(uint32_t rangeIndex);
+
+    std::vector<std::thread> mWorkers;
+    //! \brief One range per worker plus the last one for the calling thread
+    std::unique_ptr<Range[]> mRanges;
+
+    const std::function<void(uint32_t)>* mTask;
+    //! \brief Incremented for each loop so that the workers know there is a new one
+    uint64_t mLoopIndex;
+    //! \brief Number of workers that have not finished the current loop
+    uint32_t mNbBusy;
+    bool mStop;
+
+    std::mutex mMutex;
+    std::condition_variable mCondStart;
+    std::condition_variable mCondDone;
+};
+
+#endif // _WORKERPOOL_H_